@@ -0,0 +1,49 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "orchard-shell.h"
+#include "orchard-ftrace.h"
+
+#include <string.h>
+
+#if ORCHARD_USE_FTRACE
+
+static void cmd_ftrace(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  if (argc != 1) {
+    chprintf(chp, "Usage: ftrace start|stop|reset|dump\r\n");
+    return;
+  }
+
+  if (!strcmp(argv[0], "start"))
+    orchardFtraceStart();
+  else if (!strcmp(argv[0], "stop"))
+    orchardFtraceStop();
+  else if (!strcmp(argv[0], "reset"))
+    orchardFtraceReset();
+  else if (!strcmp(argv[0], "dump"))
+    orchardFtraceDump(chp);
+  else
+    chprintf(chp, "Usage: ftrace start|stop|reset|dump\r\n");
+}
+
+orchard_command("ftrace", cmd_ftrace);
+
+#endif /* ORCHARD_USE_FTRACE */
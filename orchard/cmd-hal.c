@@ -0,0 +1,56 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "orchard-shell.h"
+
+#if HAL_USE_INIT_STATS == TRUE
+
+static void cmd_hal(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  const hal_init_stats_t *sp;
+  uint32_t freq, total;
+  unsigned n, i;
+
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: hal\r\n");
+    return;
+  }
+
+  sp = halGetInitStats(&n);
+  freq = HAL_INIT_STATS_FREQUENCY;
+
+  chprintf(chp, "times in 1/%lu s\r\n", freq);
+  chprintf(chp, " init                 time\r\n");
+  total = 0;
+  for (i = 0; i < n; i++) {
+    chprintf(chp, " %-16s %8lu%s\r\n",
+             sp[i].name, sp[i].time, sp[i].lazy ? " lazy" : "");
+    if (!sp[i].lazy)
+      total += sp[i].time;
+  }
+  chprintf(chp, " %-16s %8lu (%lu us)\r\n", "(boot)", total,
+           (uint32_t)(((uint64_t)total * 1000000U) / freq));
+}
+
+orchard_command("hal", cmd_hal);
+
+#endif /* HAL_USE_INIT_STATS == TRUE */
@@ -0,0 +1,96 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "orchard-shell.h"
+
+#include <string.h>
+
+#if CH_DBG_LOCK_STATISTICS == TRUE
+
+/* Number of objects listed, the worst offenders by cumulative wait.*/
+#define LOCKS_TOP             8
+
+#if PORT_SUPPORTS_RT == TRUE
+#define LOCKS_UNIT            "cycles"
+#else
+#define LOCKS_UNIT            "ticks"
+#endif
+
+static uint32_t clamp32(rttime_t x) {
+
+  return x > 0xFFFFFFFFU ? 0xFFFFFFFFU : (uint32_t)x;
+}
+
+static void locks_dump(BaseSequentialStream *chp, lock_stats_t *lsp) {
+
+  chprintf(chp, " %-12s %c %8lu %8lu %10lu %8lu %8lu %s\r\n",
+    lsp->ls_name != NULL ? lsp->ls_name : "(noname)",
+    lsp->ls_type,
+    (uint32_t)lsp->ls_acquired,
+    (uint32_t)lsp->ls_contended,
+    clamp32(lsp->ls_wait_total),
+    (uint32_t)lsp->ls_wait_max,
+    (uint32_t)lsp->ls_hold_max,
+    lsp->ls_hold_max == 0 ? "" :
+      lsp->ls_hold_name != NULL ? lsp->ls_hold_name : "(noname)");
+}
+
+static void cmd_locks(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  lock_stats_t *top[LOCKS_TOP];
+  lock_stats_t *lsp;
+  unsigned n, i, total;
+
+  if ((argc > 1) || ((argc == 1) && strcmp(argv[0], "reset"))) {
+    chprintf(chp, "Usage: locks [reset]\r\n");
+    return;
+  }
+
+  if (argc == 1) {
+    chLockStatsReset();
+    return;
+  }
+
+  /* Insertion into a small sorted array, no need for allocations.*/
+  n = 0;
+  total = 0;
+  for (lsp = chLockStatsFirst(); lsp != NULL; lsp = chLockStatsNext(lsp)) {
+    total++;
+    if ((n == LOCKS_TOP) &&
+        (lsp->ls_wait_total <= top[LOCKS_TOP - 1]->ls_wait_total))
+      continue;
+    i = n < LOCKS_TOP ? n++ : LOCKS_TOP - 1;
+    while ((i > 0) && (top[i - 1]->ls_wait_total < lsp->ls_wait_total)) {
+      top[i] = top[i - 1];
+      i--;
+    }
+    top[i] = lsp;
+  }
+
+  chprintf(chp, "times in " LOCKS_UNIT ", %u of %u objects\r\n", n, total);
+  chprintf(chp, " name         T acquired contend  wait total wait max"
+                " hold max holder\r\n");
+  for (i = 0; i < n; i++)
+    locks_dump(chp, top[i]);
+}
+
+orchard_command("locks", cmd_locks);
+
+#endif /* CH_DBG_LOCK_STATISTICS == TRUE */
@@ -0,0 +1,64 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "shell.h"
+#include "chprintf.h"
+#include "lzstreams.h"
+
+#include "orchard-shell.h"
+
+#include <string.h>
+
+/* Printed before the compressed output, tools/lz-capture.py looks for it
+   past the echo of the command line.*/
+#define LZ_MARKER             "<lz>\r\n"
+
+/* Runs a command with its output compressed, "lz ftrace dump" takes a
+   fraction of the time of the text dump.  The stream state comes from
+   the heap so it only costs memory while in use.*/
+static void cmd_lz(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  const ShellCommand *scp;
+  LzStream *lzsp;
+
+  if (argc < 1) {
+    chprintf(chp, "Usage: lz command [args]\r\n");
+    return;
+  }
+
+  for (scp = orchard_command_start(); scp->sc_name != NULL; scp++)
+    if (!strcmp(scp->sc_name, argv[0]))
+      break;
+  if (scp->sc_name == NULL) {
+    chprintf(chp, "lz: %s not found\r\n", argv[0]);
+    return;
+  }
+
+  lzsp = chHeapAlloc(NULL, sizeof(*lzsp));
+  if (lzsp == NULL) {
+    chprintf(chp, "lz: out of memory\r\n");
+    return;
+  }
+
+  chprintf(chp, LZ_MARKER);
+  lzsObjectInit(lzsp, chp);
+  scp->sc_function((BaseSequentialStream *)lzsp, argc - 1, &argv[1]);
+  lzsFinish(lzsp);
+  chHeapFree(lzsp);
+}
+
+orchard_command("lz", cmd_lz);
@@ -0,0 +1,40 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "orchard-shell.h"
+#include "orchard-rpc.h"
+
+#if ORCHARD_USE_RPC
+
+static void cmd_rpc(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  (void)argv;
+  if (argc > 0) {
+    chprintf(chp, "Usage: rpc\r\n");
+    return;
+  }
+
+  /* The shell runs on the serial driver, a channel.*/
+  orchardRpcServe((BaseChannel *)chp);
+}
+
+orchard_command("rpc", cmd_rpc);
+
+#endif /* ORCHARD_USE_RPC */
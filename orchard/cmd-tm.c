@@ -0,0 +1,89 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "shell.h"
+#include "chprintf.h"
+
+#include "orchard-shell.h"
+
+#include <string.h>
+
+#if (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAM == TRUE)
+
+static void tm_dump(BaseSequentialStream *chp, tm_histogram_t *hp) {
+  time_measurement_t *tmp = hp->tmp;
+
+  chprintf(chp, " %-12s %8lu %8lu %8lu %8lu %8lu %8lu %8lu\r\n",
+    hp->name,
+    (uint32_t)tmp->n,
+    (uint32_t)tmp->best,
+    (uint32_t)chTMHistogramGetPercentileX(hp, 500),
+    (uint32_t)chTMHistogramGetPercentileX(hp, 900),
+    (uint32_t)chTMHistogramGetPercentileX(hp, 990),
+    (uint32_t)chTMHistogramGetPercentileX(hp, 999),
+    (uint32_t)tmp->worst);
+}
+
+static void tm_dump_buckets(BaseSequentialStream *chp, tm_histogram_t *hp) {
+  unsigned i;
+
+  chprintf(chp, "%s:\r\n", hp->name);
+  for (i = 0; i < CH_CFG_TM_HISTOGRAM_BUCKETS; i++) {
+    if (hp->buckets[i] == 0)
+      continue;
+    if (i == CH_CFG_TM_HISTOGRAM_BUCKETS - 1)
+      chprintf(chp, "   >%8lu %8lu\r\n",
+        (uint32_t)chTMHistogramGetBucketLimitX(i - 1),
+        (uint32_t)hp->buckets[i]);
+    else
+      chprintf(chp, "  <=%8lu %8lu\r\n",
+        (uint32_t)chTMHistogramGetBucketLimitX(i),
+        (uint32_t)hp->buckets[i]);
+  }
+}
+
+static void cmd_tm(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  tm_histogram_t *hp;
+
+  if ((argc > 1) ||
+      ((argc == 1) && strcmp(argv[0], "reset") && strcmp(argv[0], "-v"))) {
+    chprintf(chp, "Usage: tm [reset|-v]\r\n");
+    return;
+  }
+
+  if ((argc == 1) && !strcmp(argv[0], "reset")) {
+    for (hp = chTMHistogramFirst(); hp != NULL; hp = chTMHistogramNext(hp))
+      chTMHistogramResetX(hp);
+    return;
+  }
+
+  if (argc == 1) {
+    for (hp = chTMHistogramFirst(); hp != NULL; hp = chTMHistogramNext(hp))
+      tm_dump_buckets(chp, hp);
+    return;
+  }
+
+  chprintf(chp, " name                n     best      p50      p90"
+                "      p99    p99.9    worst\r\n");
+  for (hp = chTMHistogramFirst(); hp != NULL; hp = chTMHistogramNext(hp))
+    tm_dump(chp, hp);
+}
+
+orchard_command("tm", cmd_tm);
+
+#endif /* (CH_CFG_USE_TM == TRUE) && (CH_CFG_USE_TM_HISTOGRAM == TRUE) */
@@ -156,6 +156,28 @@
 #define HAL_USE_USB                 FALSE
 #endif
 
+/*===========================================================================*/
+/* HAL initialization related settings.                                      */
+/*===========================================================================*/
+
+/**
+ * @brief   Drivers initialized on first use.
+ * @details Mask of @p HAL_DRV_XXX identifiers, those drivers classes are
+ *          not initialized by @p halInit() but by their first start.
+ * @note    The driver objects of those classes must not be used before
+ *          the first start, see @p HAL_LAZY_DRIVERS in hal.h.
+ */
+#if !defined(HAL_LAZY_DRIVERS) || defined(__DOXYGEN__)
+#define HAL_LAZY_DRIVERS            0U
+#endif
+
+/**
+ * @brief   Enables the drivers initialization statistics.
+ */
+#if !defined(HAL_USE_INIT_STATS) || defined(__DOXYGEN__)
+#define HAL_USE_INIT_STATS          FALSE
+#endif
+
 /*===========================================================================*/
 /* ADC driver related settings.                                              */
 /*===========================================================================*/
@@ -280,12 +302,32 @@
  * @brief   Serial buffers size.
  * @details Configuration parameter, you can change the depth of the queue
  *          buffers depending on the requirements of your application.
- * @note    The default is 64 bytes for both the transmission and receive
- *          buffers.
+ * @note    The default is 16 bytes for both the transmission and receive
+ *          buffers, 64 bytes when the binary RPC channel is built in.
  */
 #if !defined(SERIAL_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#if defined(ORCHARD_USE_RPC) && (ORCHARD_USE_RPC == TRUE)
+#define SERIAL_BUFFERS_SIZE         64
+#else
 #define SERIAL_BUFFERS_SIZE         16
 #endif
+#endif
+
+/**
+ * @brief   Frames receive API.
+ * @details If enabled then @p CHN_FRAME_END is broadcast on idle line and
+ *          @p sdReadFrameTimeout() is available.
+ */
+#if !defined(SERIAL_USE_FRAMES) || defined(__DOXYGEN__)
+#define SERIAL_USE_FRAMES           FALSE
+#endif
+
+/**
+ * @brief   Number of complete frames tracked in the input queue.
+ */
+#if !defined(SERIAL_FRAMES_NUMBER) || defined(__DOXYGEN__)
+#define SERIAL_FRAMES_NUMBER        4
+#endif
 
 /*===========================================================================*/
 /* SERIAL_USB driver related setting.                                        */
@@ -302,6 +344,23 @@
 #define SERIAL_USB_BUFFERS_SIZE     256
 #endif
 
+/**
+ * @brief   Serial over USB packet mode.
+ * @details If enabled the driver transfers whole buffers directly from and
+ *          to the USB endpoints instead of using byte queues.
+ */
+#if !defined(SERIAL_USB_PACKET_MODE) || defined(__DOXYGEN__)
+#define SERIAL_USB_PACKET_MODE      FALSE
+#endif
+
+/**
+ * @brief   Serial over USB number of buffers.
+ * @note    Only used in packet mode.
+ */
+#if !defined(SERIAL_USB_BUFFERS_NUMBER) || defined(__DOXYGEN__)
+#define SERIAL_USB_BUFFERS_NUMBER   2
+#endif
+
 /*===========================================================================*/
 /* SPI driver related settings.                                              */
 /*===========================================================================*/
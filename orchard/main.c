@@ -25,6 +25,8 @@
 #include "orchard.h"
 #include "orchard-shell.h"
 #include "orchard-events.h"
+#include "orchard-prof.h"
+#include "orchard-stacks.h"
 
 #include <string.h>
 
@@ -120,6 +122,14 @@ int main(void)
   spiObjectInit(&SPID1);
 #endif
 
+#if ORCHARD_USE_PROF
+  orchardProfInit();
+#endif
+
+#if ORCHARD_USE_STACKS
+  orchardStacksInit();
+#endif
+
   evtTableInit(orchard_events, 32);
 
   orchardShellInit();
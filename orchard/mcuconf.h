@@ -51,6 +51,18 @@
 #define KINETIS_SYSCLK_FREQUENCY    47972352UL  /* 32.768 kHz * 1464 (~48 MHz) */
 #endif /* 0 */
 
+/*
+ * ST driver system settings.
+ * The tick feeds the PC-sampling profiler unless it has its own timer.
+ */
+#if ORCHARD_USE_PROF && !ORCHARD_PROF_USE_TPM
+#if !defined(_FROM_ASM_)
+extern void orchardProfSampleI(uint32_t exc_return);
+#endif
+#define KINETIS_ST_TICK_HOOK()                                              \
+  orchardProfSampleI((uint32_t)__builtin_return_address(0))
+#endif
+
 /*
  * SERIAL driver system settings.
  */
@@ -0,0 +1,135 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+#include "orchard-ftrace.h"
+
+#include <string.h>
+
+#if ORCHARD_USE_FTRACE
+
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+struct orchard_ftrace orchard_ftrace;
+
+void __cyg_profile_func_enter(void *this_fn, void *call_site) NO_INSTRUMENT;
+void __cyg_profile_func_exit(void *this_fn, void *call_site) NO_INSTRUMENT;
+
+/*
+ * Core cycles since boot, modulo 2^32.  If the SysTick counter wrapped and
+ * the tick has not been served yet (interrupts masked or a higher priority
+ * handler running) then the pending tick is accounted here.
+ */
+static inline NO_INSTRUMENT uint32_t ftrace_now(void) {
+  uint32_t reload = SysTick->LOAD;
+  systime_t t1, t2;
+  uint32_t val;
+
+  do {
+    t1 = chVTGetSystemTimeX();
+    val = SysTick->VAL;
+    t2 = chVTGetSystemTimeX();
+  } while (t1 != t2);
+
+  if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && (val > (reload >> 1)))
+    t1++;
+
+  return (uint32_t)t1 * (reload + 1) + (reload - val);
+}
+
+static inline NO_INSTRUMENT void ftrace_record(uint32_t fn) {
+  struct orchard_ftrace_rec *rp;
+  uint32_t primask;
+  uint32_t slot;
+
+  if (!orchard_ftrace.running)
+    return;
+
+  /* Slot reservation, the only part that must be atomic.*/
+  primask = __get_PRIMASK();
+  __disable_irq();
+  slot = orchard_ftrace.head++;
+  __set_PRIMASK(primask);
+
+  rp = &orchard_ftrace.ring[slot & (ORCHARD_FTRACE_RECORDS - 1)];
+  rp->ts = ftrace_now();
+  rp->fn = fn;
+  rp->thd = port_is_isr_context() ? NULL : chThdGetSelfX();
+}
+
+void __cyg_profile_func_enter(void *this_fn, void *call_site) {
+
+  (void)call_site;
+  ftrace_record((uint32_t)this_fn & ~FTRACE_EXIT);
+}
+
+void __cyg_profile_func_exit(void *this_fn, void *call_site) {
+
+  (void)call_site;
+  ftrace_record((uint32_t)this_fn | FTRACE_EXIT);
+}
+
+void orchardFtraceStart(void) {
+
+  orchard_ftrace.running = true;
+}
+
+void orchardFtraceStop(void) {
+
+  orchard_ftrace.running = false;
+}
+
+void orchardFtraceReset(void) {
+  bool running = orchard_ftrace.running;
+
+  orchard_ftrace.running = false;
+  memset(orchard_ftrace.ring, 0, sizeof(orchard_ftrace.ring));
+  orchard_ftrace.head = 0;
+  orchard_ftrace.running = running;
+}
+
+/*
+ * Dumps the ring oldest record first, the format is parsed by
+ * tools/ftrace-decode.py so keep it stable.  Recording is suspended while
+ * dumping so the output is not polluted by the dump itself.
+ */
+void orchardFtraceDump(BaseSequentialStream *chp) {
+  bool running = orchard_ftrace.running;
+  uint32_t first, head, i;
+  struct orchard_ftrace_rec *rp;
+
+  orchard_ftrace.running = false;
+
+  head = orchard_ftrace.head;
+  first = head > ORCHARD_FTRACE_RECORDS ? head - ORCHARD_FTRACE_RECORDS : 0;
+
+  chprintf(chp, "ftrace hz %lu records %lu lost %lu\r\n",
+           (uint32_t)(SysTick->LOAD + 1) * CH_CFG_ST_FREQUENCY,
+           head - first, first);
+  for (i = first; i < head; i++) {
+    rp = &orchard_ftrace.ring[i & (ORCHARD_FTRACE_RECORDS - 1)];
+    chprintf(chp, "ft %08lx %08lx %08lx\r\n",
+             rp->ts, rp->fn, (uint32_t)rp->thd);
+  }
+  chprintf(chp, "end\r\n");
+
+  orchard_ftrace.running = running;
+}
+
+#endif /* ORCHARD_USE_FTRACE */
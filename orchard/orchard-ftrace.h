@@ -0,0 +1,63 @@
+#ifndef __ORCHARD_FTRACE_H__
+#define __ORCHARD_FTRACE_H__
+
+/* Function entry/exit tracer.
+
+   Modules listed in the USE_FTRACE Makefile variable are compiled with
+   -finstrument-functions, their function entries and exits are recorded by
+   the __cyg_profile_func_enter/exit hooks in a global ring buffer together
+   with a timestamp and the current thread.  The ring is a flight recorder,
+   the oldest records are overwritten.
+
+     make USE_FTRACE="main.c orchard-shell.c"
+
+   A slot is reserved by incrementing the ring head with interrupts masked
+   for three instructions, the kernel lock is never taken so the hooks can
+   run in any context, including handlers above the kernel priority.
+
+   Timestamps are in core clock cycles, derived from the system tick count
+   and the SysTick counter.  Use "ftrace start", "ftrace stop" and
+   "ftrace dump" from the shell and feed the dump to tools/ftrace-decode.py
+   in order to rebuild the call trees.
+ */
+
+#if !defined(ORCHARD_USE_FTRACE)
+#define ORCHARD_USE_FTRACE                  FALSE
+#endif
+
+/* Number of records in the ring, must be a power of two.*/
+#if !defined(ORCHARD_FTRACE_RECORDS)
+#define ORCHARD_FTRACE_RECORDS              32
+#endif
+
+#if (ORCHARD_FTRACE_RECORDS & (ORCHARD_FTRACE_RECORDS - 1)) != 0
+#error "ORCHARD_FTRACE_RECORDS must be a power of two"
+#endif
+
+/* Set in the fn field of exit records.*/
+#define FTRACE_EXIT                         1U
+
+#if ORCHARD_USE_FTRACE
+
+struct orchard_ftrace_rec {
+  uint32_t ts;                          /* Core cycles.                 */
+  uint32_t fn;                          /* Function, FTRACE_EXIT on exit.*/
+  thread_t *thd;                        /* NULL in handler mode.        */
+};
+
+struct orchard_ftrace {
+  volatile bool running;
+  volatile uint32_t head;               /* Total records written.       */
+  struct orchard_ftrace_rec ring[ORCHARD_FTRACE_RECORDS];
+};
+
+extern struct orchard_ftrace orchard_ftrace;
+
+void orchardFtraceStart(void);
+void orchardFtraceStop(void);
+void orchardFtraceReset(void);
+void orchardFtraceDump(BaseSequentialStream *chp);
+
+#endif /* ORCHARD_USE_FTRACE */
+
+#endif /* __ORCHARD_FTRACE_H__ */
@@ -0,0 +1,214 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+#include "orchard-prof.h"
+
+#include <string.h>
+
+#if ORCHARD_USE_PROF
+
+#if ORCHARD_PROF_USE_TPM
+#include "kinetis_tpm.h"
+
+#if HAL_USE_PWM && KINETIS_PWM_USE_TPM1
+#error "ORCHARD_PROF_USE_TPM requires TPM1, disable KINETIS_PWM_USE_TPM1"
+#endif
+
+#define PROF_TPM_HANDLER      Vector88
+#define PROF_TPM_PRESCALER    6           /* Clock divided by 64.*/
+#define PROF_TPM_MOD          ((KINETIS_SYSCLK_FREQUENCY >> PROF_TPM_PRESCALER) \
+                               / ORCHARD_PROF_TPM_FREQUENCY)
+
+#if PROF_TPM_MOD > 0xFFFF
+#error "ORCHARD_PROF_TPM_FREQUENCY too low"
+#endif
+#endif /* ORCHARD_PROF_USE_TPM */
+
+/* Offset of the stacked PC in the exception frame, in words.*/
+#define FRAME_PC_OFFSET       6
+
+/* EXC_RETURN bit set when the exception frame is on the process stack.*/
+#define EXC_RETURN_PSP        (1 << 2)
+
+struct orchard_prof orchard_prof;
+
+static inline uint32_t prof_hash(uint32_t key) {
+
+  /* Fibonacci hashing, the KL02 has a single cycle multiplier.*/
+  return ((key >> ORCHARD_PROF_PC_SHIFT) * 2654435761U) &
+         (ORCHARD_PROF_BUCKETS - 1);
+}
+
+static void prof_account_pc(uint32_t pc) {
+  uint32_t key = (pc & ~((1U << ORCHARD_PROF_PC_SHIFT) - 1)) | 1;
+  uint32_t i = prof_hash(key);
+  int probes;
+
+  for (probes = 0; probes < ORCHARD_PROF_MAX_PROBES; probes++) {
+    if (orchard_prof.pc[i] == key) {
+      if (orchard_prof.hits[i] != 0xFFFF)
+        orchard_prof.hits[i]++;
+      return;
+    }
+    if (orchard_prof.pc[i] == 0) {
+      orchard_prof.pc[i] = key;
+      orchard_prof.hits[i] = 1;
+      return;
+    }
+    i = (i + 1) & (ORCHARD_PROF_BUCKETS - 1);
+  }
+  orchard_prof.dropped++;
+}
+
+static void prof_account_thread(thread_t *tp) {
+  int i;
+
+  for (i = 0; i < ORCHARD_PROF_THREADS; i++) {
+    if (orchard_prof.thd[i] == tp) {
+      if (orchard_prof.thd_hits[i] != 0xFFFF)
+        orchard_prof.thd_hits[i]++;
+      return;
+    }
+    if (orchard_prof.thd[i] == NULL) {
+      orchard_prof.thd[i] = tp;
+      orchard_prof.thd_hits[i] = 1;
+      return;
+    }
+  }
+}
+
+/*
+ * Takes a sample, to be invoked from an interrupt handler with the
+ * EXC_RETURN value the handler was entered with.
+ */
+void orchardProfSampleI(uint32_t exc_return) {
+  uint32_t *psp;
+
+  if (!orchard_prof.running)
+    return;
+
+  orchard_prof.samples++;
+  if (!(exc_return & EXC_RETURN_PSP)) {
+    orchard_prof.irq++;
+    return;
+  }
+
+  asm volatile ("mrs %0, psp" : "=r" (psp));
+  prof_account_pc(psp[FRAME_PC_OFFSET]);
+  prof_account_thread(chThdGetSelfX());
+}
+
+#if ORCHARD_PROF_USE_TPM
+OSAL_IRQ_HANDLER(PROF_TPM_HANDLER) {
+
+  OSAL_IRQ_PROLOGUE();
+  TPM1->STATUS = TPM_STATUS_TOF;
+  orchardProfSampleI((uint32_t)__builtin_return_address(0));
+  OSAL_IRQ_EPILOGUE();
+}
+#endif
+
+void orchardProfInit(void) {
+
+  memset(&orchard_prof, 0, sizeof(orchard_prof));
+
+#if ORCHARD_PROF_USE_TPM
+  SIM->SCGC6 |= SIM_SCGC6_TPM1;
+  TPM1->SC = 0;
+  TPM1->CNT = 0;
+  TPM1->MOD = PROF_TPM_MOD - 1;
+  nvicEnableVector(TPM1_IRQn, ORCHARD_PROF_TPM_IRQ_PRIORITY);
+#endif
+}
+
+void orchardProfStart(void) {
+
+  orchard_prof.running = true;
+#if ORCHARD_PROF_USE_TPM
+  TPM1->STATUS = TPM_STATUS_TOF;
+  TPM1->SC = TPM_SC_CMOD_LPTPM_CLK | TPM_SC_TOIE | PROF_TPM_PRESCALER;
+#endif
+}
+
+void orchardProfStop(void) {
+
+#if ORCHARD_PROF_USE_TPM
+  TPM1->SC = 0;
+#endif
+  orchard_prof.running = false;
+}
+
+void orchardProfReset(void) {
+  bool running = orchard_prof.running;
+
+  orchardProfStop();
+  memset(&orchard_prof, 0, sizeof(orchard_prof));
+  if (running)
+    orchardProfStart();
+}
+
+static const char *prof_thread_name(thread_t *tp) {
+  const char *name = "(gone)";
+  thread_t *rtp;
+
+  /* The thread could have been terminated in the meantime, only trust
+     pointers still present in the registry.  The scan is never cut short
+     because chRegNextThread() takes care of the references.*/
+  rtp = chRegFirstThread();
+  do {
+    if ((rtp == tp) && (tp->p_name != NULL))
+      name = tp->p_name;
+    else if (rtp == tp)
+      name = "(noname)";
+    rtp = chRegNextThread(rtp);
+  } while (rtp != NULL);
+
+  return name;
+}
+
+/*
+ * Dumps the collected samples, the format is parsed by
+ * tools/prof-resolve.py so keep it stable.
+ */
+void orchardProfDump(BaseSequentialStream *chp) {
+  int i;
+
+  chprintf(chp, "prof samples %lu irq %lu dropped %lu shift %d\r\n",
+           orchard_prof.samples, orchard_prof.irq, orchard_prof.dropped,
+           ORCHARD_PROF_PC_SHIFT);
+
+  for (i = 0; i < ORCHARD_PROF_THREADS; i++) {
+    if (orchard_prof.thd[i] == NULL)
+      break;
+    chprintf(chp, "thd %08lx %u %s\r\n",
+             (uint32_t)orchard_prof.thd[i], orchard_prof.thd_hits[i],
+             prof_thread_name(orchard_prof.thd[i]));
+  }
+
+  for (i = 0; i < ORCHARD_PROF_BUCKETS; i++) {
+    if (orchard_prof.pc[i] == 0)
+      continue;
+    chprintf(chp, "pc %08lx %u\r\n",
+             orchard_prof.pc[i] & ~1UL, orchard_prof.hits[i]);
+  }
+  chprintf(chp, "end\r\n");
+}
+
+#endif /* ORCHARD_USE_PROF */
@@ -0,0 +1,90 @@
+#ifndef __ORCHARD_PROF_H__
+#define __ORCHARD_PROF_H__
+
+/* Statistical PC-sampling profiler.
+
+   On every sample the PC of the interrupted thread is read back from the
+   exception frame on the process stack and accounted in a small hash table,
+   the current thread_t is accounted in a second table.  Samples taken while
+   another handler was running only bump the 'irq' counter, their PC is on
+   the main stack and can't be recovered.
+
+   Samples come from the system tick (SysTick_Handler calls the
+   KINETIS_ST_TICK_HOOK() defined in mcuconf.h) or, with
+   ORCHARD_PROF_USE_TPM, from a dedicated TPM1 overflow interrupt running
+   at ORCHARD_PROF_TPM_FREQUENCY, which avoids aliasing with code that is
+   itself synchronized to the tick.
+
+   Build with "make USE_PROF=tick" or "make USE_PROF=tpm", then use the
+   "prof start", "prof stop" and "prof dump" shell commands.  Feed the dump
+   to tools/prof-resolve.py together with build/orchard.elf in order to get
+   a flat per-function profile.
+ */
+
+#if !defined(ORCHARD_USE_PROF)
+#define ORCHARD_USE_PROF                    FALSE
+#endif
+
+/* Samples come from TPM1 instead of the system tick.*/
+#if !defined(ORCHARD_PROF_USE_TPM)
+#define ORCHARD_PROF_USE_TPM                FALSE
+#endif
+
+/* Sampling rate when using TPM1, keep it prime with the tick frequency.*/
+#if !defined(ORCHARD_PROF_TPM_FREQUENCY)
+#define ORCHARD_PROF_TPM_FREQUENCY          997
+#endif
+
+#if !defined(ORCHARD_PROF_TPM_IRQ_PRIORITY)
+#define ORCHARD_PROF_TPM_IRQ_PRIORITY       1
+#endif
+
+/* Number of PC buckets, must be a power of two.*/
+#if !defined(ORCHARD_PROF_BUCKETS)
+#define ORCHARD_PROF_BUCKETS                64
+#endif
+
+/* PCs are grouped in (1 << ORCHARD_PROF_PC_SHIFT) bytes granules, the
+   Makefile aligns functions to 16 bytes so a granule never spans two
+   functions.*/
+#if !defined(ORCHARD_PROF_PC_SHIFT)
+#define ORCHARD_PROF_PC_SHIFT               4
+#endif
+
+/* Number of distinct threads accounted.*/
+#if !defined(ORCHARD_PROF_THREADS)
+#define ORCHARD_PROF_THREADS                8
+#endif
+
+/* Maximum number of probes in the PC hash table before dropping a sample.*/
+#define ORCHARD_PROF_MAX_PROBES             4
+
+#if (ORCHARD_PROF_BUCKETS & (ORCHARD_PROF_BUCKETS - 1)) != 0
+#error "ORCHARD_PROF_BUCKETS must be a power of two"
+#endif
+
+#if ORCHARD_USE_PROF
+
+struct orchard_prof {
+  bool running;
+  uint32_t samples;                     /* Total samples taken.         */
+  uint32_t irq;                         /* Samples in handler mode.     */
+  uint32_t dropped;                     /* PC table overflows.          */
+  uint32_t pc[ORCHARD_PROF_BUCKETS];    /* Granule address | 1, 0 = free. */
+  uint16_t hits[ORCHARD_PROF_BUCKETS];
+  thread_t *thd[ORCHARD_PROF_THREADS];
+  uint16_t thd_hits[ORCHARD_PROF_THREADS];
+};
+
+extern struct orchard_prof orchard_prof;
+
+void orchardProfInit(void);
+void orchardProfStart(void);
+void orchardProfStop(void);
+void orchardProfReset(void);
+void orchardProfSampleI(uint32_t exc_return);
+void orchardProfDump(BaseSequentialStream *chp);
+
+#endif /* ORCHARD_USE_PROF */
+
+#endif /* __ORCHARD_PROF_H__ */
@@ -0,0 +1,285 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "shell.h"
+
+#include "orchard-shell.h"
+#include "orchard-rpc.h"
+
+#include <string.h>
+
+#if ORCHARD_USE_RPC
+
+/* Bytes around the data, id, op or status and CRC.*/
+#define RPC_OVERHEAD          4
+#define RPC_PAYLOAD           (ORCHARD_RPC_FRAME_SIZE - RPC_OVERHEAD)
+
+#if ORCHARD_RPC_IDLE_TIMEOUT > 0
+#define RPC_IDLE              MS2ST(ORCHARD_RPC_IDLE_TIMEOUT)
+#else
+#define RPC_IDLE              TIME_INFINITE
+#endif
+
+/* Stream handed to the commands, the output is cut into frames.*/
+struct rpc_stream {
+  const struct BaseSequentialStreamVMT *vmt;
+  BaseChannel *chp;
+  size_t n;                             /* Payload bytes buffered.      */
+  uint8_t id;                           /* Request being served.        */
+};
+
+static uint8_t rx_buf[ORCHARD_RPC_FRAME_SIZE];
+
+/* The response is built one byte in, a frame fits a single COBS block so
+   it can be encoded in place, plus the delimiter.*/
+static uint8_t tx_buf[1 + ORCHARD_RPC_FRAME_SIZE + 1];
+#define tx_frame              (&tx_buf[1])
+
+static bool serving;
+
+/* CRC-16/CCITT-FALSE, a nibble at a time.*/
+static uint16_t crc16(const uint8_t *p, size_t n) {
+  static const uint16_t tab[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+  };
+  uint16_t crc = 0xFFFF;
+
+  while (n--) {
+    crc = (uint16_t)(crc << 4) ^ tab[(crc >> 12) ^ (*p >> 4)];
+    crc = (uint16_t)(crc << 4) ^ tab[(crc >> 12) ^ (*p++ & 0x0F)];
+  }
+  return crc;
+}
+
+/* COBS encoder for up to 254 bytes, delimiter included.  The source may
+   start one byte after the destination.*/
+static size_t cobs_encode(uint8_t *dst, const uint8_t *src, size_t n) {
+  uint8_t *start = dst;
+  uint8_t *cp = dst++;
+  uint8_t code = 1;
+
+  while (n--) {
+    uint8_t b = *src++;
+
+    if (b == 0) {
+      *cp = code;
+      cp = dst++;
+      code = 1;
+    }
+    else {
+      *dst++ = b;
+      code++;
+    }
+  }
+  *cp = code;
+  *dst++ = 0;
+
+  return (size_t)(dst - start);
+}
+
+static void rpc_send(struct rpc_stream *rsp, uint8_t status) {
+  size_t n = rsp->n + 2;
+  uint16_t crc;
+
+  tx_frame[0] = rsp->id;
+  tx_frame[1] = status;
+  crc = crc16(tx_frame, n);
+  tx_frame[n++] = (uint8_t)crc;
+  tx_frame[n++] = (uint8_t)(crc >> 8);
+  n = cobs_encode(tx_buf, tx_frame, n);
+  chnWrite(rsp->chp, tx_buf, n);
+  rsp->n = 0;
+}
+
+static msg_t rpc_put(void *ip, uint8_t b) {
+  struct rpc_stream *rsp = ip;
+
+  tx_frame[2 + rsp->n++] = b;
+  if (rsp->n == RPC_PAYLOAD)
+    rpc_send(rsp, RPC_MORE);
+  return MSG_OK;
+}
+
+static size_t rpc_write(void *ip, const uint8_t *bp, size_t n) {
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    rpc_put(ip, bp[i]);
+  return n;
+}
+
+static size_t rpc_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+  return 0;
+}
+
+static msg_t rpc_get(void *ip) {
+
+  (void)ip;
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT rpc_vmt = {
+  rpc_write, rpc_read, rpc_put, rpc_get, NULL
+};
+
+/* Serves a request of n bytes, CRC excluded, returns true on exit.*/
+static bool rpc_dispatch(struct rpc_stream *rsp, uint8_t *fp, size_t n) {
+  char *argv[SHELL_MAX_ARGUMENTS + 1];
+  const ShellCommand *scp;
+  char *p, *end;
+  int argc;
+  unsigned i;
+
+  rsp->id = fp[0];
+  rsp->n = 0;
+
+  switch (fp[1]) {
+  case RPC_OP_PING:
+    rpc_write(rsp, &fp[2], n - 2);
+    break;
+
+  case RPC_OP_LIST:
+    for (scp = orchard_command_start(); scp->sc_name != NULL; scp++)
+      rpc_write(rsp, (const uint8_t *)scp->sc_name, strlen(scp->sc_name) + 1);
+    break;
+
+  case RPC_OP_CALL:
+    if (n < 3) {
+      rpc_send(rsp, RPC_ERR_ARGS);
+      return false;
+    }
+    scp = orchard_command_start();
+    for (i = 0; (i < fp[2]) && (scp->sc_name != NULL); i++)
+      scp++;
+    if (scp->sc_name == NULL) {
+      rpc_send(rsp, RPC_ERR_CMD);
+      return false;
+    }
+
+    /* Arguments are NUL terminated strings, the CRC is no longer needed
+       so the last one can't run past the data.*/
+    fp[n] = '\0';
+    p = (char *)&fp[3];
+    end = (char *)&fp[n];
+    argc = 0;
+    while (p < end) {
+      if (argc == SHELL_MAX_ARGUMENTS) {
+        rpc_send(rsp, RPC_ERR_ARGS);
+        return false;
+      }
+      argv[argc++] = p;
+      p += strlen(p) + 1;
+    }
+    argv[argc] = NULL;
+    scp->sc_function((BaseSequentialStream *)rsp, argc, argv);
+    break;
+
+  case RPC_OP_EXIT:
+    rpc_send(rsp, RPC_OK);
+    return true;
+
+  default:
+    rpc_send(rsp, RPC_ERR_OP);
+    return false;
+  }
+
+  rpc_send(rsp, RPC_OK);
+  return false;
+}
+
+void orchardRpcServe(BaseChannel *chp)
+{
+  struct rpc_stream rs;
+  size_t len;
+  unsigned left;
+  uint8_t code, status;
+  bool overflow;
+  msg_t msg;
+
+  /* The buffers are static, "rpc" invoked over RPC does nothing.*/
+  if (serving)
+    return;
+  serving = true;
+
+  rs.vmt = &rpc_vmt;
+  rs.chp = chp;
+
+  len = 0;
+  left = 0;
+  code = 0xFF;
+  overflow = false;
+
+  chnPutTimeout(chp, 0, TIME_INFINITE);
+  while ((msg = chnGetTimeout(chp, RPC_IDLE)) >= MSG_OK) {
+    uint8_t b = (uint8_t)msg;
+
+    if (b != 0) {
+      if (left > 0)
+        left--;
+      else {
+        /* Code byte, the zero that ended the previous block goes back in
+           unless it was a full block or there is no previous block.*/
+        bool zero = code != 0xFF;
+
+        code = b;
+        left = b - 1U;
+        if (!zero)
+          continue;
+        b = 0;
+      }
+      if (len < sizeof(rx_buf))
+        rx_buf[len++] = b;
+      else
+        overflow = true;
+      continue;
+    }
+
+    /* Delimiter, empty frames are sync bytes.*/
+    if (len > 0) {
+      if (overflow)
+        status = RPC_ERR_SIZE;
+      else if ((left != 0) || (len < RPC_OVERHEAD) ||
+               (crc16(rx_buf, len - 2) !=
+                (rx_buf[len - 2] | (rx_buf[len - 1] << 8))))
+        status = RPC_ERR_CRC;
+      else if (rpc_dispatch(&rs, rx_buf, len - 2))
+        break;
+      else
+        status = RPC_OK;
+
+      if (status != RPC_OK) {
+        rs.id = rx_buf[0];
+        rs.n = 0;
+        rpc_send(&rs, status);
+      }
+    }
+    len = 0;
+    left = 0;
+    code = 0xFF;
+    overflow = false;
+  }
+
+  serving = false;
+}
+
+#endif /* ORCHARD_USE_RPC */
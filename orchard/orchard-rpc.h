@@ -0,0 +1,77 @@
+#ifndef __ORCHARD_RPC_H__
+#define __ORCHARD_RPC_H__
+
+/* Binary RPC channel.
+
+   The "rpc" shell command switches the console into a binary mode where
+   each request and response is a COBS encoded frame terminated by a zero
+   byte.  Decoded, a frame is:
+
+     request:   id, op, data..., crc16
+     response:  id, status, data..., crc16
+
+   The CRC is CRC-16/CCITT-FALSE over id to data, little endian.  The id
+   is chosen by the host and copied in the responses, so a host can keep
+   several requests in flight and match the answers.  Requests are served
+   in order, as they are read from the serial input queue, the bytes in
+   flight must fit in it (SERIAL_BUFFERS_SIZE).
+
+   The commands are the ones registered with orchard_command(), addressed
+   by their index in the table returned by RPC_OP_LIST.  A command writes
+   its output to a stream that cuts it into RPC_MORE frames whenever the
+   frame buffer fills, the last frame carries RPC_OK.  A single zero byte
+   is sent on entry so the host can sync past the echo of the command
+   line.  RPC_OP_EXIT, or no frames for ORCHARD_RPC_IDLE_TIMEOUT
+   milliseconds, returns to the text shell.
+
+   tools/orchardrpc.py is the host side, test/rpc runs this file on the
+   host against it.
+
+   Off by default, build it in with "make USE_RPC=yes".  On the KL02 it
+   costs about 130 bytes of frame buffers, 96 bytes of serial queues as
+   SERIAL_BUFFERS_SIZE goes from 16 to 64 to hold the requests in flight,
+   see halconf.h, and 64 bytes of shell stack because the commands run one
+   call deeper.
+ */
+
+#if !defined(ORCHARD_USE_RPC)
+#define ORCHARD_USE_RPC                     FALSE
+#endif
+
+/* Largest decoded frame, id, op or status and CRC included.*/
+#if !defined(ORCHARD_RPC_FRAME_SIZE)
+#define ORCHARD_RPC_FRAME_SIZE              64
+#endif
+
+/* Idle time before falling back to the text shell, in milliseconds, zero
+   means never.*/
+#if !defined(ORCHARD_RPC_IDLE_TIMEOUT)
+#define ORCHARD_RPC_IDLE_TIMEOUT            30000
+#endif
+
+/* Requests.*/
+#define RPC_OP_PING                         0x00    /* Echoes the data.  */
+#define RPC_OP_LIST                         0x01    /* Command names.    */
+#define RPC_OP_CALL                         0x02    /* Index, arguments. */
+#define RPC_OP_EXIT                         0x03    /* Back to the shell.*/
+
+/* Responses status.*/
+#define RPC_OK                              0x00
+#define RPC_MORE                            0x01
+#define RPC_ERR_CRC                         0x10
+#define RPC_ERR_OP                          0x11
+#define RPC_ERR_CMD                         0x12
+#define RPC_ERR_ARGS                        0x13
+#define RPC_ERR_SIZE                        0x14
+
+#if ORCHARD_USE_RPC
+
+#if ORCHARD_RPC_FRAME_SIZE > 254
+#error "ORCHARD_RPC_FRAME_SIZE must fit a single COBS block"
+#endif
+
+void orchardRpcServe(BaseChannel *chp);
+
+#endif /* ORCHARD_USE_RPC */
+
+#endif /* __ORCHARD_RPC_H__ */
@@ -19,6 +19,7 @@
 #include "shell.h"
 #include "orchard.h"
 #include "orchard-shell.h"
+#include "orchard-rpc.h"
 
 /* Global stream variable, lets modules use chprintf().*/
 void *stream;
@@ -29,8 +30,15 @@ static const SerialConfig serialConfig = {
   115200,
 };
 
+/* The RPC server runs the commands one call deeper.*/
+#if ORCHARD_USE_RPC
+#define SHELL_WA_SIZE 320
+#else
+#define SHELL_WA_SIZE 256
+#endif
+
 static thread_t *shell_tp = NULL;
-static THD_WORKING_AREA(waShellThread, 256);
+static THD_WORKING_AREA(waShellThread, SHELL_WA_SIZE);
 
 void orchardShellInit(void)
 {
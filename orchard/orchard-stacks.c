@@ -0,0 +1,211 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+#include "orchard-stacks.h"
+
+#if ORCHARD_USE_STACKS
+
+/* Fill pattern as seen by word reads, crt0 uses the same for the main and
+   exception stacks.*/
+#define STACKS_PAINT          ((uint32_t)CH_DBG_STACK_FILL_VALUE * 0x01010101U)
+
+/* Linker symbols, see rules.ld.*/
+extern uint32_t __main_stack_base__, __main_stack_end__;
+extern uint32_t __main_thread_stack_base__, __main_thread_stack_end__;
+
+/* Identifier of the exception stack in the table.*/
+#define STACKS_EXC_ID         ((const void *)&__main_stack_base__)
+
+static struct orchard_stack stacks[ORCHARD_STACKS_MAX];
+static uint8_t stacks_pass;
+static MUTEX_DECL(stacks_mtx);
+static THD_WORKING_AREA(waStacksThread, 96);
+
+static size_t stacks_size(const struct orchard_stack *sp) {
+
+  return (size_t)(sp->top - sp->base) * sizeof(uint32_t);
+}
+
+/*
+ * Counts the bytes still holding the paint from the base of a stack up to
+ * the specified limit.  No lock is held, a concurrent push can only make
+ * the result smaller on the next scan.
+ */
+static size_t stacks_unused(const uint32_t *base, const uint32_t *limit) {
+  const uint32_t *p = base;
+
+  while ((p < limit) && (*p == STACKS_PAINT))
+    p++;
+
+  return (size_t)(p - base) * sizeof(uint32_t);
+}
+
+/* Must be invoked with stacks_mtx locked.*/
+static void stacks_update(const void *id, const char *name,
+                          const uint32_t *base, const uint32_t *top) {
+  struct orchard_stack *sp = NULL;
+  int i;
+
+  for (i = 0; i < ORCHARD_STACKS_MAX; i++) {
+    if (stacks[i].id == id) {
+      sp = &stacks[i];
+      break;
+    }
+    if ((sp == NULL) && (stacks[i].id == NULL))
+      sp = &stacks[i];
+  }
+  if (sp == NULL)
+    return;
+
+  /* New entry or a different stack at the same address.*/
+  if ((sp->id != id) || (sp->base != base) || (sp->top != top)) {
+    sp->id = id;
+    sp->base = base;
+    sp->top = top;
+    sp->unused = stacks_size(sp);
+    sp->warned = 0;
+  }
+  sp->name = name;
+  sp->pass = stacks_pass;
+
+  /* The paint can't come back, the scan stops at the previous mark.*/
+  sp->unused = stacks_unused(base, base + sp->unused / sizeof(uint32_t));
+
+  if (!sp->warned && (sp->unused < ORCHARD_STACKS_WARN_BYTES)) {
+    sp->warned = 1;
+#if defined(ORCHARD_STACKS_WARN_HOOK)
+    ORCHARD_STACKS_WARN_HOOK(sp->name, stacks_size(sp), sp->unused);
+#endif
+  }
+}
+
+static void stacks_scan_thread(thread_t *tp) {
+  const uint32_t *base, *top;
+
+  if (tp->p_state == CH_STATE_FINAL)
+    return;
+
+  if (tp == &ch.mainthread) {
+    base = &__main_thread_stack_base__;
+    top = &__main_thread_stack_end__;
+  }
+  else if (tp->p_stktop != NULL) {
+    base = (const uint32_t *)(tp + 1);
+    top = (const uint32_t *)tp->p_stktop;
+  }
+  else {
+    /* Created without filling the stack.*/
+    return;
+  }
+
+  chMtxLock(&stacks_mtx);
+  stacks_update(tp, chRegGetThreadNameX(tp), base, top);
+  chMtxUnlock(&stacks_mtx);
+}
+
+static void stacks_scan_exceptions(void) {
+
+  chMtxLock(&stacks_mtx);
+  stacks_update(STACKS_EXC_ID, "(exceptions)",
+                &__main_stack_base__, &__main_stack_end__);
+  chMtxUnlock(&stacks_mtx);
+}
+
+/* Forgets the stacks of the threads not seen during the pass.*/
+static void stacks_end_pass(void) {
+  int i;
+
+  chMtxLock(&stacks_mtx);
+  for (i = 0; i < ORCHARD_STACKS_MAX; i++) {
+    if ((stacks[i].id != NULL) && (stacks[i].pass != stacks_pass))
+      stacks[i].id = NULL;
+  }
+  stacks_pass++;
+  chMtxUnlock(&stacks_mtx);
+}
+
+/*
+ * Scans a single stack per period, the thread reference taken by the
+ * registry walk keeps a dynamic thread's memory around while sleeping.
+ */
+static THD_FUNCTION(stacks_thread, arg) {
+  thread_t *tp;
+
+  (void)arg;
+  chRegSetThreadName("stacks");
+
+  while (true) {
+    tp = chRegFirstThread();
+    do {
+      stacks_scan_thread(tp);
+      chThdSleepMilliseconds(ORCHARD_STACKS_PERIOD);
+      tp = chRegNextThread(tp);
+    } while (tp != NULL);
+
+    stacks_scan_exceptions();
+    stacks_end_pass();
+    chThdSleepMilliseconds(ORCHARD_STACKS_PERIOD);
+  }
+}
+
+void orchardStacksInit(void) {
+
+  chMtxSetName(&stacks_mtx, "stacks");
+  chThdCreateStatic(waStacksThread, sizeof(waStacksThread),
+                    ORCHARD_STACKS_PRIORITY, stacks_thread, NULL);
+}
+
+/*
+ * Scans all the stacks now.  Entries are not purged here, that is left to
+ * the scanner thread at the end of its own pass.
+ */
+void orchardStacksScan(void) {
+  thread_t *tp;
+
+  tp = chRegFirstThread();
+  do {
+    stacks_scan_thread(tp);
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+
+  stacks_scan_exceptions();
+}
+
+void orchardStacksDump(BaseSequentialStream *chp) {
+  struct orchard_stack *sp;
+  size_t size;
+  int i;
+
+  chprintf(chp, " name             size  used  free\r\n");
+  chMtxLock(&stacks_mtx);
+  for (i = 0; i < ORCHARD_STACKS_MAX; i++) {
+    sp = &stacks[i];
+    if (sp->id == NULL)
+      continue;
+    size = stacks_size(sp);
+    chprintf(chp, " %-14s %6u %5u %5u%s\r\n",
+             sp->name != NULL ? sp->name : "(noname)",
+             size, size - sp->unused, sp->unused,
+             sp->unused < ORCHARD_STACKS_WARN_BYTES ? " low" : "");
+  }
+  chMtxUnlock(&stacks_mtx);
+}
+
+#endif /* ORCHARD_USE_STACKS */
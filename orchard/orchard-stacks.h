@@ -0,0 +1,69 @@
+#ifndef __ORCHARD_STACKS_H__
+#define __ORCHARD_STACKS_H__
+
+/* Stack high-water-mark scanner.
+
+   Thread stacks are filled with CH_DBG_STACK_FILL_VALUE by the kernel when
+   CH_DBG_FILL_THREADS is enabled, the main and exception stacks are filled
+   with the same pattern by crt0.  The scanner counts the words still
+   holding the pattern at the far end of each stack, what is left is the
+   peak usage since the stack was filled.
+
+   A low priority thread walks the registry and scans one stack every
+   ORCHARD_STACKS_PERIOD milliseconds, the system lock is only taken by the
+   registry walk itself.  A stack is only rescanned up to the previous mark
+   because the paint can't come back, so the steady state cost is small.
+
+   When the unused part of a stack drops below ORCHARD_STACKS_WARN_BYTES
+   then ORCHARD_STACKS_WARN_HOOK(name, size, unused) is invoked, once per
+   stack, from the scanner thread.  The "stacks" shell command performs a
+   full scan and prints the table.
+ */
+
+#if !defined(ORCHARD_USE_STACKS)
+#define ORCHARD_USE_STACKS                  CH_DBG_FILL_THREADS
+#endif
+
+/* Delay between two stacks scans, in milliseconds.*/
+#if !defined(ORCHARD_STACKS_PERIOD)
+#define ORCHARD_STACKS_PERIOD               250
+#endif
+
+/* Warning threshold on the unused part of a stack, in bytes.*/
+#if !defined(ORCHARD_STACKS_WARN_BYTES)
+#define ORCHARD_STACKS_WARN_BYTES           32
+#endif
+
+/* Maximum number of tracked stacks, the main and exception stacks
+   included.*/
+#if !defined(ORCHARD_STACKS_MAX)
+#define ORCHARD_STACKS_MAX                  10
+#endif
+
+#if !defined(ORCHARD_STACKS_PRIORITY)
+#define ORCHARD_STACKS_PRIORITY             (LOWPRIO + 1)
+#endif
+
+#if ORCHARD_USE_STACKS
+
+#if !CH_DBG_FILL_THREADS
+#error "ORCHARD_USE_STACKS requires CH_DBG_FILL_THREADS"
+#endif
+
+struct orchard_stack {
+  const void *id;                       /* Thread, NULL if free.        */
+  const char *name;
+  const uint32_t *base;                 /* Lowest address.              */
+  const uint32_t *top;                  /* Highest address +1.          */
+  uint16_t unused;                      /* Bytes never touched.         */
+  uint8_t pass;                         /* Last pass seeing this stack. */
+  uint8_t warned;
+};
+
+void orchardStacksInit(void);
+void orchardStacksScan(void);
+void orchardStacksDump(BaseSequentialStream *chp);
+
+#endif /* ORCHARD_USE_STACKS */
+
+#endif /* __ORCHARD_STACKS_H__ */
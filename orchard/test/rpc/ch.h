@@ -0,0 +1,52 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/* Minimal kernel header for the host build of the RPC server, only the
+   types used by the streams, channels and shell headers.*/
+
+#ifndef _CH_H_
+#define _CH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FALSE                   0
+#define TRUE                    1
+
+#define CH_CFG_USE_HEAP         FALSE
+#define CH_CFG_USE_DYNAMIC      FALSE
+
+typedef int32_t msg_t;
+typedef uint32_t systime_t;
+typedef uint32_t eventflags_t;
+typedef int tprio_t;
+typedef struct { int dummy; } event_source_t;
+typedef struct thread thread_t;
+
+#define MSG_OK                  (msg_t)0
+#define MSG_TIMEOUT             (msg_t)-1
+#define MSG_RESET               (msg_t)-2
+
+/* One millisecond ticks.*/
+#define TIME_IMMEDIATE          ((systime_t)0)
+#define TIME_INFINITE           ((systime_t)-1)
+#define MS2ST(msec)             ((systime_t)(msec))
+
+#include "hal_streams.h"
+#include "hal_channels.h"
+
+#endif /* _CH_H_ */
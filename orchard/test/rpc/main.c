@@ -0,0 +1,146 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/* Host build of the RPC server.
+
+   orchard-rpc.c serves a channel on stdin and stdout, the commands are the
+   ones the loopback device of tools/rpc-test.py implements so that the
+   same tests run against both.  The program returns when the server does,
+   on RPC_OP_EXIT, on the idle timeout or when the host closes the channel.
+ */
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ch.h"
+#include "shell.h"
+
+#include "orchard-shell.h"
+#include "orchard-rpc.h"
+
+static size_t fd_write(void *ip, const uint8_t *bp, size_t n) {
+  size_t done = 0;
+  ssize_t r;
+
+  (void)ip;
+  while (done < n) {
+    r = write(STDOUT_FILENO, bp + done, n - done);
+    if (r <= 0)
+      break;
+    done += (size_t)r;
+  }
+  return done;
+}
+
+static size_t fd_readt(void *ip, uint8_t *bp, size_t n, systime_t time) {
+  struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+  size_t done = 0;
+  ssize_t r;
+
+  (void)ip;
+  while (done < n) {
+    if (poll(&pfd, 1, time == TIME_INFINITE ? -1 : (int)time) <= 0)
+      break;
+    r = read(STDIN_FILENO, bp + done, n - done);
+    if (r <= 0)
+      break;
+    done += (size_t)r;
+  }
+  return done;
+}
+
+static size_t fd_read(void *ip, uint8_t *bp, size_t n) {
+
+  return fd_readt(ip, bp, n, TIME_INFINITE);
+}
+
+static msg_t fd_putt(void *ip, uint8_t b, systime_t time) {
+
+  (void)time;
+  return fd_write(ip, &b, 1) == 1 ? MSG_OK : MSG_RESET;
+}
+
+static msg_t fd_put(void *ip, uint8_t b) {
+
+  return fd_putt(ip, b, TIME_INFINITE);
+}
+
+static msg_t fd_gett(void *ip, systime_t time) {
+  struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+  uint8_t b;
+
+  (void)ip;
+  if (poll(&pfd, 1, time == TIME_INFINITE ? -1 : (int)time) == 0)
+    return MSG_TIMEOUT;
+  if (read(STDIN_FILENO, &b, 1) != 1)
+    return MSG_RESET;
+  return b;
+}
+
+static msg_t fd_get(void *ip) {
+
+  return fd_gett(ip, TIME_INFINITE);
+}
+
+static size_t fd_writet(void *ip, const uint8_t *bp, size_t n,
+                        systime_t time) {
+
+  (void)time;
+  return fd_write(ip, bp, n);
+}
+
+static const struct BaseChannelVMT fd_vmt = {
+  fd_write, fd_read, fd_put, fd_get, NULL,
+  fd_putt, fd_gett, fd_writet, fd_readt
+};
+
+static BaseChannel console = {&fd_vmt};
+
+static void cmd_echo(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  int i;
+
+  for (i = 0; i < argc; i++) {
+    if (i > 0)
+      streamWrite(chp, (const uint8_t *)" ", 1);
+    streamWrite(chp, (const uint8_t *)argv[i], strlen(argv[i]));
+  }
+  streamWrite(chp, (const uint8_t *)"\r\n", 2);
+}
+
+static void cmd_dump(BaseSequentialStream *chp, int argc, char *argv[])
+{
+  int i, n;
+
+  n = argc > 0 ? atoi(argv[0]) : 0;
+  for (i = 0; i < n; i++)
+    streamPut(chp, (uint8_t)i);
+}
+
+const ShellCommand rpc_commands[] = {
+  {"echo", cmd_echo},
+  {"dump", cmd_dump},
+  {NULL, NULL}
+};
+
+int main(void)
+{
+
+  orchardRpcServe(&console);
+  return 0;
+}
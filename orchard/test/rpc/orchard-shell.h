@@ -0,0 +1,26 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef __ORCHARD_SHELL_H__
+#define __ORCHARD_SHELL_H__
+
+/* The command table is a plain array in the host build, the firmware
+   collects it from linker sections.*/
+extern const ShellCommand rpc_commands[];
+
+#define orchard_command_start() rpc_commands
+
+#endif /* __ORCHARD_SHELL_H__ */
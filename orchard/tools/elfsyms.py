@@ -0,0 +1,40 @@
+#
+# Function symbols lookup shared by the host tools, symbols are read with
+# $NM (default arm-none-eabi-nm).
+
+import bisect
+import os
+import subprocess
+
+
+def load_symbols(elf):
+    nm = os.environ.get("NM", "arm-none-eabi-nm")
+    out = subprocess.check_output([nm, "-n", "-S", "--defined-only", elf],
+                                  universal_newlines=True)
+    addrs = []
+    syms = []
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4:
+            addr, size, kind, name = fields
+            size = int(size, 16)
+        elif len(fields) == 3:
+            addr, kind, name = fields
+            size = 0
+        else:
+            continue
+        if kind not in "tTwW":
+            continue
+        addrs.append(int(addr, 16) & ~1)
+        syms.append((name, size))
+    return addrs, syms
+
+
+def resolve(addrs, syms, pc):
+    i = bisect.bisect_right(addrs, pc) - 1
+    if i < 0:
+        return "??"
+    name, size = syms[i]
+    if size and pc >= addrs[i] + size:
+        return "?? (after %s)" % name
+    return name
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Rebuilds call trees from an "ftrace dump" capture.
+#
+#   ./tools/ftrace-decode.py capture.txt [build/orchard.elf]
+#
+# Prints a flat profile with inclusive and exclusive times followed by the
+# call tree of each thread, handler mode code is shown as the "irq" context.
+# Times are wall-clock, a function that gets preempted is also charged for
+# the time spent by the other threads.  Records whose entry was overwritten
+# in the ring are ignored.
+
+import sys
+
+from elfsyms import load_symbols, resolve
+
+EXIT = 1
+WRAP = 1 << 32
+
+
+class Node(object):
+    def __init__(self, name):
+        self.name = name
+        self.calls = 0
+        self.incl = 0
+        self.excl = 0
+        self.max = 0
+        self.children = {}
+
+    def child(self, name):
+        if name not in self.children:
+            self.children[name] = Node(name)
+        return self.children[name]
+
+    def account(self, incl, excl):
+        self.calls += 1
+        self.incl += incl
+        self.excl += excl
+        self.max = max(self.max, incl)
+
+
+def parse_dump(path):
+    header = {}
+    records = []
+    with open(path) as f:
+        for line in f:
+            fields = line.strip().split()
+            if not fields:
+                continue
+            if fields[0] == "ftrace" and len(fields) >= 7:
+                header = dict(zip(fields[1::2], (int(x) for x in fields[2::2])))
+            elif fields[0] == "ft" and len(fields) == 4:
+                records.append(tuple(int(x, 16) for x in fields[1:]))
+    return header, records
+
+
+def decode(records, name_of):
+    roots = {}
+    stacks = {}
+    flat = {}
+    orphans = 0
+
+    for ts, fn, thd in records:
+        ctx = "irq" if thd == 0 else "%08x" % thd
+        if ctx not in roots:
+            roots[ctx] = Node(ctx)
+            stacks[ctx] = []
+        stack = stacks[ctx]
+        name = name_of(fn & ~EXIT)
+
+        if not fn & EXIT:
+            parent = stack[-1][3] if stack else roots[ctx]
+            stack.append([name, ts, 0, parent.child(name)])
+            continue
+
+        if not any(frame[0] == name for frame in stack):
+            orphans += 1
+            continue
+        # Unwind frames whose exit record is missing (longjmp, lost data).
+        while stack[-1][0] != name:
+            stack.pop()
+        name, start, children, node = stack.pop()
+        incl = (ts - start) % WRAP
+        excl = max(incl - children, 0)
+        node.account(incl, excl)
+        if name not in flat:
+            flat[name] = Node(name)
+        flat[name].account(incl, excl)
+        if stack:
+            stack[-1][2] += incl
+
+    return roots, flat, orphans
+
+
+def print_tree(node, us, depth=0):
+    for child in sorted(node.children.values(), key=lambda n: -n.incl):
+        if child.calls:
+            print("%10.1f %10.1f %6d  %s%s" % (child.incl * us, child.excl * us,
+                                               child.calls, "  " * depth,
+                                               child.name))
+        else:
+            print("%10s %10s %6s  %s%s (open)" % ("-", "-", "-", "  " * depth,
+                                                  child.name))
+        print_tree(child, us, depth + 1)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: ftrace-decode.py capture.txt [orchard.elf]\n")
+        return 1
+    elf = sys.argv[2] if len(sys.argv) > 2 else "build/orchard.elf"
+
+    header, records = parse_dump(sys.argv[1])
+    if not header:
+        sys.stderr.write("no 'ftrace' header found in %s\n" % sys.argv[1])
+        return 1
+    addrs, syms = load_symbols(elf)
+    us = 1e6 / header["hz"]
+
+    roots, flat, orphans = decode(records,
+                                  lambda pc: resolve(addrs, syms, pc))
+
+    print("records: %d  lost: %d  unmatched exits: %d" %
+          (header.get("records", 0), header.get("lost", 0), orphans))
+    print()
+    print("   incl us    excl us  calls     max us  function")
+    for node in sorted(flat.values(), key=lambda n: -n.excl):
+        print("%10.1f %10.1f %6d %10.1f  %s" % (node.incl * us, node.excl * us,
+                                               node.calls, node.max * us,
+                                               node.name))
+
+    for ctx in sorted(roots):
+        print()
+        print("context %s" % ctx)
+        print("   incl us    excl us  calls  call tree")
+        print_tree(roots[ctx], us)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
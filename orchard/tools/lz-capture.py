@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+#
+# Captures the compressed output of a shell command.
+#
+#   ./tools/lz-capture.py /dev/ttyUSB0 "ftrace dump" > capture.txt
+#
+# The command is run through the "lz" shell command and the output is
+# decompressed as it arrives, the result can be fed to ftrace-decode.py or
+# prof-resolve.py as a text dump would.
+
+import os
+import select
+import sys
+import termios
+import time
+import tty
+
+from lzdecode import LzDecoder, LzError
+
+MARKER = b"<lz>\r\n"
+TIMEOUT = 5.0
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write("usage: %s tty command\n" % sys.argv[0])
+        return 1
+
+    fd = os.open(sys.argv[1], os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attr = termios.tcgetattr(fd)
+    attr[4] = attr[5] = termios.B115200
+    termios.tcsetattr(fd, termios.TCSANOW, attr)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    os.write(fd, ("lz %s\r" % sys.argv[2]).encode())
+
+    start = time.time()
+    head = b""
+    received = 0
+    decoder = None
+    while decoder is None or not decoder.done:
+        if not select.select([fd], [], [], TIMEOUT)[0]:
+            sys.stderr.write("timeout\n")
+            return 1
+        data = os.read(fd, 4096)
+        if decoder is None:
+            head += data
+            if MARKER not in head:
+                if b"\r\nlz: " in head:
+                    sys.stderr.write(head.decode("latin-1"))
+                    return 1
+                continue
+            data = head[head.index(MARKER) + len(MARKER):]
+            decoder = LzDecoder()
+        received += len(data)
+        try:
+            sys.stdout.buffer.write(decoder.feed(data))
+        except LzError as e:
+            sys.stderr.write("%s\n" % e)
+            return 1
+
+    received -= len(decoder.tail)
+    sys.stderr.write("%d bytes received for %d, %.1f s\n" %
+                     (received, decoder.pos, time.time() - start))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+#
+# Decompressor for the LzStream encoded data, see lzstreams.c for the
+# format.
+#
+#   ./tools/lzdecode.py capture.lz > capture.txt
+#
+# LzDecoder can be fed incrementally, it stops at the end of stream marker
+# and keeps what follows it in the tail attribute.
+
+import sys
+
+MIN_MATCH = 2
+
+
+class LzError(Exception):
+    pass
+
+
+class LzDecoder(object):
+    def __init__(self):
+        self.wbits = None
+        self.lbits = None
+        self.window = None
+        self.pos = 0
+        self.bits = 0
+        self.nbits = 0
+        self.done = False
+        self.tail = b""
+
+    def _token(self, out):
+        """Decodes a token if the bits are there, returns False if not."""
+        if self.nbits < 1:
+            return False
+        if self.bits >> (self.nbits - 1) & 1:
+            if self.nbits < 9:
+                return False
+            self.nbits -= 9
+            self._emit(out, self.bits >> self.nbits & 0xFF)
+            return True
+        need = 1 + self.wbits + self.lbits
+        if self.nbits < need:
+            return False
+        self.nbits -= need
+        token = self.bits >> self.nbits
+        dist = token >> self.lbits & ((1 << self.wbits) - 1)
+        length = (token & ((1 << self.lbits) - 1)) + MIN_MATCH
+        if dist == (1 << self.wbits) - 1:
+            self.done = True
+            self.nbits -= self.nbits % 8
+            return True
+        for _ in range(length):
+            self._emit(out, self.window[(self.pos - dist - 1) & self.mask])
+        return True
+
+    def _emit(self, out, b):
+        self.window[self.pos & self.mask] = b
+        self.pos += 1
+        out.append(b)
+
+    def feed(self, data):
+        """Returns the bytes decoded from data."""
+        out = bytearray()
+        data = bytearray(data)
+        if self.done:
+            self.tail += bytes(data)
+            return bytes(out)
+        for i, b in enumerate(data):
+            if self.wbits is None:
+                self.wbits, self.lbits = b >> 4, b & 15
+                if not 5 <= self.wbits <= 8 or not 2 <= self.lbits <= 4:
+                    raise LzError("bad header 0x%02x" % b)
+                self.mask = (1 << self.wbits) - 1
+                self.window = bytearray(1 << self.wbits)
+                continue
+            self.bits = (self.bits << 8 | b) & ((1 << 32) - 1)
+            self.nbits += 8
+            while not self.done and self._token(out):
+                pass
+            if self.done:
+                if self.nbits:
+                    raise LzError("data after the end of stream marker")
+                self.tail = bytes(data[i + 1:])
+                break
+        return bytes(out)
+
+
+def decode(data):
+    d = LzDecoder()
+    out = d.feed(data)
+    if not d.done:
+        raise LzError("truncated stream")
+    return out
+
+
+def main():
+    if len(sys.argv) > 2:
+        sys.stderr.write("usage: %s [capture.lz]\n" % sys.argv[0])
+        return 1
+    f = open(sys.argv[1], "rb") if len(sys.argv) == 2 else sys.stdin.buffer
+    try:
+        out = decode(f.read())
+    except LzError as e:
+        sys.stderr.write("%s\n" % e)
+        return 1
+    sys.stdout.buffer.write(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
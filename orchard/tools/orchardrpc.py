@@ -0,0 +1,363 @@
+#
+# Host side of the binary RPC channel, see orchard-rpc.h for the frames.
+#
+# RpcClient talks to the device over a serial port or any file descriptor.
+# Requests are pipelined, the encoded bytes of the requests not answered
+# yet are limited to a window that must fit the device serial input queue.
+# LoopbackDevice is a stand-in for the firmware, it serves Python functions
+# on the other end of a socket pair and models the input queue, what
+# overflows it is dropped as the UART driver would.
+
+import collections
+import os
+import select
+import socket
+import termios
+import threading
+import time
+import tty
+
+OP_PING = 0x00
+OP_LIST = 0x01
+OP_CALL = 0x02
+OP_EXIT = 0x03
+
+OK = 0x00
+MORE = 0x01
+ERR_CRC = 0x10
+ERR_OP = 0x11
+ERR_CMD = 0x12
+ERR_ARGS = 0x13
+ERR_SIZE = 0x14
+
+STATUS_NAMES = {
+    OK: "ok", MORE: "more", ERR_CRC: "bad CRC", ERR_OP: "bad op",
+    ERR_CMD: "no such command", ERR_ARGS: "bad arguments",
+    ERR_SIZE: "frame too long",
+}
+
+# Firmware defaults, ORCHARD_RPC_FRAME_SIZE, SERIAL_BUFFERS_SIZE and
+# SHELL_MAX_ARGUMENTS.
+FRAME_SIZE = 64
+QUEUE_SIZE = 64
+MAX_ARGS = 4
+
+
+def crc16(data, crc=0xFFFF):
+    for b in bytearray(data):
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    cp = 0
+    for b in bytearray(data):
+        if b:
+            out.append(b)
+        if not b or len(out) - cp == 0xFF:
+            out[cp] = len(out) - cp
+            cp = len(out)
+            out.append(0)
+    out[cp] = len(out) - cp
+    out.append(0)
+    return bytes(out)
+
+
+class CobsDecoder(object):
+    """Splits a byte stream on zeros, yields the decoded frames, None for
+    the malformed ones."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.left = 0
+        self.code = 0xFF
+
+    def feed(self, data):
+        frames = []
+        for b in bytearray(data):
+            if b == 0:
+                if self.buf:
+                    frames.append(None if self.left else bytes(self.buf))
+                self.buf = bytearray()
+                self.left = 0
+                self.code = 0xFF
+            elif self.left:
+                self.buf.append(b)
+                self.left -= 1
+            else:
+                if self.code != 0xFF:
+                    self.buf.append(0)
+                self.code = b
+                self.left = b - 1
+        return frames
+
+
+def pack(id, op, data=b""):
+    raw = bytearray([id, op]) + bytearray(data)
+    crc = crc16(raw)
+    raw += bytearray([crc & 0xFF, crc >> 8])
+    return cobs_encode(raw)
+
+
+def unpack(raw):
+    """Returns id, op or status and data, None if the frame is damaged."""
+    if raw is None or len(raw) < 4:
+        return None
+    if crc16(raw[:-2]) != raw[-2] | raw[-1] << 8:
+        return None
+    return raw[0], raw[1], raw[2:-2]
+
+
+def call_data(index, args):
+    data = bytearray([index])
+    for a in args:
+        data += a.encode() + b"\0"
+    return bytes(data)
+
+
+class RpcError(Exception):
+    def __init__(self, status, what=""):
+        self.status = status
+        Exception.__init__(self, "%s%s" % (
+            what + ": " if what else "",
+            STATUS_NAMES.get(status, "status 0x%02x" % status)
+            if status is not None else "timeout"))
+
+
+class RpcClient(object):
+    def __init__(self, fd, window=QUEUE_SIZE, frame_size=FRAME_SIZE,
+                 timeout=2.0):
+        self.fd = fd
+        self.window = window
+        self.frame_size = frame_size
+        self.timeout = timeout
+        self.decoder = CobsDecoder()
+        self.pending = {}
+        self.done = {}
+        self.in_flight = 0
+        self.max_pending = 0
+        self.next_id = 0
+        self.table = None
+
+    @classmethod
+    def open_serial(cls, path, baud=115200, **kw):
+        """Opens the console and switches the shell into RPC mode."""
+        fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(fd)
+        attr = termios.tcgetattr(fd)
+        speed = getattr(termios, "B%d" % baud)
+        attr[4] = attr[5] = speed
+        termios.tcsetattr(fd, termios.TCSANOW, attr)
+        termios.tcflush(fd, termios.TCIOFLUSH)
+        os.write(fd, b"\r\nrpc\r\n")
+        client = cls(fd, **kw)
+        client.sync()
+        return client
+
+    def sync(self):
+        """Waits for the zero sent on entry, skipping the shell echo, then
+        flushes the device decoder."""
+        deadline = time.time() + self.timeout
+        while True:
+            left = deadline - time.time()
+            if left <= 0 or not select.select([self.fd], [], [], left)[0]:
+                raise RpcError(None, "no sync")
+            data = os.read(self.fd, 256)
+            if not data:
+                raise RpcError(None, "closed")
+            if b"\0" in data:
+                break
+        self.decoder.feed(data[data.index(b"\0"):])
+        os.write(self.fd, b"\0")
+
+    def _pump(self, timeout):
+        if not select.select([self.fd], [], [], timeout)[0]:
+            return False
+        data = os.read(self.fd, 4096)
+        if not data:
+            raise RpcError(None, "closed")
+        for raw in self.decoder.feed(data):
+            frame = unpack(raw)
+            if frame is None or frame[0] not in self.pending:
+                continue
+            id, status, payload = frame
+            p = self.pending[id]
+            p[1] += payload
+            if status != MORE:
+                del self.pending[id]
+                self.in_flight -= p[0]
+                self.done[id] = (status, bytes(p[1]))
+        return True
+
+    def _wait(self, cond):
+        while not cond():
+            if not self._pump(self.timeout):
+                raise RpcError(None, "%d requests pending" % len(self.pending))
+
+    def submit(self, op, data=b""):
+        """Sends a request without waiting for the answer, returns its id."""
+        if len(data) + 4 > self.frame_size:
+            raise RpcError(ERR_SIZE)
+        frame = pack(0, op, data)
+        self._wait(lambda: len(self.pending) < 255 and
+                   self.in_flight + len(frame) <= max(self.window, len(frame))
+                   or not self.pending)
+        while self.next_id in self.pending or self.next_id in self.done:
+            self.next_id = (self.next_id + 1) & 0xFF
+        id = self.next_id
+        self.next_id = (id + 1) & 0xFF
+        frame = pack(id, op, data)
+        self.pending[id] = [len(frame), bytearray()]
+        self.in_flight += len(frame)
+        self.max_pending = max(self.max_pending, len(self.pending))
+        os.write(self.fd, frame)
+        return id
+
+    def result(self, id):
+        """Waits for the answer to a request, returns its data."""
+        self._wait(lambda: id in self.done)
+        status, data = self.done.pop(id)
+        if status != OK:
+            raise RpcError(status)
+        return data
+
+    def ping(self, data=b""):
+        return self.result(self.submit(OP_PING, data))
+
+    def commands(self):
+        if self.table is None:
+            names = self.result(self.submit(OP_LIST))
+            self.table = [n.decode() for n in names.split(b"\0")[:-1]]
+        return self.table
+
+    def submit_call(self, name, *args):
+        try:
+            index = self.commands().index(name)
+        except ValueError:
+            raise RpcError(ERR_CMD, name)
+        return self.submit(OP_CALL, call_data(index, args))
+
+    def call(self, name, *args):
+        return self.result(self.submit_call(name, *args))
+
+    def call_many(self, calls):
+        """Runs (name, args...) tuples pipelined, returns the outputs."""
+        ids = [self.submit_call(*c) for c in calls]
+        return [self.result(id) for id in ids]
+
+    def exit(self):
+        self.result(self.submit(OP_EXIT))
+
+
+class LoopbackDevice(object):
+    """Firmware stand-in, commands is a list of (name, function) where the
+    function takes the arguments list and returns the output."""
+
+    def __init__(self, commands, queue_size=QUEUE_SIZE,
+                 frame_size=FRAME_SIZE, delay=0.0):
+        self.commands = commands
+        self.queue_size = queue_size
+        self.frame_size = frame_size
+        self.delay = delay
+        self.queue = collections.deque()
+        self.dropped = 0
+        self.served = 0
+        self.sock, peer = socket.socketpair()
+        self.fd = peer.detach()
+        self.thread = threading.Thread(target=self._run)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def close(self):
+        try:
+            self.sock.shutdown(socket.SHUT_RDWR)
+        except OSError:
+            pass
+        self.thread.join()
+        self.sock.close()
+        os.close(self.fd)
+
+    def _receive(self, block):
+        """Moves what the host sent into the modelled input queue, a device
+        waiting for input keeps up with the line so only the bytes that
+        arrive while it is busy can overflow the queue."""
+        self.sock.setblocking(block)
+        try:
+            data = self.sock.recv(4096)
+        except (BlockingIOError, OSError):
+            return True
+        if not data:
+            return False
+        for b in bytearray(data):
+            if block or len(self.queue) < self.queue_size:
+                self.queue.append(b)
+            else:
+                self.dropped += 1
+        return True
+
+    def _send(self, id, status, data=b""):
+        raw = bytearray([id, status]) + bytearray(data)
+        crc = crc16(raw)
+        raw += bytearray([crc & 0xFF, crc >> 8])
+        self.sock.sendall(cobs_encode(raw))
+
+    def _output(self, id, data):
+        size = self.frame_size - 4
+        while len(data) >= size:
+            self._send(id, MORE, data[:size])
+            data = data[size:]
+        self._send(id, OK, data)
+
+    def _dispatch(self, raw):
+        self.served += 1
+        if len(raw) > self.frame_size:
+            return self._send(raw[0], ERR_SIZE)
+        frame = unpack(raw)
+        if frame is None:
+            return self._send(raw[0], ERR_CRC)
+        id, op, data = frame
+        if op == OP_PING:
+            return self._output(id, data)
+        if op == OP_LIST:
+            return self._output(id, b"".join(n.encode() + b"\0"
+                                             for n, _ in self.commands))
+        if op == OP_EXIT:
+            self._send(id, OK)
+            return True
+        if op != OP_CALL:
+            return self._send(id, ERR_OP)
+        if not data:
+            return self._send(id, ERR_ARGS)
+        if data[0] >= len(self.commands):
+            return self._send(id, ERR_CMD)
+        args = [a.decode() for a in data[1:].split(b"\0")]
+        if data[-1:] == b"\0":
+            args.pop()
+        if len(data) == 1:
+            args = []
+        if len(args) > MAX_ARGS:
+            return self._send(id, ERR_ARGS)
+        if self.delay:
+            time.sleep(self.delay)
+        out = self.commands[data[0]][1](args)
+        self._output(id, out.encode() if isinstance(out, str) else out)
+
+    def _run(self):
+        decoder = CobsDecoder()
+        try:
+            self.sock.sendall(b"\0")
+            while True:
+                if not self._receive(not self.queue):
+                    return
+                if not self.queue:
+                    continue
+                for raw in decoder.feed([self.queue.popleft()]):
+                    if raw is None:
+                        self._send(0, ERR_CRC)
+                    elif self._dispatch(raw):
+                        return
+        except OSError:
+            pass
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+#
+# Resolves a "prof dump" capture against the firmware ELF and prints a flat
+# profile.
+#
+#   ./tools/prof-resolve.py capture.txt [build/orchard.elf]
+#
+# The capture is the console output of "prof dump", any other line in the
+# file is ignored.  Symbols are read with $NM (default arm-none-eabi-nm).
+
+import sys
+
+from elfsyms import load_symbols, resolve
+
+
+def parse_dump(path):
+    header = {}
+    threads = []
+    pcs = []
+    with open(path) as f:
+        for line in f:
+            fields = line.strip().split()
+            if not fields:
+                continue
+            if fields[0] == "prof" and len(fields) >= 9:
+                header = dict(zip(fields[1::2], (int(x) for x in fields[2::2])))
+            elif fields[0] == "thd" and len(fields) >= 4:
+                threads.append((" ".join(fields[3:]), int(fields[1], 16),
+                                int(fields[2])))
+            elif fields[0] == "pc" and len(fields) == 3:
+                pcs.append((int(fields[1], 16), int(fields[2])))
+    return header, threads, pcs
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: prof-resolve.py capture.txt [orchard.elf]\n")
+        return 1
+    elf = sys.argv[2] if len(sys.argv) > 2 else "build/orchard.elf"
+
+    header, threads, pcs = parse_dump(sys.argv[1])
+    if not header:
+        sys.stderr.write("no 'prof' header found in %s\n" % sys.argv[1])
+        return 1
+    addrs, syms = load_symbols(elf)
+
+    total = header.get("samples", 0)
+    print("samples: %d  irq: %d  dropped: %d" %
+          (total, header.get("irq", 0), header.get("dropped", 0)))
+    if total == 0:
+        return 0
+
+    funcs = {}
+    for pc, hits in pcs:
+        name = resolve(addrs, syms, pc)
+        funcs[name] = funcs.get(name, 0) + hits
+    if header.get("irq", 0):
+        funcs["(interrupt handlers)"] = header["irq"]
+
+    print()
+    print("  %time  samples  function")
+    for name, hits in sorted(funcs.items(), key=lambda x: -x[1]):
+        print("%7.2f %8d  %s" % (100.0 * hits / total, hits, name))
+
+    print()
+    print("  %time  samples  thread")
+    for name, addr, hits in sorted(threads, key=lambda x: -x[2]):
+        print("%7.2f %8d  %s (%08x)" % (100.0 * hits / total, hits, name, addr))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
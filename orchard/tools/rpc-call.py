@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+#
+# Runs shell commands over the binary RPC channel.
+#
+#   ./tools/rpc-call.py /dev/ttyUSB0 "stacks" "locks reset" ...
+#   ./tools/rpc-call.py /dev/ttyUSB0
+#
+# The commands are sent pipelined and their outputs printed in order, with
+# no command the table of the device is listed.  The console is left in
+# the text shell on exit.
+
+import sys
+
+from orchardrpc import RpcClient, RpcError
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write("usage: %s tty [command ...]\n" % sys.argv[0])
+        return 1
+
+    client = RpcClient.open_serial(sys.argv[1])
+    try:
+        if len(sys.argv) == 2:
+            for i, name in enumerate(client.commands()):
+                print("%3d %s" % (i, name))
+        else:
+            calls = [tuple(c.split()) for c in sys.argv[2:]]
+            ids = [client.submit_call(*c) for c in calls]
+            for c, id in zip(calls, ids):
+                print("# %s" % " ".join(c))
+                try:
+                    sys.stdout.write(client.result(id).decode("latin-1"))
+                except RpcError as e:
+                    print("error, %s" % e)
+    finally:
+        client.exit()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+#
+# Checks the RPC host library against the loopback stand-in, or against
+# the firmware server built for the host, see test/rpc.
+#
+#   ./tools/rpc-test.py
+#   ./tools/rpc-test.py --device test/rpc/rpcserver
+#
+# Covers the framing, the errors reported by the device, outputs longer
+# than a frame and pipelined requests, these must not overflow the input
+# queue of a device that is slow at running its commands.  The overflow
+# checks need the modelled input queue and are only run on the stand-in.
+
+import os
+import random
+import socket
+import subprocess
+import sys
+
+import orchardrpc
+from orchardrpc import (CobsDecoder, LoopbackDevice, RpcClient, RpcError,
+                        cobs_encode, crc16, pack)
+
+failures = 0
+
+
+def check(cond, what):
+    global failures
+    if not cond:
+        print("FAILED: %s" % what)
+        failures += 1
+
+
+def cmd_echo(args):
+    return " ".join(args) + "\r\n"
+
+
+def cmd_dump(args):
+    return bytes(bytearray(i & 0xFF for i in range(int(args[0]))))
+
+
+COMMANDS = [("echo", cmd_echo), ("dump", cmd_dump)]
+
+# Server program to test instead of the stand-in.
+device = None
+
+
+class ProcessDevice(object):
+    """Server program with its console on stdin and stdout, it must have
+    the same commands as COMMANDS."""
+
+    def __init__(self, command):
+        host, peer = socket.socketpair()
+        self.proc = subprocess.Popen([command], stdin=peer, stdout=peer)
+        peer.close()
+        self.fd = host.detach()
+        self.dropped = 0
+
+    def close(self):
+        try:
+            status = self.proc.wait(timeout=2)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+            status = self.proc.wait()
+        check(status == 0, "server exit status %d" % status)
+        os.close(self.fd)
+
+
+def open_device(delay=0.0):
+    if device:
+        return ProcessDevice(device)
+    return LoopbackDevice(COMMANDS, delay=delay)
+
+
+def test_codec():
+    rnd = random.Random(1)
+    check(crc16(b"123456789") == 0x29B1, "CRC-16/CCITT-FALSE check value")
+    for n in list(range(0, 300)) + [508, 509, 600]:
+        data = bytes(bytearray(rnd.choice([0, 0, 1, 0x55, 0xFF])
+                               for _ in range(n)))
+        enc = cobs_encode(data)
+        check(enc.index(b"\0") == len(enc) - 1, "COBS zero free, %d bytes" % n)
+        check(len(enc) <= n + n // 254 + 2, "COBS overhead, %d bytes" % n)
+        frames = CobsDecoder().feed(b"\0" + enc)
+        check(frames == [data] if n else frames == [],
+              "COBS round trip, %d bytes" % n)
+    run = bytes(bytearray([0x41] * 254))
+    check(cobs_encode(run) == b"\xff" + run + b"\x01\0", "COBS full block")
+
+
+def test_requests():
+    dev = open_device()
+    client = RpcClient(dev.fd)
+    client.sync()
+
+    check(client.ping(b"\0abc\0") == b"\0abc\0", "ping")
+    check(client.commands() == ["echo", "dump"], "command table")
+    check(client.call("echo", "a", "b") == b"a b\r\n", "call")
+    check(client.call("echo") == b"\r\n", "call without arguments")
+
+    out = client.call("dump", "1000")
+    check(out == cmd_dump(["1000"]), "output over several frames")
+    out = client.call("dump", "60")
+    check(out == cmd_dump(["60"]), "output filling a frame")
+
+    for op, data, status, what in [
+            (0x7F, b"", orchardrpc.ERR_OP, "unknown op"),
+            (orchardrpc.OP_CALL, b"\x09", orchardrpc.ERR_CMD,
+             "unknown command"),
+            (orchardrpc.OP_CALL, b"", orchardrpc.ERR_ARGS, "no index"),
+            (orchardrpc.OP_CALL, b"\x00a\0b\0c\0d\0e\0", orchardrpc.ERR_ARGS,
+             "too many arguments")]:
+        try:
+            client.result(client.submit(op, data))
+            check(False, what)
+        except RpcError as e:
+            check(e.status == status, "%s, %s" % (what, e))
+
+    # A damaged frame gets an error with its id, the next one is served.
+    client.pending[0x42] = [0, bytearray()]
+    frame = bytearray(pack(0x42, orchardrpc.OP_PING, b"xyz"))
+    frame[3] ^= 0x10
+    os.write(client.fd, bytes(frame))
+    try:
+        client.result(0x42)
+        check(False, "damaged frame")
+    except RpcError as e:
+        check(e.status == orchardrpc.ERR_CRC, "damaged frame, %s" % e)
+    check(client.ping(b"ok") == b"ok", "ping after a damaged frame")
+
+    # Too long for the device buffer.
+    client.frame_size = 128
+    try:
+        client.ping(b"x" * 100)
+        check(False, "long frame")
+    except RpcError as e:
+        check(e.status == orchardrpc.ERR_SIZE, "long frame, %s" % e)
+
+    client.exit()
+    dev.close()
+
+
+def test_pipeline():
+    calls = [("echo", "n%d" % i) for i in range(200)]
+
+    dev = open_device(delay=0.001)
+    client = RpcClient(dev.fd)
+    client.sync()
+    outs = client.call_many(calls)
+    check(outs == [("n%d\r\n" % i).encode() for i in range(200)],
+          "pipelined outputs")
+    check(client.max_pending > 1, "requests kept in flight")
+    check(dev.dropped == 0, "input queue overflows, %d" % dev.dropped)
+    print("pipeline: %d requests, up to %d in flight" %
+          (len(calls), client.max_pending))
+    client.exit()
+    dev.close()
+    if device:
+        return
+
+    # The window is what keeps a busy device from dropping input.
+    dev = LoopbackDevice(COMMANDS, delay=0.01)
+    client = RpcClient(dev.fd, window=256, timeout=0.5)
+    client.sync()
+    try:
+        client.call_many(calls[:40])
+    except RpcError:
+        pass
+    check(dev.dropped > 0, "overflow without a window")
+    print("no window: %d bytes dropped" % dev.dropped)
+    dev.close()
+
+
+def main():
+    global device
+    if len(sys.argv) == 3 and sys.argv[1] == "--device":
+        device = sys.argv[2]
+    elif len(sys.argv) != 1:
+        sys.stderr.write("usage: %s [--device program]\n" % sys.argv[0])
+        return 1
+
+    test_codec()
+    test_requests()
+    test_pipeline()
+    if failures:
+        print("%d failures" % failures)
+        return 1
+    print("all tests passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
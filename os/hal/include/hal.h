@@ -129,22 +129,131 @@
 #define HAL_FAILED              true
 /** @} */
 
+/**
+ * @name    Drivers classes identifiers
+ * @{
+ */
+#define HAL_DRV_ADC             (1U << 0)
+#define HAL_DRV_CAN             (1U << 1)
+#define HAL_DRV_DAC             (1U << 2)
+#define HAL_DRV_EXT             (1U << 3)
+#define HAL_DRV_GPT             (1U << 4)
+#define HAL_DRV_I2C             (1U << 5)
+#define HAL_DRV_I2S             (1U << 6)
+#define HAL_DRV_ICU             (1U << 7)
+#define HAL_DRV_MAC             (1U << 8)
+#define HAL_DRV_PWM             (1U << 9)
+#define HAL_DRV_SERIAL          (1U << 10)
+#define HAL_DRV_SDC             (1U << 11)
+#define HAL_DRV_SPI             (1U << 12)
+#define HAL_DRV_UART            (1U << 13)
+#define HAL_DRV_USB             (1U << 14)
+#define HAL_DRV_WDG             (1U << 15)
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Drivers initialized on first use.
+ * @details Mask of @p HAL_DRV_XXX identifiers, the drivers classes in the
+ *          mask are not initialized by @p halInit() but by the first
+ *          invocation of their @p xxxStart() function. PAL, RTC and the
+ *          drivers without a low level initialization are always
+ *          initialized by @p halInit().
+ * @note    The driver class initialization also initializes the driver
+ *          objects, so the objects of a lazy class must not be used before
+ *          their first @p xxxStart(). For example the bus of an I2C or SPI
+ *          driver must not be acquired and listeners must not be registered
+ *          on the event source of a serial driver before the driver is
+ *          started, the start would reset the mutex or the listeners list.
+ */
+#if !defined(HAL_LAZY_DRIVERS) || defined(__DOXYGEN__)
+#define HAL_LAZY_DRIVERS            0U
+#endif
+
+/**
+ * @brief   Drivers initialization statistics.
+ * @details If enabled then the time spent initializing each driver class
+ *          is recorded, see @p halGetInitStats().
+ */
+#if !defined(HAL_USE_INIT_STATS) || defined(__DOXYGEN__)
+#define HAL_USE_INIT_STATS          FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (HAL_USE_INIT_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Maximum number of initialization statistics records.
+ */
+#define HAL_INIT_STATS_SIZE         24U
+
+/**
+ * @brief   Time stamp used by the initialization statistics.
+ * @note    The platform can provide its own time stamp, else the HAL
+ *          realtime counter is used if available. As last resort the
+ *          system time is used, the system tick is not running before
+ *          @p halInit() returns so the eager drivers would be accounted
+ *          as zero.
+ */
+#if defined(HAL_INIT_STATS_NOW) && !defined(__DOXYGEN__)
+/* Provided by the platform.*/
+#elif (HAL_IMPLEMENTS_COUNTERS == TRUE) || defined(__DOXYGEN__)
+#define HAL_INIT_STATS_NOW()        ((uint32_t)hal_lld_get_counter_value())
+#define HAL_INIT_STATS_FREQUENCY    ((uint32_t)hal_lld_get_counter_frequency())
+#else
+#define HAL_INIT_STATS_NOW()        ((uint32_t)osalOsGetSystemTimeX())
+#define HAL_INIT_STATS_FREQUENCY    ((uint32_t)OSAL_ST_FREQUENCY)
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a driver initialization record.
+ */
+typedef struct {
+  /**
+   * @brief Name of the initialization function.
+   */
+  const char            *name;
+  /**
+   * @brief Initialization time, see @p HAL_INIT_STATS_FREQUENCY.
+   */
+  uint32_t              time;
+  /**
+   * @brief Initialized on first use.
+   */
+  bool                  lazy;
+} hal_init_stats_t;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Initializes a driver class on first use.
+ * @details This macro is invoked by the drivers @p xxxStart() functions,
+ *          it expands to nothing if the driver class is not in the
+ *          @p HAL_LAZY_DRIVERS mask.
+ *
+ * @param[in] id        driver class identifier
+ * @param[in] initf     driver class initialization function
+ *
+ * @notapi
+ */
+#define halLazyInit(id, initf) do {                                         \
+  if (((HAL_LAZY_DRIVERS) & (id)) != 0U) {                                  \
+    _hal_lazy_init(id, initf, #initf);                                      \
+  }                                                                         \
+} while (false)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -153,6 +262,10 @@
 extern "C" {
 #endif
   void halInit(void);
+  void _hal_lazy_init(uint32_t id, void (*initf)(void), const char *name);
+#if HAL_USE_INIT_STATS == TRUE
+  const hal_init_stats_t *halGetInitStats(unsigned *np);
+#endif
 #ifdef __cplusplus
 }
 #endif
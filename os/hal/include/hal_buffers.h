@@ -29,8 +29,6 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
-#define HAL_BUFFERS_QUEUE_SIZE              2
-
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -44,72 +42,77 @@
 /*===========================================================================*/
 
 /**
- * @brief   Type of an I/O buffer.
- */
-typedef struct hal_buffer io_buffer_t;
-
-/**
- * @brief   Structure of a generic buffer.
- */
-struct hal_buffer {
-  /**
-   * @brief   Pointer to the buffer in memory.
-   */
-  uint8_t               *buffer;
-  /**
-   * @brief   Pointer to the first non-used location in the buffer.
-   */
-  uint8_t               *limit;
-  /**
-   * @brief   Pointer to the buffer boundary.
-   */
-  uint8_t               *top;
-};
-
-/**
- * @brief   Type of a generic double buffer.
+ * @brief   Type of a generic queue of buffers.
  */
-typedef struct io_double_buffer io_double_buffer_t;
+typedef struct io_buffers_queue io_buffers_queue_t;
 
 /**
- * @brief   Double buffer notification callback type.
+ * @brief   Buffers queue notification callback type.
  *
- * @param[in] iodbp     the double buffer pointer
+ * @param[in] bqp       the buffers queue pointer
  */
-typedef void (*dbnotify_t)(io_double_buffer_t *iodbp);
+typedef void (*bqnotify_t)(io_buffers_queue_t *bqp);
 
 /**
- * @brief   Structure of a generic double buffer.
+ * @brief   Structure of a generic buffers queue.
+ * @details The queue is a circular array of @p bn buffers, each one
+ *          preceded by a @p size_t header holding the amount of data
+ *          committed into it. Full buffers are handed between producer
+ *          and consumer as a whole, the buffer get, release and post
+ *          functions never copy the data. Only the read and write
+ *          functions and the byte get and put functions copy it.
  */
-struct io_double_buffer {
+struct io_buffers_queue {
   /**
    * @brief   Queue of waiting threads.
    */
   threads_queue_t       waiting;
   /**
    * @brief   Active buffers counter.
+   * @details Number of empty buffers for input queues, number of free
+   *          buffers for output queues.
    */
-  volatile size_t       counter;
+  volatile size_t       bcounter;
   /**
    * @brief   Buffer write pointer.
    */
-  io_buffer_t           *bwrptr;
+  uint8_t               *bwrptr;
   /**
    * @brief   Buffer read pointer.
    */
-  io_buffer_t           *brdptr;
+  uint8_t               *brdptr;
+  /**
+   * @brief   Pointer to the buffers boundary.
+   */
+  uint8_t               *btop;
+  /**
+   * @brief   Size of buffers.
+   * @note    The buffer size must be not lower than <tt>sizeof(size_t) + 2</tt>
+   *          because the first bytes are used to store the used size of the
+   *          buffer.
+   */
+  size_t                bsize;
+  /**
+   * @brief   Number of buffers.
+   */
+  size_t                bn;
+  /**
+   * @brief   Queue of buffer objects.
+   */
+  uint8_t               *buffers;
   /**
    * @brief   Pointer for R/W sequential access.
+   * @note    It is @p NULL if a new buffer must be fetched from the queue.
    */
   uint8_t               *ptr;
   /**
-   * @brief   Queue of buffer objects.
+   * @brief   Boundary for R/W sequential access.
    */
-  io_buffer_t           buffers[HAL_BUFFERS_QUEUE_SIZE];
+  uint8_t               *top;
   /**
    * @brief   Data notification callback.
    */
-  dbnotify_t            notify;
+  bqnotify_t            notify;
   /**
    * @brief   Application defined field.
    */
@@ -117,19 +120,114 @@ struct io_double_buffer {
 };
 
 /**
- * @brief   Type of an input double buffer.
+ * @brief   Type of an input buffers queue.
  */
-typedef io_double_buffer_t input_double_buffer_t;
+typedef io_buffers_queue_t input_buffers_queue_t;
 
 /**
- * @brief   Type of an output double buffer.
+ * @brief   Type of an output buffers queue.
  */
-typedef io_double_buffer_t output_double_buffer_t;
+typedef io_buffers_queue_t output_buffers_queue_t;
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Computes the size of a buffers queue buffer size.
+ *
+ * @param[in] n         number of buffers in the queue
+ * @param[in] size      size of the buffers
+ */
+#define BQ_BUFFER_SIZE(n, size)                                             \
+  (((size_t)(size) + sizeof (size_t)) * (size_t)(n))
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the queue's number of buffers.
+ *
+ * @param[in] bqp       pointer to an @p io_buffers_queue_t structure
+ * @return              The number of buffers.
+ *
+ * @xclass
+ */
+#define bqSizeX(bqp) ((bqp)->bn)
+
+/**
+ * @brief   Return the empty buffers number.
+ * @details Returns the number of empty buffers, on an input queue these
+ *          are available to the producer, on an output queue to the
+ *          writer.
+ *
+ * @param[in] bqp       pointer to an @p io_buffers_queue_t structure
+ * @return              The number of empty buffers.
+ *
+ * @iclass
+ */
+#define bqSpaceI(bqp) ((bqp)->bcounter)
+
+/**
+ * @brief   Returns the queue application-defined link.
+ *
+ * @param[in] bqp       pointer to an @p io_buffers_queue_t structure
+ * @return              The application-defined link.
+ *
+ * @special
+ */
+#define bqGetLinkX(bqp) ((bqp)->link)
+
+/**
+ * @brief   Evaluates to @p TRUE if the specified input buffers queue is empty.
+ *
+ * @param[in] ibqp      pointer to an @p input_buffers_queue_t structure
+ * @return              The queue status.
+ * @retval false        if the queue is not empty.
+ * @retval true         if the queue is empty.
+ *
+ * @iclass
+ */
+#define ibqIsEmptyI(ibqp) ((bool)(bqSpaceI(ibqp) == bqSizeX(ibqp)))
+
+/**
+ * @brief   Evaluates to @p TRUE if the specified input buffers queue is full.
+ *
+ * @param[in] ibqp      pointer to an @p input_buffers_queue_t structure
+ * @return              The queue status.
+ * @retval false        if the queue is not full.
+ * @retval true         if the queue is full.
+ *
+ * @iclass
+ */
+#define ibqIsFullI(ibqp) ((bool)(bqSpaceI(ibqp) == 0U))
+
+/**
+ * @brief   Evaluates to @p true if the specified output buffers queue is empty.
+ *
+ * @param[in] obqp      pointer to an @p output_buffers_queue_t structure
+ * @return              The queue status.
+ * @retval false        if the queue is not empty.
+ * @retval true         if the queue is empty.
+ *
+ * @iclass
+ */
+#define obqIsEmptyI(obqp) ((bool)(bqSpaceI(obqp) == bqSizeX(obqp)))
+
+/**
+ * @brief   Evaluates to @p true if the specified output buffers queue is full.
+ *
+ * @param[in] obqp      pointer to an @p output_buffers_queue_t structure
+ * @return              The queue status.
+ * @retval false        if the queue is not full.
+ * @retval true         if the queue is full.
+ *
+ * @iclass
+ */
+#define obqIsFullI(obqp) ((bool)(bqSpaceI(obqp) == 0U))
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -137,10 +235,40 @@ typedef io_double_buffer_t output_double_buffer_t;
 #ifdef __cplusplus
 extern "C" {
 #endif
-  void iobInit(io_buffer_t *iobp, uint8_t *bp, size_t size);
-  void idbObjectInit(input_double_buffer_t *idbp,
-                     uint8_t *b1p, uint8_t *b2p, size_t size,
-                     dbnotify_t infy, void *link);
+  void ibqObjectInit(input_buffers_queue_t *ibqp, uint8_t *bp,
+                     size_t size, size_t n,
+                     bqnotify_t infy, void *link);
+  void ibqResetI(input_buffers_queue_t *ibqp);
+  uint8_t *ibqGetEmptyBufferI(input_buffers_queue_t *ibqp);
+  void ibqPostFullBufferI(input_buffers_queue_t *ibqp, size_t size);
+  msg_t ibqGetFullBufferTimeout(input_buffers_queue_t *ibqp,
+                                systime_t timeout);
+  msg_t ibqGetFullBufferTimeoutS(input_buffers_queue_t *ibqp,
+                                 systime_t timeout);
+  void ibqReleaseEmptyBuffer(input_buffers_queue_t *ibqp);
+  void ibqReleaseEmptyBufferS(input_buffers_queue_t *ibqp);
+  msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, systime_t timeout);
+  size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
+                        size_t n, systime_t timeout);
+  void obqObjectInit(output_buffers_queue_t *obqp, uint8_t *bp,
+                     size_t size, size_t n,
+                     bqnotify_t onfy, void *link);
+  void obqResetI(output_buffers_queue_t *obqp);
+  uint8_t *obqGetFullBufferI(output_buffers_queue_t *obqp,
+                             size_t *sizep);
+  void obqReleaseEmptyBufferI(output_buffers_queue_t *obqp);
+  msg_t obqGetEmptyBufferTimeout(output_buffers_queue_t *obqp,
+                                 systime_t timeout);
+  msg_t obqGetEmptyBufferTimeoutS(output_buffers_queue_t *obqp,
+                                  systime_t timeout);
+  void obqPostFullBuffer(output_buffers_queue_t *obqp, size_t size);
+  void obqPostFullBufferS(output_buffers_queue_t *obqp, size_t size);
+  msg_t obqPutTimeout(output_buffers_queue_t *obqp, uint8_t b,
+                      systime_t timeout);
+  size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
+                         size_t n, systime_t timeout);
+  bool obqTryFlushI(output_buffers_queue_t *obqp);
+  void obqFlush(output_buffers_queue_t *obqp);
 #ifdef __cplusplus
 }
 #endif
@@ -211,6 +211,8 @@ typedef struct {
 #define CHN_OUTPUT_EMPTY        (eventflags_t)8
 /** @brief Transmission end.*/
 #define CHN_TRANSMISSION_END    (eventflags_t)16
+/** @brief End of a received frame, bits 5..9 are used by the drivers.*/
+#define CHN_FRAME_END           (eventflags_t)1024
 /** @} */
 
 /**
@@ -71,6 +71,9 @@ struct io_queue {
   uint8_t               *q_rdptr;   /**< @brief Read pointer.               */
   qnotify_t             q_notify;   /**< @brief Data notification callback. */
   void                  *q_link;    /**< @brief Application defined field.  */
+  size_t                q_watermark;/**< @brief Wakeup watermark.           */
+  size_t                q_wakeup;   /**< @brief Wakeup threshold of the
+                                                waiting thread.             */
 };
 
 /**
@@ -211,7 +214,9 @@ typedef io_queue_t input_queue_t;
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer),                                                      \
   (inotify),                                                                \
-  (link)                                                                    \
+  (link),                                                                   \
+  1U,                                                                       \
+  1U                                                                        \
 }
 
 /**
@@ -327,7 +332,9 @@ typedef io_queue_t output_queue_t;
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer),                                                      \
   (onotify),                                                                \
-  (link)                                                                    \
+  (link),                                                                   \
+  1U,                                                                       \
+  1U                                                                        \
 }
 
 /**
@@ -350,6 +357,7 @@ extern "C" {
   void iqObjectInit(input_queue_t *iqp, uint8_t *bp, size_t size,
                     qnotify_t infy, void *link);
   void iqResetI(input_queue_t *iqp);
+  void iqSetWatermarkI(input_queue_t *iqp, size_t n);
   msg_t iqPutI(input_queue_t *iqp, uint8_t b);
   msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout);
   size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
@@ -358,8 +366,10 @@ extern "C" {
   void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
                     qnotify_t onfy, void *link);
   void oqResetI(output_queue_t *oqp);
+  void oqSetWatermarkI(output_queue_t *oqp, size_t n);
   msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout);
   msg_t oqGetI(output_queue_t *oqp);
+  size_t oqWriteI(output_queue_t *oqp, const uint8_t *bp, size_t n);
   size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                         size_t n, systime_t timeout);
 #ifdef __cplusplus
@@ -386,18 +396,32 @@ extern "C" {
 #define iqObjectInit(iqp, bp, size, infy, link)                             \
   chIQObjectInit(iqp, bp, size, infy, link)
 #define iqResetI(iqp)                       chIQResetI(iqp)
+#define iqSetWatermarkI(iqp, n)             chIQSetWatermarkI(iqp, n)
 #define iqPutI(iqp, b)                      chIQPutI(iqp, b)
 #define iqGetTimeout(iqp, time)             chIQGetTimeout(iqp, time)
 #define iqReadTimeout(iqp, bp, n, time)     chIQReadTimeout(iqp, bp, n, time)
 #define oqObjectInit(oqp, bp, size, onfy, link)                             \
   chOQObjectInit(oqp, bp, size, onfy, link)
 #define oqResetI(oqp)                       chOQResetI(oqp)
+#define oqSetWatermarkI(oqp, n)             chOQSetWatermarkI(oqp, n)
 #define oqPutTimeout(oqp, b, time)          chOQPutTimeout(oqp, b, time)
 #define oqGetI(oqp)                         chOQGetI(oqp)
+#define oqWriteI(oqp, bp, n)                chOQWriteI(oqp, bp, n)
 #define oqWriteTimeout(oqp, bp, n, time)    chOQWriteTimeout(oqp, bp, n, time)
 
 #endif /* defined(_CHIBIOS_RT_) || (CH_CFG_USE_QUEUES == FALSE) */
 
+/* Functions implemented on top of the queues API, both the HAL and the
+   ChibiOS queues are supported.*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+  size_t oqWriteVTimeout(output_queue_t *oqp, const stream_iovec_t *iov,
+                         size_t cnt, systime_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _HAL_QUEUES_H_ */
 
 /** @} */
@@ -48,6 +48,16 @@
    check is performed in order to avoid conflicts. */
 #if !defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
 
+/**
+ * @brief   Fragment of a gather write.
+ */
+typedef struct {
+  /** @brief Pointer to the fragment data.*/
+  const uint8_t         *bp;
+  /** @brief Size of the fragment, can be zero.*/
+  size_t                n;
+} stream_iovec_t;
+
 /**
  * @brief   BaseSequentialStream specific methods.
  */
@@ -60,6 +70,8 @@
   msg_t (*put)(void *instance, uint8_t b);                                  \
   /* Channel get method, blocking.*/                                        \
   msg_t (*get)(void *instance);                                             \
+  /* Stream gather write method, NULL if not implemented.*/                 \
+  size_t (*writev)(void *instance, const stream_iovec_t *iov, size_t cnt);  \
 
 /**
  * @brief   @p BaseSequentialStream specific data.
@@ -151,8 +163,58 @@ typedef struct {
  * @api
  */
 #define streamGet(ip) ((ip)->vmt->get(ip))
+
+/**
+ * @brief   Sequential Stream gather write.
+ * @details The function writes the data from an array of fragments to a
+ *          stream, as a single @p streamWrite() of the fragments
+ *          concatenated would do. Streams that do not implement the
+ *          method are served by @p streamWriteVGeneric().
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[in] iov       pointer to the array of fragments
+ * @param[in] cnt       number of fragments in the array
+ * @return              The number of bytes transferred. The return value can
+ *                      be less than the total size of the fragments if an
+ *                      end-of-file condition has been met.
+ *
+ * @api
+ */
+#define streamWriteV(ip, iov, cnt)                                          \
+  ((ip)->vmt->writev != NULL ? (ip)->vmt->writev(ip, iov, cnt) :            \
+   streamWriteVGeneric((BaseSequentialStream *)(ip), iov, cnt))
 /** @} */
 
+/**
+ * @brief   Generic gather write.
+ * @details The fragments are written one at time using the stream write
+ *          method, the operation stops on the first short write.
+ *
+ * @param[in] ip        pointer to a @p BaseSequentialStream or derived class
+ * @param[in] iov       pointer to the array of fragments
+ * @param[in] cnt       number of fragments in the array
+ * @return              The number of bytes transferred.
+ *
+ * @api
+ */
+static inline size_t streamWriteVGeneric(BaseSequentialStream *ip,
+                                         const stream_iovec_t *iov,
+                                         size_t cnt) {
+  size_t i, w, total = 0U;
+
+  for (i = 0U; i < cnt; i++) {
+    if (iov[i].n > 0U) {
+      w = ip->vmt->write(ip, iov[i].bp, iov[i].n);
+      total += w;
+      if (w < iov[i].n) {
+        break;
+      }
+    }
+  }
+
+  return total;
+}
+
 #endif /* _HAL_STREAMS_H_ */
 
 /** @} */
@@ -69,12 +69,37 @@
 #if !defined(SERIAL_BUFFERS_SIZE) || defined(__DOXYGEN__)
 #define SERIAL_BUFFERS_SIZE         16
 #endif
+
+/**
+ * @brief   Frames receive API.
+ * @details If enabled then the low level driver reports idle line
+ *          conditions, @p CHN_FRAME_END is broadcast at the end of each
+ *          received frame and @p sdReadFrameTimeout() becomes available.
+ * @note    Low level drivers without idle line detection never terminate
+ *          frames, readers are then only woken by the bytes count.
+ */
+#if !defined(SERIAL_USE_FRAMES) || defined(__DOXYGEN__)
+#define SERIAL_USE_FRAMES           FALSE
+#endif
+
+/**
+ * @brief   Number of complete frames tracked in the input queue.
+ * @details When more complete frames than this are waiting in the input
+ *          queue then the last ones are merged into one.
+ */
+#if !defined(SERIAL_FRAMES_NUMBER) || defined(__DOXYGEN__)
+#define SERIAL_FRAMES_NUMBER        4
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SERIAL_USE_FRAMES == TRUE) && (SERIAL_FRAMES_NUMBER < 1)
+#error "SERIAL_FRAMES_NUMBER must be greater than zero"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -121,6 +146,20 @@ struct SerialDriver {
   /** @brief Virtual Methods Table.*/
   const struct SerialDriverVMT *vmt;
   _serial_driver_data
+#if (SERIAL_USE_FRAMES == TRUE) || defined(__DOXYGEN__)
+  /** @brief Threads waiting in @p sdReadFrameTimeout().*/
+  threads_queue_t           fqueue;
+  /** @brief Bytes of the frame being received still in the input queue.*/
+  size_t                    frame_rx;
+  /** @brief Bytes count a waiting reader is interested in, zero if none.*/
+  size_t                    frame_want;
+  /** @brief Lengths of the complete frames in the input queue.*/
+  size_t                    frames[SERIAL_FRAMES_NUMBER];
+  /** @brief Index of the oldest complete frame in @p frames.*/
+  unsigned                  frame_first;
+  /** @brief Number of complete frames in @p frames.*/
+  unsigned                  frame_count;
+#endif
 };
 
 /*===========================================================================*/
@@ -275,6 +314,11 @@ extern "C" {
   msg_t sdRequestDataI(SerialDriver *sdp);
   bool sdPutWouldBlock(SerialDriver *sdp);
   bool sdGetWouldBlock(SerialDriver *sdp);
+#if SERIAL_USE_FRAMES == TRUE
+  void sdFrameEndI(SerialDriver *sdp);
+  size_t sdReadFrameTimeout(SerialDriver *sdp, uint8_t *bp, size_t n,
+                            systime_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -121,6 +121,26 @@
 #if !defined(SERIAL_USB_BUFFERS_SIZE) || defined(__DOXYGEN__)
 #define SERIAL_USB_BUFFERS_SIZE     256
 #endif
+
+/**
+ * @brief   Packet mode.
+ * @details If enabled the driver uses buffers queues instead of byte
+ *          queues, each USB transfer is performed directly into or from
+ *          a buffer of @p SERIAL_USB_BUFFERS_SIZE bytes without copies.
+ */
+#if !defined(SERIAL_USB_PACKET_MODE) || defined(__DOXYGEN__)
+#define SERIAL_USB_PACKET_MODE      FALSE
+#endif
+
+/**
+ * @brief   Serial over USB number of buffers.
+ * @note    Only used in packet mode, the memory used by each queue is
+ *          <tt>SERIAL_USB_BUFFERS_NUMBER * (SERIAL_USB_BUFFERS_SIZE +
+ *          sizeof(size_t))</tt> bytes.
+ */
+#if !defined(SERIAL_USB_BUFFERS_NUMBER) || defined(__DOXYGEN__)
+#define SERIAL_USB_BUFFERS_NUMBER   2
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -131,6 +151,16 @@
 #error "Serial over USB Driver requires HAL_USE_USB"
 #endif
 
+#if SERIAL_USB_PACKET_MODE == TRUE
+#if (SERIAL_USB_BUFFERS_SIZE % 4) != 0
+#error "SERIAL_USB_BUFFERS_SIZE must be a multiple of 4 in packet mode"
+#endif
+
+#if SERIAL_USB_BUFFERS_NUMBER < 2
+#error "SERIAL_USB_BUFFERS_NUMBER must be at least 2"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -188,6 +218,7 @@ typedef struct {
 /**
  * @brief   @p SerialDriver specific data.
  */
+#if (SERIAL_USB_PACKET_MODE == FALSE) || defined(__DOXYGEN__)
 #define _serial_usb_driver_data                                             \
   _base_asynchronous_channel_data                                           \
   /* Driver state.*/                                                        \
@@ -203,6 +234,25 @@ typedef struct {
   /* End of the mandatory fields.*/                                         \
   /* Current configuration data.*/                                          \
   const SerialUSBConfig     *config;
+#else
+#define _serial_usb_driver_data                                             \
+  _base_asynchronous_channel_data                                           \
+  /* Driver state.*/                                                        \
+  sdustate_t                state;                                          \
+  /* Input buffers queue.*/                                                 \
+  input_buffers_queue_t     ibqueue;                                        \
+  /* Output buffers queue.*/                                                \
+  output_buffers_queue_t    obqueue;                                        \
+  /* Input buffers, aligned because of the size_t headers.*/                \
+  uint8_t                   ib[BQ_BUFFER_SIZE(SERIAL_USB_BUFFERS_NUMBER,    \
+                                              SERIAL_USB_BUFFERS_SIZE)];    \
+  /* Output buffers, aligned because of the size_t headers.*/               \
+  uint8_t                   ob[BQ_BUFFER_SIZE(SERIAL_USB_BUFFERS_NUMBER,    \
+                                              SERIAL_USB_BUFFERS_SIZE)];    \
+  /* End of the mandatory fields.*/                                         \
+  /* Current configuration data.*/                                          \
+  const SerialUSBConfig     *config;
+#endif
 
 /**
  * @brief   @p SerialUSBDriver specific methods.
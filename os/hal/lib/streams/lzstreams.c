@@ -0,0 +1,274 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lzstreams.c
+ * @brief   Compressing streams code.
+ * @details The data written to the stream is LZ77 encoded and forwarded
+ *          to a target stream. The encoded stream is:
+ *          - An header byte, @p LZSTREAM_WINDOW_BITS in the upper nibble
+ *            and @p LZSTREAM_LENGTH_BITS in the lower nibble.
+ *          - Tokens, MSB first. A literal is a 1 bit followed by the
+ *            byte. A back reference is a 0 bit followed by the distance
+ *            minus one on @p LZSTREAM_WINDOW_BITS bits and by the length
+ *            minus @p LZSTREAM_MIN_MATCH on @p LZSTREAM_LENGTH_BITS bits.
+ *            The window starts zero filled.
+ *          - A back reference with all the distance bits set, ending the
+ *            stream, then zero bits up to the byte boundary.
+ *          .
+ *          Matches are found through a two bytes hash and chains of
+ *          previous positions, at most @p LZSTREAM_MAX_CHAIN positions are
+ *          examined and at most one token is encoded for each byte
+ *          written, so the work done by a write is bounded by its size.
+ *
+ * @addtogroup lz_streams
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "lzstreams.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define WMASK                       (LZSTREAM_WINDOW_SIZE - 1U)
+#define HMASK                       ((1U << LZSTREAM_HASH_BITS) - 1U)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static unsigned hash(LzStream *lzsp, uint32_t p) {
+  unsigned a = lzsp->window[p & WMASK];
+  unsigned b = lzsp->window[(p + 1U) & WMASK];
+
+  return ((a << 3) ^ (a >> 5) ^ b) & HMASK;
+}
+
+/*
+ * Most recent position before ref with the specified low bits.
+ */
+static uint32_t unwrap(uint32_t ref, uint8_t low) {
+
+  return ref - 1U - ((ref - 1U - low) & WMASK);
+}
+
+static void lzs_out(LzStream *lzsp, uint8_t b) {
+
+  lzsp->out[lzsp->outn++] = b;
+  if (lzsp->outn == LZSTREAM_OUT_SIZE) {
+    streamWrite(lzsp->target, lzsp->out, lzsp->outn);
+    lzsp->outn = 0U;
+  }
+}
+
+static void lzs_bits(LzStream *lzsp, unsigned v, unsigned n) {
+
+  while (n > 0U) {
+    n--;
+    lzsp->acc = (uint8_t)((lzsp->acc << 1) | ((v >> n) & 1U));
+    if (++lzsp->nbits == 8U) {
+      lzs_out(lzsp, lzsp->acc);
+      lzsp->nbits = 0U;
+    }
+  }
+}
+
+static void lzs_reset(LzStream *lzsp) {
+
+  memset(lzsp->window, 0, sizeof (lzsp->window));
+  memset(lzsp->prev, 0, sizeof (lzsp->prev));
+  memset(lzsp->head, 0, sizeof (lzsp->head));
+  lzsp->end   = 0U;
+  lzsp->pos   = 0U;
+  lzsp->ins   = 0U;
+  lzsp->acc   = 0U;
+  lzsp->nbits = 0U;
+  lzsp->out[0] = (uint8_t)((LZSTREAM_WINDOW_BITS << 4) | LZSTREAM_LENGTH_BITS);
+  lzsp->outn  = 1U;
+}
+
+/*
+ * Adds the positions already encoded to the hash chains, both bytes of a
+ * position must have been written.
+ */
+static void lzs_index(LzStream *lzsp) {
+  unsigned h;
+
+  while ((lzsp->ins != lzsp->pos) && (lzsp->ins + 1U != lzsp->end)) {
+    h = hash(lzsp, lzsp->ins);
+    lzsp->prev[lzsp->ins & WMASK] = lzsp->head[h];
+    lzsp->head[h] = (uint8_t)(lzsp->ins & WMASK);
+    lzsp->ins++;
+  }
+}
+
+/*
+ * Longest match for the bytes at the encoding position. The chains hold
+ * low bits only, stale links lead to positions that just don't match.
+ */
+static unsigned lzs_match(LzStream *lzsp, uint32_t *distp) {
+  uint32_t c = lzsp->pos;
+  unsigned avail, best, len, chain;
+  uint8_t low;
+
+  avail = lzsp->end - lzsp->pos;
+  if (avail < LZSTREAM_MIN_MATCH) {
+    return 0U;
+  }
+  if (avail > LZSTREAM_MAX_MATCH) {
+    avail = LZSTREAM_MAX_MATCH;
+  }
+
+  best = 0U;
+  low = lzsp->head[hash(lzsp, lzsp->pos)];
+  for (chain = 0U; chain < LZSTREAM_MAX_CHAIN; chain++) {
+    c = unwrap(c, low);
+    if (lzsp->pos - c > LZSTREAM_MAX_DISTANCE) {
+      break;
+    }
+    len = 0U;
+    while ((len < avail) &&
+           (lzsp->window[(c + len) & WMASK] ==
+            lzsp->window[(lzsp->pos + len) & WMASK])) {
+      len++;
+    }
+    if (len > best) {
+      best = len;
+      *distp = lzsp->pos - c;
+      if (len == avail) {
+        break;
+      }
+    }
+    low = lzsp->prev[c & WMASK];
+  }
+
+  return best;
+}
+
+/*
+ * Encodes a single token.
+ */
+static void lzs_step(LzStream *lzsp) {
+  uint32_t dist = 0U;
+  unsigned len;
+
+  lzs_index(lzsp);
+  len = lzs_match(lzsp, &dist);
+  if (len >= LZSTREAM_MIN_MATCH) {
+    lzs_bits(lzsp, 0U, 1U);
+    lzs_bits(lzsp, (unsigned)dist - 1U, LZSTREAM_WINDOW_BITS);
+    lzs_bits(lzsp, len - LZSTREAM_MIN_MATCH, LZSTREAM_LENGTH_BITS);
+  }
+  else {
+    len = 1U;
+    lzs_bits(lzsp, 0x100U | lzsp->window[lzsp->pos & WMASK], 9U);
+  }
+  lzsp->pos += len;
+}
+
+static msg_t put(void *ip, uint8_t b) {
+  LzStream *lzsp = ip;
+
+  lzsp->window[lzsp->end & WMASK] = b;
+  lzsp->end++;
+  if (lzsp->end - lzsp->pos == LZSTREAM_MAX_MATCH) {
+    lzs_step(lzsp);
+  }
+  return MSG_OK;
+}
+
+static size_t writes(void *ip, const uint8_t *bp, size_t n) {
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    (void)put(ip, bp[i]);
+  }
+  return n;
+}
+
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+static msg_t get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct LzStreamVMT vmt = {writes, reads, put, get, NULL};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Compressing stream object initialization.
+ *
+ * @param[out] lzsp     pointer to the @p LzStream object to be initialized
+ * @param[in] target    pointer to the stream receiving the encoded data
+ */
+void lzsObjectInit(LzStream *lzsp, BaseSequentialStream *target) {
+
+  lzsp->vmt    = &vmt;
+  lzsp->target = target;
+  lzs_reset(lzsp);
+}
+
+/**
+ * @brief   Ends the encoded stream.
+ * @details The pending bytes are encoded and the end of stream marker is
+ *          written to the target stream. The object is then ready for a
+ *          new encoded stream.
+ *
+ * @param[in] lzsp      pointer to the @p LzStream object
+ */
+void lzsFinish(LzStream *lzsp) {
+
+  while (lzsp->pos != lzsp->end) {
+    lzs_step(lzsp);
+  }
+  lzs_bits(lzsp, 0U, 1U);
+  lzs_bits(lzsp, WMASK, LZSTREAM_WINDOW_BITS);
+  lzs_bits(lzsp, 0U, LZSTREAM_LENGTH_BITS);
+  if (lzsp->nbits > 0U) {
+    lzs_bits(lzsp, 0U, 8U - lzsp->nbits);
+  }
+  if (lzsp->outn > 0U) {
+    streamWrite(lzsp->target, lzsp->out, lzsp->outn);
+  }
+  lzs_reset(lzsp);
+}
+
+/** @} */
@@ -0,0 +1,190 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lzstreams.h
+ * @brief   Compressing streams structures and macros.
+ *
+ * @addtogroup lz_streams
+ * @{
+ */
+
+#ifndef _LZSTREAMS_H_
+#define _LZSTREAMS_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Shortest back reference.
+ */
+#define LZSTREAM_MIN_MATCH          2U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Window size as a power of two.
+ * @details The window holds both the history and the bytes not yet
+ *          encoded, it is also the size of the matches index.
+ */
+#if !defined(LZSTREAM_WINDOW_BITS) || defined(__DOXYGEN__)
+#define LZSTREAM_WINDOW_BITS        8
+#endif
+
+/**
+ * @brief   Back references length field size in bits.
+ */
+#if !defined(LZSTREAM_LENGTH_BITS) || defined(__DOXYGEN__)
+#define LZSTREAM_LENGTH_BITS        4
+#endif
+
+/**
+ * @brief   Hash table size as a power of two.
+ */
+#if !defined(LZSTREAM_HASH_BITS) || defined(__DOXYGEN__)
+#define LZSTREAM_HASH_BITS          6
+#endif
+
+/**
+ * @brief   Maximum number of candidate matches examined per token.
+ * @details This bounds the work done for each byte written to the stream.
+ */
+#if !defined(LZSTREAM_MAX_CHAIN) || defined(__DOXYGEN__)
+#define LZSTREAM_MAX_CHAIN          8
+#endif
+
+/**
+ * @brief   Output buffer size.
+ * @details The encoded data is written to the target stream in blocks of
+ *          this size.
+ */
+#if !defined(LZSTREAM_OUT_SIZE) || defined(__DOXYGEN__)
+#define LZSTREAM_OUT_SIZE           16
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Window size in bytes.
+ */
+#define LZSTREAM_WINDOW_SIZE        (1U << LZSTREAM_WINDOW_BITS)
+
+/**
+ * @brief   Longest back reference.
+ */
+#define LZSTREAM_MAX_MATCH                                                  \
+  (LZSTREAM_MIN_MATCH + (1U << LZSTREAM_LENGTH_BITS) - 1U)
+
+/**
+ * @brief   Farthest back reference.
+ * @note    The window also holds the bytes not yet encoded, a distance
+ *          of @p LZSTREAM_WINDOW_SIZE marks the end of the stream.
+ */
+#define LZSTREAM_MAX_DISTANCE       (LZSTREAM_WINDOW_SIZE - LZSTREAM_MAX_MATCH)
+
+#if (LZSTREAM_WINDOW_BITS < 5) || (LZSTREAM_WINDOW_BITS > 8)
+#error "LZSTREAM_WINDOW_BITS out of range (5..8)"
+#endif
+
+#if (LZSTREAM_LENGTH_BITS < 2) || (LZSTREAM_LENGTH_BITS > 4)
+#error "LZSTREAM_LENGTH_BITS out of range (2..4)"
+#endif
+
+#if (LZSTREAM_HASH_BITS < 1) || (LZSTREAM_HASH_BITS > 8)
+#error "LZSTREAM_HASH_BITS out of range (1..8)"
+#endif
+
+#if LZSTREAM_MAX_CHAIN < 1
+#error "invalid LZSTREAM_MAX_CHAIN value"
+#endif
+
+#if LZSTREAM_OUT_SIZE < 2
+#error "invalid LZSTREAM_OUT_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   @p LzStream specific data.
+ */
+#define _lz_stream_data                                                     \
+  _base_sequential_stream_data                                              \
+  /* Stream receiving the encoded data.*/                                   \
+  BaseSequentialStream  *target;                                            \
+  /* Bytes written to the stream.*/                                         \
+  uint32_t              end;                                                \
+  /* Next byte to be encoded.*/                                             \
+  uint32_t              pos;                                                \
+  /* Next byte to be indexed.*/                                             \
+  uint32_t              ins;                                                \
+  /* Window, history and bytes not yet encoded.*/                           \
+  uint8_t               window[LZSTREAM_WINDOW_SIZE];                       \
+  /* Previous position with the same hash, low bits.*/                      \
+  uint8_t               prev[LZSTREAM_WINDOW_SIZE];                         \
+  /* Last position for each hash, low bits.*/                               \
+  uint8_t               head[1U << LZSTREAM_HASH_BITS];                     \
+  /* Encoded data not yet written to the target.*/                          \
+  uint8_t               out[LZSTREAM_OUT_SIZE];                             \
+  uint8_t               outn;                                               \
+  /* Bits accumulator.*/                                                    \
+  uint8_t               acc;                                                \
+  uint8_t               nbits;
+
+/**
+ * @brief   @p LzStream virtual methods table.
+ */
+struct LzStreamVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief   Compressing stream object.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct LzStreamVMT *vmt;
+  _lz_stream_data
+} LzStream;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void lzsObjectInit(LzStream *lzsp, BaseSequentialStream *target);
+  void lzsFinish(LzStream *lzsp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LZSTREAMS_H_ */
+
+/** @} */
@@ -84,7 +84,24 @@ static msg_t get(void *ip) {
   return b;
 }
 
-static const struct MemStreamVMT vmt = {writes, reads, put, get};
+static size_t writesv(void *ip, const stream_iovec_t *iov, size_t cnt) {
+  MemoryStream *msp = ip;
+  size_t i, n, total = 0;
+
+  for (i = 0; i < cnt; i++) {
+    n = iov[i].n;
+    if (msp->size - msp->eos < n)
+      n = msp->size - msp->eos;
+    memcpy(msp->buffer + msp->eos, iov[i].bp, n);
+    msp->eos += n;
+    total += n;
+    if (n < iov[i].n)
+      break;
+  }
+  return total;
+}
+
+static const struct MemStreamVMT vmt = {writes, reads, put, get, writesv};
 
 /*===========================================================================*/
 /* Driver exported functions.                                                */
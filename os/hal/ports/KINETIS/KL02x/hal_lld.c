@@ -80,8 +80,37 @@ const uint8_t _cfm[0x10] = {
  * @notapi
  */
 void hal_lld_init(void) {
+
+#if HAL_USE_INIT_STATS == TRUE
+  /* Free running SysTick for the initialization statistics, the ST driver
+     takes it over at the end of halInit().*/
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+#endif
 }
 
+#if (HAL_USE_INIT_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Time stamp for the HAL initialization statistics.
+ * @details Core clock cycles, composed from the system time and the
+ *          SysTick down counter. Before the ST driver is started the system
+ *          time is zero and the counter runs over its full range.
+ * @note    A tick occurring between the two reads can offset a sample by
+ *          one tick period.
+ *
+ * @return              The time stamp.
+ *
+ * @notapi
+ */
+uint32_t kl2x_init_stats_now(void) {
+  uint32_t load = SysTick->LOAD;
+
+  return ((uint32_t)osalOsGetSystemTimeX() * (load + 1U)) +
+         (load - SysTick->VAL);
+}
+#endif
+
 /**
  * @brief   KL2x clocks and PLL initialization.
  * @note    All the involved constants come from the file @p board.h.
@@ -249,6 +249,22 @@ typedef uint32_t halrtcnt_t;
  */
 #define hal_lld_get_counter_frequency()     0
 
+#if (defined(HAL_USE_INIT_STATS) && (HAL_USE_INIT_STATS == TRUE)) ||        \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Time stamp for the HAL initialization statistics.
+ * @note    The SysTick is left free running by @p hal_lld_init() until the
+ *          ST driver reprograms it, the time stamp is valid in both
+ *          phases.
+ */
+#define HAL_INIT_STATS_NOW()                kl2x_init_stats_now()
+
+/**
+ * @brief   Frequency of the initialization statistics time stamp.
+ */
+#define HAL_INIT_STATS_FREQUENCY            KINETIS_SYSCLK_FREQUENCY
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -260,6 +276,9 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void kl2x_clock_init(void);
+#if defined(HAL_USE_INIT_STATS) && (HAL_USE_INIT_STATS == TRUE)
+  uint32_t kl2x_init_stats_now(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
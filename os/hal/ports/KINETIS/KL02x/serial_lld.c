@@ -81,10 +81,14 @@ static void serve_interrupt(SerialDriver *sdp) {
 
   if (u->S1 & UARTx_S1_RDRF) {
     osalSysLockFromISR();
+#if SERIAL_USE_FRAMES
+    sdIncomingDataI(sdp, u->D);
+#else
     if (iqIsEmptyI(&sdp->iqueue))
       chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
     if (iqPutI(&sdp->iqueue, u->D) < Q_OK)
       chnAddFlagsI(sdp, SD_OVERRUN_ERROR);
+#endif
     osalSysUnlockFromISR();
   }
 
@@ -105,8 +109,20 @@ static void serve_interrupt(SerialDriver *sdp) {
     }
   }
 
-  if (u->S1 & UARTx_S1_IDLE)
+  if (u->S1 & UARTx_S1_IDLE) {
     u->S1 = UARTx_S1_IDLE;  // Clear IDLE (S1 bits are write-1-to-clear).
+#if SERIAL_USE_FRAMES
+#if KINETIS_SERIAL_USE_UART1 || KINETIS_SERIAL_USE_UART2
+    // UART1 and UART2 clear IDLE by reading S1 then D.
+    if (((void *)u != (void *)UART0) && !(u->S1 & UARTx_S1_RDRF))
+      (void)u->D;
+#endif
+    // The line has been idle for a character time after the last byte.
+    osalSysLockFromISR();
+    sdFrameEndI(sdp);
+    osalSysUnlockFromISR();
+#endif
+  }
 
   if (u->S1 & (UARTx_S1_OR | UARTx_S1_NF | UARTx_S1_FE | UARTx_S1_PF)) {
     // FIXME: need to add set_error()
@@ -197,7 +213,14 @@ static void configure_uart(UARTLP_TypeDef *uart, const SerialConfig *config)
   uart->BDH = (divisor >> 8) & UARTx_BDH_SBR;
   uart->BDL = (divisor & UARTx_BDL_SBR);
 
+#if SERIAL_USE_FRAMES
+  /* Idle line counted after the stop bit, trailing ones in the last data
+     byte can't shorten the gap.*/
+  uart->C1 = UARTx_C1_ILT;
+  uart->C2 = UARTx_C2_RE | UARTx_C2_RIE | UARTx_C2_ILIE | UARTx_C2_TE;
+#else
   uart->C2 = UARTx_C2_RE | UARTx_C2_RIE | UARTx_C2_TE;
+#endif
 }
 
 /*===========================================================================*/
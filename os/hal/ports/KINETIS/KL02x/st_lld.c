@@ -61,6 +61,12 @@ OSAL_IRQ_HANDLER(SysTick_Handler) {
 
   OSAL_IRQ_PROLOGUE();
 
+#if defined(KINETIS_ST_TICK_HOOK)
+  /* The hook is invoked in the handler body so it can use
+     __builtin_return_address(0) in order to get EXC_RETURN.*/
+  KINETIS_ST_TICK_HOOK();
+#endif
+
   osalSysLockFromISR();
   osalOsTimerHandlerI();
   osalSysUnlockFromISR();
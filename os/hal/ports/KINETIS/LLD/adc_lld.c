@@ -32,6 +32,9 @@
 
 #define ADC_CHANNEL_MASK                    0x1f
 
+/* ADC0ALTTRGEN, ADC0PRETRGSEL and ADC0TRGSEL fields of SIM_SOPT7.*/
+#define ADC_SOPT7_MASK                      0x9f
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -49,7 +52,49 @@ ADCDriver ADCD1;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
-static void calibrate(ADCDriver *adcp) {
+#if KINETIS_ADC_PERSIST_CALIBRATION
+static uint16_t calib_checksum(const adccalib_t *rp) {
+  const uint16_t *p = (const uint16_t *)rp;
+  const uint16_t *end = &rp->checksum;
+  uint16_t sum = 0;
+
+  while (p < end)
+    sum += *p++;
+
+  return (uint16_t)~sum;
+}
+
+static void save_calibration(ADCDriver *adcp) {
+  volatile uint32_t *clp = &adcp->adc->CLPD;
+  volatile uint32_t *clm = &adcp->adc->CLMD;
+  unsigned i;
+
+  adcp->calib.ofs = adcp->adc->OFS;
+  adcp->calib.pg = adcp->adc->PG;
+  adcp->calib.mg = adcp->adc->MG;
+  for (i = 0; i < 7; i++) {
+    adcp->calib.clp[i] = clp[i];
+    adcp->calib.clm[i] = clm[i];
+  }
+  adcp->calib.magic = ADC_CALIB_MAGIC;
+}
+
+static void restore_calibration(ADCDriver *adcp) {
+  volatile uint32_t *clp = &adcp->adc->CLPD;
+  volatile uint32_t *clm = &adcp->adc->CLMD;
+  unsigned i;
+
+  adcp->adc->OFS = adcp->calib.ofs;
+  adcp->adc->PG = adcp->calib.pg;
+  adcp->adc->MG = adcp->calib.mg;
+  for (i = 0; i < 7; i++) {
+    clp[i] = adcp->calib.clp[i];
+    clm[i] = adcp->calib.clm[i];
+  }
+}
+#endif
+
+static void calibrate_start(ADCDriver *adcp) {
 
   /* Clock Divide by 8, Use Bus Clock Div 2 */
   /* At 48MHz this results in ADCCLK of 48/8/2 == 3MHz */
@@ -59,16 +104,20 @@ static void calibrate(ADCDriver *adcp) {
   /* Use software trigger and disable DMA etc. */
   adcp->adc->SC2 = 0;
 
+#if KINETIS_ADC_BACKGROUND_CALIBRATION
+  /* Interrupt at the end of the calibration, the disabled channel does
+     not start a conversion.*/
+  adcp->adc->SC1A = ADCx_SC1n_AIEN | ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+  adcp->calibrating = true;
+#endif
+
   /* Enable Hardware Average, Average 32 Samples, Calibrate */
   adcp->adc->SC3 = ADCx_SC3_AVGE |
       ADCx_SC3_AVGS(ADCx_SC3_AVGS_AVERAGE_32_SAMPLES) |
       ADCx_SC3_CAL;
+}
 
-  /* FIXME: May take several ms. Use an interrupt instead of busy wait */
-  /* Wait for calibration completion */
-  while (!(adcp->adc->SC1A & ADCx_SC1n_COCO))
-    ;
-
+static void calibrate_end(ADCDriver *adcp) {
   uint16_t gain = ((adcp->adc->CLP0 + adcp->adc->CLP1 + adcp->adc->CLP2 +
       adcp->adc->CLP3 + adcp->adc->CLP4 + adcp->adc->CLPS) / 2) | 0x8000;
   adcp->adc->PG = gain;
@@ -77,6 +126,32 @@ static void calibrate(ADCDriver *adcp) {
       adcp->adc->CLM3 + adcp->adc->CLM4 + adcp->adc->CLMS) / 2) | 0x8000;
   adcp->adc->MG = gain;
 
+#if KINETIS_ADC_PERSIST_CALIBRATION
+  /* Only a successful calibration is kept.*/
+  if (!(adcp->adc->SC3 & ADCx_SC3_CALF)) {
+    save_calibration(adcp);
+  }
+#endif
+}
+
+static void calibrate(ADCDriver *adcp) {
+
+#if KINETIS_ADC_PERSIST_CALIBRATION
+  if (adcp->calib.magic == ADC_CALIB_MAGIC) {
+    restore_calibration(adcp);
+    return;
+  }
+#endif
+
+  calibrate_start(adcp);
+
+#if !KINETIS_ADC_BACKGROUND_CALIBRATION
+  /* Wait for calibration completion, it may take several ms.*/
+  while (!(adcp->adc->SC1A & ADCx_SC1n_COCO))
+    ;
+
+  calibrate_end(adcp);
+#endif
 }
 
 /*===========================================================================*/
@@ -93,38 +168,74 @@ OSAL_IRQ_HANDLER(KINETIS_ADC0_IRQ_VECTOR) {
   OSAL_IRQ_PROLOGUE();
 
   ADCDriver *adcp = &ADCD1;
+  const ADCConversionGroup *grpp;
+  adcsample_t *samples;
+  size_t index, channel;
+
+#if KINETIS_ADC_BACKGROUND_CALIBRATION
+  if (adcp->calibrating) {
+    /* End of the background calibration, a deferred conversion is
+       started now.*/
+    adcp->adc->SC1A = ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+    calibrate_end(adcp);
+    adcp->calibrating = false;
+    osalSysLockFromISR();
+    if (adcp->start_pending) {
+      adcp->start_pending = false;
+      adc_lld_start_conversion(adcp);
+    }
+    osalSysUnlockFromISR();
+    OSAL_IRQ_EPILOGUE();
+    return;
+  }
+#endif
 
-  /* Disable Interrupt, Disable Channel */
-  adcp->adc->SC1A = ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+  /* Disable Interrupt, Disable Channel, unless the hardware starts the
+     next conversion by itself.*/
+  if (!adcp->streaming) {
+    adcp->adc->SC1A = ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+  }
 
   /* Read the sample into the buffer */
   adcp->samples[adcp->current_index++] = adcp->adc->RA;
 
-  bool more = true;
-
-  /*  At the end of the buffer then we may be finished */
+  /* State of the conversion before the callbacks, they may stop it and
+     start another one.*/
+  grpp    = adcp->grpp;
+  samples = adcp->samples;
+  channel = adcp->current_channel;
   if (adcp->current_index == adcp->number_of_samples) {
-    _adc_isr_full_code(&ADCD1);
-
     adcp->current_index = 0;
-
-    /* We are never finished in circular mode */
-    more = ADCD1.grpp->circular;
   }
+  index   = adcp->current_index;
 
-  if (more) {
-
-    /* Signal half completion in circular mode. */
-    if (ADCD1.grpp->circular &&
-        (adcp->current_index == (adcp->number_of_samples / 2))) {
-
-        _adc_isr_half_code(&ADCD1);
+  /*  At the end of the buffer then we may be finished */
+  if (index == 0U) {
+    _adc_isr_full_code(adcp);
+
+    /* We are never finished in circular mode, in linear mode the callback
+       may already have started another conversion.*/
+    if (!grpp->circular) {
+      OSAL_IRQ_EPILOGUE();
+      return;
     }
+  }
+  else if (grpp->circular && (index == adcp->half_index)) {
+    _adc_isr_half_code(adcp);
+  }
+
+  /* The callbacks may have stopped the conversion or restarted it, a
+     restart has already selected the first channel of its group. With a
+     single channel a restart is not detected, selecting the same channel
+     again only restarts its conversion.*/
+  if ((adcp->state == ADC_ACTIVE) && !adcp->streaming &&
+      (adcp->grpp == grpp) && (adcp->samples == samples) &&
+      (adcp->current_index == index) && (adcp->current_channel == channel)) {
 
     /* Skip to the next channel */
     do {
       adcp->current_channel = (adcp->current_channel + 1) & ADC_CHANNEL_MASK;
-    } while (((1 << adcp->current_channel) & adcp->grpp->channel_mask) == 0);
+    } while (((1U << adcp->current_channel) & adcp->grpp->channel_mask) == 0);
 
     /* Enable Interrupt, Select the Channel */
     adcp->adc->SC1A = ADCx_SC1n_AIEN | ADCx_SC1n_ADCH(adcp->current_channel);
@@ -148,6 +259,9 @@ void adc_lld_init(void) {
 #if KINETIS_ADC_USE_ADC0
   /* Driver initialization.*/
   adcObjectInit(&ADCD1);
+  /* The calibration record is not cleared, the driver is zeroed at
+     startup and a record loaded by adcKinetisSetCalibration() before a
+     lazy initialization must be kept.*/
 #endif
 
   /* The shared vector is initialized on driver initialization and never
@@ -171,6 +285,11 @@ void adc_lld_start(ADCDriver *adcp) {
 #if KINETIS_ADC_USE_ADC0
     if (&ADCD1 == adcp) {
       adcp->adc = ADC0;
+      adcp->streaming = false;
+#if KINETIS_ADC_BACKGROUND_CALIBRATION
+      adcp->calibrating = false;
+      adcp->start_pending = false;
+#endif
       if (adcp->config->calibrate) {
         calibrate(adcp);
       }
@@ -190,14 +309,20 @@ void adc_lld_stop(ADCDriver *adcp) {
 
   /* If in ready state then disables the ADC clock.*/
   if (adcp->state == ADC_READY) {
-    SIM->SCGC6 &= ~SIM_SCGC6_ADC0;
-
 #if KINETIS_ADC_USE_ADC0
     if (&ADCD1 == adcp) {
-      /* Disable Interrupt, Disable Channel */
+      /* Disable Interrupt, Disable Channel, this also aborts a
+         calibration in progress. The registers are not accessible
+         after gating the clock.*/
       adcp->adc->SC1A = ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+#if KINETIS_ADC_BACKGROUND_CALIBRATION
+      adcp->calibrating = false;
+      adcp->start_pending = false;
+#endif
     }
 #endif
+
+    SIM->SCGC6 &= ~SIM_SCGC6_ADC0;
   }
 }
 
@@ -211,17 +336,26 @@ void adc_lld_stop(ADCDriver *adcp) {
 void adc_lld_start_conversion(ADCDriver *adcp) {
   const ADCConversionGroup *grpp = adcp->grpp;
 
+#if KINETIS_ADC_BACKGROUND_CALIBRATION
+  if (adcp->calibrating) {
+    /* Started by the ISR at the end of the calibration.*/
+    adcp->start_pending = true;
+    return;
+  }
+#endif
+
   /* Enable the Bandgap Buffer if channel mask includes BANDGAP */
   if (grpp->channel_mask & ADC_BANDGAP) {
     PMC->REGSC |= PMC_REGSC_BGBE;
   }
 
   adcp->number_of_samples = adcp->depth * grpp->num_channels;
+  adcp->half_index = (adcp->depth / 2) * grpp->num_channels;
   adcp->current_index = 0;
 
   /* Skip to the next channel */
   adcp->current_channel = 0;
-  while (((1 << adcp->current_channel) & grpp->channel_mask) == 0) {
+  while (((1U << adcp->current_channel) & grpp->channel_mask) == 0) {
     adcp->current_channel = (adcp->current_channel + 1) & ADC_CHANNEL_MASK;
   }
 
@@ -231,6 +365,17 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   /* Set averaging */
   adcp->adc->SC3 = grpp->sc3;
 
+  /* A single channel needs no reprogramming between samples if the
+     conversions are restarted by the trigger or in continuous mode.*/
+  adcp->streaming = ((grpp->channel_mask & (grpp->channel_mask - 1)) == 0) &&
+                    ((grpp->trigger != ADC_TRIGGER_SOFTWARE) ||
+                     ((grpp->sc3 & ADCx_SC3_ADCO) != 0));
+
+  /* Select the trigger source */
+  SIM->SOPT7 = (SIM->SOPT7 & ~ADC_SOPT7_MASK) |
+               (grpp->trigger & ADC_SOPT7_MASK);
+  adcp->adc->SC2 = grpp->trigger != ADC_TRIGGER_SOFTWARE ? ADCx_SC2_ADTRG : 0;
+
   /* Enable Interrupt, Select Channel */
   adcp->adc->SC1A = ADCx_SC1n_AIEN | ADCx_SC1n_ADCH(adcp->current_channel);
 }
@@ -245,6 +390,20 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
 void adc_lld_stop_conversion(ADCDriver *adcp) {
   const ADCConversionGroup *grpp = adcp->grpp;
 
+#if KINETIS_ADC_BACKGROUND_CALIBRATION
+  /* A deferred conversion is simply forgotten, nothing was started.*/
+  adcp->start_pending = false;
+  if (adcp->calibrating) {
+    return;
+  }
+#endif
+
+  /* Disable Interrupt, Disable Channel, back to software trigger, this
+     also stops the continuous and the triggered conversions.*/
+  adcp->adc->SC1A = ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+  adcp->adc->SC2 = 0;
+  adcp->streaming = false;
+
   /* Disable the Bandgap buffer if channel mask includes BANDGAP */
   if (grpp->channel_mask & ADC_BANDGAP) {
     /* Clear BGBE, ACKISO is w1c, avoid setting */
@@ -253,6 +412,97 @@ void adc_lld_stop_conversion(ADCDriver *adcp) {
 
 }
 
+#if KINETIS_ADC_PERSIST_CALIBRATION || defined(__DOXYGEN__)
+/**
+ * @brief   Exports the calibration results kept by the driver.
+ * @details The record is completed with the specified conditions and a
+ *          checksum, it can then be stored and loaded on a later boot using
+ *          @p adcKinetisSetCalibration().
+ *
+ * @param[in] adcp        pointer to the @p ADCDriver object
+ * @param[out] rp         pointer to the record to be filled
+ * @param[in] temperature current temperature, degrees Celsius
+ * @param[in] vdd         current supply voltage, mV
+ * @return                The operation status.
+ * @retval false          if a successful calibration has not been
+ *                        performed yet.
+ *
+ * @api
+ */
+bool adcKinetisGetCalibration(ADCDriver *adcp, adccalib_t *rp,
+                              int16_t temperature, uint16_t vdd) {
+
+  osalDbgCheck((adcp != NULL) && (rp != NULL));
+
+  osalSysLock();
+  *rp = adcp->calib;
+  osalSysUnlock();
+
+  if (rp->magic != ADC_CALIB_MAGIC) {
+    return false;
+  }
+  rp->temperature = temperature;
+  rp->vdd = vdd;
+  rp->checksum = calib_checksum(rp);
+
+  return true;
+}
+
+/**
+ * @brief   Loads a calibration record.
+ * @details The record is restored by the next @p adcStart() instead of
+ *          running the calibration. A corrupted record or one taken at a
+ *          temperature or supply voltage too far from the current ones is
+ *          rejected, see @p KINETIS_ADC_CALIB_MAX_TEMP_DELTA and
+ *          @p KINETIS_ADC_CALIB_MAX_VDD_DELTA.
+ * @note    Passing @p NULL discards the calibration kept by the driver,
+ *          the next @p adcStart() calibrates again.
+ * @note    The record can be loaded before the driver is initialized on
+ *          first use, see @p HAL_LAZY_DRIVERS.
+ *
+ * @param[in] adcp        pointer to the @p ADCDriver object
+ * @param[in] rp          pointer to the record or @p NULL
+ * @param[in] temperature current temperature, degrees Celsius
+ * @param[in] vdd         current supply voltage, mV
+ * @return                The operation status.
+ * @retval false          if the record has been rejected.
+ *
+ * @api
+ */
+bool adcKinetisSetCalibration(ADCDriver *adcp, const adccalib_t *rp,
+                              int16_t temperature, uint16_t vdd) {
+  int dt, dv;
+
+  osalDbgCheck(adcp != NULL);
+
+  if (rp != NULL) {
+    if ((rp->magic != ADC_CALIB_MAGIC) ||
+        (rp->checksum != calib_checksum(rp))) {
+      return false;
+    }
+    dt = (int)rp->temperature - (int)temperature;
+    dv = (int)rp->vdd - (int)vdd;
+    if ((dt > KINETIS_ADC_CALIB_MAX_TEMP_DELTA) ||
+        (dt < -KINETIS_ADC_CALIB_MAX_TEMP_DELTA) ||
+        (dv > KINETIS_ADC_CALIB_MAX_VDD_DELTA) ||
+        (dv < -KINETIS_ADC_CALIB_MAX_VDD_DELTA)) {
+      return false;
+    }
+  }
+
+  osalSysLock();
+  if (rp != NULL) {
+    adcp->calib = *rp;
+  }
+  else {
+    adcp->calib.magic = 0;
+  }
+  osalSysUnlock();
+
+  return true;
+}
+#endif /* KINETIS_ADC_PERSIST_CALIBRATION */
+
 #endif /* HAL_USE_ADC */
 
 /** @} */
@@ -135,6 +135,31 @@
 
 /** @} */
 
+/**
+ * @name    Conversion trigger sources
+ * @note    The hardware triggers are the SIM_SOPT7 alternate trigger
+ *          selections, the available sources depend on the device, the
+ *          TPMx triggers are the FTMx ones on devices with FTM timers.
+ * @{
+ */
+#define ADC_TRIGGER_SOFTWARE            0x00
+#define ADC_TRIGGER_EXTRG_IN            0x80
+#define ADC_TRIGGER_CMP0                0x81
+#define ADC_TRIGGER_PIT0                0x84
+#define ADC_TRIGGER_PIT1                0x85
+#define ADC_TRIGGER_TPM0                0x88
+#define ADC_TRIGGER_TPM1                0x89
+#define ADC_TRIGGER_TPM2                0x8A
+#define ADC_TRIGGER_RTC_ALARM           0x8C
+#define ADC_TRIGGER_RTC_SECONDS         0x8D
+#define ADC_TRIGGER_LPTMR0              0x8E
+/** @} */
+
+/**
+ * @brief   Marker of a valid calibration record.
+ */
+#define ADC_CALIB_MAGIC                 0x41444343U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -160,6 +185,46 @@
 #define KINETIS_ADC_IRQ_PRIORITY            5
 #endif
 
+/**
+ * @brief   Background calibration.
+ * @details If set to @p TRUE the calibration requested by the driver
+ *          configuration runs in background, @p adcStart() returns
+ *          immediately and a conversion started before the end of the
+ *          calibration is deferred until the calibration completes.
+ */
+#if !defined(KINETIS_ADC_BACKGROUND_CALIBRATION) || defined(__DOXYGEN__)
+#define KINETIS_ADC_BACKGROUND_CALIBRATION  TRUE
+#endif
+
+/**
+ * @brief   Persistent calibration.
+ * @details If set to @p TRUE the calibration results are kept by the driver
+ *          and restored by the following @p adcStart() instead of running
+ *          the calibration again. The results can also be exported into a
+ *          record, for example stored in flash, and loaded on the next boot.
+ */
+#if !defined(KINETIS_ADC_PERSIST_CALIBRATION) || defined(__DOXYGEN__)
+#define KINETIS_ADC_PERSIST_CALIBRATION     TRUE
+#endif
+
+/**
+ * @brief   Maximum temperature difference for a calibration record.
+ * @details A record taken at a temperature farther than this, in degrees
+ *          Celsius, is rejected by @p adcKinetisSetCalibration().
+ */
+#if !defined(KINETIS_ADC_CALIB_MAX_TEMP_DELTA) || defined(__DOXYGEN__)
+#define KINETIS_ADC_CALIB_MAX_TEMP_DELTA    15
+#endif
+
+/**
+ * @brief   Maximum supply voltage difference for a calibration record.
+ * @details A record taken at a supply voltage farther than this, in mV,
+ *          is rejected by @p adcKinetisSetCalibration().
+ */
+#if !defined(KINETIS_ADC_CALIB_MAX_VDD_DELTA) || defined(__DOXYGEN__)
+#define KINETIS_ADC_CALIB_MAX_VDD_DELTA     100
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -203,6 +268,45 @@ typedef enum {
  */
 typedef struct ADCDriver ADCDriver;
 
+/**
+ * @brief   ADC calibration record.
+ * @details Results of a hardware calibration with the conditions it was
+ *          taken at. The layout is fixed, a record can be stored as-is in
+ *          flash and loaded on a later boot.
+ */
+typedef struct {
+  /**
+   * @brief Record marker, @p ADC_CALIB_MAGIC for a valid record.
+   */
+  uint32_t                  magic;
+  /**
+   * @brief OFS, PG and MG registers.
+   */
+  uint16_t                  ofs;
+  uint16_t                  pg;
+  uint16_t                  mg;
+  /**
+   * @brief CLPD, CLPS and CLP4..CLP0 registers.
+   */
+  uint16_t                  clp[7];
+  /**
+   * @brief CLMD, CLMS and CLM4..CLM0 registers.
+   */
+  uint16_t                  clm[7];
+  /**
+   * @brief Temperature at calibration time, degrees Celsius.
+   */
+  int16_t                   temperature;
+  /**
+   * @brief Supply voltage at calibration time, mV.
+   */
+  uint16_t                  vdd;
+  /**
+   * @brief Checksum of all the preceding fields.
+   */
+  uint16_t                  checksum;
+} adccalib_t;
+
 /**
  * @brief   ADC notification callback type.
  *
@@ -257,8 +361,22 @@ typedef struct {
   /**
    * @brief   ADC SC3 register initialization data.
    * @note    All the required bits must be defined into this field.
+   * @note    @p ADCx_SC3_AVGE enables the hardware averaging, a sample is
+   *          the average of 4 to 32 conversions. @p ADCx_SC3_ADCO starts
+   *          the next conversion as soon as one ends, do not combine it
+   *          with a hardware trigger.
    */
   uint32_t                  sc3;
+  /**
+   * @brief   Conversion trigger source.
+   * @details With a hardware trigger a sample is taken on each event of
+   *          the source, one channel of the group per event. The source
+   *          itself, for example a TPM started by the PWM driver, must be
+   *          configured by the application.
+   * @note    Groups initialized without this field use the software
+   *          trigger.
+   */
+  uint32_t                  trigger;
 } ADCConversionGroup;
 
 /**
@@ -326,6 +444,34 @@ struct ADCDriver {
    * @brief Current channel index into group channel_mask.
    */
   size_t                    current_channel;
+  /**
+   * @brief Position of the half buffer notification in circular mode.
+   */
+  size_t                    half_index;
+  /**
+   * @brief Single channel conversions restarted by the hardware.
+   * @details Set when the group has a single channel and uses either a
+   *          hardware trigger or the continuous mode, the channel is not
+   *          selected again after each sample.
+   */
+  bool                      streaming;
+#if (KINETIS_ADC_BACKGROUND_CALIBRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Calibration in progress.
+   */
+  bool                      calibrating;
+  /**
+   * @brief Conversion deferred until the end of the calibration.
+   */
+  bool                      start_pending;
+#endif
+#if (KINETIS_ADC_PERSIST_CALIBRATION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Calibration results restored on start, valid if the
+   *        @p magic field is @p ADC_CALIB_MAGIC.
+   */
+  adccalib_t                calib;
+#endif
 };
 
 /*===========================================================================*/
@@ -349,6 +495,12 @@ extern "C" {
   void adc_lld_stop(ADCDriver *adcp);
   void adc_lld_start_conversion(ADCDriver *adcp);
   void adc_lld_stop_conversion(ADCDriver *adcp);
+#if KINETIS_ADC_PERSIST_CALIBRATION
+  bool adcKinetisGetCalibration(ADCDriver *adcp, adccalib_t *rp,
+                                int16_t temperature, uint16_t vdd);
+  bool adcKinetisSetCalibration(ADCDriver *adcp, const adccalib_t *rp,
+                                int16_t temperature, uint16_t vdd);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -273,7 +273,7 @@ static msg_t _lseek(void *instance, fileoffset_t offset) {
  * @brief   VMT for the RTC storage file interface.
  */
 struct RTCDriverVMT _rtc_lld_vmt = {
-  _write, _read, _put, _get,
+  _write, _read, _put, _get, NULL,
   _close, _geterror, _getsize, _getposition, _lseek
 };
 #endif /* RTC_HAS_STORAGE */
@@ -114,7 +114,7 @@ static size_t readt(void *ip, uint8_t *bp, size_t n, systime_t time) {
 }
 
 static const struct BaseChannelVMT vmt = {
-  write, read, put, get,
+  write, read, put, get, NULL,
   putt, gett, writet, readt
 };
 
@@ -95,6 +95,7 @@ void adcObjectInit(ADCDriver *adcp) {
 void adcStart(ADCDriver *adcp, const ADCConfig *config) {
 
   osalDbgCheck(adcp != NULL);
+  halLazyInit(HAL_DRV_ADC, adcInit);
 
   osalSysLock();
   osalDbgAssert((adcp->state == ADC_STOP) || (adcp->state == ADC_READY),
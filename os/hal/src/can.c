@@ -95,6 +95,7 @@ void canObjectInit(CANDriver *canp) {
 void canStart(CANDriver *canp, const CANConfig *config) {
 
   osalDbgCheck(canp != NULL);
+  halLazyInit(HAL_DRV_CAN, canInit);
 
   osalSysLock();
   osalDbgAssert(canp->state == CAN_STOP, "invalid state");
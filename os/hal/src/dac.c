@@ -93,6 +93,7 @@ void dacObjectInit(DACDriver *dacp) {
 void dacStart(DACDriver *dacp, const DACConfig *config) {
 
   osalDbgCheck(dacp != NULL);
+  halLazyInit(HAL_DRV_DAC, dacInit);
 
   osalSysLock();
 
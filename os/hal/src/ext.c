@@ -84,6 +84,7 @@ void extObjectInit(EXTDriver *extp) {
 void extStart(EXTDriver *extp, const EXTConfig *config) {
 
   osalDbgCheck((extp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_EXT, extInit);
 
   osalSysLock();
   osalDbgAssert((extp->state == EXT_STOP) || (extp->state == EXT_ACTIVE),
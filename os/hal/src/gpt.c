@@ -82,6 +82,7 @@ void gptObjectInit(GPTDriver *gptp) {
 void gptStart(GPTDriver *gptp, const GPTConfig *config) {
 
   osalDbgCheck((gptp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_GPT, gptInit);
 
   osalSysLock();
   osalDbgAssert((gptp->state == GPT_STOP) || (gptp->state == GPT_READY),
@@ -28,6 +28,30 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if (HAL_USE_INIT_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Performs an initialization step and records its duration.
+ */
+#define HAL_INIT_STEP(code, name) do {                                      \
+  uint32_t start = HAL_INIT_STATS_NOW();                                    \
+  code;                                                                     \
+  hal_init_record(name, HAL_INIT_STATS_NOW() - start, false);               \
+} while (false)
+#else
+#define HAL_INIT_STEP(code, name) do {                                      \
+  code;                                                                     \
+} while (false)
+#endif
+
+/**
+ * @brief   Initializes a driver class unless initialized on first use.
+ */
+#define HAL_INIT_DRIVER(id, initf) do {                                     \
+  if (((HAL_LAZY_DRIVERS) & (id)) == 0U) {                                  \
+    HAL_INIT_STEP(initf(), #initf);                                         \
+  }                                                                         \
+} while (false)
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -36,10 +60,46 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Drivers classes already initialized on first use.
+ */
+static uint32_t hal_lazy_done;
+
+#if (HAL_USE_INIT_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initialization statistics records.
+ */
+static hal_init_stats_t hal_init_stats[HAL_INIT_STATS_SIZE];
+
+/**
+ * @brief   Number of used records.
+ */
+static unsigned hal_init_nstats;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (HAL_USE_INIT_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Appends an initialization statistics record.
+ *
+ * @param[in] name      name of the initialization step
+ * @param[in] time      duration of the initialization step
+ * @param[in] lazy      step performed on first use
+ */
+static void hal_init_record(const char *name, uint32_t time, bool lazy) {
+
+  if (hal_init_nstats < HAL_INIT_STATS_SIZE) {
+    hal_init_stats[hal_init_nstats].name = name;
+    hal_init_stats[hal_init_nstats].time = time;
+    hal_init_stats[hal_init_nstats].lazy = lazy;
+    hal_init_nstats++;
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -50,6 +110,8 @@
  *          initializes all the drivers enabled in the HAL. Finally the
  *          board-specific initialization is performed by invoking
  *          @p boardInit() (usually defined in @p board.c).
+ * @note    Drivers classes in the @p HAL_LAZY_DRIVERS mask are skipped,
+ *          those are initialized by their first @p xxxStart().
  *
  * @init
  */
@@ -59,78 +121,78 @@ void halInit(void) {
   osalInit();
 
   /* Platform low level initializations.*/
-  hal_lld_init();
+  HAL_INIT_STEP(hal_lld_init(), "hal_lld_init");
 
 #if (HAL_USE_PAL == TRUE) || defined(__DOXYGEN__)
-  palInit(&pal_default_config);
+  HAL_INIT_STEP(palInit(&pal_default_config), "palInit");
 #endif
 #if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
-  adcInit();
+  HAL_INIT_DRIVER(HAL_DRV_ADC, adcInit);
 #endif
 #if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
-  canInit();
+  HAL_INIT_DRIVER(HAL_DRV_CAN, canInit);
 #endif
 #if (HAL_USE_DAC == TRUE) || defined(__DOXYGEN__)
-  dacInit();
+  HAL_INIT_DRIVER(HAL_DRV_DAC, dacInit);
 #endif
 #if (HAL_USE_EXT == TRUE) || defined(__DOXYGEN__)
-  extInit();
+  HAL_INIT_DRIVER(HAL_DRV_EXT, extInit);
 #endif
 #if (HAL_USE_GPT == TRUE) || defined(__DOXYGEN__)
-  gptInit();
+  HAL_INIT_DRIVER(HAL_DRV_GPT, gptInit);
 #endif
 #if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
-  i2cInit();
+  HAL_INIT_DRIVER(HAL_DRV_I2C, i2cInit);
 #endif
 #if (HAL_USE_I2S == TRUE) || defined(__DOXYGEN__)
-  i2sInit();
+  HAL_INIT_DRIVER(HAL_DRV_I2S, i2sInit);
 #endif
 #if (HAL_USE_ICU == TRUE) || defined(__DOXYGEN__)
-  icuInit();
+  HAL_INIT_DRIVER(HAL_DRV_ICU, icuInit);
 #endif
 #if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
-  macInit();
+  HAL_INIT_DRIVER(HAL_DRV_MAC, macInit);
 #endif
 #if (HAL_USE_PWM == TRUE) || defined(__DOXYGEN__)
-  pwmInit();
+  HAL_INIT_DRIVER(HAL_DRV_PWM, pwmInit);
 #endif
 #if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
-  sdInit();
+  HAL_INIT_DRIVER(HAL_DRV_SERIAL, sdInit);
 #endif
 #if (HAL_USE_SDC == TRUE) || defined(__DOXYGEN__)
-  sdcInit();
+  HAL_INIT_DRIVER(HAL_DRV_SDC, sdcInit);
 #endif
 #if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
-  spiInit();
+  HAL_INIT_DRIVER(HAL_DRV_SPI, spiInit);
 #endif
 #if (HAL_USE_UART == TRUE) || defined(__DOXYGEN__)
-  uartInit();
+  HAL_INIT_DRIVER(HAL_DRV_UART, uartInit);
 #endif
 #if (HAL_USE_USB == TRUE) || defined(__DOXYGEN__)
-  usbInit();
+  HAL_INIT_DRIVER(HAL_DRV_USB, usbInit);
 #endif
 #if (HAL_USE_MMC_SPI == TRUE) || defined(__DOXYGEN__)
-  mmcInit();
+  HAL_INIT_STEP(mmcInit(), "mmcInit");
 #endif
 #if (HAL_USE_SERIAL_USB == TRUE) || defined(__DOXYGEN__)
-  sduInit();
+  HAL_INIT_STEP(sduInit(), "sduInit");
 #endif
 #if (HAL_USE_RTC == TRUE) || defined(__DOXYGEN__)
-  rtcInit();
+  HAL_INIT_STEP(rtcInit(), "rtcInit");
 #endif
 #if (HAL_USE_WDG == TRUE) || defined(__DOXYGEN__)
-  wdgInit();
+  HAL_INIT_DRIVER(HAL_DRV_WDG, wdgInit);
 #endif
 
   /* Community driver overlay initialization.*/
 #if defined(HAL_USE_COMMUNITY) || defined(__DOXYGEN__)
 #if (HAL_USE_COMMUNITY == TRUE) || defined(__DOXYGEN__)
-  halCommunityInit();
+  HAL_INIT_STEP(halCommunityInit(), "halCommunityInit");
 #endif
 #endif
 
   /* Board specific initialization.*/
-  boardInit();
+  HAL_INIT_STEP(boardInit(), "boardInit");
 
 /*
  *  The ST driver is a special case, it is only initialized if the OSAL is
@@ -141,4 +203,59 @@ void halInit(void) {
 #endif
 }
 
+/**
+ * @brief   Initializes a driver class on first use.
+ * @details The initialization function is invoked once, the following
+ *          invocations do nothing.
+ * @note    The initialization is performed within a critical zone, the
+ *          low level initialization of lazy drivers must not invoke
+ *          blocking APIs.
+ * @note    Use the @p halLazyInit() macro.
+ *
+ * @param[in] id        driver class identifier
+ * @param[in] initf     driver class initialization function
+ * @param[in] name      name of the initialization function
+ *
+ * @notapi
+ */
+void _hal_lazy_init(uint32_t id, void (*initf)(void), const char *name) {
+
+  osalSysLock();
+  if ((hal_lazy_done & id) == 0U) {
+    hal_lazy_done |= id;
+#if HAL_USE_INIT_STATS == TRUE
+    {
+      uint32_t start = HAL_INIT_STATS_NOW();
+      initf();
+      hal_init_record(name, HAL_INIT_STATS_NOW() - start, true);
+    }
+#else
+    (void)name;
+    initf();
+#endif
+  }
+  osalSysUnlock();
+}
+
+#if (HAL_USE_INIT_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the drivers initialization statistics.
+ * @details Records are in initialization order, the lazy drivers are
+ *          appended when first started.
+ *
+ * @param[out] np       number of valid records
+ * @return              Pointer to the first record.
+ *
+ * @api
+ */
+const hal_init_stats_t *halGetInitStats(unsigned *np) {
+
+  osalDbgCheck(np != NULL);
+
+  *np = hal_init_nstats;
+
+  return hal_init_stats;
+}
+#endif
+
 /** @} */
@@ -19,15 +19,37 @@
  * @brief   I/O Buffers code.
  *
  * @addtogroup HAL_BUFFERS
+ * @details Buffers Queues are used when there is the need to exchange
+ *          fixed-length data buffers between ISRs and threads.
+ *          On the ISR side data can be exchanged only using buffers,
+ *          on the thread side data can be exchanged both using buffers and/or
+ *          using an emulation of regular byte queues.
+ *          There are several kind of buffers queues:<br>
+ *          - <b>Input queue</b>, unidirectional queue where the writer is the
+ *            ISR side and the reader is the thread side.
+ *          - <b>Output queue</b>, unidirectional queue where the writer is the
+ *            thread side and the reader is the ISR side.
+ *          .
+ *          Both sides can work in zero-copy mode, a buffer is acquired,
+ *          filled or consumed in place and then committed or released.
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 /*===========================================================================*/
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum amount of data copied within a single critical zone.
+ * @details The bulk read and write functions copy data in chunks of this
+ *          size in order to not make the critical zones too long.
+ */
+#define BQ_MAX_CHUNK                        64U
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -40,47 +62,778 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Advances a buffer pointer to the next buffer in the queue.
+ *
+ * @param[in] bqp       pointer to an @p io_buffers_queue_t object
+ * @param[in] p         buffer pointer
+ * @return              The pointer to the next buffer.
+ *
+ * @notapi
+ */
+static uint8_t *bq_next(io_buffers_queue_t *bqp, uint8_t *p) {
+
+  p += bqp->bsize;
+  if (p >= bqp->btop) {
+    p = bqp->buffers;
+  }
+
+  return p;
+}
+
+/**
+ * @brief   Initializes the common part of a buffers queue.
+ *
+ * @param[out] bqp      pointer to an @p io_buffers_queue_t object
+ * @param[in] bp        pointer to a memory area allocated for buffers
+ * @param[in] size      buffers size
+ * @param[in] n         number of buffers
+ * @param[in] nfy       callback called when a buffer is released or posted
+ * @param[in] link      application defined pointer
+ *
+ * @notapi
+ */
+static void bq_object_init(io_buffers_queue_t *bqp, uint8_t *bp,
+                           size_t size, size_t n,
+                           bqnotify_t nfy, void *link) {
+
+  osalDbgCheck((bp != NULL) && (size >= 2U) && (n >= 1U));
+
+  osalThreadQueueObjectInit(&bqp->waiting);
+  bqp->bcounter = n;
+  bqp->brdptr   = bp;
+  bqp->bwrptr   = bp;
+  bqp->btop     = bp + ((size + sizeof (size_t)) * n);
+  bqp->bsize    = size + sizeof (size_t);
+  bqp->bn       = n;
+  bqp->buffers  = bp;
+  bqp->ptr      = NULL;
+  bqp->top      = NULL;
+  bqp->notify   = nfy;
+  bqp->link     = link;
+}
+
+/**
+ * @brief   Resets the common part of a buffers queue.
+ *
+ * @param[in] bqp       pointer to an @p io_buffers_queue_t object
+ *
+ * @iclass
+ */
+static void bq_reset_i(io_buffers_queue_t *bqp) {
+
+  osalDbgCheckClassI();
+
+  bqp->bcounter = bqp->bn;
+  bqp->brdptr   = bqp->buffers;
+  bqp->bwrptr   = bqp->buffers;
+  bqp->ptr      = NULL;
+  bqp->top      = NULL;
+  osalThreadDequeueAllI(&bqp->waiting, MSG_RESET);
+}
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
 
 /**
- * @brief   Initializes an I/O buffer object.
+ * @brief   Initializes an input buffers queue object.
  *
- * @param[out] iobp     pointer to the @p input_double_buffer_t object
- * @param[in] bp        pointer to a memory area allocated as buffer
- * @param[in] size      size of the buffers
+ * @param[out] ibqp     pointer to the @p input_buffers_queue_t object
+ * @param[in] bp        pointer to a memory area allocated for buffers,
+ *                      see @p BQ_BUFFER_SIZE()
+ * @param[in] size      buffers size
+ * @param[in] n         number of buffers
+ * @param[in] infy      callback called when a buffer is returned to the queue
+ * @param[in] link      application defined pointer
  *
  * @init
  */
-void iobInit(io_buffer_t *iobp, uint8_t *bp, size_t size) {
+void ibqObjectInit(input_buffers_queue_t *ibqp, uint8_t *bp,
+                   size_t size, size_t n,
+                   bqnotify_t infy, void *link) {
 
-  iobp->buffer = bp;
-  iobp->limit  = bp;
-  iobp->top    = bp + size;
+  bq_object_init(ibqp, bp, size, n, infy, link);
 }
 
 /**
- * @brief   Initializes an input double buffer object.
+ * @brief   Resets an input buffers queue.
+ * @details All the data in the input buffers queue is erased and lost, any
+ *          waiting thread is resumed with status @p MSG_RESET.
+ * @note    A reset operation can be used by a low level driver in order to
+ *          obtain immediate attention from the high level layers.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
  *
- * @param[out] idbp     pointer to the @p input_double_buffer_t object
- * @param[in] b1p       pointer to a memory area allocated as buffer 1
- * @param[in] b2p       pointer to a memory area allocated as buffer 2
- * @param[in] size      size of the buffers
+ * @iclass
+ */
+void ibqResetI(input_buffers_queue_t *ibqp) {
+
+  bq_reset_i(ibqp);
+}
+
+/**
+ * @brief   Gets the next empty buffer from the queue.
+ * @note    The function always returns the same buffer if called repeatedly.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @return              A pointer to the next buffer to be filled.
+ * @retval NULL         if the queue is full.
+ *
+ * @iclass
+ */
+uint8_t *ibqGetEmptyBufferI(input_buffers_queue_t *ibqp) {
+
+  osalDbgCheckClassI();
+
+  if (ibqIsFullI(ibqp)) {
+    return NULL;
+  }
+
+  return ibqp->bwrptr + sizeof (size_t);
+}
+
+/**
+ * @brief   Posts a new filled buffer to the queue.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] size      used size of the buffer, cannot be zero
+ *
+ * @iclass
+ */
+void ibqPostFullBufferI(input_buffers_queue_t *ibqp, size_t size) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((size > 0U) && (size <= (ibqp->bsize - sizeof (size_t))));
+  osalDbgAssert(!ibqIsFullI(ibqp), "buffers queue full");
+
+  /* Writing size field in the buffer.*/
+  *((size_t *)ibqp->bwrptr) = size;
+
+  /* Posting the buffer in the queue.*/
+  ibqp->bcounter--;
+  ibqp->bwrptr = bq_next(ibqp, ibqp->bwrptr);
+
+  /* Waking up one waiting thread, if any.*/
+  osalThreadDequeueNextI(&ibqp->waiting, MSG_OK);
+}
+
+/**
+ * @brief   Gets the next filled buffer from the queue.
+ * @note    The function always acquires the same buffer if called repeatedly.
+ * @post    After calling the function the fields @p ptr and @p top are set
+ *          at beginning and end of the buffer data or @p NULL if the queue
+ *          is empty.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a buffer has been acquired.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @api
+ */
+msg_t ibqGetFullBufferTimeout(input_buffers_queue_t *ibqp,
+                              systime_t timeout) {
+  msg_t msg;
+
+  osalSysLock();
+  msg = ibqGetFullBufferTimeoutS(ibqp, timeout);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Gets the next filled buffer from the queue.
+ * @note    The function always acquires the same buffer if called repeatedly.
+ * @post    After calling the function the fields @p ptr and @p top are set
+ *          at beginning and end of the buffer data or @p NULL if the queue
+ *          is empty.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a buffer has been acquired.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @sclass
+ */
+msg_t ibqGetFullBufferTimeoutS(input_buffers_queue_t *ibqp,
+                               systime_t timeout) {
+
+  osalDbgCheckClassS();
+
+  while (ibqIsEmptyI(ibqp)) {
+    msg_t msg = osalThreadEnqueueTimeoutS(&ibqp->waiting, timeout);
+    if (msg < MSG_OK) {
+      return msg;
+    }
+  }
+
+  /* Setting up the "current" buffer and its boundary.*/
+  ibqp->ptr = ibqp->brdptr + sizeof (size_t);
+  ibqp->top = ibqp->ptr + *((size_t *)ibqp->brdptr);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases the buffer back in the queue.
+ * @note    The object callback is called after releasing the buffer.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ *
+ * @api
+ */
+void ibqReleaseEmptyBuffer(input_buffers_queue_t *ibqp) {
+
+  osalSysLock();
+  ibqReleaseEmptyBufferS(ibqp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Releases the buffer back in the queue.
+ * @note    The object callback is called after releasing the buffer.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ *
+ * @sclass
+ */
+void ibqReleaseEmptyBufferS(input_buffers_queue_t *ibqp) {
+
+  osalDbgCheckClassS();
+  osalDbgAssert(!ibqIsEmptyI(ibqp), "buffers queue empty");
+
+  /* Freeing a buffer slot in the queue.*/
+  ibqp->bcounter++;
+  ibqp->brdptr = bq_next(ibqp, ibqp->brdptr);
+
+  /* No "current" buffer.*/
+  ibqp->ptr = NULL;
+
+  /* Notifying the buffer release.*/
+  if (ibqp->notify != NULL) {
+    ibqp->notify(ibqp);
+  }
+}
+
+/**
+ * @brief   Input queue read with timeout.
+ * @details This function reads a byte value from an input queue. If
+ *          the queue is empty then the calling thread is suspended until a
+ *          new buffer arrives in the queue or a timeout occurs.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A byte value from the queue.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @api
+ */
+msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, systime_t timeout) {
+  msg_t msg;
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (ibqp->ptr == NULL) {
+    msg = ibqGetFullBufferTimeoutS(ibqp, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+
+  /* Next byte from the buffer.*/
+  msg = (msg_t)*ibqp->ptr;
+  ibqp->ptr++;
+
+  /* If the current buffer has been fully read then it is returned as
+     empty in the queue.*/
+  if (ibqp->ptr >= ibqp->top) {
+    ibqReleaseEmptyBufferS(ibqp);
+  }
+
+  osalSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Input queue read with timeout.
+ * @details The function reads data from an input queue into a buffer.
+ *          The operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout or if the queue has
+ *          been reset.
+ * @note    The function is not atomic, if you need atomicity it is suggested
+ *          to use a semaphore or a mutex for mutual exclusion.
+ * @note    The data is copied out of the buffers in chunks of
+ *          @p BQ_MAX_CHUNK bytes, the system is unlocked between chunks.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
+                      size_t n, systime_t timeout) {
+  size_t r = 0;
+
+  osalDbgCheck(n > 0U);
+
+  osalSysLock();
+  while (true) {
+    size_t size;
+
+    /* This condition indicates that a new buffer must be acquired.*/
+    if (ibqp->ptr == NULL) {
+      if (ibqGetFullBufferTimeoutS(ibqp, timeout) != MSG_OK) {
+        osalSysUnlock();
+        return r;
+      }
+    }
+
+    /* Size of the data chunk present in the current buffer.*/
+    size = (size_t)(ibqp->top - ibqp->ptr);
+    if (size > (n - r)) {
+      size = n - r;
+    }
+    if (size > BQ_MAX_CHUNK) {
+      size = BQ_MAX_CHUNK;
+    }
+    memcpy(bp, ibqp->ptr, size);
+
+    bp += size;
+    r += size;
+    ibqp->ptr += size;
+
+    /* Buffer fully consumed.*/
+    if (ibqp->ptr >= ibqp->top) {
+      ibqReleaseEmptyBufferS(ibqp);
+    }
+
+    if (r >= n) {
+      osalSysUnlock();
+      return r;
+    }
+
+    /* Gives a preemption chance in a controlled point.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+}
+
+/**
+ * @brief   Initializes an output buffers queue object.
+ *
+ * @param[out] obqp     pointer to the @p output_buffers_queue_t object
+ * @param[in] bp        pointer to a memory area allocated for buffers,
+ *                      see @p BQ_BUFFER_SIZE()
+ * @param[in] size      buffers size
+ * @param[in] n         number of buffers
+ * @param[in] onfy      callback called when a buffer is posted in the queue
+ * @param[in] link      application defined pointer
  *
  * @init
  */
-void idbObjectInit(input_double_buffer_t *idbp,
-                   uint8_t *b1p, uint8_t *b2p, size_t size,
-                   dbnotify_t infy, void *link) {
-
-  iobInit(&idbp->buffers[0], b1p, size);
-  iobInit(&idbp->buffers[1], b2p, size);
-  idbp->counter = 0;
-  idbp->brdptr  = &idbp->buffers[0];
-  idbp->bwrptr  = &idbp->buffers[0];
-  idbp->notify  = infy;
-  idbp->link    = link;
+void obqObjectInit(output_buffers_queue_t *obqp, uint8_t *bp,
+                   size_t size, size_t n,
+                   bqnotify_t onfy, void *link) {
+
+  bq_object_init(obqp, bp, size, n, onfy, link);
+}
+
+/**
+ * @brief   Resets an output buffers queue.
+ * @details All the data in the output buffers queue is erased and lost, any
+ *          waiting thread is resumed with status @p MSG_RESET.
+ * @note    A reset operation can be used by a low level driver in order to
+ *          obtain immediate attention from the high level layers.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ *
+ * @iclass
+ */
+void obqResetI(output_buffers_queue_t *obqp) {
+
+  bq_reset_i(obqp);
+}
+
+/**
+ * @brief   Gets the next filled buffer from the queue.
+ * @note    The function always returns the same buffer if called repeatedly.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] sizep    pointer to the filled buffer size
+ * @return              A pointer to the filled buffer.
+ * @retval NULL         if the queue is empty.
+ *
+ * @iclass
+ */
+uint8_t *obqGetFullBufferI(output_buffers_queue_t *obqp,
+                           size_t *sizep) {
+
+  osalDbgCheckClassI();
+
+  if (obqIsEmptyI(obqp)) {
+    return NULL;
+  }
+
+  /* Buffer size.*/
+  *sizep = *((size_t *)obqp->brdptr);
+
+  return obqp->brdptr + sizeof (size_t);
+}
+
+/**
+ * @brief   Releases the next filled buffer back in the queue.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ *
+ * @iclass
+ */
+void obqReleaseEmptyBufferI(output_buffers_queue_t *obqp) {
+
+  osalDbgCheckClassI();
+  osalDbgAssert(!obqIsEmptyI(obqp), "buffers queue empty");
+
+  /* Freeing a buffer slot in the queue.*/
+  obqp->bcounter++;
+  obqp->brdptr = bq_next(obqp, obqp->brdptr);
+
+  /* Waking up one waiting thread, if any.*/
+  osalThreadDequeueNextI(&obqp->waiting, MSG_OK);
+}
+
+/**
+ * @brief   Gets the next empty buffer from the queue.
+ * @note    The function always acquires the same buffer if called repeatedly.
+ * @post    After calling the function the fields @p ptr and @p top are set
+ *          at beginning and end of the buffer data or @p NULL if the queue
+ *          is full.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a buffer has been acquired.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @api
+ */
+msg_t obqGetEmptyBufferTimeout(output_buffers_queue_t *obqp,
+                               systime_t timeout) {
+  msg_t msg;
+
+  osalSysLock();
+  msg = obqGetEmptyBufferTimeoutS(obqp, timeout);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Gets the next empty buffer from the queue.
+ * @note    The function always acquires the same buffer if called repeatedly.
+ * @post    After calling the function the fields @p ptr and @p top are set
+ *          at beginning and end of the buffer data or @p NULL if the queue
+ *          is full.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a buffer has been acquired.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @sclass
+ */
+msg_t obqGetEmptyBufferTimeoutS(output_buffers_queue_t *obqp,
+                                systime_t timeout) {
+
+  osalDbgCheckClassS();
+
+  while (obqIsFullI(obqp)) {
+    msg_t msg = osalThreadEnqueueTimeoutS(&obqp->waiting, timeout);
+    if (msg < MSG_OK) {
+      return msg;
+    }
+  }
+
+  /* Setting up the "current" buffer and its boundary.*/
+  obqp->ptr = obqp->bwrptr + sizeof (size_t);
+  obqp->top = obqp->bwrptr + obqp->bsize;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Posts a new filled buffer to the queue.
+ * @note    The object callback is called after posting the buffer.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] size      used size of the buffer, cannot be zero
+ *
+ * @api
+ */
+void obqPostFullBuffer(output_buffers_queue_t *obqp, size_t size) {
+
+  osalSysLock();
+  obqPostFullBufferS(obqp, size);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Posts a new filled buffer to the queue.
+ * @note    The object callback is called after posting the buffer.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] size      used size of the buffer, cannot be zero
+ *
+ * @sclass
+ */
+void obqPostFullBufferS(output_buffers_queue_t *obqp, size_t size) {
+
+  osalDbgCheckClassS();
+  osalDbgCheck((size > 0U) && (size <= (obqp->bsize - sizeof (size_t))));
+  osalDbgAssert(!obqIsFullI(obqp), "buffers queue full");
+
+  /* Writing size field in the buffer.*/
+  *((size_t *)obqp->bwrptr) = size;
+
+  /* Posting the buffer in the queue.*/
+  obqp->bcounter--;
+  obqp->bwrptr = bq_next(obqp, obqp->bwrptr);
+
+  /* No "current" buffer.*/
+  obqp->ptr = NULL;
+
+  /* Notifying the buffer release.*/
+  if (obqp->notify != NULL) {
+    obqp->notify(obqp);
+  }
+}
+
+/**
+ * @brief   Output queue write with timeout.
+ * @details This function writes a byte value to an output queue. If
+ *          the queue is full then the calling thread is suspended until a
+ *          new buffer is freed in the queue or a timeout occurs.
+ * @note    The buffer is posted when full, see @p obqFlush() for partially
+ *          filled buffers.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] b         byte value to be transferred
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the operation succeeded.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @api
+ */
+msg_t obqPutTimeout(output_buffers_queue_t *obqp, uint8_t b,
+                    systime_t timeout) {
+  msg_t msg;
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (obqp->ptr == NULL) {
+    msg = obqGetEmptyBufferTimeoutS(obqp, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+
+  /* Writing the byte to the buffer.*/
+  *obqp->ptr = b;
+  obqp->ptr++;
+
+  /* If the current buffer has been fully written then it is posted as
+     full in the queue.*/
+  if (obqp->ptr >= obqp->top) {
+    obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+  }
+
+  osalSysUnlock();
+  return MSG_OK;
+}
+
+/**
+ * @brief   Output queue write with timeout.
+ * @details The function writes data from a buffer to an output queue. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout or if the queue has
+ *          been reset.
+ * @note    The function is not atomic, if you need atomicity it is suggested
+ *          to use a semaphore or a mutex for mutual exclusion.
+ * @note    The data is copied into the buffers in chunks of
+ *          @p BQ_MAX_CHUNK bytes, the system is unlocked between chunks.
+ *          The last buffer is posted only when full, see @p obqFlush()
+ *          for partially filled buffers.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
+                       size_t n, systime_t timeout) {
+  size_t w = 0;
+
+  osalDbgCheck(n > 0U);
+
+  osalSysLock();
+  while (true) {
+    size_t size;
+
+    /* This condition indicates that a new buffer must be acquired.*/
+    if (obqp->ptr == NULL) {
+      if (obqGetEmptyBufferTimeoutS(obqp, timeout) != MSG_OK) {
+        osalSysUnlock();
+        return w;
+      }
+    }
+
+    /* Size of the space available in the current buffer. The copy is
+       performed inside the critical zone because a partially filled
+       buffer can be flushed from ISR context, see obqTryFlushI().*/
+    size = (size_t)(obqp->top - obqp->ptr);
+    if (size > (n - w)) {
+      size = n - w;
+    }
+    if (size > BQ_MAX_CHUNK) {
+      size = BQ_MAX_CHUNK;
+    }
+    memcpy(obqp->ptr, bp, size);
+
+    bp += size;
+    w += size;
+    obqp->ptr += size;
+
+    /* Buffer fully written.*/
+    if (obqp->ptr >= obqp->top) {
+      obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+    }
+
+    if (w >= n) {
+      osalSysUnlock();
+      return w;
+    }
+
+    /* Gives a preemption chance in a controlled point.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+}
+
+/**
+ * @brief   Flushes the current, partially filled, buffer to the queue.
+ * @note    The notification callback is not invoked because the function
+ *          is meant to be called from ISR context. An operation status is
+ *          returned instead.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @return              The operation status.
+ * @retval false        if no new filled buffer has been posted to the queue.
+ * @retval true         if a new filled buffer has been posted to the queue.
+ *
+ * @iclass
+ */
+bool obqTryFlushI(output_buffers_queue_t *obqp) {
+
+  osalDbgCheckClassI();
+
+  /* If queue is empty and there is a buffer partially filled and
+     it is not being written.*/
+  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL)) {
+    size_t size = (size_t)(obqp->ptr - (obqp->bwrptr + sizeof (size_t)));
+
+    if (size > 0U) {
+
+      /* Writing size field in the buffer.*/
+      *((size_t *)obqp->bwrptr) = size;
+
+      /* Posting the buffer in the queue.*/
+      obqp->bcounter--;
+      obqp->bwrptr = bq_next(obqp, obqp->bwrptr);
+
+      /* No "current" buffer.*/
+      obqp->ptr = NULL;
+
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief   Flushes the current, partially filled, buffer to the queue.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ *
+ * @api
+ */
+void obqFlush(output_buffers_queue_t *obqp) {
+
+  osalSysLock();
+
+  /* If there is a buffer partially filled and not being written.*/
+  if (obqp->ptr != NULL) {
+    size_t size = (size_t)(obqp->ptr - (obqp->bwrptr + sizeof (size_t)));
+
+    if (size > 0U) {
+      obqPostFullBufferS(obqp, size);
+    }
+  }
+
+  osalSysUnlock();
 }
 
 /** @} */
@@ -37,6 +37,13 @@
 
 #include "hal.h"
 
+/**
+ * @brief   Maximum amount of data copied within a single critical zone.
+ * @details The gather write copies data in chunks of this size in order to
+ *          not make the critical zones too long.
+ */
+#define Q_MAX_CHUNK                         64U
+
 #if !defined(_CHIBIOS_RT_) || (CH_CFG_USE_QUEUES == FALSE) ||               \
     defined(__DOXYGEN__)
 
@@ -66,6 +73,8 @@ void iqObjectInit(input_queue_t *iqp, uint8_t *bp, size_t size,
   iqp->q_top     = bp + size;
   iqp->q_notify  = infy;
   iqp->q_link    = link;
+  iqp->q_watermark = 1U;
+  iqp->q_wakeup  = 1U;
 }
 
 /**
@@ -89,6 +98,31 @@ void iqResetI(input_queue_t *iqp) {
   osalThreadDequeueAllI(&iqp->q_waiting, Q_RESET);
 }
 
+/**
+ * @brief   Sets the wakeup watermark of an input queue.
+ * @details A thread blocked in @p iqReadTimeout() is only resumed when
+ *          the queue holds at least @p n bytes, or the number of bytes
+ *          still to be read if smaller, instead of on every byte. This
+ *          reduces the context switches on bursty streams.
+ * @note    The default watermark is one, the legacy behavior.
+ * @note    The timeout of @p iqReadTimeout() is applied to each wait
+ *          for the watermark, the data already in the queue is returned
+ *          when it expires.
+ * @note    The watermark is meant for queues with a single reader thread.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         the new watermark, from one to the queue size
+ *
+ * @iclass
+ */
+void iqSetWatermarkI(input_queue_t *iqp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((n > 0U) && (n <= qSizeX(iqp)));
+
+  iqp->q_watermark = n;
+}
+
 /**
  * @brief   Input queue write.
  * @details A byte value is written into the low end of an input queue.
@@ -116,7 +150,10 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
     iqp->q_wrptr = iqp->q_buffer;
   }
 
-  osalThreadDequeueNextI(&iqp->q_waiting, Q_OK);
+  /* The reader is only woken when its watermark is reached.*/
+  if (iqp->q_counter >= iqp->q_wakeup) {
+    osalThreadDequeueNextI(&iqp->q_waiting, Q_OK);
+  }
 
   return Q_OK;
 }
@@ -150,7 +187,10 @@ msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
   }
 
   while (iqIsEmptyI(iqp)) {
-    msg_t msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
+    msg_t msg;
+
+    iqp->q_wakeup = 1U;
+    msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
     if (msg < Q_OK) {
       osalSysUnlock();
       return msg;
@@ -194,7 +234,8 @@ msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
 size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
                      size_t n, systime_t timeout) {
   qnotify_t nfy = iqp->q_notify;
-  size_t r = 0;
+  size_t r = 0, wm;
+  bool expired = false;
 
   osalDbgCheck(n > 0U);
 
@@ -204,8 +245,18 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
       nfy(iqp);
     }
 
-    while (iqIsEmptyI(iqp)) {
-      if (osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout) != Q_OK) {
+    /* When the queue is empty then waiting for the watermark or for the
+       remaining data, whichever is smaller. After a timeout the data
+       already in the queue is still returned.*/
+    if (iqIsEmptyI(iqp)) {
+      wm = n < iqp->q_watermark ? n : iqp->q_watermark;
+      while (!expired && (qSpaceI(iqp) < wm)) {
+        iqp->q_wakeup = wm;
+        if (osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout) != Q_OK) {
+          expired = true;
+        }
+      }
+      if (iqIsEmptyI(iqp)) {
         osalSysUnlock();
         return r;
       }
@@ -253,6 +304,8 @@ void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
   oqp->q_top     = bp + size;
   oqp->q_notify  = onfy;
   oqp->q_link    = link;
+  oqp->q_watermark = 1U;
+  oqp->q_wakeup  = 1U;
 }
 
 /**
@@ -276,6 +329,31 @@ void oqResetI(output_queue_t *oqp) {
   osalThreadDequeueAllI(&oqp->q_waiting, Q_RESET);
 }
 
+/**
+ * @brief   Sets the wakeup watermark of an output queue.
+ * @details A thread blocked in @p oqWriteTimeout() is only resumed when
+ *          the queue has at least @p n free bytes, or the number of bytes
+ *          still to be written if smaller, instead of on every byte. This
+ *          reduces the context switches on bursty streams.
+ * @note    The default watermark is one, the legacy behavior.
+ * @note    The timeout of @p oqWriteTimeout() is applied to each wait
+ *          for the watermark, the space already available is used when
+ *          it expires.
+ * @note    The watermark is meant for queues with a single writer thread.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         the new watermark, from one to the queue size
+ *
+ * @iclass
+ */
+void oqSetWatermarkI(output_queue_t *oqp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((n > 0U) && (n <= qSizeX(oqp)));
+
+  oqp->q_watermark = n;
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details This function writes a byte value to an output queue. If the queue
@@ -302,7 +380,10 @@ msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
 
   osalSysLock();
   while (oqIsFullI(oqp)) {
-    msg_t msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout);
+    msg_t msg;
+
+    oqp->q_wakeup = 1U;
+    msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout);
     if (msg < Q_OK) {
       osalSysUnlock();
       return msg;
@@ -348,11 +429,46 @@ msg_t oqGetI(output_queue_t *oqp) {
     oqp->q_rdptr = oqp->q_buffer;
   }
 
-  osalThreadDequeueNextI(&oqp->q_waiting, Q_OK);
+  /* The writer is only woken when its watermark is reached.*/
+  if (oqp->q_counter >= oqp->q_wakeup) {
+    osalThreadDequeueNextI(&oqp->q_waiting, Q_OK);
+  }
 
   return (msg_t)b;
 }
 
+/**
+ * @brief   Output queue non-blocking write.
+ * @details The function writes data from a buffer to an output queue, as
+ *          much data as the free space allows is written without waiting.
+ * @note    The callback is not invoked, this way several buffers can be
+ *          written before notifying the consumer once.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is allowed
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t oqWriteI(output_queue_t *oqp, const uint8_t *bp, size_t n) {
+  size_t w = 0;
+
+  osalDbgCheckClassI();
+
+  while ((w < n) && !oqIsFullI(oqp)) {
+    oqp->q_counter--;
+    *oqp->q_wrptr++ = *bp++;
+    if (oqp->q_wrptr >= oqp->q_top) {
+      oqp->q_wrptr = oqp->q_buffer;
+    }
+    w++;
+  }
+
+  return w;
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details The function writes data from a buffer to an output queue. The
@@ -380,14 +496,25 @@ msg_t oqGetI(output_queue_t *oqp) {
 size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                       size_t n, systime_t timeout) {
   qnotify_t nfy = oqp->q_notify;
-  size_t w = 0;
+  size_t w = 0, wm;
+  bool expired = false;
 
   osalDbgCheck(n > 0U);
 
   osalSysLock();
   while (true) {
-    while (oqIsFullI(oqp)) {
-      if (osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout) != Q_OK) {
+    /* When the queue is full then waiting for the watermark or for the
+       space for the remaining data, whichever is smaller. After a timeout
+       the space already available is still used.*/
+    if (oqIsFullI(oqp)) {
+      wm = n < oqp->q_watermark ? n : oqp->q_watermark;
+      while (!expired && (qSpaceI(oqp) < wm)) {
+        oqp->q_wakeup = wm;
+        if (osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout) != Q_OK) {
+          expired = true;
+        }
+      }
+      if (oqIsFullI(oqp)) {
         osalSysUnlock();
         return w;
       }
@@ -414,4 +541,81 @@ size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
 
 #endif /* !defined(_CHIBIOS_RT_) || (CH_USE_QUEUES == FALSE) */
 
+/*
+ * The following functions are implemented on top of the queues API, both
+ * the HAL and the ChibiOS queues are supported.
+ */
+
+/**
+ * @brief   Output queue gather write with timeout.
+ * @details The fragments are copied into the queue in chunks of
+ *          @p Q_MAX_CHUNK bytes, a chunk can span several fragments and the
+ *          system is unlocked between chunks. If the queue becomes full the
+ *          rest of the fragment is written as @p oqWriteTimeout() does.
+ *          The operation completes when all the data has been transferred
+ *          or if a wait for space times out or if the queue has been reset.
+ * @note    The timeout applies to each wait for space in the queue, not to
+ *          the whole operation, a slow reader can make it last longer.
+ * @note    The callback is invoked once after writing all the fragments
+ *          into the buffer, or before waiting if the queue becomes full.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] iov       pointer to the array of fragments
+ * @param[in] cnt       number of fragments in the array
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t oqWriteVTimeout(output_queue_t *oqp, const stream_iovec_t *iov,
+                       size_t cnt, systime_t timeout) {
+  qnotify_t nfy = oqp->q_notify;
+  const uint8_t *bp;
+  size_t i, n, m, w, total = 0, room = Q_MAX_CHUNK;
+
+  osalSysLock();
+  for (i = 0; i < cnt; i++) {
+    bp = iov[i].bp;
+    n  = iov[i].n;
+    while (n > 0U) {
+      if (room == 0U) {
+        osalSysUnlock(); /* Gives a preemption chance in a controlled point.*/
+        osalSysLock();
+        room = Q_MAX_CHUNK;
+      }
+      m = n < room ? n : room;
+      w = oqWriteI(oqp, bp, m);
+      total += w;
+      bp    += w;
+      n     -= w;
+      room  -= w;
+      if (w < m) {
+        /* The queue is full, waiting for space outside the critical zone.*/
+        if (nfy != NULL) {
+          nfy(oqp);
+        }
+        osalSysUnlock();
+        w = oqWriteTimeout(oqp, bp, n, timeout);
+        total += w;
+        if (w < n) {
+          return total;
+        }
+        osalSysLock();
+        n    = 0U;
+        room = Q_MAX_CHUNK;
+      }
+    }
+  }
+  if ((total > 0U) && (nfy != NULL)) {
+    nfy(oqp);
+  }
+  osalSysUnlock();
+
+  return total;
+}
+
 /** @} */
@@ -93,6 +93,7 @@ void i2cObjectInit(I2CDriver *i2cp) {
 void i2cStart(I2CDriver *i2cp, const I2CConfig *config) {
 
   osalDbgCheck((i2cp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_I2C, i2cInit);
   osalDbgAssert((i2cp->state == I2C_STOP) || (i2cp->state == I2C_READY) ||
                 (i2cp->state == I2C_LOCKED), "invalid state");
 
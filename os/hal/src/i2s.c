@@ -82,6 +82,7 @@ void i2sObjectInit(I2SDriver *i2sp) {
 void i2sStart(I2SDriver *i2sp, const I2SConfig *config) {
 
   osalDbgCheck((i2sp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_I2S, i2sInit);
 
   osalSysLock();
   osalDbgAssert((i2sp->state == I2S_STOP) || (i2sp->state == I2S_READY),
@@ -82,6 +82,7 @@ void icuObjectInit(ICUDriver *icup) {
 void icuStart(ICUDriver *icup, const ICUConfig *config) {
 
   osalDbgCheck((icup != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_ICU, icuInit);
 
   osalSysLock();
   osalDbgAssert((icup->state == ICU_STOP) || (icup->state == ICU_READY),
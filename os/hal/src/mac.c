@@ -95,6 +95,7 @@ void macObjectInit(MACDriver *macp) {
 void macStart(MACDriver *macp, const MACConfig *config) {
 
   osalDbgCheck((macp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_MAC, macInit);
 
   osalSysLock();
   osalDbgAssert(macp->state == MAC_STOP,
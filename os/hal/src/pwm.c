@@ -89,6 +89,7 @@ void pwmObjectInit(PWMDriver *pwmp) {
 void pwmStart(PWMDriver *pwmp, const PWMConfig *config) {
 
   osalDbgCheck((pwmp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_PWM, pwmInit);
 
   osalSysLock();
   osalDbgAssert((pwmp->state == PWM_STOP) || (pwmp->state == PWM_READY),
@@ -572,6 +572,7 @@ void sdcObjectInit(SDCDriver *sdcp) {
 void sdcStart(SDCDriver *sdcp, const SDCConfig *config) {
 
   osalDbgCheck(sdcp != NULL);
+  halLazyInit(HAL_DRV_SDC, sdcInit);
 
   osalSysLock();
   osalDbgAssert((sdcp->state == BLK_STOP) || (sdcp->state == BLK_ACTIVE),
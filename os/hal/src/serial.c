@@ -69,6 +69,12 @@ static msg_t get(void *ip) {
   return iqGetTimeout(&((SerialDriver *)ip)->iqueue, TIME_INFINITE);
 }
 
+static size_t writev(void *ip, const stream_iovec_t *iov, size_t cnt) {
+
+  return oqWriteVTimeout(&((SerialDriver *)ip)->oqueue, iov,
+                         cnt, TIME_INFINITE);
+}
+
 static msg_t putt(void *ip, uint8_t b, systime_t timeout) {
 
   return oqPutTimeout(&((SerialDriver *)ip)->oqueue, b, timeout);
@@ -90,10 +96,20 @@ static size_t readt(void *ip, uint8_t *bp, size_t n, systime_t timeout) {
 }
 
 static const struct SerialDriverVMT vmt = {
-  write, read, put, get,
+  write, read, put, get, writev,
   putt, gett, writet, readt
 };
 
+#if (SERIAL_USE_FRAMES == TRUE) || defined(__DOXYGEN__)
+static void frames_reset(SerialDriver *sdp) {
+
+  sdp->frame_rx    = (size_t)0;
+  sdp->frame_want  = (size_t)0;
+  sdp->frame_first = 0U;
+  sdp->frame_count = 0U;
+}
+#endif
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -132,6 +148,10 @@ void sdObjectInit(SerialDriver *sdp, qnotify_t inotify, qnotify_t onotify) {
   sdp->state = SD_STOP;
   iqObjectInit(&sdp->iqueue, sdp->ib, SERIAL_BUFFERS_SIZE, inotify, sdp);
   oqObjectInit(&sdp->oqueue, sdp->ob, SERIAL_BUFFERS_SIZE, onotify, sdp);
+#if SERIAL_USE_FRAMES == TRUE
+  osalThreadQueueObjectInit(&sdp->fqueue);
+  frames_reset(sdp);
+#endif
 }
 
 /**
@@ -147,6 +167,7 @@ void sdObjectInit(SerialDriver *sdp, qnotify_t inotify, qnotify_t onotify) {
 void sdStart(SerialDriver *sdp, const SerialConfig *config) {
 
   osalDbgCheck(sdp != NULL);
+  halLazyInit(HAL_DRV_SERIAL, sdInit);
 
   osalSysLock();
   osalDbgAssert((sdp->state == SD_STOP) || (sdp->state == SD_READY),
@@ -176,6 +197,10 @@ void sdStop(SerialDriver *sdp) {
   sdp->state = SD_STOP;
   oqResetI(&sdp->oqueue);
   iqResetI(&sdp->iqueue);
+#if SERIAL_USE_FRAMES == TRUE
+  frames_reset(sdp);
+  osalThreadDequeueAllI(&sdp->fqueue, MSG_RESET);
+#endif
   osalOsRescheduleS();
   osalSysUnlock();
 }
@@ -189,7 +214,9 @@ void sdStop(SerialDriver *sdp) {
  *          becomes non-empty.
  * @note    In order to gain some performance it is suggested to not use
  *          this function directly but copy this code directly into the
- *          interrupt service routine.
+ *          interrupt service routine, this does not apply when
+ *          @p SERIAL_USE_FRAMES is enabled because the frame accounting
+ *          is done here.
  *
  * @param[in] sdp       pointer to a @p SerialDriver structure
  * @param[in] b         the byte to be written in the driver's Input Queue
@@ -203,8 +230,20 @@ void sdIncomingDataI(SerialDriver *sdp, uint8_t b) {
 
   if (iqIsEmptyI(&sdp->iqueue))
     chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
-  if (iqPutI(&sdp->iqueue, b) < Q_OK)
+  if (iqPutI(&sdp->iqueue, b) < Q_OK) {
     chnAddFlagsI(sdp, SD_OVERRUN_ERROR);
+    return;
+  }
+
+#if SERIAL_USE_FRAMES == TRUE
+  /* The reader is only woken when its bytes count is reached, not on
+     each byte.*/
+  sdp->frame_rx++;
+  if ((sdp->frame_want > (size_t)0) && (sdp->frame_rx >= sdp->frame_want)) {
+    sdp->frame_want = (size_t)0;
+    osalThreadDequeueNextI(&sdp->fqueue, MSG_OK);
+  }
+#endif
 }
 
 /**
@@ -284,6 +323,117 @@ bool sdGetWouldBlock(SerialDriver *sdp) {
   return b;
 }
 
+#if (SERIAL_USE_FRAMES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Handles the end of a received frame.
+ * @details This function must be called from the interrupt service routine
+ *          when an idle line condition is detected. The bytes received
+ *          since the previous frame end are marked as a complete frame,
+ *          @p CHN_FRAME_END is broadcast and the waiting reader is woken.
+ * @note    An idle line without data in between is ignored.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ *
+ * @iclass
+ */
+void sdFrameEndI(SerialDriver *sdp) {
+  unsigned i;
+
+  osalDbgCheckClassI();
+  osalDbgCheck(sdp != NULL);
+
+  if (sdp->frame_rx == (size_t)0) {
+    return;
+  }
+
+  if (sdp->frame_count < (unsigned)SERIAL_FRAMES_NUMBER) {
+    i = (sdp->frame_first + sdp->frame_count) % (unsigned)SERIAL_FRAMES_NUMBER;
+    sdp->frames[i] = sdp->frame_rx;
+    sdp->frame_count++;
+  }
+  else {
+    /* No room, merged with the newest frame.*/
+    i = (sdp->frame_first + sdp->frame_count - 1U) %
+        (unsigned)SERIAL_FRAMES_NUMBER;
+    sdp->frames[i] += sdp->frame_rx;
+  }
+  sdp->frame_rx = (size_t)0;
+
+  chnAddFlagsI(sdp, CHN_FRAME_END);
+  if (sdp->frame_want > (size_t)0) {
+    sdp->frame_want = (size_t)0;
+    osalThreadDequeueNextI(&sdp->fqueue, MSG_OK);
+  }
+}
+
+/**
+ * @brief   Frame read with timeout.
+ * @details The function waits until a complete frame or @p n bytes of the
+ *          frame being received are in the input queue, the caller is
+ *          woken once instead of once per byte. Then up to @p n bytes of
+ *          the oldest frame are read, a frame longer than @p n is returned
+ *          by multiple calls.
+ * @pre     There must be a single reader and it must not use any other
+ *          read function, the frames boundaries would be lost.
+ * @note    Bytes lost to an input queue overrun are not part of the frame,
+ *          @p SD_OVERRUN_ERROR is broadcast in that case.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         maximum number of bytes to be read, it should not
+ *                      exceed the input queue size else a frame longer than
+ *                      the queue is only returned after its end
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes read, less than @p n if the end
+ *                      of the frame has been reached.
+ * @retval 0            if a timeout occurred or the driver has been
+ *                      stopped, no data is consumed.
+ *
+ * @api
+ */
+size_t sdReadFrameTimeout(SerialDriver *sdp, uint8_t *bp, size_t n,
+                          systime_t timeout) {
+  size_t *lenp;
+
+  osalDbgCheck((sdp != NULL) && (bp != NULL) && (n > (size_t)0));
+
+  osalSysLock();
+  while ((sdp->frame_count == 0U) && (sdp->frame_rx < n)) {
+    sdp->frame_want = n;
+    if (osalThreadEnqueueTimeoutS(&sdp->fqueue, timeout) != MSG_OK) {
+      sdp->frame_want = (size_t)0;
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  /* Accounting the bytes as consumed, they cannot go away because there
+     is a single reader.*/
+  if (sdp->frame_count > 0U) {
+    lenp = &sdp->frames[sdp->frame_first];
+    if (*lenp <= n) {
+      n = *lenp;
+      sdp->frame_first = (sdp->frame_first + 1U) %
+                         (unsigned)SERIAL_FRAMES_NUMBER;
+      sdp->frame_count--;
+    }
+    else {
+      *lenp -= n;
+    }
+  }
+  else {
+    sdp->frame_rx -= n;
+  }
+  osalSysUnlock();
+
+  return iqReadTimeout(&sdp->iqueue, bp, n, TIME_IMMEDIATE);
+}
+#endif /* SERIAL_USE_FRAMES == TRUE */
+
 #endif /* HAL_USE_SERIAL == TRUE */
 
 /** @} */
@@ -50,6 +50,7 @@ static cdc_linecoding_t linecoding = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SERIAL_USB_PACKET_MODE == FALSE) || defined(__DOXYGEN__)
 /*
  * Interface implementation.
  */
@@ -88,6 +89,15 @@ static msg_t get(void *ip) {
   return iqGetTimeout(&((SerialUSBDriver *)ip)->iqueue, TIME_INFINITE);
 }
 
+static size_t writev(void *ip, const stream_iovec_t *iov, size_t cnt) {
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return 0;
+
+  return oqWriteVTimeout(&((SerialUSBDriver *)ip)->oqueue, iov,
+                         cnt, TIME_INFINITE);
+}
+
 static msg_t putt(void *ip, uint8_t b, systime_t timeout) {
 
   if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
@@ -121,7 +131,7 @@ static size_t readt(void *ip, uint8_t *bp, size_t n, systime_t timeout) {
 }
 
 static const struct SerialUSBDriverVMT vmt = {
-  write, read, put, get,
+  write, read, put, get, writev,
   putt, gett, writet, readt
 };
 
@@ -192,6 +202,244 @@ static void onotify(io_queue_t *qp) {
   }
 }
 
+#else /* SERIAL_USB_PACKET_MODE == TRUE */
+/**
+ * @brief   Checks if transactions can be started.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @return              The driver status.
+ * @retval true         if the USB driver is active and the driver ready.
+ */
+static bool sdu_ready_i(SerialUSBDriver *sdup) {
+
+  return (sdup->state == SDU_READY) &&
+         (usbGetDriverStateI(sdup->config->usbp) == USB_ACTIVE);
+}
+
+/**
+ * @brief   Starts a receive transaction into the next empty buffer.
+ * @details Nothing is done if a transaction is already ongoing or if all
+ *          the buffers are full.
+ * @note    Must be called with the system locked, from thread or ISR
+ *          context.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ */
+static void sdu_start_receive(SerialUSBDriver *sdup) {
+  USBDriver *usbp = sdup->config->usbp;
+  uint8_t *buf;
+
+  if (usbGetReceiveStatusI(usbp, sdup->config->bulk_out)) {
+    return;
+  }
+
+  buf = ibqGetEmptyBufferI(&sdup->ibqueue);
+  if (buf != NULL) {
+    usbPrepareReceive(usbp, sdup->config->bulk_out,
+                      buf, SERIAL_USB_BUFFERS_SIZE);
+    (void) usbStartReceiveI(usbp, sdup->config->bulk_out);
+  }
+}
+
+/**
+ * @brief   Starts a transmit transaction from the next filled buffer.
+ * @details Nothing is done if a transaction is already ongoing. If there
+ *          are no filled buffers and @p flush is @p true then a partially
+ *          filled buffer is posted and transmitted, this way the data
+ *          written while the endpoint is busy is sent in a single
+ *          transaction as soon as the endpoint becomes idle.
+ * @note    Must be called with the system locked, from thread or ISR
+ *          context.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] flush     also transmit a partially filled buffer
+ * @return              The operation status.
+ * @retval true         if a transaction has been started.
+ */
+static bool sdu_start_transmit(SerialUSBDriver *sdup, bool flush) {
+  USBDriver *usbp = sdup->config->usbp;
+  uint8_t *buf;
+  size_t n;
+
+  if (usbGetTransmitStatusI(usbp, sdup->config->bulk_in)) {
+    return false;
+  }
+
+  buf = obqGetFullBufferI(&sdup->obqueue, &n);
+  if ((buf == NULL) && flush && obqTryFlushI(&sdup->obqueue)) {
+    buf = obqGetFullBufferI(&sdup->obqueue, &n);
+  }
+  if (buf == NULL) {
+    return false;
+  }
+
+  usbPrepareTransmit(usbp, sdup->config->bulk_in, buf, n);
+  (void) usbStartTransmitI(usbp, sdup->config->bulk_in);
+
+  return true;
+}
+
+/**
+ * @brief   Transmits the data left in a partially filled buffer.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ */
+static void sdu_flush(SerialUSBDriver *sdup) {
+
+  osalSysLock();
+  if (sdu_ready_i(sdup)) {
+    (void) sdu_start_transmit(sdup, true);
+  }
+  osalSysUnlock();
+}
+
+/*
+ * Interface implementation.
+ */
+
+static size_t write(void *ip, const uint8_t *bp, size_t n) {
+  size_t w;
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return 0;
+
+  w = obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, bp,
+                      n, TIME_INFINITE);
+  sdu_flush((SerialUSBDriver *)ip);
+
+  return w;
+}
+
+static size_t read(void *ip, uint8_t *bp, size_t n) {
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return 0;
+
+  return ibqReadTimeout(&((SerialUSBDriver *)ip)->ibqueue, bp,
+                        n, TIME_INFINITE);
+}
+
+static msg_t put(void *ip, uint8_t b) {
+  msg_t msg;
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return MSG_RESET;
+
+  msg = obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, TIME_INFINITE);
+  sdu_flush((SerialUSBDriver *)ip);
+
+  return msg;
+}
+
+static msg_t get(void *ip) {
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return MSG_RESET;
+
+  return ibqGetTimeout(&((SerialUSBDriver *)ip)->ibqueue, TIME_INFINITE);
+}
+
+/*
+ * The fragments are flushed once, at the end, this way a frame written
+ * in pieces while the endpoint is idle is not split in several packets.
+ */
+static size_t writev(void *ip, const stream_iovec_t *iov, size_t cnt) {
+  size_t i, w, total = 0;
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return 0;
+
+  for (i = 0; i < cnt; i++) {
+    if (iov[i].n > 0U) {
+      w = obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, iov[i].bp,
+                          iov[i].n, TIME_INFINITE);
+      total += w;
+      if (w < iov[i].n) {
+        break;
+      }
+    }
+  }
+  sdu_flush((SerialUSBDriver *)ip);
+
+  return total;
+}
+
+static msg_t putt(void *ip, uint8_t b, systime_t timeout) {
+  msg_t msg;
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return MSG_RESET;
+
+  msg = obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, timeout);
+  sdu_flush((SerialUSBDriver *)ip);
+
+  return msg;
+}
+
+static msg_t gett(void *ip, systime_t timeout) {
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return MSG_RESET;
+
+  return ibqGetTimeout(&((SerialUSBDriver *)ip)->ibqueue, timeout);
+}
+
+static size_t writet(void *ip, const uint8_t *bp, size_t n, systime_t timeout) {
+  size_t w;
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return 0;
+
+  w = obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, bp, n, timeout);
+  sdu_flush((SerialUSBDriver *)ip);
+
+  return w;
+}
+
+static size_t readt(void *ip, uint8_t *bp, size_t n, systime_t timeout) {
+
+  if (usbGetDriverStateI(((SerialUSBDriver *)ip)->config->usbp) != USB_ACTIVE)
+    return 0;
+
+  return ibqReadTimeout(&((SerialUSBDriver *)ip)->ibqueue, bp, n, timeout);
+}
+
+static const struct SerialUSBDriverVMT vmt = {
+  write, read, put, get, writev,
+  putt, gett, writet, readt
+};
+
+/**
+ * @brief   Notification of a buffer released by the input buffers queue.
+ *
+ * @param[in] bqp       the buffers queue pointer.
+ */
+static void ibnotify(io_buffers_queue_t *bqp) {
+  SerialUSBDriver *sdup = bqGetLinkX(bqp);
+
+  /* If the USB driver is not in the appropriate state then transactions
+     must not be started.*/
+  if (sdu_ready_i(sdup)) {
+    sdu_start_receive(sdup);
+  }
+}
+
+/**
+ * @brief   Notification of a buffer posted into the output buffers queue.
+ *
+ * @param[in] bqp       the buffers queue pointer.
+ */
+static void obnotify(io_buffers_queue_t *bqp) {
+  SerialUSBDriver *sdup = bqGetLinkX(bqp);
+
+  /* If the USB driver is not in the appropriate state then transactions
+     must not be started.*/
+  if (sdu_ready_i(sdup)) {
+    (void) sdu_start_transmit(sdup, false);
+  }
+}
+#endif /* SERIAL_USB_PACKET_MODE == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -220,8 +468,15 @@ void sduObjectInit(SerialUSBDriver *sdup) {
   sdup->vmt = &vmt;
   osalEventObjectInit(&sdup->event);
   sdup->state = SDU_STOP;
+#if SERIAL_USB_PACKET_MODE == FALSE
   iqObjectInit(&sdup->iqueue, sdup->ib, SERIAL_USB_BUFFERS_SIZE, inotify, sdup);
   oqObjectInit(&sdup->oqueue, sdup->ob, SERIAL_USB_BUFFERS_SIZE, onotify, sdup);
+#else
+  ibqObjectInit(&sdup->ibqueue, sdup->ib, SERIAL_USB_BUFFERS_SIZE,
+                SERIAL_USB_BUFFERS_NUMBER, ibnotify, sdup);
+  obqObjectInit(&sdup->obqueue, sdup->ob, SERIAL_USB_BUFFERS_SIZE,
+                SERIAL_USB_BUFFERS_NUMBER, obnotify, sdup);
+#endif
 }
 
 /**
@@ -295,8 +550,13 @@ void sduDisconnectI(SerialUSBDriver *sdup) {
 
   /* Queues reset in order to signal the driver stop to the application.*/
   chnAddFlagsI(sdup, CHN_DISCONNECTED);
+#if SERIAL_USB_PACKET_MODE == FALSE
   iqResetI(&sdup->iqueue);
   iqResetI(&sdup->oqueue);
+#else
+  ibqResetI(&sdup->ibqueue);
+  obqResetI(&sdup->obqueue);
+#endif
 }
 
 /**
@@ -309,6 +569,7 @@ void sduDisconnectI(SerialUSBDriver *sdup) {
 void sduConfigureHookI(SerialUSBDriver *sdup) {
   USBDriver *usbp = sdup->config->usbp;
 
+#if SERIAL_USB_PACKET_MODE == FALSE
   iqResetI(&sdup->iqueue);
   oqResetI(&sdup->oqueue);
   chnAddFlagsI(sdup, CHN_CONNECTED);
@@ -317,6 +578,18 @@ void sduConfigureHookI(SerialUSBDriver *sdup) {
   usbPrepareQueuedReceive(usbp, sdup->config->bulk_out, &sdup->iqueue,
                           usbp->epc[sdup->config->bulk_out]->out_maxsize);
   (void) usbStartReceiveI(usbp, sdup->config->bulk_out);
+#else
+  osalDbgAssert((SERIAL_USB_BUFFERS_SIZE %
+                 usbp->epc[sdup->config->bulk_out]->out_maxsize) == 0U,
+                "buffers size not a multiple of the packet size");
+
+  ibqResetI(&sdup->ibqueue);
+  obqResetI(&sdup->obqueue);
+  chnAddFlagsI(sdup, CHN_CONNECTED);
+
+  /* Starts the first OUT transaction immediately.*/
+  sdu_start_receive(sdup);
+#endif
 }
 
 /**
@@ -374,6 +647,25 @@ void sduDataTransmitted(USBDriver *usbp, usbep_t ep) {
   osalSysLockFromISR();
   chnAddFlagsI(sdup, CHN_OUTPUT_EMPTY);
 
+#if SERIAL_USB_PACKET_MODE == TRUE
+  /* The buffer just transmitted is returned to the queue, a zero sized
+     packet has no buffer.*/
+  n = usbp->epc[ep]->in_state->txsize;
+  if (n > 0U) {
+    obqReleaseEmptyBufferI(&sdup->obqueue);
+  }
+
+  /* The endpoint cannot be busy, we are in the context of the callback,
+     the next buffer is transmitted immediately.*/
+  if (!sdu_start_transmit(sdup, true) &&
+      (n > 0U) && ((n & ((size_t)usbp->epc[ep]->in_maxsize - 1U)) == 0U)) {
+    /* Transmit zero sized packet in case the last one has maximum allowed
+       size and there is nothing else to send, see the same case below.*/
+    usbPrepareTransmit(usbp, ep, NULL, 0);
+    (void) usbStartTransmitI(usbp, ep);
+  }
+#else
+
   /*lint -save -e9013 [15.7] There is no else because it is not needed.*/
   if ((n = oqGetFullI(&sdup->oqueue)) > 0U) {
     /* The endpoint cannot be busy, we are in the context of the callback,
@@ -400,6 +692,7 @@ void sduDataTransmitted(USBDriver *usbp, usbep_t ep) {
     (void) usbStartTransmitI(usbp, ep);
   }
   /*lint -restore*/
+#endif
 
   osalSysUnlockFromISR();
 }
@@ -421,6 +714,22 @@ void sduDataReceived(USBDriver *usbp, usbep_t ep) {
   }
 
   osalSysLockFromISR();
+
+#if SERIAL_USB_PACKET_MODE == TRUE
+  (void)maxsize;
+
+  /* The data has been received in place, the buffer is posted unless it
+     was a zero sized packet.*/
+  n = usbGetReceiveTransactionSizeI(usbp, ep);
+  if (n > 0U) {
+    ibqPostFullBufferI(&sdup->ibqueue, n);
+    chnAddFlagsI(sdup, CHN_INPUT_AVAILABLE);
+  }
+
+  /* Next transaction into the next empty buffer, if any, else it is
+     started when a buffer is released by the reader.*/
+  sdu_start_receive(sdup);
+#else
   chnAddFlagsI(sdup, CHN_INPUT_AVAILABLE);
 
   /* Writes to the input queue can only happen when there is enough space
@@ -437,6 +746,7 @@ void sduDataReceived(USBDriver *usbp, usbep_t ep) {
     osalSysLockFromISR();
     (void) usbStartReceiveI(usbp, ep);
   }
+#endif
   osalSysUnlockFromISR();
 }
 
@@ -91,6 +91,7 @@ void spiObjectInit(SPIDriver *spip) {
 void spiStart(SPIDriver *spip, const SPIConfig *config) {
 
   osalDbgCheck((spip != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_SPI, spiInit);
 
   osalSysLock();
   osalDbgAssert((spip->state == SPI_STOP) || (spip->state == SPI_READY),
@@ -97,6 +97,7 @@ void uartObjectInit(UARTDriver *uartp) {
 void uartStart(UARTDriver *uartp, const UARTConfig *config) {
 
   osalDbgCheck((uartp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_UART, uartInit);
 
   osalSysLock();
   osalDbgAssert((uartp->state == UART_STOP) || (uartp->state == UART_READY),
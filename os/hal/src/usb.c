@@ -288,6 +288,7 @@ void usbStart(USBDriver *usbp, const USBConfig *config) {
   unsigned i;
 
   osalDbgCheck((usbp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_USB, usbInit);
 
   osalSysLock();
   osalDbgAssert((usbp->state == USB_STOP) || (usbp->state == USB_READY),
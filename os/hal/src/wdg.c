@@ -69,6 +69,7 @@ void wdgInit(void) {
 void wdgStart(WDGDriver *wdgp, const WDGConfig *config) {
 
   osalDbgCheck((wdgp != NULL) && (config != NULL));
+  halLazyInit(HAL_DRV_WDG, wdgInit);
 
   osalSysLock();
   osalDbgAssert((wdgp->state == WDG_STOP) || (wdgp->state == WDG_READY),
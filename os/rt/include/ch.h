@@ -75,6 +75,7 @@
 #include "chdebug.h"
 #include "chtm.h"
 #include "chstats.h"
+#include "chlockstats.h"
 #include "chschd.h"
 #include "chsys.h"
 #include "chvt.h"
@@ -92,9 +93,13 @@
 #include "chmemcore.h"
 #include "chheap.h"
 #include "chmempools.h"
+#include "chmemarena.h"
+#include "chmemslab.h"
+#include "chmemreloc.h"
 #include "chdynamic.h"
 #include "chqueues.h"
 #include "chstreams.h"
+#include "chpipes.h"
 
 #endif /* _CH_H_ */
 
@@ -59,6 +59,10 @@
 typedef struct condition_variable {
   threads_queue_t       c_queue;            /**< @brief Condition variable
                                                  threads queue.             */
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          c_stats;            /**< @brief Contention
+                                                 statistics.                */
+#endif
 } condition_variable_t;
 
 /*===========================================================================*/
@@ -72,7 +76,12 @@ typedef struct condition_variable {
  *
  * @param[in] name      the name of the condition variable
  */
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#define _CONDVAR_DATA(name) {_THREADS_QUEUE_DATA(name.c_queue),             \
+                             _LOCK_STATS_DATA}
+#else
 #define _CONDVAR_DATA(name) {_THREADS_QUEUE_DATA(name.c_queue)}
+#endif
 
 /**
  * @brief Static condition variable initializer.
@@ -109,6 +118,27 @@ extern "C" {
 /* Module inline functions.                                                  */
 /*===========================================================================*/
 
+/**
+ * @brief   Registers a condition variable in the lock statistics with a name.
+ * @pre     This function only registers the condition variable if the option
+ *          @p CH_DBG_LOCK_STATISTICS is enabled else no action is performed.
+ * @note    Each wait on a condition variable is accounted as contended.
+ *
+ * @param[in] cp        pointer to the @p condition_variable_t structure
+ * @param[in] name      condition variable name
+ *
+ * @api
+ */
+static inline void chCondSetName(condition_variable_t *cp, const char *name) {
+
+#if CH_DBG_LOCK_STATISTICS == TRUE
+  chLockStatsRegister(&cp->c_stats, name, LOCK_STATS_CONDVAR);
+#else
+  (void)cp;
+  (void)name;
+#endif
+}
+
 #endif /* CH_CFG_USE_CONDVARS == TRUE */
 
 #endif /* _CHCOND_H_ */
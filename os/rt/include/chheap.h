@@ -100,6 +100,7 @@ extern "C" {
 #endif
   void _heap_init(void);
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
+  void chHeapObjectInitProvider(memory_heap_t *heapp, memgetfunc_t provider);
   void *chHeapAlloc(memory_heap_t *heapp, size_t size);
   void chHeapFree(void *p);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *sizep);
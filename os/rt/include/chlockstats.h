@@ -0,0 +1,158 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chlockstats.h
+ * @brief   Lock contention statistics macros and structures.
+ *
+ * @addtogroup lock_statistics
+ * @{
+ */
+
+#ifndef _CHLOCKSTATS_H_
+#define _CHLOCKSTATS_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Lock object types
+ * @{
+ */
+#define LOCK_STATS_MUTEX        'M'     /**< @brief Mutex.                  */
+#define LOCK_STATS_SEMAPHORE    'S'     /**< @brief Counting semaphore.     */
+#define LOCK_STATS_CONDVAR      'C'     /**< @brief Condition variable.     */
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Debug option, lock contention statistics.
+ * @details If enabled then mutexes, semaphores and condition variables
+ *          account acquisitions, contended acquisitions, wait times and,
+ *          for mutexes, hold times.
+ */
+#if !defined(CH_DBG_LOCK_STATISTICS) || defined(__DOXYGEN__)
+#define CH_DBG_LOCK_STATISTICS              FALSE
+#endif
+
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a lock statistics time stamp.
+ * @note    The realtime counter is used when available, else times are
+ *          expressed in system ticks.
+ */
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+typedef rtcnt_t lstime_t;
+#else
+typedef systime_t lstime_t;
+#endif
+
+/**
+ * @brief   Type of a lock statistics structure.
+ */
+typedef struct lock_stats lock_stats_t;
+
+/**
+ * @brief   Structure representing the statistics of a lock object.
+ * @note    Hold times are only accounted for mutexes, semaphores and
+ *          condition variables have no owner.
+ */
+struct lock_stats {
+  lock_stats_t          *ls_next;   /**< @brief Next registered object.     */
+  const char            *ls_name;   /**< @brief Object name or @p NULL.     */
+  char                  ls_type;    /**< @brief Object type.                */
+  ucnt_t                ls_acquired;/**< @brief Number of acquisitions.     */
+  ucnt_t                ls_contended;/**< @brief Number of acquisitions that
+                                                had to wait or failed.      */
+  rttime_t              ls_wait_total;/**< @brief Cumulative wait time.     */
+  lstime_t              ls_wait_max;/**< @brief Longest wait.               */
+  lstime_t              ls_hold_max;/**< @brief Longest hold time.          */
+  thread_t              *ls_hold_thd;/**< @brief Thread responsible of
+                                                @p ls_hold_max.             */
+  const char            *ls_hold_name;/**< @brief Name of @p ls_hold_thd at
+                                                the time of the hold.       */
+  lstime_t              ls_hold_start;/**< @brief Time stamp of the current
+                                                acquisition.                */
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static lock statistics initializer.
+ */
+#define _LOCK_STATS_DATA                                                    \
+  {NULL, NULL, '\0', (ucnt_t)0, (ucnt_t)0, (rttime_t)0, (lstime_t)0,        \
+   (lstime_t)0, NULL, NULL, (lstime_t)0}
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void _lock_stats_init(void);
+  void _lock_stats_object_init(lock_stats_t *lsp);
+  void _lock_stats_acquired(lock_stats_t *lsp);
+  void _lock_stats_failed(lock_stats_t *lsp);
+  lstime_t _lock_stats_wait_begin(lock_stats_t *lsp);
+  void _lock_stats_wait_end(lock_stats_t *lsp, lstime_t start);
+  void _lock_stats_handoff(lock_stats_t *lsp);
+  void _lock_stats_released(lock_stats_t *lsp);
+  void chLockStatsRegister(lock_stats_t *lsp, const char *name, char type);
+  void chLockStatsReset(void);
+  lock_stats_t *chLockStatsFirst(void);
+  lock_stats_t *chLockStatsNext(lock_stats_t *lsp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#else /* CH_DBG_LOCK_STATISTICS == FALSE */
+
+/* Stub functions for when the lock statistics module is disabled. */
+#define _lock_stats_object_init(lsp)
+#define _lock_stats_acquired(lsp)
+#define _lock_stats_failed(lsp)
+#define _lock_stats_handoff(lsp)
+#define _lock_stats_released(lsp)
+
+#endif /* CH_DBG_LOCK_STATISTICS == FALSE */
+
+#endif /* _CHLOCKSTATS_H_ */
+
+/** @} */
@@ -0,0 +1,233 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chmemarena.h
+ * @brief   Memory Arenas macros and structures.
+ *
+ * @addtogroup arenas
+ * @{
+ */
+
+#ifndef _CHMEMARENA_H_
+#define _CHMEMARENA_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Memory Arenas APIs.
+ * @details If enabled then the memory arenas allocator APIs are included
+ *          in the kernel.
+ */
+#if !defined(CH_CFG_USE_ARENAS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_ARENAS                   FALSE
+#endif
+
+#if (CH_CFG_USE_ARENAS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MEMCORE == FALSE
+#error "CH_CFG_USE_ARENAS requires CH_CFG_USE_MEMCORE"
+#endif
+
+#else /* CH_CFG_USE_ARENAS == FALSE */
+
+#if CH_CFG_USE_THREAD_ARENAS == TRUE
+#error "CH_CFG_USE_THREAD_ARENAS requires CH_CFG_USE_ARENAS"
+#endif
+
+#endif /* CH_CFG_USE_ARENAS == FALSE */
+
+#if (CH_CFG_USE_ARENAS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an arena allocation mark.
+ */
+typedef uint8_t *arenamark_t;
+
+/**
+ * @brief   Type of a memory arena.
+ */
+typedef struct memory_arena memory_arena_t;
+
+/**
+ * @brief   Structure representing a memory arena.
+ */
+struct memory_arena {
+  uint8_t               *a_base;    /**< @brief Arena buffer base.          */
+  uint8_t               *a_next;    /**< @brief Next free byte.             */
+  uint8_t               *a_end;     /**< @brief Arena buffer end.           */
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  bool                  a_owned;    /**< @brief Buffer allocated from a heap
+                                                by the arena itself.        */
+#endif
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static memory arena initializer.
+ * @details This macro should be used when statically initializing a
+ *          memory arena that is part of a bigger structure.
+ *
+ * @param[in] buf       arena buffer, must be aligned to @p MEM_ALIGN_SIZE
+ * @param[in] size      size of the arena buffer
+ */
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+#define _MEMORY_ARENA_DATA(buf, size)                                       \
+  {(uint8_t *)(buf), (uint8_t *)(buf), (uint8_t *)(buf) + (size), false}
+#else
+#define _MEMORY_ARENA_DATA(buf, size)                                       \
+  {(uint8_t *)(buf), (uint8_t *)(buf), (uint8_t *)(buf) + (size)}
+#endif
+
+/**
+ * @brief   Static memory arena initializer.
+ * @details Statically initialized arenas require no explicit
+ *          initialization using @p chArenaObjectInit().
+ *
+ * @param[in] name      the name of the memory arena variable
+ * @param[in] buf       arena buffer, must be aligned to @p MEM_ALIGN_SIZE
+ * @param[in] size      size of the arena buffer
+ */
+#define MEMORY_ARENA_DECL(name, buf, size)                                  \
+  memory_arena_t name = _MEMORY_ARENA_DATA(buf, size)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chArenaObjectInit(memory_arena_t *ap, void *buf, size_t size);
+  memory_arena_t *chArenaObjectInitFromCore(memory_arena_t *ap, size_t size);
+#if CH_CFG_USE_HEAP == TRUE
+  memory_arena_t *chArenaObjectInitFromHeap(memory_arena_t *ap,
+                                            memory_heap_t *heapp,
+                                            size_t size);
+#endif
+  void chArenaRelease(memory_arena_t *ap);
+  void *chArenaAlloc(memory_arena_t *ap, size_t size);
+#if CH_CFG_USE_THREAD_ARENAS == TRUE
+  memory_arena_t *chArenaSetDefault(memory_arena_t *ap);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a mark of the current arena allocation level.
+ * @details The mark can be passed later to @p chArenaReset() in order to
+ *          release all the allocations performed after this call.
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure
+ * @return              The allocation mark.
+ *
+ * @xclass
+ */
+static inline arenamark_t chArenaMarkX(memory_arena_t *ap) {
+
+  return ap->a_next;
+}
+
+/**
+ * @brief   Rolls back an arena to a previously taken mark.
+ * @details All the allocations performed after the mark are released at
+ *          once, older allocations are not touched.
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure
+ * @param[in] mark      mark returned by @p chArenaMarkX()
+ *
+ * @xclass
+ */
+static inline void chArenaResetX(memory_arena_t *ap, arenamark_t mark) {
+
+  chDbgCheck((mark >= ap->a_base) && (mark <= ap->a_next));
+
+  ap->a_next = mark;
+}
+
+/**
+ * @brief   Releases all the allocations of an arena.
+ * @note    The arena buffer is retained, see @p chArenaRelease().
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure
+ *
+ * @xclass
+ */
+static inline void chArenaClearX(memory_arena_t *ap) {
+
+  ap->a_next = ap->a_base;
+}
+
+/**
+ * @brief   Returns the free space in an arena.
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure
+ * @return              The free space in bytes.
+ *
+ * @xclass
+ */
+static inline size_t chArenaGetStatusX(memory_arena_t *ap) {
+
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  return (size_t)(ap->a_end - ap->a_next);
+  /*lint -restore*/
+}
+
+#if (CH_CFG_USE_THREAD_ARENAS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the default arena of the current thread.
+ *
+ * @return              A pointer to the default arena.
+ * @retval NULL         if the thread has no default arena.
+ *
+ * @xclass
+ */
+static inline memory_arena_t *chArenaGetDefaultX(void) {
+
+  return chThdGetSelfX()->p_arena;
+}
+#endif
+
+#endif /* CH_CFG_USE_ARENAS == TRUE */
+
+#endif /* _CHMEMARENA_H_ */
+
+/** @} */
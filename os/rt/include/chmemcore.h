@@ -34,10 +34,51 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Memory region attributes and placement hints
+ * @{
+ */
+/**
+ * @brief   No placement requirement.
+ */
+#define MEM_ANY             0U
+/**
+ * @brief   Fast memory, single cycle or tightly coupled.
+ * @note    This is a preference, if no fast region can satisfy the request
+ *          then the allocation falls back on the other regions.
+ */
+#define MEM_FAST            1U
+/**
+ * @brief   Memory reachable by the DMA controllers.
+ */
+#define MEM_DMA             2U
+/**
+ * @brief   Memory retained in low power modes.
+ */
+#define MEM_RETAINED        4U
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Multiple core memory regions.
+ * @details If enabled then further memory regions can be added to the
+ *          core allocator using @p chCoreAddRegion(), allocations can
+ *          specify placement hints.
+ */
+#if !defined(CH_CFG_USE_MEMCORE_REGIONS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_MEMCORE_REGIONS          FALSE
+#endif
+
+/**
+ * @brief   Attributes of the default core memory region.
+ */
+#if !defined(CH_CFG_MEMCORE_DEFAULT_FLAGS) || defined(__DOXYGEN__)
+#define CH_CFG_MEMCORE_DEFAULT_FLAGS        MEM_DMA
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -53,6 +94,28 @@
  */
 typedef void *(*memgetfunc_t)(size_t size);
 
+#if (CH_CFG_USE_MEMCORE_REGIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of memory region attributes.
+ */
+typedef uint8_t memflags_t;
+
+/**
+ * @brief   Type of a core memory region.
+ */
+typedef struct memory_region memory_region_t;
+
+/**
+ * @brief   Structure representing a core memory region.
+ */
+struct memory_region {
+  memory_region_t       *next;      /**< @brief Next region in the list.    */
+  uint8_t               *nextmem;   /**< @brief First free byte.            */
+  uint8_t               *endmem;    /**< @brief End of the region.          */
+  memflags_t            flags;      /**< @brief Region attributes.          */
+};
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -87,6 +150,27 @@ typedef void *(*memgetfunc_t)(size_t size);
 #define MEM_IS_ALIGNED(p)   (((size_t)(p) & MEM_ALIGN_MASK) == 0U)
 /** @} */
 
+#if (CH_CFG_USE_MEMCORE_REGIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds the free part of a linker RAM section as a core region.
+ * @details The region spans from the end of the @p .ramN sections to the
+ *          end of the @p ramN memory declared in the linker script.
+ * @note    Do not add the RAM section hosting the default heap, that
+ *          memory already belongs to the default region.
+ *
+ * @param[out] mrp      pointer to a @p memory_region_t structure
+ * @param[in] n         RAM section number, from 0 to 7
+ * @param[in] flags     region attributes
+ *
+ * @init
+ */
+#define chCoreAddRAMRegion(mrp, n, flags) do {                              \
+  extern uint8_t __ram##n##_free__[];                                       \
+  extern uint8_t __ram##n##_end__[];                                        \
+  chCoreAddRegion(mrp, __ram##n##_free__, __ram##n##_end__, flags);         \
+} while (false)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -98,6 +182,16 @@ extern "C" {
   void *chCoreAlloc(size_t size);
   void *chCoreAllocI(size_t size);
   size_t chCoreGetStatusX(void);
+#if CH_CFG_USE_MEMCORE_REGIONS == TRUE
+  void chCoreAddRegion(memory_region_t *mrp, void *base, void *end,
+                       memflags_t flags);
+  void *chCoreAllocHint(size_t size, memflags_t hints);
+  void *chCoreAllocHintI(size_t size, memflags_t hints);
+  void *chCoreAllocFast(size_t size);
+  void *chCoreAllocDMA(size_t size);
+  void *chCoreAllocRetained(size_t size);
+  size_t chCoreGetStatusHintX(memflags_t hints);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,17 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Lock-free memory pools.
+ * @details If enabled, and if the port supports exclusive load/store
+ *          operations, then the pools free lists are updated without
+ *          entering a critical zone. On other ports the option has no
+ *          effect.
+ */
+#if !defined(CH_CFG_USE_LOCKFREE_POOLS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_LOCKFREE_POOLS           FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,6 +57,17 @@
 #error "CH_CFG_USE_MEMPOOLS requires CH_CFG_USE_MEMCORE"
 #endif
 
+/**
+ * @brief   Lock-free pools actually in use.
+ */
+#if ((CH_CFG_USE_LOCKFREE_POOLS == TRUE) &&                                 \
+     defined(PORT_SUPPORTS_EXCLUSIVE) && (PORT_SUPPORTS_EXCLUSIVE == TRUE)) ||\
+    defined(__DOXYGEN__)
+#define CH_MEMPOOLS_LOCKFREE                TRUE
+#else
+#define CH_MEMPOOLS_LOCKFREE                FALSE
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
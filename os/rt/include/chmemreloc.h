@@ -0,0 +1,175 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chmemreloc.h
+ * @brief   Relocatable heaps macros and structures.
+ *
+ * @addtogroup reloc_heaps
+ * @{
+ */
+
+#ifndef _CHMEMRELOC_H_
+#define _CHMEMRELOC_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Relocatable heaps APIs.
+ * @details If enabled then the handle-based relocatable heaps APIs are
+ *          included in the kernel.
+ */
+#if !defined(CH_CFG_USE_RELOC_HEAPS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_RELOC_HEAPS              FALSE
+#endif
+
+/**
+ * @brief   Bytes moved by the compactor thread in a single step.
+ * @details The heap is locked while a step is performed, this value
+ *          bounds the time other threads can be kept waiting. A block is
+ *          always moved as a whole so a step can exceed this value.
+ */
+#if !defined(CH_CFG_RHEAP_COMPACT_STEP) || defined(__DOXYGEN__)
+#define CH_CFG_RHEAP_COMPACT_STEP           64
+#endif
+
+#if (CH_CFG_USE_RELOC_HEAPS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CH_CFG_USE_MUTEXES == FALSE) || (CH_CFG_USE_SEMAPHORES == FALSE)
+#error "CH_CFG_USE_RELOC_HEAPS requires CH_CFG_USE_MUTEXES and CH_CFG_USE_SEMAPHORES"
+#endif
+
+#if CH_CFG_USE_MEMCORE == FALSE
+#error "CH_CFG_USE_RELOC_HEAPS requires CH_CFG_USE_MEMCORE"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a relocatable heap handle.
+ */
+typedef struct {
+  void                  *h_ptr;     /**< @brief Block payload or @p NULL if
+                                                the handle is free.         */
+  cnt_t                 h_locks;    /**< @brief Lock counter, a locked
+                                                block is never moved.       */
+} rhandle_t;
+
+/**
+ * @brief   Relocatable heap block header.
+ */
+union rheap_block {
+  stkalign_t align;
+  struct {
+    rhandle_t           *handle;    /**< @brief Owner handle or @p NULL if
+                                                the block is a hole.        */
+    size_t              size;       /**< @brief Block size, header
+                                                included.                   */
+  } b;
+};
+
+/**
+ * @brief   Relocatable heap statistics.
+ */
+typedef struct {
+  ucnt_t                rs_steps;   /**< @brief Compaction steps that moved
+                                                or reclaimed something.     */
+  ucnt_t                rs_moves;   /**< @brief Blocks moved.               */
+  size_t                rs_moved;   /**< @brief Bytes moved.                */
+  size_t                rs_reclaimed;/**< @brief Bytes given back to the
+                                                free tail.                  */
+  ucnt_t                rs_rescues; /**< @brief Allocations served only
+                                                after a full compaction.    */
+  ucnt_t                rs_failures;/**< @brief Failed allocations.         */
+} rheap_stats_t;
+
+/**
+ * @brief   Structure describing a relocatable heap.
+ * @note    Blocks and holes are contiguous from @p rh_base to @p rh_top,
+ *          the space from @p rh_top to @p rh_end is free.
+ */
+typedef struct {
+  uint8_t               *rh_base;   /**< @brief First block.                */
+  uint8_t               *rh_top;    /**< @brief Start of the free tail.     */
+  uint8_t               *rh_end;    /**< @brief End of the heap buffer.     */
+  rhandle_t             *rh_handles;/**< @brief Handles table.              */
+  size_t                rh_nhandles;/**< @brief Handles table size.         */
+  size_t                rh_holes;   /**< @brief Bytes in holes.             */
+  mutex_t               rh_mtx;     /**< @brief Heap access mutex.          */
+  binary_semaphore_t    rh_dirty;   /**< @brief Signaled when holes are
+                                                created.                    */
+  rheap_stats_t         rh_stats;   /**< @brief Compaction statistics.      */
+} reloc_heap_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Space taken in a relocatable heap by a block.
+ * @details This macro can be used in order to size a heap buffer.
+ *
+ * @param[in] n         the block payload size
+ */
+#define CH_RHEAP_BLOCK_SIZE(n)                                              \
+  (MEM_ALIGN_NEXT(n) + sizeof (union rheap_block))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRHeapObjectInit(reloc_heap_t *rhp, rhandle_t *handles, size_t n,
+                         void *buf, size_t size);
+  rhandle_t *chRHeapAlloc(reloc_heap_t *rhp, size_t size);
+  void chRHeapFree(reloc_heap_t *rhp, rhandle_t *hp);
+  void *chRHeapLock(reloc_heap_t *rhp, rhandle_t *hp);
+  void chRHeapUnlock(reloc_heap_t *rhp, rhandle_t *hp);
+  size_t chRHeapCompact(reloc_heap_t *rhp, size_t limit);
+  thread_t *chRHeapStartCompactor(reloc_heap_t *rhp, void *wsp, size_t size,
+                                  tprio_t prio);
+  size_t chRHeapStatus(reloc_heap_t *rhp, size_t *sizep,
+                       rheap_stats_t *rsp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CH_CFG_USE_RELOC_HEAPS == TRUE */
+
+#endif /* _CHMEMRELOC_H_ */
+
+/** @} */
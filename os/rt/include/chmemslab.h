@@ -0,0 +1,188 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chmemslab.h
+ * @brief   Slab allocator macros and structures.
+ *
+ * @addtogroup slabs
+ * @{
+ */
+
+#ifndef _CHMEMSLAB_H_
+#define _CHMEMSLAB_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Slab allocator APIs.
+ * @details If enabled then the slab allocator APIs are included in the
+ *          kernel.
+ */
+#if !defined(CH_CFG_USE_SLABS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_SLABS                    FALSE
+#endif
+
+#if (CH_CFG_USE_SLABS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_MEMCORE == FALSE
+#error "CH_CFG_USE_SLABS requires CH_CFG_USE_MEMCORE"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a slab.
+ */
+typedef struct slab slab_t;
+
+/**
+ * @brief   Slabs list header.
+ */
+struct slab_list {
+  slab_t                *sl_next;   /**< @brief Next slab in the list.      */
+  slab_t                *sl_prev;   /**< @brief Previous slab in the list.  */
+};
+
+/**
+ * @brief   Structure representing a size class.
+ * @note    The slabs with free objects are kept at the head of the list,
+ *          full slabs at the tail.
+ */
+typedef struct {
+  size_t                sc_size;    /**< @brief Objects size.               */
+  struct slab_list      sc_slabs;   /**< @brief Slabs of this class.        */
+  size_t                sc_perslab; /**< @brief Objects in a slab.          */
+  ucnt_t                sc_nslabs;  /**< @brief Number of slabs.            */
+  ucnt_t                sc_used;    /**< @brief Objects in use.             */
+} slab_class_t;
+
+/**
+ * @brief   Header of an object allocated from a slab allocator.
+ * @note    Blocks bigger than the largest class are allocated from the
+ *          heap and have @p NULL in the @p slab field.
+ */
+union slab_object {
+  stkalign_t            align;
+  slab_t                *slab;      /**< @brief Owner slab.                 */
+};
+
+/**
+ * @brief   Free object in a slab.
+ */
+struct slab_free {
+  struct slab_free      *sf_next;   /**< @brief Next free object.           */
+};
+
+/**
+ * @brief   Structure representing a slab.
+ */
+struct slab {
+  struct slab_list      s_list;     /**< @brief Class list links, must be
+                                                the first field.            */
+  slab_class_t          *s_class;   /**< @brief Owner class.                */
+  struct slab_free      *s_free;    /**< @brief Free objects in the slab.   */
+  size_t                s_used;     /**< @brief Objects in use.             */
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  bool                  s_heap;     /**< @brief Slab allocated from a heap,
+                                                returned when empty.        */
+#endif
+};
+
+/**
+ * @brief   Structure representing a slab allocator.
+ */
+typedef struct {
+  slab_class_t          *sa_classes;/**< @brief Size classes, in ascending
+                                                size order.                 */
+  unsigned              sa_nclasses;/**< @brief Number of size classes.     */
+  size_t                sa_slabsize;/**< @brief Size of a slab.             */
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  memory_heap_t         *sa_heap;   /**< @brief Slabs heap.                 */
+#endif
+  memgetfunc_t          sa_provider;/**< @brief Slabs provider or @p NULL if
+                                                slabs come from the heap.   */
+} slab_allocator_t;
+
+/**
+ * @brief   Size class occupancy.
+ */
+typedef struct {
+  size_t                ss_size;    /**< @brief Objects size.               */
+  size_t                ss_slabs;   /**< @brief Number of slabs.            */
+  size_t                ss_used;    /**< @brief Objects in use.             */
+  size_t                ss_free;    /**< @brief Free objects in the slabs.  */
+} slab_status_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Static size class initializer.
+ * @details Size classes are declared as an array of these initializers,
+ *          in ascending size order.
+ *
+ * @param[in] size      size of the class objects
+ */
+#define SLAB_CLASS(size)                                                    \
+  {(size), {NULL, NULL}, (size_t)0, (ucnt_t)0, (ucnt_t)0}
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if CH_CFG_USE_HEAP == TRUE
+  void chSlabObjectInit(slab_allocator_t *sap, slab_class_t *classes,
+                        unsigned n, size_t slabsize, memory_heap_t *heapp);
+#endif
+  void chSlabObjectInitProvider(slab_allocator_t *sap, slab_class_t *classes,
+                                unsigned n, size_t slabsize,
+                                memgetfunc_t provider);
+  void *chSlabAlloc(slab_allocator_t *sap, size_t size);
+  void chSlabFree(void *p);
+  void chSlabGetStatus(slab_allocator_t *sap, unsigned i, slab_status_t *ssp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CH_CFG_USE_SLABS == TRUE */
+
+#endif /* _CHMEMSLAB_H_ */
+
+/** @} */
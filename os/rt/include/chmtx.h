@@ -64,6 +64,9 @@ struct ch_mutex {
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
   cnt_t                 m_cnt;      /**< @brief Mutex recursion counter.    */
 #endif
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          m_stats;    /**< @brief Contention statistics.      */
+#endif
 };
 
 /*===========================================================================*/
@@ -77,11 +80,21 @@ struct ch_mutex {
  *
  * @param[in] name      the name of the mutex variable
  */
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
+#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.m_queue), NULL, NULL, 0,  \
+                           _LOCK_STATS_DATA}
+#else
+#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.m_queue), NULL, NULL,     \
+                           _LOCK_STATS_DATA}
+#endif
+#else /* CH_DBG_LOCK_STATISTICS == FALSE */
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
 #define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.m_queue), NULL, NULL, 0}
 #else
 #define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.m_queue), NULL, NULL}
 #endif
+#endif /* CH_DBG_LOCK_STATISTICS == FALSE */
 
 /**
  * @brief   Static mutex initializer.
@@ -146,6 +159,26 @@ static inline mutex_t *chMtxGetNextMutexS(void) {
   return chThdGetSelfX()->p_mtxlist;
 }
 
+/**
+ * @brief   Registers a mutex in the lock statistics with a name.
+ * @pre     This function only registers the mutex if the option
+ *          @p CH_DBG_LOCK_STATISTICS is enabled else no action is performed.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @param[in] name      mutex name
+ *
+ * @api
+ */
+static inline void chMtxSetName(mutex_t *mp, const char *name) {
+
+#if CH_DBG_LOCK_STATISTICS == TRUE
+  chLockStatsRegister(&mp->m_stats, name, LOCK_STATS_MUTEX);
+#else
+  (void)mp;
+  (void)name;
+#endif
+}
+
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
 #endif /* _CHMTX_H_ */
@@ -0,0 +1,207 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chpipes.h
+ * @brief   Pipes macros and structures.
+ *
+ * @addtogroup pipes
+ * @{
+ */
+
+#ifndef _CHPIPES_H_
+#define _CHPIPES_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Pipes APIs.
+ * @details If enabled then the pipes APIs are included in the kernel.
+ */
+#if !defined(CH_CFG_USE_PIPES) || defined(__DOXYGEN__)
+#define CH_CFG_USE_PIPES                    FALSE
+#endif
+
+/**
+ * @brief   Maximum bytes copied within a single critical zone.
+ * @details Bulk transfers are split in chunks of this size, the critical
+ *          zone is left between chunks in order to bound the interrupts
+ *          latency.
+ */
+#if !defined(CH_CFG_PIPES_MAX_CHUNK) || defined(__DOXYGEN__)
+#define CH_CFG_PIPES_MAX_CHUNK              64U
+#endif
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_PIPES_MAX_CHUNK < 1U
+#error "invalid CH_CFG_PIPES_MAX_CHUNK value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief   Structure representing a pipe object.
+ * @details A pipe is a circular buffer shared between threads, writers
+ *          are suspended while the pipe is full and readers while it is
+ *          empty. Data is transferred in bulk.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct BaseSequentialStreamVMT *vmt;
+  _base_sequential_stream_data
+  uint8_t               *p_buffer;  /**< @brief Pointer to the pipe buffer.*/
+  uint8_t               *p_top;     /**< @brief Pointer to the first location
+                                                after the buffer.           */
+  uint8_t               *p_wrptr;   /**< @brief Write pointer.              */
+  uint8_t               *p_rdptr;   /**< @brief Read pointer.               */
+  volatile size_t       p_cnt;      /**< @brief Bytes in the pipe.          */
+  threads_queue_t       p_rqueue;   /**< @brief Queue of waiting readers.   */
+  threads_queue_t       p_wqueue;   /**< @brief Queue of waiting writers.   */
+} pipe_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Data part of a static pipe initializer.
+ * @details This macro should be used when statically initializing a
+ *          pipe that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the pipe variable
+ * @param[in] buffer    pointer to the pipe buffer area
+ * @param[in] size      size of the pipe buffer area
+ */
+#define _PIPE_DATA(name, buffer, size) {                                    \
+  &_pipe_vmt,                                                               \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer) + (size),                                             \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer),                                                      \
+  (size_t)0,                                                                \
+  _THREADS_QUEUE_DATA(name.p_rqueue),                                       \
+  _THREADS_QUEUE_DATA(name.p_wqueue)                                        \
+}
+
+/**
+ * @brief   Static pipe initializer.
+ * @details Statically initialized pipes require no explicit
+ *          initialization using @p chPipeObjectInit().
+ *
+ * @param[in] name      the name of the pipe variable
+ * @param[in] buffer    pointer to the pipe buffer area
+ * @param[in] size      size of the pipe buffer area
+ */
+#define PIPE_DECL(name, buffer, size)                                       \
+  pipe_t name = _PIPE_DATA(name, buffer, size)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern const struct BaseSequentialStreamVMT _pipe_vmt;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chPipeObjectInit(pipe_t *pp, uint8_t *bp, size_t size);
+  void chPipeResetI(pipe_t *pp);
+  void chPipeReset(pipe_t *pp);
+  size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
+                            size_t n, systime_t timeout);
+  size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
+                           size_t n, systime_t timeout);
+  uint8_t *chPipeWritePeekTimeout(pipe_t *pp, size_t *np, systime_t timeout);
+  void chPipeWriteCommit(pipe_t *pp, size_t n);
+  const uint8_t *chPipeReadPeekTimeout(pipe_t *pp, size_t *np,
+                                       systime_t timeout);
+  void chPipeReadCommit(pipe_t *pp, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the size of a pipe buffer.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @return              The size of the buffer.
+ *
+ * @xclass
+ */
+static inline size_t chPipeGetSizeX(pipe_t *pp) {
+
+  return (size_t)(pp->p_top - pp->p_buffer);
+}
+
+/**
+ * @brief   Returns the number of bytes in a pipe.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @return              The number of bytes that can be read.
+ *
+ * @iclass
+ */
+static inline size_t chPipeGetUsedCountI(pipe_t *pp) {
+
+  chDbgCheckClassI();
+
+  return pp->p_cnt;
+}
+
+/**
+ * @brief   Returns the free space in a pipe.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @return              The number of bytes that can be written.
+ *
+ * @iclass
+ */
+static inline size_t chPipeGetFreeCountI(pipe_t *pp) {
+
+  chDbgCheckClassI();
+
+  return chPipeGetSizeX(pp) - pp->p_cnt;
+}
+
+#endif /* CH_CFG_USE_PIPES == TRUE */
+
+#endif /* _CHPIPES_H_ */
+
+/** @} */
@@ -84,6 +84,9 @@ struct io_queue {
   uint8_t               *q_rdptr;   /**< @brief Read pointer.               */
   qnotify_t             q_notify;   /**< @brief Data notification callback. */
   void                  *q_link;    /**< @brief Application defined field.  */
+  size_t                q_watermark;/**< @brief Wakeup watermark.           */
+  size_t                q_wakeup;   /**< @brief Wakeup threshold of the
+                                                waiting thread.             */
 };
 
 /**
@@ -135,7 +138,9 @@ typedef io_queue_t output_queue_t;
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer),                                                      \
   (inotify),                                                                \
-  (link)                                                                    \
+  (link),                                                                   \
+  1U,                                                                       \
+  1U                                                                        \
 }
 
 /**
@@ -171,7 +176,9 @@ typedef io_queue_t output_queue_t;
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer),                                                      \
   (onotify),                                                                \
-  (link)                                                                    \
+  (link),                                                                   \
+  1U,                                                                       \
+  1U                                                                        \
 }
 
 /**
@@ -238,6 +245,7 @@ extern "C" {
   void chIQObjectInit(input_queue_t *iqp, uint8_t *bp, size_t size,
                       qnotify_t infy, void *link);
   void chIQResetI(input_queue_t *iqp);
+  void chIQSetWatermarkI(input_queue_t *iqp, size_t n);
   msg_t chIQPutI(input_queue_t *iqp, uint8_t b);
   msg_t chIQGetTimeout(input_queue_t *iqp, systime_t timeout);
   size_t chIQReadTimeout(input_queue_t *iqp, uint8_t *bp,
@@ -246,8 +254,10 @@ extern "C" {
   void chOQObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
                       qnotify_t onfy, void *link);
   void chOQResetI(output_queue_t *oqp);
+  void chOQSetWatermarkI(output_queue_t *oqp, size_t n);
   msg_t chOQPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout);
   msg_t chOQGetI(output_queue_t *oqp);
+  size_t chOQWriteI(output_queue_t *oqp, const uint8_t *bp, size_t n);
   size_t chOQWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                           size_t n, systime_t timeout);
 #ifdef __cplusplus
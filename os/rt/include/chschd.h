@@ -162,6 +162,31 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Per-thread default memory arenas.
+ * @details If enabled then each thread has a default arena, used when
+ *          @p NULL is passed to @p chArenaAlloc().
+ * @note    Requires @p CH_CFG_USE_ARENAS.
+ */
+#if !defined(CH_CFG_USE_THREAD_ARENAS) || defined(__DOXYGEN__)
+#define CH_CFG_USE_THREAD_ARENAS            FALSE
+#endif
+
+/**
+ * @brief   Compact threads layout.
+ * @details If enabled then the @p thread_t structure is laid out for size,
+ *          priorities are stored as 8 bits values and packed with the
+ *          thread state and flags in the space before the context field.
+ *          If @p CH_CFG_ST_RESOLUTION is 16 then the profiling time counter
+ *          is packed with the other narrow fields.
+ * @note    Requires a port with 8 bits @p tstate_t and @p tmode_t types,
+ *          the context field offset is not changed so the port assembler
+ *          code is not affected.
+ */
+#if !defined(CH_CFG_COMPACT_THREADS) || defined(__DOXYGEN__)
+#define CH_CFG_COMPACT_THREADS              FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -170,6 +195,15 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a priority as stored in the @p thread_t structure.
+ */
+#if (CH_CFG_COMPACT_THREADS == TRUE) || defined(__DOXYGEN__)
+typedef uint8_t tsprio_t;
+#else
+typedef tprio_t tsprio_t;
+#endif
+
 /**
  * @brief   Generic threads single link list, it works like a stack.
  */
@@ -196,7 +230,16 @@ struct ch_thread {
   /* End of the fields shared with the threads_list_t structure.*/
   thread_t              *p_prev;    /**< @brief Previous in the queue.      */
   /* End of the fields shared with the threads_queue_t structure.*/
-  tprio_t               p_prio;     /**< @brief Thread priority.            */
+  tsprio_t              p_prio;     /**< @brief Thread priority.            */
+#if (CH_CFG_COMPACT_THREADS == TRUE) || defined(__DOXYGEN__)
+  /* Narrow fields packed before the context, its offset does not change.*/
+  tstate_t              p_state;    /**< @brief Current thread state.       */
+  tmode_t               p_flags;    /**< @brief Various thread flags.       */
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  tsprio_t              p_realprio; /**< @brief Thread's own, non-inherited,
+                                                priority.                   */
+#endif
+#endif
   struct context        p_ctx;      /**< @brief Processor context.          */
 #if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
   thread_t              *p_newer;   /**< @brief Newer registry element.     */
@@ -215,6 +258,16 @@ struct ch_thread {
    */
   stkalign_t            *p_stklimit;
 #endif
+#if (CH_DBG_FILL_THREADS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief End of the filled thread stack.
+   * @details The stack is filled with @p CH_DBG_STACK_FILL_VALUE from the
+   *          end of the @p thread_t structure up to this address, @p NULL
+   *          if the thread has been created without filling its stack.
+   */
+  stkalign_t            *p_stktop;
+#endif
+#if CH_CFG_COMPACT_THREADS == FALSE
   /**
    * @brief Current thread state.
    */
@@ -223,6 +276,7 @@ struct ch_thread {
    * @brief Various thread flags.
    */
   tmode_t               p_flags;
+#endif
 #if (CH_CFG_USE_DYNAMIC == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief References to this thread.
@@ -239,6 +293,8 @@ struct ch_thread {
   /**
    * @brief Thread consumed time in ticks.
    * @note  This field can overflow.
+   * @note  In the compact layout with 16 bits system time the field
+   *        is packed with the narrow fields above.
    */
   volatile systime_t    p_time;
 #endif
@@ -331,10 +387,12 @@ struct ch_thread {
    * @note  The list is terminated by a @p NULL in this field.
    */
   struct ch_mutex       *p_mtxlist;
+#if CH_CFG_COMPACT_THREADS == FALSE
   /**
    * @brief Thread's own, non-inherited, priority.
    */
-  tprio_t               p_realprio;
+  tsprio_t              p_realprio;
+#endif
 #endif
 #if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) ||      \
     defined(__DOXYGEN__)
@@ -343,6 +401,12 @@ struct ch_thread {
    */
   void                  *p_mpool;
 #endif
+#if (CH_CFG_USE_THREAD_ARENAS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Default memory arena of the thread.
+   */
+  struct memory_arena   *p_arena;
+#endif
 #if (CH_DBG_STATISTICS == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief Thread statistics.
@@ -399,7 +463,7 @@ struct ch_virtual_timers_list {
  */
 struct ch_ready_list {
   threads_queue_t       r_queue;    /**< @brief Threads queue.              */
-  tprio_t               r_prio;     /**< @brief This field must be
+  tsprio_t              r_prio;     /**< @brief This field must be
                                                 initialized to zero.        */
   struct context        r_ctx;      /**< @brief Not used, present because
                                                 offsets.                    */
@@ -476,6 +540,12 @@ struct ch_system {
    */
   kernel_stats_t        kernel_stats;
 #endif
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   List of the registered lock objects.
+   */
+  lock_stats_t          *lockstats;
+#endif
 #if CH_CFG_NO_IDLE_THREAD == FALSE
   /**
    * @brief   Idle thread working area.
@@ -53,6 +53,9 @@ typedef struct ch_semaphore {
   threads_queue_t       s_queue;    /**< @brief Queue of the threads sleeping
                                                 on this semaphore.          */
   cnt_t                 s_cnt;      /**< @brief The semaphore counter.      */
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+  lock_stats_t          s_stats;    /**< @brief Contention statistics.      */
+#endif
 } semaphore_t;
 
 /*===========================================================================*/
@@ -68,7 +71,12 @@ typedef struct ch_semaphore {
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+#define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.s_queue), n,     \
+                                  _LOCK_STATS_DATA}
+#else
 #define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.s_queue), n}
+#endif
 
 /**
  * @brief   Static semaphore initializer.
@@ -153,6 +161,26 @@ static inline cnt_t chSemGetCounterI(semaphore_t *sp) {
   return sp->s_cnt;
 }
 
+/**
+ * @brief   Registers a semaphore in the lock statistics with a name.
+ * @pre     This function only registers the semaphore if the option
+ *          @p CH_DBG_LOCK_STATISTICS is enabled else no action is performed.
+ *
+ * @param[in] sp        pointer to a @p semaphore_t structure
+ * @param[in] name      semaphore name
+ *
+ * @api
+ */
+static inline void chSemSetName(semaphore_t *sp, const char *name) {
+
+#if CH_DBG_LOCK_STATISTICS == TRUE
+  chLockStatsRegister(&sp->s_stats, name, LOCK_STATS_SEMAPHORE);
+#else
+  (void)sp;
+  (void)name;
+#endif
+}
+
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
 #endif /* _CHSEM_H_ */
@@ -38,6 +38,16 @@
 #ifndef _CHSTREAMS_H_
 #define _CHSTREAMS_H_
 
+/**
+ * @brief   Fragment of a gather write.
+ */
+typedef struct {
+  /** @brief Pointer to the fragment data.*/
+  const uint8_t         *bp;
+  /** @brief Size of the fragment, can be zero.*/
+  size_t                n;
+} stream_iovec_t;
+
 /**
  * @brief   BaseSequentialStream specific methods.
  */
@@ -50,6 +60,8 @@
   msg_t (*put)(void *instance, uint8_t b);                                  \
   /* Channel get method, blocking.*/                                        \
   msg_t (*get)(void *instance);                                             \
+  /* Stream gather write method, NULL if not implemented.*/                 \
+  size_t (*writev)(void *instance, const stream_iovec_t *iov, size_t cnt);  \
 
 /**
  * @brief   @p BaseSequentialStream specific data.
@@ -38,6 +38,15 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Static threads table.
+ * @details If enabled then @p chSysInit() creates the threads declared by
+ *          the application in a constant table, see @p THD_TABLE_BEGIN.
+ */
+#if !defined(CH_CFG_USE_THREAD_TABLE) || defined(__DOXYGEN__)
+#define CH_CFG_USE_THREAD_TABLE             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -51,6 +60,36 @@
  */
 typedef void (*tfunc_t)(void *p);
 
+/**
+ * @brief   Type of a thread descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Thread name, can be @p NULL.
+   */
+  const char        *name;
+  /**
+   * @brief Pointer to the working area.
+   */
+  void              *wbase;
+  /**
+   * @brief Size of the working area.
+   */
+  size_t            wsize;
+  /**
+   * @brief Thread priority.
+   */
+  tprio_t           prio;
+  /**
+   * @brief Thread function, @p NULL terminates a table.
+   */
+  tfunc_t           funcp;
+  /**
+   * @brief Thread argument.
+   */
+  void              *arg;
+} thread_descriptor_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -78,6 +117,48 @@ typedef void (*tfunc_t)(void *p);
   threads_queue_t name = _THREADS_QUEUE_DATA(name)
 /** @} */
 
+/**
+ * @name    Threads tables
+ * @{
+ */
+/**
+ * @brief   Start of the threads table.
+ * @details The table is scanned by @p chSysInit() when the option
+ *          @p CH_CFG_USE_THREAD_TABLE is enabled.
+ * @note    Kernel objects should be declared using their static
+ *          initializers, for example @p SEMAPHORE_DECL(), those are
+ *          initialized together with the @p .data section.
+ */
+#define THD_TABLE_BEGIN                                                     \
+  const thread_descriptor_t ch_thd_table[] = {
+
+/**
+ * @brief   Entry of a threads table.
+ *
+ * @param[in] wa        the thread working area, declared using
+ *                      @p THD_WORKING_AREA()
+ * @param[in] name      the thread name, can be @p NULL
+ * @param[in] prio      the thread priority
+ * @param[in] funcp     the thread function
+ * @param[in] arg       the thread argument
+ */
+#define THD_TABLE_ENTRY(wa, name, prio, funcp, arg)                         \
+  {(name), (wa), sizeof (wa), (prio), (funcp), (arg)},
+
+/**
+ * @brief   End of a threads table.
+ */
+#define THD_TABLE_TERMINATOR                                                \
+  {NULL, NULL, (size_t)0, (tprio_t)0, NULL, NULL}
+
+/**
+ * @brief   End of the threads table.
+ */
+#define THD_TABLE_END                                                       \
+  THD_TABLE_TERMINATOR                                                      \
+};
+/** @} */
+
 /**
  * @name    Macro Functions
  * @{
@@ -125,6 +206,10 @@ typedef void (*tfunc_t)(void *p);
 /* External declarations.                                                    */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_THREAD_TABLE == TRUE) && !defined(__DOXYGEN__)
+extern const thread_descriptor_t ch_thd_table[];
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -136,6 +221,7 @@ extern "C" {
                          tprio_t prio, tfunc_t pf, void *arg);
   thread_t *chThdCreateStatic(void *wsp, size_t size,
                               tprio_t prio, tfunc_t pf, void *arg);
+  void chThdCreateTable(const thread_descriptor_t *tdp);
   thread_t *chThdStart(thread_t *tp);
   tprio_t chThdSetPriority(tprio_t newprio);
   msg_t chThdSuspendS(thread_reference_t *trp);
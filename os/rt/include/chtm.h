@@ -38,6 +38,34 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Time measurement histograms.
+ * @details If enabled then a log-scale histogram can be attached to a
+ *          @p time_measurement_t object, the histogram is updated on each
+ *          stopped measurement.
+ */
+#if !defined(CH_CFG_USE_TM_HISTOGRAM) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TM_HISTOGRAM             FALSE
+#endif
+
+/**
+ * @brief   Number of buckets in a time measurement histogram.
+ * @note    Measurements exceeding the range of the last bucket are
+ *          accumulated in the last bucket.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_BUCKETS) || defined(__DOXYGEN__)
+#define CH_CFG_TM_HISTOGRAM_BUCKETS         40
+#endif
+
+/**
+ * @brief   Histogram resolution.
+ * @details Each power of two is split in <tt>2^CH_CFG_TM_HISTOGRAM_SUBBITS</tt>
+ *          buckets, zero means one bucket for each power of two.
+ */
+#if !defined(CH_CFG_TM_HISTOGRAM_SUBBITS) || defined(__DOXYGEN__)
+#define CH_CFG_TM_HISTOGRAM_SUBBITS         1
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -46,10 +74,25 @@
 #error "CH_CFG_USE_TM requires PORT_SUPPORTS_RT"
 #endif
 
+#if (CH_CFG_TM_HISTOGRAM_SUBBITS < 0) || (CH_CFG_TM_HISTOGRAM_SUBBITS > 4)
+#error "invalid CH_CFG_TM_HISTOGRAM_SUBBITS value"
+#endif
+
+#if CH_CFG_TM_HISTOGRAM_BUCKETS < (2 << CH_CFG_TM_HISTOGRAM_SUBBITS)
+#error "CH_CFG_TM_HISTOGRAM_BUCKETS too small for CH_CFG_TM_HISTOGRAM_SUBBITS"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a time measurement histogram.
+ */
+typedef struct tm_histogram tm_histogram_t;
+#endif
+
 /**
  * @brief   Type of a time measurement calibration data.
  */
@@ -58,6 +101,12 @@ typedef struct {
    * @brief   Measurement calibration value.
    */
   rtcnt_t               offset;
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   List of the registered histograms.
+   */
+  tm_histogram_t        *histograms;
+#endif
 } tm_calibration_t;
 
 /**
@@ -75,8 +124,31 @@ typedef struct {
   rtcnt_t               last;           /**< @brief Last measurement.       */
   ucnt_t                n;              /**< @brief Number of measurements. */
   rttime_t              cumulative;     /**< @brief Cumulative measurement. */
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+  tm_histogram_t        *histogram;     /**< @brief Attached histogram or
+                                                    @p NULL.                */
+#endif
 } time_measurement_t;
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing a time measurement histogram.
+ * @details Buckets are log-scaled, values below
+ *          <tt>2^(CH_CFG_TM_HISTOGRAM_SUBBITS+1)</tt> have one bucket each,
+ *          then each power of two is split in
+ *          <tt>2^CH_CFG_TM_HISTOGRAM_SUBBITS</tt> buckets.
+ */
+struct tm_histogram {
+  tm_histogram_t        *next;          /**< @brief Next registered
+                                                    histogram.              */
+  const char            *name;          /**< @brief Histogram name.         */
+  time_measurement_t    *tmp;           /**< @brief Owner measurement.      */
+  ucnt_t                n;              /**< @brief Number of samples.      */
+  ucnt_t                buckets[CH_CFG_TM_HISTOGRAM_BUCKETS];
+                                        /**< @brief Samples counters.       */
+};
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -94,6 +166,16 @@ extern "C" {
   NOINLINE void chTMStopMeasurementX(time_measurement_t *tmp);
   NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
                                         time_measurement_t *tmp2);
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  void chTMHistogramObjectInit(tm_histogram_t *hp, const char *name);
+  void chTMAttachHistogram(time_measurement_t *tmp, tm_histogram_t *hp);
+  void chTMHistogramResetX(tm_histogram_t *hp);
+  rtcnt_t chTMHistogramGetPercentileX(const tm_histogram_t *hp,
+                                      unsigned permille);
+  rtcnt_t chTMHistogramGetBucketLimitX(unsigned idx);
+  tm_histogram_t *chTMHistogramFirst(void);
+  tm_histogram_t *chTMHistogramNext(tm_histogram_t *hp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -104,6 +186,12 @@ extern "C" {
 
 #endif /* CH_CFG_USE_TM == TRUE */
 
+#if (CH_CFG_USE_TM == FALSE) && defined(CH_CFG_USE_TM_HISTOGRAM)
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+#error "CH_CFG_USE_TM_HISTOGRAM requires CH_CFG_USE_TM"
+#endif
+#endif
+
 #endif /* _CHTM_H_ */
 
 /** @} */
@@ -109,6 +109,11 @@ void PendSV_Handler(void) {
  */
 void _port_irq_epilogue(regarm_t lr) {
 
+  /* Threads must run on the process stack, this keeps the interrupts
+     processing on the main stack and the per-thread reserve minimal.*/
+  chDbgAssert((lr == (regarm_t)0xFFFFFFF1U) || (lr == (regarm_t)0xFFFFFFFDU),
+              "not using PSP");
+
   if (lr != (regarm_t)0xFFFFFFF1U) {
     struct port_extctx *ctxp;
 
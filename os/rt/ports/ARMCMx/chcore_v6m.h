@@ -37,6 +37,11 @@
  */
 #define PORT_SUPPORTS_RT                FALSE
 
+/**
+ * @brief   This port does not support exclusive load/store operations.
+ */
+#define PORT_SUPPORTS_EXCLUSIVE         FALSE
+
 /**
  * @brief   PendSV priority level.
  * @note    This priority is enforced to be equal to @p 0,
@@ -66,12 +71,22 @@
  * @brief   Per-thread stack overhead for interrupts servicing.
  * @details This constant is used in the calculation of the correct working
  *          area size.
- * @note    In this port this value is conservatively set to 64 because the
- *          function @p chSchDoReschedule() can have a stack frame, especially
- *          with compiler optimizations disabled. The value can be reduced
- *          when compiler optimizations are enabled.
- */
-#if !defined(PORT_INT_REQUIRED_STACK)
+ *          Threads run on the process stack and exceptions always run on
+ *          the main stack, so a thread stack only receives the exception
+ *          frame of the first interrupt whatever the nesting level, this
+ *          frame and the context switch frame are already accounted by
+ *          @p PORT_WA_SIZE(). This value only has to cover the frame of
+ *          @p chSchDoReschedule(), which stays on the thread stack when it
+ *          is preempted from an ISR, plus the 4 bytes of alignment the
+ *          exception entry can add.
+ * @note    In this port this value is conservatively set to 64, the
+ *          frame of @p chSchDoReschedule() grows with the debug options,
+ *          the trace, assertions and stack checks, and with a context
+ *          switch hook. A board can lower it in its chconf.h after
+ *          checking the "minimum working area" benchmark of the test
+ *          suite on the target with its own configuration.
+ */
+#if !defined(PORT_INT_REQUIRED_STACK) || defined(__DOXYGEN__)
 #define PORT_INT_REQUIRED_STACK         64
 #endif
 
@@ -194,6 +209,11 @@ struct port_intctx {
 
 /**
  * @brief   Computes the thread working area global size.
+ * @details The fixed part is the switch frame, one exception frame and the
+ *          @p PORT_INT_REQUIRED_STACK reserve. The minimum working area of
+ *          a thread is this size plus the size of the @p thread_t
+ *          structure, the "minimum working area" benchmark of the test
+ *          suite measures the actual usage for the current configuration.
  * @note    There is no need to perform alignments in this macro.
  */
 #define PORT_WA_SIZE(n) (sizeof(struct port_intctx) +                       \
@@ -37,6 +37,11 @@
  */
 #define PORT_SUPPORTS_RT                TRUE
 
+/**
+ * @brief   This port supports exclusive load/store operations.
+ */
+#define PORT_SUPPORTS_EXCLUSIVE         TRUE
+
 /**
  * @brief   Disabled value for BASEPRI register.
  */
@@ -570,6 +575,49 @@ static inline rtcnt_t port_rt_get_counter_value(void) {
   return DWT->CYCCNT;
 }
 
+/**
+ * @brief   Exclusive load of a pointer.
+ * @details Loads a pointer and marks its address for a following
+ *          @p port_store_exclusive().
+ * @note    The exclusive monitor is cleared on exception entry and return
+ *          so the sequence fails if it is preempted.
+ *
+ * @param[in] p         address of the pointer
+ * @return              The pointer value.
+ */
+static inline void *port_load_exclusive(void * volatile *p) {
+
+  /*lint -save -e923 -e9078 [11.1, 11.4] Pointers are 32 bits.*/
+  return (void *)__LDREXW((volatile uint32_t *)p);
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Exclusive store of a pointer.
+ * @details The store is performed only if the address is still marked by
+ *          the preceding @p port_load_exclusive().
+ *
+ * @param[in] p         address of the pointer
+ * @param[in] v         value to be stored
+ * @return              The operation status.
+ * @retval true         if the value has been stored.
+ * @retval false        if the exclusive access has been lost.
+ */
+static inline bool port_store_exclusive(void * volatile *p, void *v) {
+
+  /*lint -save -e923 -e9078 [11.1, 11.4] Pointers are 32 bits.*/
+  return (bool)(__STREXW((uint32_t)v, (volatile uint32_t *)p) == 0U);
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Abandons an exclusive access.
+ */
+static inline void port_clear_exclusive(void) {
+
+  __CLREX();
+}
+
 #endif /* !defined(_FROM_ASM_) */
 
 #endif /* _CHCORE_V7M_H_ */
@@ -14,6 +14,9 @@ endif
 ifneq ($(findstring CH_DBG_STATISTICS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chstats.c
 endif
+ifneq ($(findstring CH_DBG_LOCK_STATISTICS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chlockstats.c
+endif
 ifneq ($(findstring CH_CFG_USE_DYNAMIC TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chdynamic.c
 endif
@@ -41,6 +44,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_QUEUES TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chqueues.c
 endif
+ifneq ($(findstring CH_CFG_USE_PIPES TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chpipes.c
+endif
 ifneq ($(findstring CH_CFG_USE_MEMCORE TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chmemcore.c
 endif
@@ -50,6 +56,15 @@ endif
 ifneq ($(findstring CH_CFG_USE_MEMPOOLS TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chmempools.c
 endif
+ifneq ($(findstring CH_CFG_USE_ARENAS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chmemarena.c
+endif
+ifneq ($(findstring CH_CFG_USE_SLABS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chmemslab.c
+endif
+ifneq ($(findstring CH_CFG_USE_RELOC_HEAPS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chmemreloc.c
+endif
 else
 KERNSRC = $(CHIBIOS)/os/rt/src/chsys.c \
           $(CHIBIOS)/os/rt/src/chdebug.c \
@@ -58,6 +73,7 @@ KERNSRC = $(CHIBIOS)/os/rt/src/chsys.c \
           $(CHIBIOS)/os/rt/src/chthreads.c \
           $(CHIBIOS)/os/rt/src/chtm.c \
           $(CHIBIOS)/os/rt/src/chstats.c \
+          $(CHIBIOS)/os/rt/src/chlockstats.c \
           $(CHIBIOS)/os/rt/src/chdynamic.c \
           $(CHIBIOS)/os/rt/src/chregistry.c \
           $(CHIBIOS)/os/rt/src/chsem.c \
@@ -67,9 +83,13 @@ KERNSRC = $(CHIBIOS)/os/rt/src/chsys.c \
           $(CHIBIOS)/os/rt/src/chmsg.c \
           $(CHIBIOS)/os/rt/src/chmboxes.c \
           $(CHIBIOS)/os/rt/src/chqueues.c \
+          $(CHIBIOS)/os/rt/src/chpipes.c \
           $(CHIBIOS)/os/rt/src/chmemcore.c \
           $(CHIBIOS)/os/rt/src/chheap.c \
-          $(CHIBIOS)/os/rt/src/chmempools.c
+          $(CHIBIOS)/os/rt/src/chmempools.c \
+          $(CHIBIOS)/os/rt/src/chmemarena.c \
+          $(CHIBIOS)/os/rt/src/chmemslab.c \
+          $(CHIBIOS)/os/rt/src/chmemreloc.c
 endif
 
 # Required include directories
@@ -77,6 +77,7 @@ void chCondObjectInit(condition_variable_t *cp) {
   chDbgCheck(cp != NULL);
 
   queue_init(&cp->c_queue);
+  _lock_stats_object_init(&cp->c_stats);
 }
 
 /**
@@ -219,7 +220,15 @@ msg_t chCondWaitS(condition_variable_t *cp) {
      again.*/
   ctp->p_u.wtobjp = cp;
   queue_prio_insert(ctp, &cp->c_queue);
+#if CH_DBG_LOCK_STATISTICS == TRUE
+  {
+    lstime_t start = _lock_stats_wait_begin(&cp->c_stats);
+    chSchGoSleepS(CH_STATE_WTCOND);
+    _lock_stats_wait_end(&cp->c_stats, start);
+  }
+#else
   chSchGoSleepS(CH_STATE_WTCOND);
+#endif
   msg = ctp->p_u.rdymsg;
   chMtxLockS(mp);
 
@@ -309,7 +318,15 @@ msg_t chCondWaitTimeoutS(condition_variable_t *cp, systime_t time) {
      again.*/
   currp->p_u.wtobjp = cp;
   queue_prio_insert(currp, &cp->c_queue);
+#if CH_DBG_LOCK_STATISTICS == TRUE
+  {
+    lstime_t start = _lock_stats_wait_begin(&cp->c_stats);
+    msg = chSchGoSleepTimeoutS(CH_STATE_WTCOND, time);
+    _lock_stats_wait_end(&cp->c_stats, start);
+  }
+#else
   msg = chSchGoSleepTimeoutS(CH_STATE_WTCOND, time);
+#endif
   if (msg != MSG_TIMEOUT) {
     chMtxLockS(mp);
   }
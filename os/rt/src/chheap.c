@@ -128,6 +128,33 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 #endif
 }
 
+/**
+ * @brief   Initializes an empty memory heap fed by a memory provider.
+ * @details The heap obtains memory from the provider when its free blocks
+ *          cannot satisfy a request, like the default heap does with the
+ *          core allocator. Using a core provider with placement hints,
+ *          for example @p chCoreAllocDMA(), the heap is confined to the
+ *          matching memory regions.
+ *
+ * @param[out] heapp    pointer to the memory heap descriptor to be initialized
+ * @param[in] provider  memory provider
+ *
+ * @init
+ */
+void chHeapObjectInitProvider(memory_heap_t *heapp, memgetfunc_t provider) {
+
+  chDbgCheck((heapp != NULL) && (provider != NULL));
+
+  heapp->h_provider = provider;
+  heapp->h_free.h.u.next = NULL;
+  heapp->h_free.h.size = 0;
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  chMtxObjectInit(&heapp->h_mtx);
+#else
+  chSemObjectInit(&heapp->h_sem, (cnt_t)1);
+#endif
+}
+
 /**
  * @brief   Allocates a block of memory from the heap by using the first-fit
  *          algorithm.
@@ -0,0 +1,294 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chlockstats.c
+ * @brief   Lock contention statistics code.
+ *
+ * @addtogroup lock_statistics
+ * @details Lock contention statistics.
+ *          <h2>Operation mode</h2>
+ *          Each mutex, semaphore and condition variable embeds a
+ *          @p lock_stats_t structure updated by the kernel on each
+ *          acquisition. Objects can be registered with a name using
+ *          @p chMtxSetName(), @p chSemSetName() or @p chCondSetName(),
+ *          registered objects can then be enumerated, for example by a
+ *          shell command listing the worst offenders.
+ * @pre     In order to use the lock statistics the
+ *          @p CH_DBG_LOCK_STATISTICS option must be enabled in
+ *          @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_DBG_LOCK_STATISTICS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static inline lstime_t ls_now(void) {
+
+#if PORT_SUPPORTS_RT == TRUE
+  return chSysGetRealtimeCounterX();
+#else
+  return chVTGetSystemTimeX();
+#endif
+}
+
+static void ls_clear(lock_stats_t *lsp) {
+
+  lsp->ls_acquired   = (ucnt_t)0;
+  lsp->ls_contended  = (ucnt_t)0;
+  lsp->ls_wait_total = (rttime_t)0;
+  lsp->ls_wait_max   = (lstime_t)0;
+  lsp->ls_hold_max   = (lstime_t)0;
+  lsp->ls_hold_thd   = NULL;
+  lsp->ls_hold_name  = NULL;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the lock statistics module.
+ *
+ * @init
+ */
+void _lock_stats_init(void) {
+
+  ch.lockstats = NULL;
+}
+
+/**
+ * @brief   Initializes the statistics of a lock object.
+ * @note    The registration fields are not touched, those are only
+ *          meaningful after @p chLockStatsRegister() and an object
+ *          initialized again keeps its registration.
+ *
+ * @param[out] lsp      pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _lock_stats_object_init(lock_stats_t *lsp) {
+
+  lsp->ls_hold_start = (lstime_t)0;
+  ls_clear(lsp);
+}
+
+/**
+ * @brief   Accounts an acquisition performed without waiting.
+ *
+ * @param[in,out] lsp   pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _lock_stats_acquired(lock_stats_t *lsp) {
+
+  lsp->ls_acquired++;
+  lsp->ls_hold_start = ls_now();
+}
+
+/**
+ * @brief   Accounts a failed acquisition attempt.
+ *
+ * @param[in,out] lsp   pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _lock_stats_failed(lock_stats_t *lsp) {
+
+  lsp->ls_contended++;
+}
+
+/**
+ * @brief   Accounts a contended acquisition, the caller is about to sleep.
+ *
+ * @param[in,out] lsp   pointer to the @p lock_stats_t structure
+ * @return              The time stamp to be passed to
+ *                      @p _lock_stats_wait_end().
+ *
+ * @notapi
+ */
+lstime_t _lock_stats_wait_begin(lock_stats_t *lsp) {
+
+  lsp->ls_contended++;
+
+  return ls_now();
+}
+
+/**
+ * @brief   Accounts the end of a wait.
+ * @details The wait is accounted as an acquisition whatever the outcome,
+ *          a timed out wait is a contended acquisition anyway.
+ *
+ * @param[in,out] lsp   pointer to the @p lock_stats_t structure
+ * @param[in] start     time stamp returned by @p _lock_stats_wait_begin()
+ *
+ * @notapi
+ */
+void _lock_stats_wait_end(lock_stats_t *lsp, lstime_t start) {
+  lstime_t wait = ls_now() - start;
+
+  lsp->ls_acquired++;
+  lsp->ls_wait_total += (rttime_t)wait;
+  if (wait > lsp->ls_wait_max) {
+    lsp->ls_wait_max = wait;
+  }
+}
+
+/**
+ * @brief   Accounts the hand-off of a mutex to a waiting thread.
+ *
+ * @param[in,out] lsp   pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _lock_stats_handoff(lock_stats_t *lsp) {
+
+  lsp->ls_hold_start = ls_now();
+}
+
+/**
+ * @brief   Accounts the release of a mutex by the current thread.
+ *
+ * @param[in,out] lsp   pointer to the @p lock_stats_t structure
+ *
+ * @notapi
+ */
+void _lock_stats_released(lock_stats_t *lsp) {
+  lstime_t hold = ls_now() - lsp->ls_hold_start;
+
+  if (hold > lsp->ls_hold_max) {
+    lsp->ls_hold_max  = hold;
+    lsp->ls_hold_thd  = currp;
+    lsp->ls_hold_name = chRegGetThreadNameX(currp);
+  }
+}
+
+/**
+ * @brief   Registers a lock object with a name.
+ * @details The object is added to the list of registered objects, if the
+ *          object is already registered then just the name is updated.
+ * @pre     The object must have been initialized and must not be
+ *          deallocated while registered.
+ * @note    Use the @p chMtxSetName(), @p chSemSetName() and
+ *          @p chCondSetName() wrappers.
+ *
+ * @param[in] lsp       pointer to the @p lock_stats_t structure
+ * @param[in] name      object name
+ * @param[in] type      object type, one of @p LOCK_STATS_MUTEX,
+ *                      @p LOCK_STATS_SEMAPHORE or @p LOCK_STATS_CONDVAR
+ *
+ * @api
+ */
+void chLockStatsRegister(lock_stats_t *lsp, const char *name, char type) {
+  lock_stats_t *p;
+
+  chDbgCheck(lsp != NULL);
+
+  chSysLock();
+  lsp->ls_name = name;
+  lsp->ls_type = type;
+  p = ch.lockstats;
+  while ((p != NULL) && (p != lsp)) {
+    p = p->ls_next;
+  }
+  if (p == NULL) {
+    lsp->ls_next = ch.lockstats;
+    ch.lockstats = lsp;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the statistics of all the registered objects.
+ *
+ * @api
+ */
+void chLockStatsReset(void) {
+  lock_stats_t *lsp;
+
+  chSysLock();
+  for (lsp = ch.lockstats; lsp != NULL; lsp = lsp->ls_next) {
+    ls_clear(lsp);
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the first registered lock object.
+ *
+ * @return              A pointer to the first registered object.
+ * @retval NULL         if no object has been registered.
+ *
+ * @api
+ */
+lock_stats_t *chLockStatsFirst(void) {
+  lock_stats_t *lsp;
+
+  chSysLock();
+  lsp = ch.lockstats;
+  chSysUnlock();
+
+  return lsp;
+}
+
+/**
+ * @brief   Returns the registered lock object next to the specified one.
+ *
+ * @param[in] lsp       pointer to a registered object
+ * @return              A pointer to the next registered object.
+ * @retval NULL         if there is no next object.
+ *
+ * @api
+ */
+lock_stats_t *chLockStatsNext(lock_stats_t *lsp) {
+  lock_stats_t *nlsp;
+
+  chDbgCheck(lsp != NULL);
+
+  chSysLock();
+  nlsp = lsp->ls_next;
+  chSysUnlock();
+
+  return nlsp;
+}
+
+#endif /* CH_DBG_LOCK_STATISTICS == TRUE */
+
+/** @} */
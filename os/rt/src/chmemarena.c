@@ -0,0 +1,249 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chmemarena.c
+ * @brief   Memory Arenas code.
+ *
+ * @addtogroup arenas
+ * @details Memory Arenas related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          An arena is a buffer, taken from the core allocator, from a
+ *          heap or statically allocated, serving allocations by just
+ *          advancing a pointer. Allocations cannot be freed one by one,
+ *          instead the allocation level can be marked and later rolled
+ *          back to the mark, releasing everything allocated in between
+ *          in a single step.<br>
+ *          Arenas are meant for short-lived scratch memory with a well
+ *          defined scope, for example the buffers used while processing
+ *          a request, allocation and release are O(1) and there is no
+ *          fragmentation.<br>
+ *          Arenas are not protected by locks, an arena is meant to be
+ *          used by a single thread. When the @p CH_CFG_USE_THREAD_ARENAS
+ *          option is enabled each thread can have a default arena, used
+ *          when @p NULL is passed as arena to @p chArenaAlloc().
+ * @pre     In order to use the memory arenas APIs the @p CH_CFG_USE_ARENAS
+ *          option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_ARENAS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a memory arena over a buffer.
+ * @note    The size is rounded down to a multiple of @p MEM_ALIGN_SIZE.
+ *
+ * @param[out] ap       pointer to a @p memory_arena_t structure
+ * @param[in] buf       arena buffer, must be aligned to @p MEM_ALIGN_SIZE
+ * @param[in] size      size of the arena buffer
+ *
+ * @init
+ */
+void chArenaObjectInit(memory_arena_t *ap, void *buf, size_t size) {
+
+  chDbgCheck((ap != NULL) && MEM_IS_ALIGNED(buf));
+
+  ap->a_base = (uint8_t *)buf;
+  ap->a_next = (uint8_t *)buf;
+  ap->a_end  = (uint8_t *)buf + MEM_ALIGN_PREV(size);
+#if CH_CFG_USE_HEAP == TRUE
+  ap->a_owned = false;
+#endif
+}
+
+/**
+ * @brief   Initializes a memory arena with a buffer from the core allocator.
+ * @note    Core memory cannot be returned, @p chArenaRelease() on this
+ *          arena just detaches the buffer, such an arena is usually
+ *          created once and rolled back with @p chArenaResetX() or
+ *          @p chArenaClearX() after each use.
+ *
+ * @param[out] ap       pointer to a @p memory_arena_t structure
+ * @param[in] size      size of the arena buffer
+ * @return              The pointer to the initialized arena.
+ * @retval NULL         if the core memory is exhausted.
+ *
+ * @api
+ */
+memory_arena_t *chArenaObjectInitFromCore(memory_arena_t *ap, size_t size) {
+  void *buf;
+
+  chDbgCheck(ap != NULL);
+
+  size = MEM_ALIGN_NEXT(size);
+  buf = chCoreAlloc(size);
+  if (buf == NULL) {
+    return NULL;
+  }
+  chArenaObjectInit(ap, buf, size);
+
+  return ap;
+}
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a memory arena with a buffer from a heap.
+ * @details The buffer is returned to the heap by @p chArenaRelease().
+ *
+ * @param[out] ap       pointer to a @p memory_arena_t structure
+ * @param[in] heapp     heap from which allocate the arena buffer or
+ *                      @p NULL for the default heap
+ * @param[in] size      size of the arena buffer
+ * @return              The pointer to the initialized arena.
+ * @retval NULL         if the heap allocation failed.
+ *
+ * @api
+ */
+memory_arena_t *chArenaObjectInitFromHeap(memory_arena_t *ap,
+                                          memory_heap_t *heapp,
+                                          size_t size) {
+  void *buf;
+
+  chDbgCheck(ap != NULL);
+
+  size = MEM_ALIGN_NEXT(size);
+  buf = chHeapAlloc(heapp, size);
+  if (buf == NULL) {
+    return NULL;
+  }
+  chArenaObjectInit(ap, buf, size);
+  ap->a_owned = true;
+
+  return ap;
+}
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+/**
+ * @brief   Releases a memory arena.
+ * @details All the allocations are released at once, if the buffer has
+ *          been taken from a heap by @p chArenaObjectInitFromHeap() then
+ *          it is returned to the heap. The arena is left empty, further
+ *          allocations fail until it is initialized again.
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure
+ *
+ * @api
+ */
+void chArenaRelease(memory_arena_t *ap) {
+
+  chDbgCheck(ap != NULL);
+
+#if CH_CFG_USE_HEAP == TRUE
+  if (ap->a_owned) {
+    ap->a_owned = false;
+    chHeapFree(ap->a_base);
+  }
+#endif
+  ap->a_base = NULL;
+  ap->a_next = NULL;
+  ap->a_end  = NULL;
+}
+
+/**
+ * @brief   Allocates a block of memory from an arena.
+ * @details The allocated block is guaranteed to be aligned to
+ *          @p MEM_ALIGN_SIZE, the operation is O(1).
+ * @note    The arena is not protected by locks, it must not be used by
+ *          more than one thread at time.
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure or
+ *                      @p NULL for the default arena of the current thread,
+ *                      see @p chArenaSetDefault()
+ * @param[in] size      the size of the block to be allocated
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         if the arena is exhausted or there is no default
+ *                      arena.
+ *
+ * @xclass
+ */
+void *chArenaAlloc(memory_arena_t *ap, size_t size) {
+  void *p;
+
+#if CH_CFG_USE_THREAD_ARENAS == TRUE
+  if (ap == NULL) {
+    ap = chArenaGetDefaultX();
+    if (ap == NULL) {
+      return NULL;
+    }
+  }
+#else
+  chDbgCheck(ap != NULL);
+#endif
+
+  size = MEM_ALIGN_NEXT(size);
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  if ((size_t)(ap->a_end - ap->a_next) < size) {
+  /*lint -restore*/
+    return NULL;
+  }
+  p = ap->a_next;
+  ap->a_next += size;
+
+  return p;
+}
+
+#if (CH_CFG_USE_THREAD_ARENAS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the default arena of the current thread.
+ * @details The previous default arena is returned so that a scope can
+ *          install its own arena and restore the previous one on exit.
+ * @note    The default arena is not released when the thread terminates.
+ *
+ * @param[in] ap        pointer to a @p memory_arena_t structure or
+ *                      @p NULL for no default arena
+ * @return              The previous default arena.
+ *
+ * @xclass
+ */
+memory_arena_t *chArenaSetDefault(memory_arena_t *ap) {
+  thread_t *tp = chThdGetSelfX();
+  memory_arena_t *oap;
+
+  oap = tp->p_arena;
+  tp->p_arena = ap;
+
+  return oap;
+}
+#endif /* CH_CFG_USE_THREAD_ARENAS == TRUE */
+
+#endif /* CH_CFG_USE_ARENAS == TRUE */
+
+/** @} */
@@ -38,6 +38,10 @@
  *          This allocator, alone, is also useful for very simple
  *          applications that just require a simple way to get memory
  *          blocks.
+ *          When the @p CH_CFG_USE_MEMCORE_REGIONS option is enabled then
+ *          further memory regions can be added to the allocator, each
+ *          region has attributes (fast, DMA-capable, retained) and
+ *          allocations can specify placement hints.
  * @pre     In order to use the core memory manager APIs the @p CH_CFG_USE_MEMCORE
  *          option must be enabled in @p chconf.h.
  * @{
@@ -59,13 +63,54 @@
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_MEMCORE_REGIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Default memory region.
+ */
+static memory_region_t default_region;
+
+/**
+ * @brief   List of the memory regions, the default region is the first.
+ */
+static memory_region_t *regions;
+#else
 static uint8_t *nextmem;
 static uint8_t *endmem;
+#endif
 
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_MEMCORE_REGIONS == TRUE) || defined(__DOXYGEN__)
+static void *region_alloc(memory_region_t *mrp, size_t size) {
+  void *p;
+
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  if ((size_t)(mrp->endmem - mrp->nextmem) < size) {
+  /*lint -restore*/
+    return NULL;
+  }
+  p = mrp->nextmem;
+  mrp->nextmem += size;
+
+  return p;
+}
+
+/* Usable from any context, memory pools invoke their provider with the
+   kernel already locked.*/
+static void *core_alloc_x(size_t size, memflags_t hints) {
+  syssts_t sts;
+  void *p;
+
+  sts = chSysGetStatusAndLockX();
+  p = chCoreAllocHintI(size, hints);
+  chSysRestoreStatusX(sts);
+
+  return p;
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -80,18 +125,35 @@ void _core_init(void) {
   extern uint8_t __heap_base__[];
   extern uint8_t __heap_end__[];
 
+#if CH_CFG_USE_MEMCORE_REGIONS == TRUE
+  /*lint -save -e9033 [10.8] Required cast operations.*/
+  default_region.nextmem = (uint8_t *)MEM_ALIGN_NEXT(__heap_base__);
+  default_region.endmem = (uint8_t *)MEM_ALIGN_PREV(__heap_end__);
+  /*lint restore*/
+#else
   /*lint -save -e9033 [10.8] Required cast operations.*/
   nextmem = (uint8_t *)MEM_ALIGN_NEXT(__heap_base__);
   endmem = (uint8_t *)MEM_ALIGN_PREV(__heap_end__);
   /*lint restore*/
+#endif
 #else
   static stkalign_t buffer[MEM_ALIGN_NEXT(CH_CFG_MEMCORE_SIZE) /
                            MEM_ALIGN_SIZE];
 
+#if CH_CFG_USE_MEMCORE_REGIONS == TRUE
+  default_region.nextmem = (uint8_t *)&buffer[0];
+  default_region.endmem = default_region.nextmem + sizeof (buffer);
+#else
   nextmem = (uint8_t *)&buffer[0];
   endmem = (uint8_t *)&buffer[MEM_ALIGN_NEXT(CH_CFG_MEMCORE_SIZE) /
                               MEM_ALIGN_SIZE];
 #endif
+#endif
+#if CH_CFG_USE_MEMCORE_REGIONS == TRUE
+  default_region.next = NULL;
+  default_region.flags = (memflags_t)CH_CFG_MEMCORE_DEFAULT_FLAGS;
+  regions = &default_region;
+#endif
 }
 
 /**
@@ -129,6 +191,10 @@ void *chCoreAlloc(size_t size) {
  * @iclass
  */
 void *chCoreAllocI(size_t size) {
+#if CH_CFG_USE_MEMCORE_REGIONS == TRUE
+
+  return chCoreAllocHintI(size, (memflags_t)MEM_ANY);
+#else
   void *p;
 
   chDbgCheckClassI();
@@ -143,6 +209,7 @@ void *chCoreAllocI(size_t size) {
   nextmem += size;
 
   return p;
+#endif
 }
 
 /**
@@ -154,10 +221,195 @@ void *chCoreAllocI(size_t size) {
  */
 size_t chCoreGetStatusX(void) {
 
+#if CH_CFG_USE_MEMCORE_REGIONS == TRUE
+  return chCoreGetStatusHintX((memflags_t)MEM_ANY);
+#else
   /*lint -save -e9033 [10.8] The cast is safe.*/
   return (size_t)(endmem - nextmem);
   /*lint -restore*/
+#endif
+}
+
+#if (CH_CFG_USE_MEMCORE_REGIONS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Adds a memory region to the core allocator.
+ * @details The region is appended to the regions list, allocations are
+ *          served by the first region, in list order, matching the hints
+ *          and having enough free space. The default region is always the
+ *          first.
+ * @note    Adding a region already in the list just resets its boundaries.
+ *
+ * @param[out] mrp      pointer to a @p memory_region_t structure
+ * @param[in] base      region base address
+ * @param[in] end       region end address +1
+ * @param[in] flags     region attributes, a combination of @p MEM_FAST,
+ *                      @p MEM_DMA and @p MEM_RETAINED
+ *
+ * @init
+ */
+void chCoreAddRegion(memory_region_t *mrp, void *base, void *end,
+                     memflags_t flags) {
+  memory_region_t **mrpp;
+
+  chDbgCheck((mrp != NULL) && (base <= end));
+
+  chSysLock();
+  /*lint -save -e9033 [10.8] Required cast operations.*/
+  mrp->nextmem = (uint8_t *)MEM_ALIGN_NEXT(base);
+  mrp->endmem = (uint8_t *)MEM_ALIGN_PREV(end);
+  /*lint restore*/
+  if (mrp->endmem < mrp->nextmem) {
+    mrp->endmem = mrp->nextmem;
+  }
+  mrp->flags = flags;
+  mrpp = &regions;
+  while ((*mrpp != NULL) && (*mrpp != mrp)) {
+    mrpp = &(*mrpp)->next;
+  }
+  if (*mrpp == NULL) {
+    mrp->next = NULL;
+    *mrpp = mrp;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Allocates a memory block with placement hints.
+ * @details The size of the returned block is aligned to the alignment
+ *          type so it is not possible to allocate less
+ *          than <code>MEM_ALIGN_SIZE</code>.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] hints     required region attributes, @p MEM_FAST is only a
+ *                      preference
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, no matching region has enough
+ *                      free memory.
+ *
+ * @api
+ */
+void *chCoreAllocHint(size_t size, memflags_t hints) {
+  void *p;
+
+  chSysLock();
+  p = chCoreAllocHintI(size, hints);
+  chSysUnlock();
+
+  return p;
+}
+
+/**
+ * @brief   Allocates a memory block with placement hints.
+ * @details The size of the returned block is aligned to the alignment
+ *          type so it is not possible to allocate less
+ *          than <code>MEM_ALIGN_SIZE</code>.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] hints     required region attributes, @p MEM_FAST is only a
+ *                      preference
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, no matching region has enough
+ *                      free memory.
+ *
+ * @iclass
+ */
+void *chCoreAllocHintI(size_t size, memflags_t hints) {
+  memory_region_t *mrp;
+  void *p;
+
+  chDbgCheckClassI();
+
+  size = MEM_ALIGN_NEXT(size);
+  while (true) {
+    for (mrp = regions; mrp != NULL; mrp = mrp->next) {
+      if ((mrp->flags & hints) == hints) {
+        p = region_alloc(mrp, size);
+        if (p != NULL) {
+          return p;
+        }
+      }
+    }
+
+    /* Fast memory is a preference, retrying without it.*/
+    if ((hints & (memflags_t)MEM_FAST) == 0U) {
+      return NULL;
+    }
+    hints &= (memflags_t)~MEM_FAST;
+  }
+}
+
+/**
+ * @brief   Allocates a memory block preferably from fast memory.
+ * @note    This function is assignment compatible with @p memgetfunc_t and
+ *          can be used as provider for memory pools and heaps.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, core memory exhausted.
+ *
+ * @xclass
+ */
+void *chCoreAllocFast(size_t size) {
+
+  return core_alloc_x(size, (memflags_t)MEM_FAST);
+}
+
+/**
+ * @brief   Allocates a memory block from DMA-capable memory.
+ * @note    This function is assignment compatible with @p memgetfunc_t and
+ *          can be used as provider for memory pools and heaps.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, no DMA-capable memory left.
+ *
+ * @xclass
+ */
+void *chCoreAllocDMA(size_t size) {
+
+  return core_alloc_x(size, (memflags_t)MEM_DMA);
+}
+
+/**
+ * @brief   Allocates a memory block from retained memory.
+ * @note    This function is assignment compatible with @p memgetfunc_t and
+ *          can be used as provider for memory pools and heaps.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, no retained memory left.
+ *
+ * @xclass
+ */
+void *chCoreAllocRetained(size_t size) {
+
+  return core_alloc_x(size, (memflags_t)MEM_RETAINED);
+}
+
+/**
+ * @brief   Core memory status for the regions matching the hints.
+ *
+ * @param[in] hints     region attributes, all of them must be present
+ * @return              The size, in bytes, of the free core memory in the
+ *                      matching regions.
+ *
+ * @xclass
+ */
+size_t chCoreGetStatusHintX(memflags_t hints) {
+  memory_region_t *mrp;
+  size_t n = 0U;
+
+  for (mrp = regions; mrp != NULL; mrp = mrp->next) {
+    if ((mrp->flags & hints) == hints) {
+      /*lint -save -e9033 [10.8] The cast is safe.*/
+      n += (size_t)(mrp->endmem - mrp->nextmem);
+      /*lint -restore*/
+    }
+  }
+
+  return n;
 }
+#endif /* CH_CFG_USE_MEMCORE_REGIONS == TRUE */
 #endif /* CH_CFG_USE_MEMCORE == TRUE */
 
 /** @} */
@@ -29,7 +29,12 @@
  *          problems.<br>
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
- *          to contain a pointer to void.
+ *          to contain a pointer to void.<br>
+ *          When the @p CH_CFG_USE_LOCKFREE_POOLS option is enabled and
+ *          the port supports exclusive load/store operations then the
+ *          free lists are updated using exclusive accesses instead of
+ *          critical zones, @p chPoolAlloc() and @p chPoolFree() only
+ *          lock the kernel when the pool provider has to be invoked.
  * @pre     In order to use the memory pools APIs the @p CH_CFG_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @{
@@ -55,6 +60,54 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_MEMPOOLS_LOCKFREE == TRUE) || defined(__DOXYGEN__)
+/*
+ * Removes the first object from a pool free list. The next pointer is read
+ * within the exclusive access so, if the sequence is preempted by code
+ * changing the list, the store fails and the operation is retried, the
+ * exclusive monitor itself protects against the ABA problem.
+ */
+static struct pool_header *pool_pop(memory_pool_t *mp) {
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  void * volatile *headp = (void * volatile *)&mp->mp_next;
+  /*lint -restore*/
+  struct pool_header *php;
+
+  do {
+    php = port_load_exclusive(headp);
+    if (php == NULL) {
+      port_clear_exclusive();
+      break;
+    }
+  } while (!port_store_exclusive(headp, php->ph_next));
+
+  return php;
+}
+
+/*
+ * Inserts an object in a pool free list. The object is linked outside the
+ * exclusive access, the head is then replaced only if it did not change.
+ */
+static void pool_push(memory_pool_t *mp, struct pool_header *php) {
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  void * volatile *headp = (void * volatile *)&mp->mp_next;
+  /*lint -restore*/
+  void *head;
+
+  while (true) {
+    head = *headp;
+    php->ph_next = head;
+    if (port_load_exclusive(headp) != head) {
+      port_clear_exclusive();
+      continue;
+    }
+    if (port_store_exclusive(headp, php)) {
+      break;
+    }
+  }
+}
+#endif /* CH_MEMPOOLS_LOCKFREE == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -68,7 +121,9 @@
  *                      void.
  * @param[in] provider  memory provider function for the memory pool or
  *                      @p NULL if the pool is not allowed to grow
- *                      automatically
+ *                      automatically, the core providers with placement
+ *                      hints like @p chCoreAllocDMA() place the objects in
+ *                      the matching memory regions
  *
  * @init
  */
@@ -123,6 +178,12 @@ void *chPoolAllocI(memory_pool_t *mp) {
   chDbgCheckClassI();
   chDbgCheck(mp != NULL);
 
+#if CH_MEMPOOLS_LOCKFREE == TRUE
+  objp = pool_pop(mp);
+  if ((objp == NULL) && (mp->mp_provider != NULL)) {
+    objp = mp->mp_provider(mp->mp_object_size);
+  }
+#else
   objp = mp->mp_next;
   /*lint -save -e9013 [15.7] There is no else because it is not needed.*/
   if (objp != NULL) {
@@ -132,6 +193,7 @@ void *chPoolAllocI(memory_pool_t *mp) {
     objp = mp->mp_provider(mp->mp_object_size);
   }
   /*lint -restore*/
+#endif
 
   return objp;
 }
@@ -149,9 +211,20 @@ void *chPoolAllocI(memory_pool_t *mp) {
 void *chPoolAlloc(memory_pool_t *mp) {
   void *objp;
 
+#if CH_MEMPOOLS_LOCKFREE == TRUE
+  chDbgCheck(mp != NULL);
+
+  objp = pool_pop(mp);
+  if ((objp == NULL) && (mp->mp_provider != NULL)) {
+    chSysLock();
+    objp = mp->mp_provider(mp->mp_object_size);
+    chSysUnlock();
+  }
+#else
   chSysLock();
   objp = chPoolAllocI(mp);
   chSysUnlock();
+#endif
 
   return objp;
 }
@@ -174,8 +247,12 @@ void chPoolFreeI(memory_pool_t *mp, void *objp) {
   chDbgCheckClassI();
   chDbgCheck((mp != NULL) && (objp != NULL));
 
+#if CH_MEMPOOLS_LOCKFREE == TRUE
+  pool_push(mp, php);
+#else
   php->ph_next = mp->mp_next;
   mp->mp_next = php;
+#endif
 }
 
 /**
@@ -192,9 +269,15 @@ void chPoolFreeI(memory_pool_t *mp, void *objp) {
  */
 void chPoolFree(memory_pool_t *mp, void *objp) {
 
+#if CH_MEMPOOLS_LOCKFREE == TRUE
+  chDbgCheck((mp != NULL) && (objp != NULL));
+
+  pool_push(mp, (struct pool_header *)objp);
+#else
   chSysLock();
   chPoolFreeI(mp, objp);
   chSysUnlock();
+#endif
 }
 
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
@@ -0,0 +1,525 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chmemreloc.c
+ * @brief   Relocatable heaps code.
+ *
+ * @addtogroup reloc_heaps
+ * @details Handle-based relocatable heaps.
+ *          <h2>Operation mode</h2>
+ *          Blocks allocated from a relocatable heap are not referenced by
+ *          address but by handle. In order to access a block its handle
+ *          must be locked using @p chRHeapLock(), the returned address is
+ *          only valid until the matching @p chRHeapUnlock().<br>
+ *          Unlocked blocks can be moved by the allocator, freed blocks
+ *          leave holes that are eliminated by sliding the following
+ *          blocks down, so the free space is collected at the end of the
+ *          heap buffer instead of being fragmented.<br>
+ *          Compaction is performed incrementally by a low priority
+ *          thread, see @p chRHeapStartCompactor(), or explicitly using
+ *          @p chRHeapCompact(). An allocation that does not fit because of
+ *          fragmentation performs a full compaction before failing.
+ *          <h2>Notes</h2>
+ *          - Blocks locked for long times prevent compaction of the
+ *            holes below them.
+ *          - Allocations and handle lookups are O(n) in the number of
+ *            blocks and handles, the heap is meant for small parts with a
+ *            limited number of objects.
+ *          .
+ * @pre     In order to use the relocatable heaps APIs the
+ *          @p CH_CFG_USE_RELOC_HEAPS option must be enabled in
+ *          @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_RELOC_HEAPS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#define RH_LOCK(rhp)        chMtxLock(&(rhp)->rh_mtx)
+#define RH_UNLOCK(rhp)      chMtxUnlock(&(rhp)->rh_mtx)
+
+/*lint -save -e9026 [20.10] Function-like macros.*/
+#define BLK(p)              ((union rheap_block *)(void *)(p))
+#define NEXT(bp)            ((uint8_t *)(bp) + (bp)->b.size)
+/*lint -restore*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/* Moves a block down, the areas can overlap. Sizes are multiple of the
+   alignment unit so the copy is done in stkalign_t words.*/
+static void rheap_move(void *dst, const void *src, size_t size) {
+  stkalign_t *d = dst;
+  const stkalign_t *s = src;
+
+  size /= sizeof (stkalign_t);
+  while (size > (size_t)0) {
+    *d++ = *s++;
+    size--;
+  }
+}
+
+/* Merges the holes following a hole.*/
+static void rheap_coalesce(reloc_heap_t *rhp, union rheap_block *bp) {
+  union rheap_block *nbp;
+
+  while (NEXT(bp) < rhp->rh_top) {
+    nbp = BLK(NEXT(bp));
+    if (nbp->b.handle != NULL) {
+      break;
+    }
+    bp->b.size += nbp->b.size;
+  }
+}
+
+/* Gives a hole at the top back to the free tail.*/
+static bool rheap_reclaim(reloc_heap_t *rhp, union rheap_block *bp) {
+
+  if (NEXT(bp) != rhp->rh_top) {
+    return false;
+  }
+
+  rhp->rh_top = (uint8_t *)bp;
+  rhp->rh_holes -= bp->b.size;
+  rhp->rh_stats.rs_reclaimed += bp->b.size;
+
+  return true;
+}
+
+/* First fit into the holes then into the free tail, the heap must be
+   locked.*/
+static union rheap_block *rheap_fit(reloc_heap_t *rhp, size_t size) {
+  union rheap_block *bp, *fp;
+  uint8_t *p = rhp->rh_base;
+
+  while (p < rhp->rh_top) {
+    bp = BLK(p);
+    if (bp->b.handle == NULL) {
+      rheap_coalesce(rhp, bp);
+      if (rheap_reclaim(rhp, bp)) {
+        break;
+      }
+      if (bp->b.size >= size) {
+        if ((bp->b.size - size) >= sizeof (union rheap_block)) {
+          fp = BLK(p + size);
+          fp->b.handle = NULL;
+          fp->b.size = bp->b.size - size;
+          bp->b.size = size;
+        }
+        rhp->rh_holes -= bp->b.size;
+        return bp;
+      }
+    }
+    p = NEXT(bp);
+  }
+
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  if ((size_t)(rhp->rh_end - rhp->rh_top) >= size) {
+  /*lint -restore*/
+    bp = BLK(rhp->rh_top);
+    bp->b.size = size;
+    rhp->rh_top += size;
+    return bp;
+  }
+
+  return NULL;
+}
+
+/* Slides unlocked blocks over the holes until at least limit bytes have
+   been processed, zero means no limit. The heap must be locked.*/
+static size_t rheap_compact(reloc_heap_t *rhp, size_t limit) {
+  union rheap_block *bp, *nbp;
+  rhandle_t *hp;
+  uint8_t *p = rhp->rh_base;
+  size_t hole, size, work = (size_t)0;
+
+  while (p < rhp->rh_top) {
+    bp = BLK(p);
+    if (bp->b.handle != NULL) {
+      p = NEXT(bp);
+      continue;
+    }
+
+    rheap_coalesce(rhp, bp);
+    hole = bp->b.size;
+    if (rheap_reclaim(rhp, bp)) {
+      work += hole;
+      break;
+    }
+
+    /* A locked block cannot be moved, the hole below it stays.*/
+    nbp = BLK(NEXT(bp));
+    hp = nbp->b.handle;
+    if (hp->h_locks > (cnt_t)0) {
+      p = NEXT(nbp);
+      continue;
+    }
+
+    /* The block is moved down, the hole goes above it.*/
+    size = nbp->b.size;
+    rheap_move(bp, nbp, size);
+    hp->h_ptr = (void *)(bp + 1);
+    bp = BLK(p + size);
+    bp->b.handle = NULL;
+    bp->b.size = hole;
+    rhp->rh_stats.rs_moves++;
+    rhp->rh_stats.rs_moved += size;
+    work += size;
+    p += size;
+
+    if ((limit > (size_t)0) && (work >= limit)) {
+      break;
+    }
+  }
+
+  if (work > (size_t)0) {
+    rhp->rh_stats.rs_steps++;
+  }
+
+  return work;
+}
+
+static void rheap_compactor(void *arg) {
+  reloc_heap_t *rhp = arg;
+
+  while (true) {
+    (void) chBSemWait(&rhp->rh_dirty);
+    if (chThdShouldTerminateX()) {
+      break;
+    }
+    while (chRHeapCompact(rhp, (size_t)CH_CFG_RHEAP_COMPACT_STEP) >
+           (size_t)0) {
+      chThdYield();
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a relocatable heap.
+ *
+ * @param[out] rhp      pointer to a @p reloc_heap_t structure
+ * @param[in] handles   array of handles, one handle is required for each
+ *                      allocated block
+ * @param[in] n         number of handles in the array
+ * @param[in] buf       heap buffer base, must be aligned to
+ *                      @p MEM_ALIGN_SIZE
+ * @param[in] size      heap buffer size, must be a multiple of
+ *                      @p MEM_ALIGN_SIZE, see @p CH_RHEAP_BLOCK_SIZE()
+ *
+ * @init
+ */
+void chRHeapObjectInit(reloc_heap_t *rhp, rhandle_t *handles, size_t n,
+                       void *buf, size_t size) {
+  size_t i;
+
+  chDbgCheck((rhp != NULL) && (handles != NULL) && (n > (size_t)0) &&
+             MEM_IS_ALIGNED(buf) && MEM_IS_ALIGNED(size));
+
+  rhp->rh_base = (uint8_t *)buf;
+  rhp->rh_top  = (uint8_t *)buf;
+  rhp->rh_end  = (uint8_t *)buf + size;
+  rhp->rh_handles  = handles;
+  rhp->rh_nhandles = n;
+  rhp->rh_holes = (size_t)0;
+  for (i = (size_t)0; i < n; i++) {
+    handles[i].h_ptr = NULL;
+    handles[i].h_locks = (cnt_t)0;
+  }
+  chMtxObjectInit(&rhp->rh_mtx);
+  chBSemObjectInit(&rhp->rh_dirty, true);
+  rhp->rh_stats.rs_steps = (ucnt_t)0;
+  rhp->rh_stats.rs_moves = (ucnt_t)0;
+  rhp->rh_stats.rs_moved = (size_t)0;
+  rhp->rh_stats.rs_reclaimed = (size_t)0;
+  rhp->rh_stats.rs_rescues = (ucnt_t)0;
+  rhp->rh_stats.rs_failures = (ucnt_t)0;
+}
+
+/**
+ * @brief   Allocates a block from a relocatable heap.
+ * @details If the block does not fit because of fragmentation then the
+ *          heap is compacted before giving up.
+ * @post    The block is unlocked, use @p chRHeapLock() in order to access
+ *          it.
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[in] size      the size of the block to be allocated
+ * @return              The handle of the allocated block.
+ * @retval NULL         if the heap or the handles are exhausted.
+ *
+ * @api
+ */
+rhandle_t *chRHeapAlloc(reloc_heap_t *rhp, size_t size) {
+  union rheap_block *bp;
+  rhandle_t *hp = NULL;
+  size_t i;
+
+  chDbgCheck(rhp != NULL);
+
+  size = CH_RHEAP_BLOCK_SIZE(size);
+
+  RH_LOCK(rhp);
+  for (i = (size_t)0; i < rhp->rh_nhandles; i++) {
+    if (rhp->rh_handles[i].h_ptr == NULL) {
+      hp = &rhp->rh_handles[i];
+      break;
+    }
+  }
+  if (hp == NULL) {
+    rhp->rh_stats.rs_failures++;
+    RH_UNLOCK(rhp);
+    return NULL;
+  }
+
+  bp = rheap_fit(rhp, size);
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  if ((bp == NULL) &&
+      (((size_t)(rhp->rh_end - rhp->rh_top) + rhp->rh_holes) >= size)) {
+  /*lint -restore*/
+    (void) rheap_compact(rhp, (size_t)0);
+    bp = rheap_fit(rhp, size);
+    if (bp != NULL) {
+      rhp->rh_stats.rs_rescues++;
+    }
+  }
+  if (bp == NULL) {
+    rhp->rh_stats.rs_failures++;
+    RH_UNLOCK(rhp);
+    return NULL;
+  }
+
+  bp->b.handle = hp;
+  hp->h_ptr = (void *)(bp + 1);
+  hp->h_locks = (cnt_t)0;
+  RH_UNLOCK(rhp);
+
+  return hp;
+}
+
+/**
+ * @brief   Frees a block of a relocatable heap.
+ * @details The block becomes a hole, the compactor thread, if any, is
+ *          awakened. A block at the top of the heap is given back to the
+ *          free tail immediately.
+ * @pre     The block must not be locked.
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[in] hp        handle of the block to be freed
+ *
+ * @api
+ */
+void chRHeapFree(reloc_heap_t *rhp, rhandle_t *hp) {
+  union rheap_block *bp;
+  bool hole;
+
+  chDbgCheck((rhp != NULL) && (hp != NULL));
+
+  RH_LOCK(rhp);
+  chDbgAssert((hp->h_ptr != NULL) && (hp->h_locks == (cnt_t)0),
+              "invalid or locked handle");
+
+  bp = (union rheap_block *)hp->h_ptr - 1;
+  bp->b.handle = NULL;
+  hp->h_ptr = NULL;
+  rhp->rh_holes += bp->b.size;
+  (void) rheap_reclaim(rhp, bp);
+  hole = (bool)(rhp->rh_holes > (size_t)0);
+  RH_UNLOCK(rhp);
+
+  if (hole) {
+    chBSemSignal(&rhp->rh_dirty);
+  }
+}
+
+/**
+ * @brief   Locks a block of a relocatable heap.
+ * @details A locked block is not moved, locks can be nested.
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[in] hp        handle of the block
+ * @return              The current address of the block, valid until the
+ *                      matching @p chRHeapUnlock().
+ *
+ * @api
+ */
+void *chRHeapLock(reloc_heap_t *rhp, rhandle_t *hp) {
+  void *p;
+
+  chDbgCheck((rhp != NULL) && (hp != NULL));
+
+  RH_LOCK(rhp);
+  chDbgAssert(hp->h_ptr != NULL, "invalid handle");
+
+  hp->h_locks++;
+  p = hp->h_ptr;
+  RH_UNLOCK(rhp);
+
+  return p;
+}
+
+/**
+ * @brief   Unlocks a block of a relocatable heap.
+ * @details The block can be moved after its last lock is released, if
+ *          there are holes then the compactor thread, if any, is awakened
+ *          because the holes below the block can now be compacted.
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[in] hp        handle of the block
+ *
+ * @api
+ */
+void chRHeapUnlock(reloc_heap_t *rhp, rhandle_t *hp) {
+  bool dirty;
+
+  chDbgCheck((rhp != NULL) && (hp != NULL));
+
+  RH_LOCK(rhp);
+  chDbgAssert(hp->h_locks > (cnt_t)0, "not locked");
+
+  hp->h_locks--;
+  dirty = (bool)((hp->h_locks == (cnt_t)0) && (rhp->rh_holes > (size_t)0));
+  RH_UNLOCK(rhp);
+
+  if (dirty) {
+    chBSemSignal(&rhp->rh_dirty);
+  }
+}
+
+/**
+ * @brief   Performs a compaction step.
+ * @details Unlocked blocks are moved down over the holes, the holes at the
+ *          top of the heap are given back to the free tail.
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[in] limit     bytes to be processed before returning, a block is
+ *                      always moved as a whole, zero means a full pass
+ * @return              The number of bytes moved or reclaimed.
+ * @retval 0            if there is nothing left to compact.
+ *
+ * @api
+ */
+size_t chRHeapCompact(reloc_heap_t *rhp, size_t limit) {
+  size_t work;
+
+  chDbgCheck(rhp != NULL);
+
+  RH_LOCK(rhp);
+  work = rheap_compact(rhp, limit);
+  RH_UNLOCK(rhp);
+
+  return work;
+}
+
+/**
+ * @brief   Starts a compactor thread for a relocatable heap.
+ * @details The thread sleeps until a hole is created then compacts the
+ *          heap in steps of @p CH_CFG_RHEAP_COMPACT_STEP bytes, yielding
+ *          between steps.
+ * @note    The priority should be low, compaction is a background task.
+ * @note    The thread exits if it is awakened after a @p chThdTerminate().
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[out] wsp      pointer to a working area dedicated to the thread
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level for the thread
+ * @return              The pointer to the @p thread_t structure of the
+ *                      compactor thread.
+ *
+ * @api
+ */
+thread_t *chRHeapStartCompactor(reloc_heap_t *rhp, void *wsp, size_t size,
+                                tprio_t prio) {
+  thread_t *tp;
+
+  chDbgCheck(rhp != NULL);
+
+  tp = chThdCreateStatic(wsp, size, prio, rheap_compactor, rhp);
+  chRegSetThreadNameX(tp, "compactor");
+
+  return tp;
+}
+
+/**
+ * @brief   Reports the relocatable heap status.
+ *
+ * @param[in] rhp       pointer to a @p reloc_heap_t structure
+ * @param[out] sizep    pointer to a variable that will receive the total
+ *                      free space, holes included, or @p NULL
+ * @param[out] rsp      pointer to a @p rheap_stats_t structure receiving
+ *                      the compaction statistics or @p NULL
+ * @return              The largest block that can be allocated without
+ *                      compacting the heap.
+ *
+ * @api
+ */
+size_t chRHeapStatus(reloc_heap_t *rhp, size_t *sizep, rheap_stats_t *rsp) {
+  union rheap_block *bp;
+  uint8_t *p;
+  size_t largest;
+
+  chDbgCheck(rhp != NULL);
+
+  RH_LOCK(rhp);
+  /*lint -save -e9033 [10.8] The cast is safe.*/
+  largest = (size_t)(rhp->rh_end - rhp->rh_top);
+  /*lint -restore*/
+  if (sizep != NULL) {
+    *sizep = largest + rhp->rh_holes;
+  }
+  for (p = rhp->rh_base; p < rhp->rh_top; p = NEXT(bp)) {
+    bp = BLK(p);
+    if ((bp->b.handle == NULL) && (bp->b.size > largest)) {
+      largest = bp->b.size;
+    }
+  }
+  if (rsp != NULL) {
+    *rsp = rhp->rh_stats;
+  }
+  RH_UNLOCK(rhp);
+
+  return largest > sizeof (union rheap_block) ?
+         largest - sizeof (union rheap_block) : (size_t)0;
+}
+
+#endif /* CH_CFG_USE_RELOC_HEAPS == TRUE */
+
+/** @} */
@@ -0,0 +1,425 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chmemslab.c
+ * @brief   Slab allocator code.
+ *
+ * @addtogroup slabs
+ * @details Slab allocator related APIs and services.
+ *          <h2>Operation mode</h2>
+ *          The slab allocator is a front-end for small objects of variable
+ *          size. A set of size classes is defined by the application, each
+ *          request is routed to the smallest class able to contain it.<br>
+ *          Each class obtains slabs, fixed size blocks split in objects of
+ *          the class size, from a heap or from a memory provider. Objects
+ *          are allocated from and returned to the free list of their slab
+ *          in O(1), like in memory pools, and a slab is returned to its
+ *          heap when all its objects have been freed.<br>
+ *          Requests bigger than the largest class are served by the heap
+ *          directly. Objects carry a small header pointing to their slab
+ *          so that @p chSlabFree() does not need the object size.
+ *          <h2>Notes</h2>
+ *          - Slabs obtained from a provider, for example the core
+ *            allocator, are never released.
+ *          - A class always keeps its last slab, even if empty, in order
+ *            to avoid repeated slab allocations when a single object is
+ *            allocated and freed in a loop.
+ *          .
+ * @pre     In order to use the slab allocator APIs the @p CH_CFG_USE_SLABS
+ *          option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_SLABS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Size of the slab header and of an object slot, both keep the slots
+ * aligned to MEM_ALIGN_SIZE.
+ */
+#define SLAB_HEADER_SIZE    MEM_ALIGN_NEXT(sizeof (slab_t))
+#define SLAB_SLOT_SIZE(cp)  (sizeof (union slab_object) +                   \
+                             MEM_ALIGN_NEXT((cp)->sc_size))
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static inline slab_t *class_head(slab_class_t *cp) {
+
+  /*lint -save -e740 -e826 [11.3] The list header is the first slab field.*/
+  return (slab_t *)&cp->sc_slabs;
+  /*lint -restore*/
+}
+
+static inline void slab_remove(slab_t *sp) {
+
+  sp->s_list.sl_prev->s_list.sl_next = sp->s_list.sl_next;
+  sp->s_list.sl_next->s_list.sl_prev = sp->s_list.sl_prev;
+}
+
+static inline void slab_insert_head(slab_class_t *cp, slab_t *sp) {
+  slab_t *hp = class_head(cp);
+
+  sp->s_list.sl_next = hp->s_list.sl_next;
+  sp->s_list.sl_prev = hp;
+  hp->s_list.sl_next->s_list.sl_prev = sp;
+  hp->s_list.sl_next = sp;
+}
+
+static inline void slab_insert_tail(slab_class_t *cp, slab_t *sp) {
+  slab_t *hp = class_head(cp);
+
+  sp->s_list.sl_prev = hp->s_list.sl_prev;
+  sp->s_list.sl_next = hp;
+  hp->s_list.sl_prev->s_list.sl_next = sp;
+  hp->s_list.sl_prev = sp;
+}
+
+/* Takes an object from the first slab of a class, the kernel must be
+   locked.*/
+static void *class_alloc(slab_class_t *cp) {
+  slab_t *sp = cp->sc_slabs.sl_next;
+  union slab_object *op;
+
+  if ((sp == class_head(cp)) || (sp->s_free == NULL)) {
+    return NULL;
+  }
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  op = (union slab_object *)sp->s_free;
+  /*lint -restore*/
+  sp->s_free = sp->s_free->sf_next;
+  sp->s_used++;
+  cp->sc_used++;
+
+  /* Full slabs are moved at the tail, the ones at the head always have
+     free objects.*/
+  if (sp->s_free == NULL) {
+    slab_remove(sp);
+    slab_insert_tail(cp, sp);
+  }
+
+  op->slab = sp;
+  return (void *)(op + 1);
+}
+
+static slab_t *slab_create(slab_allocator_t *sap, slab_class_t *cp) {
+  slab_t *sp;
+  uint8_t *objp;
+  size_t i;
+
+#if CH_CFG_USE_HEAP == TRUE
+  if (sap->sa_provider == NULL) {
+    sp = chHeapAlloc(sap->sa_heap, sap->sa_slabsize);
+  }
+  else {
+    sp = sap->sa_provider(sap->sa_slabsize);
+  }
+  if (sp == NULL) {
+    return NULL;
+  }
+  sp->s_heap = (bool)(sap->sa_provider == NULL);
+#else
+  sp = sap->sa_provider(sap->sa_slabsize);
+  if (sp == NULL) {
+    return NULL;
+  }
+#endif
+
+  /* Building the free list of the new slab, it is still private so no
+     lock is required.*/
+  sp->s_class = cp;
+  sp->s_free  = NULL;
+  sp->s_used  = (size_t)0;
+  objp = (uint8_t *)sp + SLAB_HEADER_SIZE;
+  for (i = (size_t)0; i < cp->sc_perslab; i++) {
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    struct slab_free *sfp = (struct slab_free *)objp;
+    /*lint -restore*/
+
+    sfp->sf_next = sp->s_free;
+    sp->s_free = sfp;
+    objp += SLAB_SLOT_SIZE(cp);
+  }
+
+  return sp;
+}
+
+static void slab_init(slab_allocator_t *sap, slab_class_t *classes,
+                      unsigned n, size_t slabsize) {
+  size_t maxslot;
+  unsigned i;
+
+  chDbgCheck((sap != NULL) && (classes != NULL) && (n > 0U));
+
+  /* The slab size must fit at least one object of the largest class.*/
+  maxslot = SLAB_SLOT_SIZE(&classes[n - 1U]);
+  if (slabsize < SLAB_HEADER_SIZE + maxslot) {
+    slabsize = SLAB_HEADER_SIZE + maxslot;
+  }
+
+  sap->sa_classes   = classes;
+  sap->sa_nclasses  = n;
+  sap->sa_slabsize  = MEM_ALIGN_NEXT(slabsize);
+  for (i = 0U; i < n; i++) {
+    slab_class_t *cp = &classes[i];
+
+    chDbgAssert((i == 0U) || (cp->sc_size > classes[i - 1U].sc_size),
+                "classes not in ascending order");
+
+    cp->sc_slabs.sl_next = class_head(cp);
+    cp->sc_slabs.sl_prev = class_head(cp);
+    cp->sc_perslab = (sap->sa_slabsize - SLAB_HEADER_SIZE) /
+                     SLAB_SLOT_SIZE(cp);
+    cp->sc_nslabs = (ucnt_t)0;
+    cp->sc_used = (ucnt_t)0;
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a slab allocator taking slabs from a heap.
+ * @details Empty slabs are returned to the heap, requests bigger than the
+ *          largest class are served by the same heap.
+ * @note    The slab size is enlarged, if required, in order to fit at least
+ *          one object of the largest class.
+ *
+ * @param[out] sap      pointer to a @p slab_allocator_t structure
+ * @param[in] classes   array of size classes, in ascending size order,
+ *                      see @p SLAB_CLASS()
+ * @param[in] n         number of size classes
+ * @param[in] slabsize  size of a slab
+ * @param[in] heapp     heap from which allocate the slabs or @p NULL for
+ *                      the default heap
+ *
+ * @init
+ */
+void chSlabObjectInit(slab_allocator_t *sap, slab_class_t *classes,
+                      unsigned n, size_t slabsize, memory_heap_t *heapp) {
+
+  slab_init(sap, classes, n, slabsize);
+  sap->sa_heap = heapp;
+  sap->sa_provider = NULL;
+}
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+/**
+ * @brief   Initializes a slab allocator taking slabs from a provider.
+ * @details Slabs cannot be returned to a provider so empty slabs are kept,
+ *          requests bigger than the largest class fail.
+ *
+ * @param[out] sap      pointer to a @p slab_allocator_t structure
+ * @param[in] classes   array of size classes, in ascending size order,
+ *                      see @p SLAB_CLASS()
+ * @param[in] n         number of size classes
+ * @param[in] slabsize  size of a slab
+ * @param[in] provider  slabs provider, for example @p chCoreAlloc
+ *
+ * @init
+ */
+void chSlabObjectInitProvider(slab_allocator_t *sap, slab_class_t *classes,
+                              unsigned n, size_t slabsize,
+                              memgetfunc_t provider) {
+
+  chDbgCheck(provider != NULL);
+
+  slab_init(sap, classes, n, slabsize);
+#if CH_CFG_USE_HEAP == TRUE
+  sap->sa_heap = NULL;
+#endif
+  sap->sa_provider = provider;
+}
+
+/**
+ * @brief   Allocates a block of memory from a slab allocator.
+ * @details The request is served by the smallest class able to contain
+ *          it, a new slab is allocated if the class has no free objects.
+ *          The allocated block is aligned to @p MEM_ALIGN_SIZE.
+ *
+ * @param[in] sap       pointer to a @p slab_allocator_t structure
+ * @param[in] size      the size of the block to be allocated
+ * @return              A pointer to the allocated block.
+ * @retval NULL         if the memory could not be allocated.
+ *
+ * @api
+ */
+void *chSlabAlloc(slab_allocator_t *sap, size_t size) {
+  slab_class_t *cp;
+  slab_t *sp;
+  void *p;
+  unsigned i;
+
+  chDbgCheck(sap != NULL);
+
+  /* Linear search, the number of classes is expected to be small.*/
+  for (i = 0U; i < sap->sa_nclasses; i++) {
+    if (size <= sap->sa_classes[i].sc_size) {
+      break;
+    }
+  }
+
+  if (i >= sap->sa_nclasses) {
+#if CH_CFG_USE_HEAP == TRUE
+    union slab_object *op;
+
+    if (sap->sa_provider != NULL) {
+      return NULL;
+    }
+    op = chHeapAlloc(sap->sa_heap, sizeof (union slab_object) + size);
+    if (op == NULL) {
+      return NULL;
+    }
+    op->slab = NULL;
+    return (void *)(op + 1);
+#else
+    return NULL;
+#endif
+  }
+
+  cp = &sap->sa_classes[i];
+  chSysLock();
+  p = class_alloc(cp);
+  chSysUnlock();
+  if (p != NULL) {
+    return p;
+  }
+
+  /* The class is exhausted, the new slab is put at the head of the
+     list so it serves the following requests.*/
+  sp = slab_create(sap, cp);
+  if (sp == NULL) {
+    return NULL;
+  }
+  chSysLock();
+  slab_insert_head(cp, sp);
+  cp->sc_nslabs++;
+  p = class_alloc(cp);
+  chSysUnlock();
+
+  return p;
+}
+
+/**
+ * @brief   Frees a block of memory allocated by a slab allocator.
+ * @details The object is returned to its slab, a slab left empty is
+ *          returned to its heap unless it is the last slab of its class.
+ *
+ * @param[in] p         pointer to the block to be freed
+ *
+ * @api
+ */
+void chSlabFree(void *p) {
+  union slab_object *op;
+  slab_class_t *cp;
+  slab_t *sp;
+  struct slab_free *sfp;
+
+  chDbgCheck((p != NULL) && MEM_IS_ALIGNED(p));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  op = (union slab_object *)p - 1;
+  sfp = (struct slab_free *)op;
+  /*lint -restore*/
+  sp = op->slab;
+
+#if CH_CFG_USE_HEAP == TRUE
+  if (sp == NULL) {
+    chHeapFree(op);
+    return;
+  }
+#endif
+
+  cp = sp->s_class;
+  chSysLock();
+  chDbgAssert((sp->s_used > (size_t)0) && (cp->sc_used > (ucnt_t)0),
+              "not allocated");
+
+  /* A full slab gets a free object, it goes back at the head.*/
+  if (sp->s_free == NULL) {
+    slab_remove(sp);
+    slab_insert_head(cp, sp);
+  }
+  sfp->sf_next = sp->s_free;
+  sp->s_free = sfp;
+  sp->s_used--;
+  cp->sc_used--;
+
+#if CH_CFG_USE_HEAP == TRUE
+  if (sp->s_heap && (sp->s_used == (size_t)0) &&
+      (cp->sc_nslabs > (ucnt_t)1)) {
+    slab_remove(sp);
+    cp->sc_nslabs--;
+    chSysUnlock();
+    chHeapFree(sp);
+    return;
+  }
+#endif
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the occupancy of a size class.
+ *
+ * @param[in] sap       pointer to a @p slab_allocator_t structure
+ * @param[in] i         index of the size class
+ * @param[out] ssp      pointer to a @p slab_status_t structure
+ *
+ * @api
+ */
+void chSlabGetStatus(slab_allocator_t *sap, unsigned i, slab_status_t *ssp) {
+  slab_class_t *cp;
+
+  chDbgCheck((sap != NULL) && (i < sap->sa_nclasses) && (ssp != NULL));
+
+  cp = &sap->sa_classes[i];
+  chSysLock();
+  ssp->ss_size  = cp->sc_size;
+  ssp->ss_slabs = (size_t)cp->sc_nslabs;
+  ssp->ss_used  = (size_t)cp->sc_used;
+  ssp->ss_free  = ((size_t)cp->sc_nslabs * cp->sc_perslab) -
+                  (size_t)cp->sc_used;
+  chSysUnlock();
+}
+
+#endif /* CH_CFG_USE_SLABS == TRUE */
+
+/** @} */
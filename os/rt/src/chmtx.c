@@ -109,6 +109,7 @@ void chMtxObjectInit(mutex_t *mp) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   mp->m_cnt = (cnt_t)0;
 #endif
+  _lock_stats_object_init(&mp->m_stats);
 }
 
 /**
@@ -211,7 +212,15 @@ void chMtxLockS(mutex_t *mp) {
       /* Sleep on the mutex.*/
       queue_prio_insert(ctp, &mp->m_queue);
       ctp->p_u.wtmtxp = mp;
+#if CH_DBG_LOCK_STATISTICS == TRUE
+      {
+        lstime_t start = _lock_stats_wait_begin(&mp->m_stats);
+        chSchGoSleepS(CH_STATE_WTMTX);
+        _lock_stats_wait_end(&mp->m_stats, start);
+      }
+#else
       chSchGoSleepS(CH_STATE_WTMTX);
+#endif
 
       /* It is assumed that the thread performing the unlock operation assigns
          the mutex to this thread.*/
@@ -232,6 +241,7 @@ void chMtxLockS(mutex_t *mp) {
     mp->m_owner = ctp;
     mp->m_next = ctp->p_mtxlist;
     ctp->p_mtxlist = mp;
+    _lock_stats_acquired(&mp->m_stats);
   }
 }
 
@@ -294,6 +304,7 @@ bool chMtxTryLockS(mutex_t *mp) {
       return true;
     }
 #endif
+    _lock_stats_failed(&mp->m_stats);
     return false;
   }
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -305,6 +316,7 @@ bool chMtxTryLockS(mutex_t *mp) {
   mp->m_owner = currp;
   mp->m_next = currp->p_mtxlist;
   currp->p_mtxlist = mp;
+  _lock_stats_acquired(&mp->m_stats);
   return true;
 }
 
@@ -342,6 +354,7 @@ void chMtxUnlock(mutex_t *mp) {
        it as not owned. Note, it is assumed to be the same mutex passed as
        parameter of this function.*/
     ctp->p_mtxlist = mp->m_next;
+    _lock_stats_released(&mp->m_stats);
 
     /* If a thread is waiting on the mutex then the fun part begins.*/
     if (chMtxQueueNotEmptyS(mp)) {
@@ -364,7 +377,7 @@ void chMtxUnlock(mutex_t *mp) {
 
       /* Assigns to the current thread the highest priority among all the
          waiting threads.*/
-      ctp->p_prio = newprio;
+      ctp->p_prio = (tsprio_t)newprio;
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -375,6 +388,7 @@ void chMtxUnlock(mutex_t *mp) {
       mp->m_owner = tp;
       mp->m_next = tp->p_mtxlist;
       tp->p_mtxlist = mp;
+      _lock_stats_handoff(&mp->m_stats);
 
       /* Note, not using chSchWakeupS() becuase that function expects the
          current thread to have the higher or equal priority than the ones
@@ -428,6 +442,7 @@ void chMtxUnlockS(mutex_t *mp) {
        it as not owned. Note, it is assumed to be the same mutex passed as
        parameter of this function.*/
     ctp->p_mtxlist = mp->m_next;
+    _lock_stats_released(&mp->m_stats);
 
     /* If a thread is waiting on the mutex then the fun part begins.*/
     if (chMtxQueueNotEmptyS(mp)) {
@@ -450,7 +465,7 @@ void chMtxUnlockS(mutex_t *mp) {
 
       /* Assigns to the current thread the highest priority among all the
          waiting threads.*/
-      ctp->p_prio = newprio;
+      ctp->p_prio = (tsprio_t)newprio;
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -461,6 +476,7 @@ void chMtxUnlockS(mutex_t *mp) {
       mp->m_owner = tp;
       mp->m_next = tp->p_mtxlist;
       tp->p_mtxlist = mp;
+      _lock_stats_handoff(&mp->m_stats);
       (void) chSchReadyI(tp);
     }
     else {
@@ -490,6 +506,7 @@ void chMtxUnlockAll(void) {
     do {
       mutex_t *mp = ctp->p_mtxlist;
       ctp->p_mtxlist = mp->m_next;
+      _lock_stats_released(&mp->m_stats);
       if (chMtxQueueNotEmptyS(mp)) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
         mp->m_cnt = (cnt_t)1;
@@ -498,6 +515,7 @@ void chMtxUnlockAll(void) {
         mp->m_owner = tp;
         mp->m_next = tp->p_mtxlist;
         tp->p_mtxlist = mp;
+        _lock_stats_handoff(&mp->m_stats);
         (void) chSchReadyI(tp);
       }
       else {
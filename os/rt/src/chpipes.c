@@ -0,0 +1,508 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chpipes.c
+ * @brief   Pipes code.
+ *
+ * @addtogroup pipes
+ * @details Pipes are circular byte buffers shared between threads, they
+ *          implement the @p BaseSequentialStream interface so any stream
+ *          user, @p chprintf() for example, can produce data for another
+ *          thread without a driver in between.<br>
+ *          Operations:
+ *          - <b>Bulk write</b>, the writer is suspended while the pipe
+ *            is full, the call returns when all the data has been written
+ *            or on timeout.
+ *          - <b>Bulk read</b>, the reader is suspended while the pipe is
+ *            empty, the call returns as soon as some data has been read,
+ *            partial reads are the norm.
+ *          - <b>Peek and commit</b>, the contiguous part of the free space
+ *            or of the data is returned as a window that can be accessed
+ *            in place, the transfer is completed by committing the number
+ *            of bytes written to or read from the window.
+ *          .
+ *          Data is copied in chunks of @p CH_CFG_PIPES_MAX_CHUNK bytes
+ *          and the waiting threads are resumed once per chunk, not once
+ *          per byte.
+ * @pre     In order to use the pipes APIs the @p CH_CFG_USE_PIPES option
+ *          must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the contiguous free space after the write pointer.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @return              The number of bytes.
+ *
+ * @notapi
+ */
+static size_t pipe_write_window(pipe_t *pp) {
+  size_t n = chPipeGetSizeX(pp) - pp->p_cnt;
+
+  if ((n > 0U) && (pp->p_wrptr >= pp->p_rdptr)) {
+    n = (size_t)(pp->p_top - pp->p_wrptr);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Size of the contiguous data after the read pointer.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @return              The number of bytes.
+ *
+ * @notapi
+ */
+static size_t pipe_read_window(pipe_t *pp) {
+  size_t n = pp->p_cnt;
+
+  if ((n > 0U) && (pp->p_rdptr >= pp->p_wrptr)) {
+    n = (size_t)(pp->p_top - pp->p_rdptr);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Makes written data available and resumes the readers.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[in] n         number of bytes written after the write pointer
+ *
+ * @notapi
+ */
+static void pipe_write_commit(pipe_t *pp, size_t n) {
+
+  pp->p_cnt += n;
+  pp->p_wrptr += n;
+  if (pp->p_wrptr >= pp->p_top) {
+    pp->p_wrptr = pp->p_buffer;
+  }
+  chThdDequeueAllI(&pp->p_rqueue, MSG_OK);
+}
+
+/**
+ * @brief   Releases read data and resumes the writers.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[in] n         number of bytes read after the read pointer
+ *
+ * @notapi
+ */
+static void pipe_read_commit(pipe_t *pp, size_t n) {
+
+  pp->p_cnt -= n;
+  pp->p_rdptr += n;
+  if (pp->p_rdptr >= pp->p_top) {
+    pp->p_rdptr = pp->p_buffer;
+  }
+  chThdDequeueAllI(&pp->p_wqueue, MSG_OK);
+}
+
+/*
+ * Interface implementation.
+ */
+
+static size_t writes(void *ip, const uint8_t *bp, size_t n) {
+
+  return chPipeWriteTimeout((pipe_t *)ip, bp, n, TIME_INFINITE);
+}
+
+/* Sequential streams read all the requested data.*/
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+  size_t r = 0, m;
+
+  while (r < n) {
+    m = chPipeReadTimeout((pipe_t *)ip, bp + r, n - r, TIME_INFINITE);
+    if (m == 0U) {
+      break;
+    }
+    r += m;
+  }
+
+  return r;
+}
+
+static msg_t put(void *ip, uint8_t b) {
+
+  if (chPipeWriteTimeout((pipe_t *)ip, &b, 1U, TIME_INFINITE) == 0U) {
+    return MSG_RESET;
+  }
+
+  return MSG_OK;
+}
+
+static msg_t get(void *ip) {
+  uint8_t b;
+
+  if (chPipeReadTimeout((pipe_t *)ip, &b, 1U, TIME_INFINITE) == 0U) {
+    return MSG_RESET;
+  }
+
+  return (msg_t)b;
+}
+
+/**
+ * @brief   VMT of the pipes stream interface.
+ */
+const struct BaseSequentialStreamVMT _pipe_vmt = {
+  writes, reads, put, get, NULL
+};
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a pipe object.
+ *
+ * @param[out] pp       pointer to a @p pipe_t structure
+ * @param[in] bp        pointer to a memory area allocated as pipe buffer
+ * @param[in] size      size of the pipe buffer
+ *
+ * @init
+ */
+void chPipeObjectInit(pipe_t *pp, uint8_t *bp, size_t size) {
+
+  chDbgCheck((pp != NULL) && (bp != NULL) && (size > 0U));
+
+  pp->vmt      = &_pipe_vmt;
+  pp->p_buffer = bp;
+  pp->p_top    = bp + size;
+  pp->p_wrptr  = bp;
+  pp->p_rdptr  = bp;
+  pp->p_cnt    = (size_t)0;
+  chThdQueueObjectInit(&pp->p_rqueue);
+  chThdQueueObjectInit(&pp->p_wqueue);
+}
+
+/**
+ * @brief   Resets a pipe.
+ * @details All the data in the pipe is erased and lost, any waiting
+ *          thread is resumed with status @p MSG_RESET.
+ * @note    Peek windows open across a reset are no more valid, their
+ *          commit must not be performed.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ *
+ * @iclass
+ */
+void chPipeResetI(pipe_t *pp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(pp != NULL);
+
+  pp->p_wrptr = pp->p_buffer;
+  pp->p_rdptr = pp->p_buffer;
+  pp->p_cnt   = (size_t)0;
+  chThdDequeueAllI(&pp->p_rqueue, MSG_RESET);
+  chThdDequeueAllI(&pp->p_wqueue, MSG_RESET);
+}
+
+/**
+ * @brief   Resets a pipe.
+ * @details All the data in the pipe is erased and lost, any waiting
+ *          thread is resumed with status @p MSG_RESET.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ *
+ * @api
+ */
+void chPipeReset(pipe_t *pp) {
+
+  chSysLock();
+  chPipeResetI(pp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Pipe write with timeout.
+ * @details The function writes data from a buffer to a pipe. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout or if the pipe has
+ *          been reset.
+ * @note    The timeout is applied to each wait for free space.
+ * @note    Writes larger than the free space can be interleaved with the
+ *          data of other writers.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
+                          size_t n, systime_t timeout) {
+  size_t w = 0, m;
+
+  chDbgCheck((pp != NULL) && (bp != NULL) && (n > 0U));
+
+  chSysLock();
+  while (w < n) {
+    while ((m = pipe_write_window(pp)) == 0U) {
+      if (chThdEnqueueTimeoutS(&pp->p_wqueue, timeout) != MSG_OK) {
+        chSysUnlock();
+        return w;
+      }
+    }
+
+    if (m > n - w) {
+      m = n - w;
+    }
+    if (m > CH_CFG_PIPES_MAX_CHUNK) {
+      m = CH_CFG_PIPES_MAX_CHUNK;
+    }
+    memcpy(pp->p_wrptr, bp + w, m);
+    pipe_write_commit(pp, m);
+    w += m;
+
+    /* Gives a preemption chance in a controlled point.*/
+    chSchRescheduleS();
+    chSysUnlock();
+    chSysLock();
+  }
+  chSysUnlock();
+
+  return w;
+}
+
+/**
+ * @brief   Pipe read with timeout.
+ * @details The function reads data from a pipe into a buffer. If the pipe
+ *          is empty then the calling thread is suspended until some data
+ *          is written or a timeout occurs, then the data available, up to
+ *          @p n bytes, is returned.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ * @retval 0            if a timeout occurred or the pipe has been reset.
+ *
+ * @api
+ */
+size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
+                         size_t n, systime_t timeout) {
+  size_t r = 0, m;
+
+  chDbgCheck((pp != NULL) && (bp != NULL) && (n > 0U));
+
+  chSysLock();
+  while (pp->p_cnt == 0U) {
+    if (chThdEnqueueTimeoutS(&pp->p_rqueue, timeout) != MSG_OK) {
+      chSysUnlock();
+      return 0;
+    }
+  }
+
+  while ((r < n) && ((m = pipe_read_window(pp)) > 0U)) {
+    if (m > n - r) {
+      m = n - r;
+    }
+    if (m > CH_CFG_PIPES_MAX_CHUNK) {
+      m = CH_CFG_PIPES_MAX_CHUNK;
+    }
+    memcpy(bp + r, pp->p_rdptr, m);
+    pipe_read_commit(pp, m);
+    r += m;
+
+    /* Gives a preemption chance in a controlled point.*/
+    chSchRescheduleS();
+    chSysUnlock();
+    chSysLock();
+  }
+  chSysUnlock();
+
+  return r;
+}
+
+/**
+ * @brief   Gets a window on the free space of a pipe.
+ * @details The contiguous free space after the write pointer is returned,
+ *          the caller writes in place and then calls
+ *          @p chPipeWriteCommit(). If the pipe is full then the calling
+ *          thread is suspended until some space is available or a timeout
+ *          occurs.
+ * @note    The window is meant for a single writer, the other writers
+ *          must not access the pipe until the commit.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[out] np       size of the window
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the window.
+ * @retval NULL         if a timeout occurred or the pipe has been reset.
+ *
+ * @api
+ */
+uint8_t *chPipeWritePeekTimeout(pipe_t *pp, size_t *np, systime_t timeout) {
+  size_t n;
+
+  chDbgCheck((pp != NULL) && (np != NULL));
+
+  chSysLock();
+  while ((n = pipe_write_window(pp)) == 0U) {
+    if (chThdEnqueueTimeoutS(&pp->p_wqueue, timeout) != MSG_OK) {
+      chSysUnlock();
+      return NULL;
+    }
+  }
+  chSysUnlock();
+
+  *np = n;
+  return pp->p_wrptr;
+}
+
+/**
+ * @brief   Commits data written in the window of a pipe.
+ * @details The data becomes available to the readers.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[in] n         number of bytes written in the window, it can be
+ *                      less than the window size, zero is allowed
+ *
+ * @api
+ */
+void chPipeWriteCommit(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  if (n > 0U) {
+    chSysLock();
+    chDbgAssert(n <= pipe_write_window(pp), "window overflow");
+    pipe_write_commit(pp, n);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+/**
+ * @brief   Gets a window on the data of a pipe.
+ * @details The contiguous data after the read pointer is returned, the
+ *          caller reads in place and then calls @p chPipeReadCommit().
+ *          If the pipe is empty then the calling thread is suspended until
+ *          some data is available or a timeout occurs.
+ * @note    The window is meant for a single reader, the other readers
+ *          must not access the pipe until the commit.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[out] np       size of the window
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the window.
+ * @retval NULL         if a timeout occurred or the pipe has been reset.
+ *
+ * @api
+ */
+const uint8_t *chPipeReadPeekTimeout(pipe_t *pp, size_t *np,
+                                     systime_t timeout) {
+  size_t n;
+
+  chDbgCheck((pp != NULL) && (np != NULL));
+
+  chSysLock();
+  while ((n = pipe_read_window(pp)) == 0U) {
+    if (chThdEnqueueTimeoutS(&pp->p_rqueue, timeout) != MSG_OK) {
+      chSysUnlock();
+      return NULL;
+    }
+  }
+  chSysUnlock();
+
+  *np = n;
+  return pp->p_rdptr;
+}
+
+/**
+ * @brief   Commits data read from the window of a pipe.
+ * @details The space becomes available to the writers.
+ *
+ * @param[in] pp        pointer to a @p pipe_t structure
+ * @param[in] n         number of bytes read from the window, it can be
+ *                      less than the window size, zero is allowed
+ *
+ * @api
+ */
+void chPipeReadCommit(pipe_t *pp, size_t n) {
+
+  chDbgCheck(pp != NULL);
+
+  if (n > 0U) {
+    chSysLock();
+    chDbgAssert(n <= pipe_read_window(pp), "window overflow");
+    pipe_read_commit(pp, n);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+#endif /* CH_CFG_USE_PIPES == TRUE */
+
+/** @} */
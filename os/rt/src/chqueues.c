@@ -95,6 +95,8 @@ void chIQObjectInit(input_queue_t *iqp, uint8_t *bp, size_t size,
   iqp->q_top     = bp + size;
   iqp->q_notify  = infy;
   iqp->q_link    = link;
+  iqp->q_watermark = 1U;
+  iqp->q_wakeup  = 1U;
 }
 
 /**
@@ -118,6 +120,31 @@ void chIQResetI(input_queue_t *iqp) {
   chThdDequeueAllI(&iqp->q_waiting, Q_RESET);
 }
 
+/**
+ * @brief   Sets the wakeup watermark of an input queue.
+ * @details A thread blocked in @p chIQReadTimeout() is only resumed when
+ *          the queue holds at least @p n bytes, or the number of bytes
+ *          still to be read if smaller, instead of on every byte. This
+ *          reduces the context switches on bursty streams.
+ * @note    The default watermark is one, the legacy behavior.
+ * @note    The timeout of @p chIQReadTimeout() is applied to each wait
+ *          for the watermark, the data already in the queue is returned
+ *          when it expires.
+ * @note    The watermark is meant for queues with a single reader thread.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         the new watermark, from one to the queue size
+ *
+ * @iclass
+ */
+void chIQSetWatermarkI(input_queue_t *iqp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((n > 0U) && (n <= chQSizeX(iqp)));
+
+  iqp->q_watermark = n;
+}
+
 /**
  * @brief   Input queue write.
  * @details A byte value is written into the low end of an input queue.
@@ -145,7 +172,10 @@ msg_t chIQPutI(input_queue_t *iqp, uint8_t b) {
     iqp->q_wrptr = iqp->q_buffer;
   }
 
-  chThdDequeueNextI(&iqp->q_waiting, Q_OK);
+  /* The reader is only woken when its watermark is reached.*/
+  if (iqp->q_counter >= iqp->q_wakeup) {
+    chThdDequeueNextI(&iqp->q_waiting, Q_OK);
+  }
 
   return Q_OK;
 }
@@ -179,7 +209,10 @@ msg_t chIQGetTimeout(input_queue_t *iqp, systime_t timeout) {
   }
 
   while (chIQIsEmptyI(iqp)) {
-    msg_t msg = chThdEnqueueTimeoutS(&iqp->q_waiting, timeout);
+    msg_t msg;
+
+    iqp->q_wakeup = 1U;
+    msg = chThdEnqueueTimeoutS(&iqp->q_waiting, timeout);
     if (msg < Q_OK) {
       chSysUnlock();
       return msg;
@@ -223,7 +256,8 @@ msg_t chIQGetTimeout(input_queue_t *iqp, systime_t timeout) {
 size_t chIQReadTimeout(input_queue_t *iqp, uint8_t *bp,
                        size_t n, systime_t timeout) {
   qnotify_t nfy = iqp->q_notify;
-  size_t r = 0;
+  size_t r = 0, wm;
+  bool expired = false;
 
   chDbgCheck(n > 0U);
 
@@ -233,8 +267,18 @@ size_t chIQReadTimeout(input_queue_t *iqp, uint8_t *bp,
       nfy(iqp);
     }
 
-    while (chIQIsEmptyI(iqp)) {
-      if (chThdEnqueueTimeoutS(&iqp->q_waiting, timeout) != Q_OK) {
+    /* When the queue is empty then waiting for the watermark or for the
+       remaining data, whichever is smaller. After a timeout the data
+       already in the queue is still returned.*/
+    if (chIQIsEmptyI(iqp)) {
+      wm = n < iqp->q_watermark ? n : iqp->q_watermark;
+      while (!expired && (chQSpaceI(iqp) < wm)) {
+        iqp->q_wakeup = wm;
+        if (chThdEnqueueTimeoutS(&iqp->q_waiting, timeout) != Q_OK) {
+          expired = true;
+        }
+      }
+      if (chIQIsEmptyI(iqp)) {
         chSysUnlock();
         return r;
       }
@@ -283,6 +327,8 @@ void chOQObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
   oqp->q_top     = bp + size;
   oqp->q_notify  = onfy;
   oqp->q_link    = link;
+  oqp->q_watermark = 1U;
+  oqp->q_wakeup  = 1U;
 }
 
 /**
@@ -306,6 +352,31 @@ void chOQResetI(output_queue_t *oqp) {
   chThdDequeueAllI(&oqp->q_waiting, Q_RESET);
 }
 
+/**
+ * @brief   Sets the wakeup watermark of an output queue.
+ * @details A thread blocked in @p chOQWriteTimeout() is only resumed when
+ *          the queue has at least @p n free bytes, or the number of bytes
+ *          still to be written if smaller, instead of on every byte. This
+ *          reduces the context switches on bursty streams.
+ * @note    The default watermark is one, the legacy behavior.
+ * @note    The timeout of @p chOQWriteTimeout() is applied to each wait
+ *          for the watermark, the space already available is used when
+ *          it expires.
+ * @note    The watermark is meant for queues with a single writer thread.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         the new watermark, from one to the queue size
+ *
+ * @iclass
+ */
+void chOQSetWatermarkI(output_queue_t *oqp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((n > 0U) && (n <= chQSizeX(oqp)));
+
+  oqp->q_watermark = n;
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details This function writes a byte value to an output queue. If the queue
@@ -332,7 +403,10 @@ msg_t chOQPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
 
   chSysLock();
   while (chOQIsFullI(oqp)) {
-    msg_t msg = chThdEnqueueTimeoutS(&oqp->q_waiting, timeout);
+    msg_t msg;
+
+    oqp->q_wakeup = 1U;
+    msg = chThdEnqueueTimeoutS(&oqp->q_waiting, timeout);
     if (msg < Q_OK) {
       chSysUnlock();
       return msg;
@@ -378,11 +452,46 @@ msg_t chOQGetI(output_queue_t *oqp) {
     oqp->q_rdptr = oqp->q_buffer;
   }
 
-  chThdDequeueNextI(&oqp->q_waiting, Q_OK);
+  /* The writer is only woken when its watermark is reached.*/
+  if (oqp->q_counter >= oqp->q_wakeup) {
+    chThdDequeueNextI(&oqp->q_waiting, Q_OK);
+  }
 
   return (msg_t)b;
 }
 
+/**
+ * @brief   Output queue non-blocking write.
+ * @details The function writes data from a buffer to an output queue, as
+ *          much data as the free space allows is written without waiting.
+ * @note    The callback is not invoked, this way several buffers can be
+ *          written before notifying the consumer once.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is allowed
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t chOQWriteI(output_queue_t *oqp, const uint8_t *bp, size_t n) {
+  size_t w = 0;
+
+  chDbgCheckClassI();
+
+  while ((w < n) && !chOQIsFullI(oqp)) {
+    oqp->q_counter--;
+    *oqp->q_wrptr++ = *bp++;
+    if (oqp->q_wrptr >= oqp->q_top) {
+      oqp->q_wrptr = oqp->q_buffer;
+    }
+    w++;
+  }
+
+  return w;
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details The function writes data from a buffer to an output queue. The
@@ -410,14 +519,25 @@ msg_t chOQGetI(output_queue_t *oqp) {
 size_t chOQWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                         size_t n, systime_t timeout) {
   qnotify_t nfy = oqp->q_notify;
-  size_t w = 0;
+  size_t w = 0, wm;
+  bool expired = false;
 
   chDbgCheck(n > 0U);
 
   chSysLock();
   while (true) {
-    while (chOQIsFullI(oqp)) {
-      if (chThdEnqueueTimeoutS(&oqp->q_waiting, timeout) != Q_OK) {
+    /* When the queue is full then waiting for the watermark or for the
+       space for the remaining data, whichever is smaller. After a timeout
+       the space already available is still used.*/
+    if (chOQIsFullI(oqp)) {
+      wm = n < oqp->q_watermark ? n : oqp->q_watermark;
+      while (!expired && (chQSpaceI(oqp) < wm)) {
+        oqp->q_wakeup = wm;
+        if (chThdEnqueueTimeoutS(&oqp->q_waiting, timeout) != Q_OK) {
+          expired = true;
+        }
+      }
+      if (chOQIsFullI(oqp)) {
         chSysUnlock();
         return w;
       }
@@ -100,6 +100,7 @@ void chSemObjectInit(semaphore_t *sp, cnt_t n) {
 
   queue_init(&sp->s_queue);
   sp->s_cnt = n;
+  _lock_stats_object_init(&sp->s_stats);
 }
 
 /**
@@ -205,10 +206,19 @@ msg_t chSemWaitS(semaphore_t *sp) {
   if (--sp->s_cnt < (cnt_t)0) {
     currp->p_u.wtsemp = sp;
     sem_insert(currp, &sp->s_queue);
+#if CH_DBG_LOCK_STATISTICS == TRUE
+    {
+      lstime_t start = _lock_stats_wait_begin(&sp->s_stats);
+      chSchGoSleepS(CH_STATE_WTSEM);
+      _lock_stats_wait_end(&sp->s_stats, start);
+    }
+#else
     chSchGoSleepS(CH_STATE_WTSEM);
+#endif
 
     return currp->p_u.rdymsg;
   }
+  _lock_stats_acquired(&sp->s_stats);
 
   return MSG_OK;
 }
@@ -272,14 +282,26 @@ msg_t chSemWaitTimeoutS(semaphore_t *sp, systime_t time) {
   if (--sp->s_cnt < (cnt_t)0) {
     if (TIME_IMMEDIATE == time) {
       sp->s_cnt++;
+      _lock_stats_failed(&sp->s_stats);
 
       return MSG_TIMEOUT;
     }
     currp->p_u.wtsemp = sp;
     sem_insert(currp, &sp->s_queue);
 
+#if CH_DBG_LOCK_STATISTICS == TRUE
+    {
+      lstime_t start = _lock_stats_wait_begin(&sp->s_stats);
+      msg_t msg = chSchGoSleepTimeoutS(CH_STATE_WTSEM, time);
+      _lock_stats_wait_end(&sp->s_stats, start);
+
+      return msg;
+    }
+#else
     return chSchGoSleepTimeoutS(CH_STATE_WTSEM, time);
+#endif
   }
+  _lock_stats_acquired(&sp->s_stats);
 
   return MSG_OK;
 }
@@ -394,10 +416,19 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
     thread_t *ctp = currp;
     sem_insert(ctp, &spw->s_queue);
     ctp->p_u.wtsemp = spw;
+#if CH_DBG_LOCK_STATISTICS == TRUE
+    {
+      lstime_t start = _lock_stats_wait_begin(&spw->s_stats);
+      chSchGoSleepS(CH_STATE_WTSEM);
+      _lock_stats_wait_end(&spw->s_stats, start);
+    }
+#else
     chSchGoSleepS(CH_STATE_WTSEM);
+#endif
     msg = ctp->p_u.rdymsg;
   }
   else {
+    _lock_stats_acquired(&spw->s_stats);
     chSchRescheduleS();
     msg = MSG_OK;
   }
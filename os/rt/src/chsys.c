@@ -87,6 +87,9 @@ static void _idle_thread(void *p) {
  * @pre     Interrupts must disabled before invoking this function.
  * @post    The main thread is created with priority @p NORMALPRIO and
  *          interrupts are enabled.
+ * @post    If @p CH_CFG_USE_THREAD_TABLE is enabled then the threads in
+ *          the application table are created, those with priority higher
+ *          than @p NORMALPRIO run before this function returns.
  *
  * @special
  */
@@ -110,6 +113,9 @@ void chSysInit(void) {
 #if CH_DBG_STATISTICS == TRUE
   _stats_init();
 #endif
+#if CH_DBG_LOCK_STATISTICS == TRUE
+  _lock_stats_init();
+#endif
 #if CH_DBG_ENABLE_TRACE == TRUE
   _dbg_trace_init();
 #endif
@@ -149,6 +155,11 @@ void chSysInit(void) {
     chRegSetThreadNameX(tp, "idle");
   }
 #endif
+
+#if CH_CFG_USE_THREAD_TABLE == TRUE
+  /* Application threads, created in a single pass.*/
+  chThdCreateTable(ch_thd_table);
+#endif
 }
 
 /**
@@ -90,14 +90,14 @@
  */
 thread_t *_thread_init(thread_t *tp, tprio_t prio) {
 
-  tp->p_prio = prio;
+  tp->p_prio = (tsprio_t)prio;
   tp->p_state = CH_STATE_WTSTART;
   tp->p_flags = CH_FLAG_MODE_STATIC;
 #if CH_CFG_TIME_QUANTUM > 0
   tp->p_preempt = (tslices_t)CH_CFG_TIME_QUANTUM;
 #endif
 #if CH_CFG_USE_MUTEXES == TRUE
-  tp->p_realprio = prio;
+  tp->p_realprio = (tsprio_t)prio;
   tp->p_mtxlist = NULL;
 #endif
 #if CH_CFG_USE_EVENTS == TRUE
@@ -122,6 +122,12 @@ thread_t *_thread_init(thread_t *tp, tprio_t prio) {
 #if CH_DBG_ENABLE_STACK_CHECK == TRUE
   tp->p_stklimit = (stkalign_t *)(tp + 1);
 #endif
+#if CH_DBG_FILL_THREADS == TRUE
+  tp->p_stktop = NULL;
+#endif
+#if CH_CFG_USE_THREAD_ARENAS == TRUE
+  tp->p_arena = NULL;
+#endif
 #if CH_DBG_STATISTICS == TRUE
   chTMObjectInit(&tp->p_stats);
   chTMStartMeasurementX(&tp->p_stats);
@@ -220,12 +226,59 @@ thread_t *chThdCreateStatic(void *wsp, size_t size,
 
   chSysLock();
   tp = chThdCreateI(wsp, size, prio, pf, arg);
+#if CH_DBG_FILL_THREADS == TRUE
+  tp->p_stktop = (stkalign_t *)((uint8_t *)wsp + size);
+#endif
   chSchWakeupS(tp, MSG_OK);
   chSysUnlock();
 
   return tp;
 }
 
+/**
+ * @brief   Creates the threads described by a table.
+ * @details All the threads are inserted in the ready list within a single
+ *          critical zone then a single reschedule is performed, threads
+ *          with priority higher than the caller's start in priority order.
+ * @note    The table is terminated by an entry with a @p NULL function,
+ *          see @p THD_TABLE_TERMINATOR.
+ * @note    The kernel is kept locked while creating the threads, large
+ *          tables increase the worst case latency accordingly.
+ *
+ * @param[in] tdp       pointer to the first thread descriptor
+ *
+ * @api
+ */
+void chThdCreateTable(const thread_descriptor_t *tdp) {
+  const thread_descriptor_t *p;
+  thread_t *tp;
+
+  chDbgCheck(tdp != NULL);
+
+#if CH_DBG_FILL_THREADS == TRUE
+  for (p = tdp; p->funcp != NULL; p++) {
+    _thread_memfill((uint8_t *)p->wbase,
+                    (uint8_t *)p->wbase + sizeof(thread_t),
+                    CH_DBG_THREAD_FILL_VALUE);
+    _thread_memfill((uint8_t *)p->wbase + sizeof(thread_t),
+                    (uint8_t *)p->wbase + p->wsize,
+                    CH_DBG_STACK_FILL_VALUE);
+  }
+#endif
+
+  chSysLock();
+  for (p = tdp; p->funcp != NULL; p++) {
+    tp = chThdCreateI(p->wbase, p->wsize, p->prio, p->funcp, p->arg);
+#if CH_DBG_FILL_THREADS == TRUE
+    tp->p_stktop = (stkalign_t *)((uint8_t *)p->wbase + p->wsize);
+#endif
+    chRegSetThreadNameX(tp, p->name);
+    (void) chSchReadyI(tp);
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
 /**
  * @brief   Resumes a thread created with @p chThdCreateI().
  *
@@ -265,12 +318,12 @@ tprio_t chThdSetPriority(tprio_t newprio) {
 #if CH_CFG_USE_MUTEXES == TRUE
   oldprio = currp->p_realprio;
   if ((currp->p_prio == currp->p_realprio) || (newprio > currp->p_prio)) {
-    currp->p_prio = newprio;
+    currp->p_prio = (tsprio_t)newprio;
   }
-  currp->p_realprio = newprio;
+  currp->p_realprio = (tsprio_t)newprio;
 #else
   oldprio = currp->p_prio;
-  currp->p_prio = newprio;
+  currp->p_prio = (tsprio_t)newprio;
 #endif
   chSchRescheduleS();
   chSysUnlock();
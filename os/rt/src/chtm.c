@@ -34,6 +34,18 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Histogram sub-buckets per power of two, as a shift amount.
+ */
+#define TM_HSHIFT               CH_CFG_TM_HISTOGRAM_SUBBITS
+
+/**
+ * @brief   Values below this threshold have one bucket each.
+ */
+#define TM_HLINEAR              ((uint32_t)2 << TM_HSHIFT)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -50,6 +62,68 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Position of the most significant bit set.
+ * @note    Branch-only implementation, no division nor CLZ instruction is
+ *          required.
+ *
+ * @param[in] x         value, must not be zero
+ * @return              The bit position.
+ *
+ * @notapi
+ */
+static inline unsigned tm_msb(uint32_t x) {
+  unsigned n = 0U;
+
+  if (x >= ((uint32_t)1 << 16)) {
+    x >>= 16;
+    n += 16U;
+  }
+  if (x >= ((uint32_t)1 << 8)) {
+    x >>= 8;
+    n += 8U;
+  }
+  if (x >= ((uint32_t)1 << 4)) {
+    x >>= 4;
+    n += 4U;
+  }
+  if (x >= ((uint32_t)1 << 2)) {
+    x >>= 2;
+    n += 2U;
+  }
+  if (x >= ((uint32_t)1 << 1)) {
+    n += 1U;
+  }
+  return n;
+}
+
+/**
+ * @brief   Histogram bucket index for a measured value.
+ *
+ * @param[in] x         measured value
+ * @return              The bucket index, saturated to the last bucket.
+ *
+ * @notapi
+ */
+static inline unsigned tm_bucket(rtcnt_t x) {
+  uint32_t v = (uint32_t)x;
+  unsigned idx, shift;
+
+  if (v < TM_HLINEAR) {
+    idx = (unsigned)v;
+  }
+  else {
+    shift = tm_msb(v) - (unsigned)TM_HSHIFT;
+    idx = (shift << TM_HSHIFT) + (unsigned)(v >> shift);
+  }
+  if (idx >= (unsigned)CH_CFG_TM_HISTOGRAM_BUCKETS) {
+    idx = (unsigned)CH_CFG_TM_HISTOGRAM_BUCKETS - 1U;
+  }
+  return idx;
+}
+#endif /* CH_CFG_USE_TM_HISTOGRAM == TRUE */
+
 static inline void tm_stop(time_measurement_t *tmp,
                            rtcnt_t now,
                            rtcnt_t offset) {
@@ -57,6 +131,12 @@ static inline void tm_stop(time_measurement_t *tmp,
   tmp->n++;
   tmp->last = (now - tmp->last) - offset;
   tmp->cumulative += (rttime_t)tmp->last;
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  if (tmp->histogram != NULL) {
+    tmp->histogram->n++;
+    tmp->histogram->buckets[tm_bucket(tmp->last)]++;
+  }
+#endif
   /*lint -save -e9013 [15.7] There is no else because it is not needed.*/
   if (tmp->last > tmp->worst) {
     tmp->worst = tmp->last;
@@ -83,6 +163,9 @@ void _tm_init(void) {
      and calculates the call overhead which is subtracted to real
      measurements.*/
   ch.tm.offset = (rtcnt_t)0;
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  ch.tm.histograms = NULL;
+#endif
   chTMObjectInit(&tm);
   chTMStartMeasurementX(&tm);
   chTMStopMeasurementX(&tm);
@@ -103,6 +186,9 @@ void chTMObjectInit(time_measurement_t *tmp) {
   tmp->last       = (rtcnt_t)0;
   tmp->n          = (ucnt_t)0;
   tmp->cumulative = (rttime_t)0;
+#if CH_CFG_USE_TM_HISTOGRAM == TRUE
+  tmp->histogram  = NULL;
+#endif
 }
 
 /**
@@ -153,6 +239,171 @@ NOINLINE void chTMChainMeasurementToX(time_measurement_t *tmp1,
   tm_stop(tmp1, tmp2->last, (rtcnt_t)0);
 }
 
+#if (CH_CFG_USE_TM_HISTOGRAM == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p tm_histogram_t object.
+ *
+ * @param[out] hp       pointer to a @p tm_histogram_t structure
+ * @param[in] name      name of the histogram, it is shown by the dump
+ *                      functions
+ *
+ * @init
+ */
+void chTMHistogramObjectInit(tm_histogram_t *hp, const char *name) {
+
+  hp->next = NULL;
+  hp->name = name;
+  hp->tmp  = NULL;
+  chTMHistogramResetX(hp);
+}
+
+/**
+ * @brief   Attaches an histogram to a measurement object.
+ * @details The histogram is also added to the list of the registered
+ *          histograms, see @p chTMHistogramFirst().
+ * @pre     The histogram must not be already attached to another
+ *          measurement object.
+ * @note    Histograms cannot be unregistered, they are meant to be static
+ *          objects.
+ *
+ * @param[in,out] tmp   pointer to a @p time_measurement_t structure
+ * @param[in,out] hp    pointer to a @p tm_histogram_t structure
+ *
+ * @api
+ */
+void chTMAttachHistogram(time_measurement_t *tmp, tm_histogram_t *hp) {
+
+  chDbgCheck((tmp != NULL) && (hp != NULL));
+
+  chSysLock();
+  chDbgAssert(hp->tmp == NULL, "already attached");
+  hp->tmp = tmp;
+  hp->next = ch.tm.histograms;
+  ch.tm.histograms = hp;
+  tmp->histogram = hp;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Clears all the samples in an histogram.
+ *
+ * @param[out] hp       pointer to a @p tm_histogram_t structure
+ *
+ * @xclass
+ */
+void chTMHistogramResetX(tm_histogram_t *hp) {
+  unsigned i;
+
+  hp->n = (ucnt_t)0;
+  for (i = 0U; i < (unsigned)CH_CFG_TM_HISTOGRAM_BUCKETS; i++) {
+    hp->buckets[i] = (ucnt_t)0;
+  }
+}
+
+/**
+ * @brief   Returns the highest value accounted in a bucket.
+ *
+ * @param[in] idx       bucket index
+ * @return              The bucket upper limit, the last bucket has no
+ *                      upper limit and returns @p (rtcnt_t)-1.
+ *
+ * @xclass
+ */
+rtcnt_t chTMHistogramGetBucketLimitX(unsigned idx) {
+  unsigned shift;
+  uint32_t m;
+
+  if (idx >= (unsigned)CH_CFG_TM_HISTOGRAM_BUCKETS - 1U) {
+    return (rtcnt_t)-1;
+  }
+  if (idx < TM_HLINEAR) {
+    return (rtcnt_t)idx;
+  }
+  shift = (idx >> TM_HSHIFT) - 1U;
+  m = ((uint32_t)1 << TM_HSHIFT) |
+      ((uint32_t)idx & (((uint32_t)1 << TM_HSHIFT) - 1U));
+  return (rtcnt_t)(((m + 1U) << shift) - 1U);
+}
+
+/**
+ * @brief   Returns a percentile of the recorded measurements.
+ * @note    The result is the upper limit of the bucket containing the
+ *          requested percentile so it is accurate within the resolution
+ *          of the histogram.
+ * @note    Samples can be added while this function is scanning the
+ *          histogram, the result is approximate in that case.
+ *
+ * @param[in] hp        pointer to a @p tm_histogram_t structure
+ * @param[in] permille  requested percentile in thousandths, for example
+ *                      990 for the 99th percentile
+ * @return              The percentile value.
+ * @retval 0            if the histogram is empty.
+ *
+ * @xclass
+ */
+rtcnt_t chTMHistogramGetPercentileX(const tm_histogram_t *hp,
+                                    unsigned permille) {
+  rttime_t target, acc;
+  unsigned i;
+
+  chDbgCheck((hp != NULL) && (permille <= 1000U));
+
+  if (hp->n == (ucnt_t)0) {
+    return (rtcnt_t)0;
+  }
+
+  /* Rank of the requested sample, rounded up.*/
+  target = (((rttime_t)hp->n * (rttime_t)permille) + (rttime_t)999) /
+           (rttime_t)1000;
+  if (target == (rttime_t)0) {
+    target = (rttime_t)1;
+  }
+
+  acc = (rttime_t)0;
+  for (i = 0U; i < (unsigned)CH_CFG_TM_HISTOGRAM_BUCKETS - 1U; i++) {
+    acc += (rttime_t)hp->buckets[i];
+    if (acc >= target) {
+      break;
+    }
+  }
+  return chTMHistogramGetBucketLimitX(i);
+}
+
+/**
+ * @brief   Returns the first registered histogram.
+ *
+ * @return              A pointer to the first histogram.
+ * @retval NULL         if there are no registered histograms.
+ *
+ * @api
+ */
+tm_histogram_t *chTMHistogramFirst(void) {
+  tm_histogram_t *hp;
+
+  chSysLock();
+  hp = ch.tm.histograms;
+  chSysUnlock();
+
+  return hp;
+}
+
+/**
+ * @brief   Returns the histogram registered after the specified one.
+ *
+ * @param[in] hp        pointer to a registered histogram
+ * @return              A pointer to the next histogram.
+ * @retval NULL         if there are no more registered histograms.
+ *
+ * @api
+ */
+tm_histogram_t *chTMHistogramNext(tm_histogram_t *hp) {
+
+  chDbgCheck(hp != NULL);
+
+  return hp->next;
+}
+#endif /* CH_CFG_USE_TM_HISTOGRAM == TRUE */
+
 #endif /* CH_CFG_USE_TM == TRUE */
 
 /** @} */
@@ -94,6 +94,16 @@
  */
 #define CH_CFG_MEMCORE_SIZE                 0
 
+/**
+ * @brief   Attributes of the default core memory region.
+ * @details Placement hints, @p MEM_FAST, @p MEM_DMA and @p MEM_RETAINED,
+ *          describing the memory managed by default.
+ *
+ * @note    The default is @p MEM_DMA.
+ * @note    Requires @p CH_CFG_USE_MEMCORE_REGIONS.
+ */
+#define CH_CFG_MEMCORE_DEFAULT_FLAGS        MEM_DMA
+
 /**
  * @brief   Idle thread automatic spawn suppression.
  * @details When this option is activated the function @p chSysInit()
@@ -103,6 +113,16 @@
  */
 #define CH_CFG_NO_IDLE_THREAD               FALSE
 
+/**
+ * @brief   Static threads table.
+ * @details If enabled then @p chSysInit() creates the threads declared by
+ *          the application using @p THD_TABLE_BEGIN, @p THD_TABLE_ENTRY()
+ *          and @p THD_TABLE_END.
+ *
+ * @note    The default is @p FALSE.
+ */
+#define CH_CFG_USE_THREAD_TABLE             FALSE
+
 /** @} */
 
 /*===========================================================================*/
@@ -122,6 +142,17 @@
  */
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 
+/**
+ * @brief   Compact threads layout.
+ * @details If enabled then the @p thread_t structure is laid out for size,
+ *          priorities are stored as 8 bits values and packed with the
+ *          thread state and flags. With @p CH_CFG_ST_RESOLUTION set to 16
+ *          the profiling time counter is packed too.
+ *
+ * @note    The default is @p FALSE.
+ */
+#define CH_CFG_COMPACT_THREADS              FALSE
+
 /** @} */
 
 /*===========================================================================*/
@@ -140,6 +171,15 @@
  */
 #define CH_CFG_USE_TM                       TRUE
 
+/**
+ * @brief   Time Measurement histograms.
+ * @details If enabled then log-scale histograms can be attached to the
+ *          time measurement objects.
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_TM.
+ */
+#define CH_CFG_USE_TM_HISTOGRAM             FALSE
+
 /**
  * @brief   Threads registry APIs.
  * @details If enabled then the registry APIs are included in the kernel.
@@ -269,6 +309,14 @@
  */
 #define CH_CFG_USE_QUEUES                   TRUE
 
+/**
+ * @brief   Pipes APIs.
+ * @details If enabled then the pipes APIs are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#define CH_CFG_USE_PIPES                    FALSE
+
 /**
  * @brief   Core Memory Manager APIs.
  * @details If enabled then the core memory manager APIs are included
@@ -278,6 +326,17 @@
  */
 #define CH_CFG_USE_MEMCORE                  TRUE
 
+/**
+ * @brief   Multiple core memory regions.
+ * @details If enabled then further memory regions, with attributes, can
+ *          be added to the core allocator and allocations can specify
+ *          placement hints.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#define CH_CFG_USE_MEMCORE_REGIONS          FALSE
+
 /**
  * @brief   Heap Allocator APIs.
  * @details If enabled then the memory heap allocator APIs are included
@@ -299,6 +358,66 @@
  */
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 
+/**
+ * @brief   Lock-free memory pools.
+ * @details If enabled, and if the port supports exclusive load/store
+ *          operations, then the memory pools are updated without entering
+ *          critical zones.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ * @note    Ports without exclusive load/store operations ignore this option.
+ */
+#define CH_CFG_USE_LOCKFREE_POOLS           FALSE
+
+/**
+ * @brief   Memory Arenas APIs.
+ * @details If enabled then the memory arenas allocator APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#define CH_CFG_USE_ARENAS                   FALSE
+
+/**
+ * @brief   Per-thread default memory arenas.
+ * @details If enabled then each thread has a default arena, used when
+ *          @p NULL is passed to @p chArenaAlloc().
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_ARENAS.
+ */
+#define CH_CFG_USE_THREAD_ARENAS            FALSE
+
+/**
+ * @brief   Slab allocator APIs.
+ * @details If enabled then the slab allocator APIs are included in the
+ *          kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#define CH_CFG_USE_SLABS                    FALSE
+
+/**
+ * @brief   Relocatable heaps APIs.
+ * @details If enabled then the handle-based relocatable heaps APIs are
+ *          included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MUTEXES, @p CH_CFG_USE_SEMAPHORES and
+ *          @p CH_CFG_USE_MEMCORE.
+ */
+#define CH_CFG_USE_RELOC_HEAPS              FALSE
+
+/**
+ * @brief   Bytes moved by a relocatable heap compactor in a single step.
+ * @details The heap is locked during a step, this value bounds the time
+ *          other threads can be kept waiting.
+ */
+#define CH_CFG_RHEAP_COMPACT_STEP           64
+
 /**
  * @brief   Dynamic Threads APIs.
  * @details If enabled then the dynamic threads creation APIs are included
@@ -326,6 +445,15 @@
  */
 #define CH_DBG_STATISTICS                   FALSE
 
+/**
+ * @brief   Debug option, lock contention statistics.
+ * @details If enabled then mutexes, semaphores and condition variables
+ *          account acquisitions, contention and wait times.
+ *
+ * @note    The default is @p FALSE.
+ */
+#define CH_DBG_LOCK_STATISTICS              FALSE
+
 /**
  * @brief   Debug option, system state check.
  * @details If enabled the correct call protocol for system APIs is checked
@@ -0,0 +1,308 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dsp.c
+ * @brief   Fixed point DSP blocks, conversion and level measurement code.
+ *
+ * @addtogroup dsp
+ * @{
+ */
+
+#include "hal.h"
+#include "dsp.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static uint32_t dsp_abs(q15_t x) {
+
+  return x < 0 ? (uint32_t)-(int32_t)x : (uint32_t)x;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts ADC samples to Q15.
+ * @details Each sample is computed as <tt>(src[i] - offset) << shift</tt>
+ *          and saturated, the offset is the mid-scale code for a signal
+ *          biased at half supply, the shift aligns the ADC resolution to
+ *          the sign bit.
+ * @note    The conversion can be done in place if @p adcsample_t is
+ *          16 bits wide.
+ *
+ * @param[out] dst      output buffer
+ * @param[in] src       ADC samples
+ * @param[in] n         number of samples
+ * @param[in] offset    value to be subtracted from each sample
+ * @param[in] shift     left shift applied after the subtraction
+ */
+void dspFromADC(q15_t *dst, const adcsample_t *src, size_t n,
+                int32_t offset, unsigned shift) {
+  int32_t scale = (int32_t)1 << shift;
+
+  while (n > 0U) {
+    *dst++ = dspSat16(((int32_t)*src++ - offset) * scale);
+    n--;
+  }
+}
+
+/**
+ * @brief   Integer square root.
+ * @details Bit by bit method, shifts and additions only.
+ *
+ * @param[in] x         the operand
+ * @return              The square root rounded toward zero.
+ */
+uint32_t dspSqrt(uint32_t x) {
+  uint32_t res = 0U;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0U) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    }
+    else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return res;
+}
+
+/**
+ * @brief   64 bits integer square root.
+ * @details Bit by bit method, shifts and additions only.
+ *
+ * @param[in] x         the operand
+ * @return              The square root rounded toward zero.
+ */
+uint32_t dspSqrt64(uint64_t x) {
+  uint64_t res = 0U;
+  uint64_t bit = 1ULL << 62;
+
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0U) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    }
+    else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)res;
+}
+
+/**
+ * @brief   RMS value of a block of samples.
+ * @note    A single division is performed per block.
+ *
+ * @param[in] in        input samples
+ * @param[in] n         number of samples, must be greater than zero
+ * @return              The RMS value, saturated to the Q15 range.
+ */
+q15_t dspRMS(const q15_t *in, size_t n) {
+  uint64_t sum = 0U;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    sum += (uint32_t)((int32_t)in[i] * (int32_t)in[i]);
+  }
+  return dspSat16((int32_t)dspSqrt((uint32_t)(sum / n)));
+}
+
+/**
+ * @brief   RMS value of a block of Q31 samples.
+ * @details The squares are accumulated in Q31, the bits below the Q31
+ *          resolution of each square are dropped.
+ * @note    A single division is performed per block.
+ *
+ * @param[in] in        input samples
+ * @param[in] n         number of samples, must be greater than zero
+ * @return              The RMS value, saturated to the Q31 range.
+ */
+q31_t dspRMSQ31(const q31_t *in, size_t n) {
+  uint64_t sum = 0U;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    sum += (uint64_t)((int64_t)in[i] * (int64_t)in[i]) >> 31;
+  }
+  return dspSat32((int64_t)dspSqrt64((sum / n) << 31));
+}
+
+/**
+ * @brief   Peak absolute value of a block of samples.
+ *
+ * @param[in] in        input samples
+ * @param[in] n         number of samples
+ * @return              The peak value, saturated to the Q15 range.
+ */
+q15_t dspPeak(const q15_t *in, size_t n) {
+  uint32_t peak = 0U, a;
+
+  while (n > 0U) {
+    a = dsp_abs(*in++);
+    if (a > peak) {
+      peak = a;
+    }
+    n--;
+  }
+  return dspSat16((int32_t)peak);
+}
+
+/**
+ * @brief   Initializes a level detector.
+ *
+ * @param[out] lp       pointer to the @p dsp_level_t structure
+ * @param[in] rms_shift mean square time constant as a power of two,
+ *                      in samples, 1..15
+ * @param[in] peak_shift peak decay rate as a power of two, 1..15
+ */
+void dspLevelObjectInit(dsp_level_t *lp, unsigned rms_shift,
+                        unsigned peak_shift) {
+
+  lp->ms         = 0U;
+  lp->peak       = 0U;
+  lp->rms_shift  = rms_shift;
+  lp->peak_shift = peak_shift;
+}
+
+/**
+ * @brief   Feeds samples to a level detector.
+ *
+ * @param[in,out] lp    pointer to the @p dsp_level_t structure
+ * @param[in] in        input samples
+ * @param[in] n         number of samples
+ */
+void dspLevelProcess(dsp_level_t *lp, const q15_t *in, size_t n) {
+  uint32_t ms = lp->ms, peak = lp->peak, a;
+
+  while (n > 0U) {
+    a = dsp_abs(*in++);
+    ms = (uint32_t)((int32_t)ms +
+                    (((int32_t)(a * a) - (int32_t)ms) >> lp->rms_shift));
+    peak -= peak >> lp->peak_shift;
+    if (a > peak) {
+      peak = a;
+    }
+    n--;
+  }
+  lp->ms   = ms;
+  lp->peak = peak;
+}
+
+/**
+ * @brief   Current RMS level.
+ *
+ * @param[in] lp        pointer to the @p dsp_level_t structure
+ * @return              The RMS level, saturated to the Q15 range.
+ */
+q15_t dspLevelRMS(const dsp_level_t *lp) {
+
+  return dspSat16((int32_t)dspSqrt(lp->ms));
+}
+
+/**
+ * @brief   Current peak level.
+ *
+ * @param[in] lp        pointer to the @p dsp_level_t structure
+ * @return              The peak level, saturated to the Q15 range.
+ */
+q15_t dspLevelPeak(const dsp_level_t *lp) {
+
+  return dspSat16((int32_t)lp->peak);
+}
+
+/**
+ * @brief   Initializes a moving average.
+ *
+ * @param[out] mp       pointer to the @p dsp_mavg_t structure
+ * @param[in] history   buffer of 2^@p log2len samples
+ * @param[in] log2len   base 2 logarithm of the length, up to 16
+ */
+void dspMavgObjectInit(dsp_mavg_t *mp, q15_t *history, unsigned log2len) {
+  size_t i;
+
+  for (i = 0U; i < ((size_t)1 << log2len); i++) {
+    history[i] = 0;
+  }
+  mp->history = history;
+  mp->sum     = 0;
+  mp->log2len = log2len;
+  mp->pos     = 0U;
+}
+
+/**
+ * @brief   Filters samples with a moving average.
+ * @details The running sum is updated with one addition and one
+ *          subtraction per sample whatever the length.
+ * @note    The filtering can be done in place.
+ *
+ * @param[in,out] mp    pointer to the @p dsp_mavg_t structure
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspMavgProcess(dsp_mavg_t *mp, const q15_t *in, q15_t *out,
+                    size_t n) {
+  q15_t *history = mp->history;
+  size_t mask = ((size_t)1 << mp->log2len) - 1U;
+  size_t pos = mp->pos;
+  int32_t sum = mp->sum;
+  int32_t half = (int32_t)(((uint32_t)1 << mp->log2len) >> 1);
+  q15_t x;
+
+  while (n > 0U) {
+    x = *in++;
+    sum += (int32_t)x - (int32_t)history[pos];
+    history[pos] = x;
+    pos = (pos + 1U) & mask;
+    *out++ = (q15_t)((sum + half) >> mp->log2len);
+    n--;
+  }
+  mp->pos = pos;
+  mp->sum = sum;
+}
+
+/** @} */
@@ -0,0 +1,361 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dsp.h
+ * @brief   Fixed point DSP blocks header.
+ *
+ * @addtogroup dsp
+ * @{
+ */
+
+#ifndef _DSP_H_
+#define _DSP_H_
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Largest FFT size, it is the size of the sine table.
+ */
+#define DSP_FFT_MAX_SIZE            1024U
+
+/**
+ * @brief   Maximum CIC filter order.
+ */
+#define DSP_CIC_MAX_ORDER           4U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+#if !defined(_ARM_MATH_H) || defined(__DOXYGEN__)
+/**
+ * @brief   Q1.15 fractional type, same as the CMSIS one.
+ */
+typedef int16_t q15_t;
+
+/**
+ * @brief   Q1.31 fractional type, same as the CMSIS one.
+ */
+typedef int32_t q31_t;
+#endif
+
+/**
+ * @brief   FIR filter.
+ */
+typedef struct {
+  /**
+   * @brief   Coefficients in Q15, @p ntaps entries.
+   */
+  const q15_t           *coeffs;
+  /**
+   * @brief   Delay line, @p ntaps entries.
+   */
+  q15_t                 *state;
+  /**
+   * @brief   Number of taps.
+   */
+  size_t                ntaps;
+  /**
+   * @brief   Position of the most recent sample in the delay line.
+   */
+  size_t                pos;
+} dsp_fir_t;
+
+/**
+ * @brief   Cascade of biquad filters.
+ */
+typedef struct {
+  /**
+   * @brief   Coefficients in Q14, b0, b1, b2, a1, a2 for each stage.
+   */
+  const q15_t           *coeffs;
+  /**
+   * @brief   State, x[n-1], x[n-2], y[n-1], y[n-2] for each stage.
+   */
+  q15_t                 *state;
+  /**
+   * @brief   Number of stages.
+   */
+  unsigned              stages;
+} dsp_biquad_t;
+
+/**
+ * @brief   Q31 FIR filter.
+ */
+typedef struct {
+  /**
+   * @brief   Coefficients in Q31, @p ntaps entries.
+   */
+  const q31_t           *coeffs;
+  /**
+   * @brief   Delay line, @p ntaps entries.
+   */
+  q31_t                 *state;
+  /**
+   * @brief   Number of taps.
+   */
+  size_t                ntaps;
+  /**
+   * @brief   Position of the most recent sample in the delay line.
+   */
+  size_t                pos;
+} dsp_fir_q31_t;
+
+/**
+ * @brief   Cascade of Q31 biquad filters.
+ */
+typedef struct {
+  /**
+   * @brief   Coefficients in Q30, b0, b1, b2, a1, a2 for each stage.
+   */
+  const q31_t           *coeffs;
+  /**
+   * @brief   State, x[n-1], x[n-2], y[n-1], y[n-2] for each stage.
+   */
+  q31_t                 *state;
+  /**
+   * @brief   Number of stages.
+   */
+  unsigned              stages;
+} dsp_biquad_q31_t;
+
+/**
+ * @brief   CIC decimator.
+ */
+typedef struct {
+  /**
+   * @brief   Integrators, modulo 2^32.
+   */
+  uint32_t              integ[DSP_CIC_MAX_ORDER];
+  /**
+   * @brief   Combs delay elements, modulo 2^32.
+   */
+  uint32_t              comb[DSP_CIC_MAX_ORDER];
+  /**
+   * @brief   Filter order.
+   */
+  unsigned              order;
+  /**
+   * @brief   Decimation ratio.
+   */
+  unsigned              ratio;
+  /**
+   * @brief   Output scaling, right shift.
+   */
+  unsigned              shift;
+  /**
+   * @brief   Input samples since the last output.
+   */
+  unsigned              phase;
+} dsp_cic_t;
+
+/**
+ * @brief   Moving average.
+ */
+typedef struct {
+  /**
+   * @brief   Last input samples, 2^@p log2len entries.
+   */
+  q15_t                 *history;
+  /**
+   * @brief   Sum of the samples in @p history.
+   */
+  int32_t               sum;
+  /**
+   * @brief   Base 2 logarithm of the length.
+   */
+  unsigned              log2len;
+  /**
+   * @brief   Position of the oldest sample in @p history.
+   */
+  size_t                pos;
+} dsp_mavg_t;
+
+/**
+ * @brief   Level detector.
+ */
+typedef struct {
+  /**
+   * @brief   Smoothed square of the signal, Q30.
+   */
+  uint32_t              ms;
+  /**
+   * @brief   Decaying peak of the absolute value, up to 32768.
+   */
+  uint32_t              peak;
+  /**
+   * @brief   Mean square smoothing, the time constant is 2^@p rms_shift
+   *          samples.
+   */
+  unsigned              rms_shift;
+  /**
+   * @brief   Peak decay, 2^-@p peak_shift of the peak per sample.
+   */
+  unsigned              peak_shift;
+} dsp_level_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Q15 constant from a real constant in the range [-1, 1].
+ * @note    Meant for constant expressions, it is evaluated by the compiler.
+ */
+#define DSP_Q15(x)                                                          \
+  ((q15_t)((x) >= 1.0 ? 32767 :                                             \
+           (x) < 0.0 ? (int32_t)((x) * 32768.0 - 0.5) :                     \
+                       (int32_t)((x) * 32768.0 + 0.5)))
+
+/**
+ * @brief   Q14 constant from a real constant in the range [-2, 2].
+ * @note    Biquad coefficients are expressed in this format.
+ */
+#define DSP_Q14(x)                                                          \
+  ((q15_t)((x) >= 2.0 ? 32767 :                                             \
+           (x) < 0.0 ? (int32_t)((x) * 16384.0 - 0.5) :                     \
+                       (int32_t)((x) * 16384.0 + 0.5)))
+
+/**
+ * @brief   Q31 constant from a real constant in the range [-1, 1].
+ * @note    Meant for constant expressions, it is evaluated by the compiler.
+ */
+#define DSP_Q31(x)                                                          \
+  ((q31_t)((x) >= 1.0 ? 2147483647 :                                        \
+           (x) < 0.0 ? (int64_t)((x) * 2147483648.0 - 0.5) :                \
+                       (int64_t)((x) * 2147483648.0 + 0.5)))
+
+/**
+ * @brief   Q30 constant from a real constant in the range [-2, 2].
+ * @note    Q31 biquad coefficients are expressed in this format.
+ */
+#define DSP_Q30(x)                                                          \
+  ((q31_t)((x) >= 2.0 ? 2147483647 :                                        \
+           (x) < 0.0 ? (int64_t)((x) * 1073741824.0 - 0.5) :                \
+                       (int64_t)((x) * 1073741824.0 + 0.5)))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dspFromADC(q15_t *dst, const adcsample_t *src, size_t n,
+                  int32_t offset, unsigned shift);
+  uint32_t dspSqrt(uint32_t x);
+  uint32_t dspSqrt64(uint64_t x);
+  q15_t dspRMS(const q15_t *in, size_t n);
+  q31_t dspRMSQ31(const q31_t *in, size_t n);
+  q15_t dspPeak(const q15_t *in, size_t n);
+  void dspLevelObjectInit(dsp_level_t *lp, unsigned rms_shift,
+                          unsigned peak_shift);
+  void dspLevelProcess(dsp_level_t *lp, const q15_t *in, size_t n);
+  q15_t dspLevelRMS(const dsp_level_t *lp);
+  q15_t dspLevelPeak(const dsp_level_t *lp);
+  void dspMavgObjectInit(dsp_mavg_t *mp, q15_t *history, unsigned log2len);
+  void dspMavgProcess(dsp_mavg_t *mp, const q15_t *in, q15_t *out,
+                      size_t n);
+  void dspFirObjectInit(dsp_fir_t *fp, const q15_t *coeffs, q15_t *state,
+                        size_t ntaps);
+  void dspFirProcess(dsp_fir_t *fp, const q15_t *in, q15_t *out, size_t n);
+  void dspBiquadObjectInit(dsp_biquad_t *bp, const q15_t *coeffs,
+                           q15_t *state, unsigned stages);
+  void dspBiquadProcess(dsp_biquad_t *bp, const q15_t *in, q15_t *out,
+                        size_t n);
+  void dspFirQ31ObjectInit(dsp_fir_q31_t *fp, const q31_t *coeffs,
+                           q31_t *state, size_t ntaps);
+  void dspFirQ31Process(dsp_fir_q31_t *fp, const q31_t *in, q31_t *out,
+                        size_t n);
+  void dspBiquadQ31ObjectInit(dsp_biquad_q31_t *bp, const q31_t *coeffs,
+                              q31_t *state, unsigned stages);
+  void dspBiquadQ31Process(dsp_biquad_q31_t *bp, const q31_t *in,
+                           q31_t *out, size_t n);
+  void dspCicObjectInit(dsp_cic_t *cp, unsigned order, unsigned ratio,
+                        unsigned shift);
+  size_t dspCicDecimate(dsp_cic_t *cp, const q15_t *in, q15_t *out,
+                        size_t n);
+  void dspFFT(q15_t *buf, size_t n);
+  void dspFFTMagnitude(const q15_t *buf, q15_t *mag, size_t n);
+  void dspFFTLoadReal(q15_t *buf, const q15_t *in, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Saturates to the Q15 range.
+ *
+ * @param[in] x         value to be saturated
+ * @return              The saturated value.
+ */
+static inline q15_t dspSat16(int32_t x) {
+
+  if (x > 32767) {
+    return 32767;
+  }
+  if (x < -32768) {
+    return -32768;
+  }
+  return (q15_t)x;
+}
+
+/**
+ * @brief   Q15 multiplication with rounding.
+ *
+ * @param[in] a         first operand
+ * @param[in] b         second operand
+ * @return              The saturated product.
+ */
+static inline q15_t dspMulQ15(q15_t a, q15_t b) {
+
+  return dspSat16(((int32_t)a * (int32_t)b + 0x4000) >> 15);
+}
+
+/**
+ * @brief   Saturates to the Q31 range.
+ *
+ * @param[in] x         value to be saturated
+ * @return              The saturated value.
+ */
+static inline q31_t dspSat32(int64_t x) {
+
+  if (x > 2147483647) {
+    return 2147483647;
+  }
+  if (x < -2147483647 - 1) {
+    return -2147483647 - 1;
+  }
+  return (q31_t)x;
+}
+
+#endif /* _DSP_H_ */
+
+/** @} */
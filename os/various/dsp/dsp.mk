@@ -0,0 +1,6 @@
+# Fixed point DSP blocks files.
+DSPSRC = ${CHIBIOS}/os/various/dsp/dsp.c \
+         ${CHIBIOS}/os/various/dsp/dsp_filter.c \
+         ${CHIBIOS}/os/various/dsp/dsp_fft.c
+
+DSPINC = ${CHIBIOS}/os/various/dsp
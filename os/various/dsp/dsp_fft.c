@@ -0,0 +1,212 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dsp_fft.c
+ * @brief   Fixed point DSP blocks, FFT code.
+ *
+ * @addtogroup dsp
+ * @{
+ */
+
+#include "hal.h"
+#include "dsp.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Entries in a quarter of the sine period.
+ */
+#define QUARTER                     (DSP_FFT_MAX_SIZE / 4U)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   First quarter of the sine period in Q15, both ends included.
+ */
+static const q15_t sine_table[QUARTER + 1U] = {
+       0,    201,    402,    603,    804,   1005,   1206,   1407,
+    1608,   1809,   2009,   2210,   2411,   2611,   2811,   3012,
+    3212,   3412,   3612,   3812,   4011,   4211,   4410,   4609,
+    4808,   5007,   5205,   5404,   5602,   5800,   5998,   6195,
+    6393,   6590,   6787,   6983,   7180,   7376,   7571,   7767,
+    7962,   8157,   8351,   8546,   8740,   8933,   9127,   9319,
+    9512,   9704,   9896,  10088,  10279,  10469,  10660,  10850,
+   11039,  11228,  11417,  11605,  11793,  11980,  12167,  12354,
+   12540,  12725,  12910,  13095,  13279,  13463,  13646,  13828,
+   14010,  14192,  14373,  14553,  14733,  14912,  15091,  15269,
+   15447,  15624,  15800,  15976,  16151,  16326,  16500,  16673,
+   16846,  17018,  17190,  17361,  17531,  17700,  17869,  18037,
+   18205,  18372,  18538,  18703,  18868,  19032,  19195,  19358,
+   19520,  19681,  19841,  20001,  20160,  20318,  20475,  20632,
+   20788,  20943,  21097,  21251,  21403,  21555,  21706,  21856,
+   22006,  22154,  22302,  22449,  22595,  22740,  22884,  23028,
+   23170,  23312,  23453,  23593,  23732,  23870,  24008,  24144,
+   24279,  24414,  24548,  24680,  24812,  24943,  25073,  25202,
+   25330,  25457,  25583,  25708,  25833,  25956,  26078,  26199,
+   26320,  26439,  26557,  26674,  26791,  26906,  27020,  27133,
+   27246,  27357,  27467,  27576,  27684,  27791,  27897,  28002,
+   28106,  28209,  28311,  28411,  28511,  28610,  28707,  28803,
+   28899,  28993,  29086,  29178,  29269,  29359,  29448,  29535,
+   29622,  29707,  29792,  29875,  29957,  30038,  30118,  30196,
+   30274,  30350,  30425,  30499,  30572,  30644,  30715,  30784,
+   30853,  30920,  30986,  31050,  31114,  31177,  31238,  31298,
+   31357,  31415,  31471,  31527,  31581,  31634,  31686,  31737,
+   31786,  31834,  31881,  31927,  31972,  32015,  32058,  32099,
+   32138,  32177,  32214,  32251,  32286,  32319,  32352,  32383,
+   32413,  32442,  32470,  32496,  32522,  32546,  32568,  32590,
+   32610,  32629,  32647,  32664,  32679,  32693,  32706,  32718,
+   32729,  32738,  32746,  32753,  32758,  32762,  32766,  32767,
+   32767
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Swaps the samples into bit reversed order.
+ */
+static void fft_reorder(q15_t *buf, size_t n) {
+  size_t i, j, m;
+  q15_t t;
+
+  j = 0U;
+  for (i = 0U; i < n - 1U; i++) {
+    if (i < j) {
+      t = buf[2U * i];
+      buf[2U * i] = buf[2U * j];
+      buf[2U * j] = t;
+      t = buf[2U * i + 1U];
+      buf[2U * i + 1U] = buf[2U * j + 1U];
+      buf[2U * j + 1U] = t;
+    }
+    m = n >> 1;
+    while (j >= m) {
+      j -= m;
+      m >>= 1;
+    }
+    j += m;
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   In place complex FFT.
+ * @details Radix 2, decimation in time. Each pass scales the data by one
+ *          half so the result is the DFT divided by @p n and no overflow
+ *          can happen. The twiddle factors are taken from a quarter period
+ *          sine table.
+ * @pre     The magnitude of each input sample must not exceed one.
+ *
+ * @param[in,out] buf   interleaved real and imaginary parts, 2 * @p n
+ *                      samples
+ * @param[in] n         number of complex samples, a power of two between
+ *                      2 and @p DSP_FFT_MAX_SIZE
+ */
+void dspFFT(q15_t *buf, size_t n) {
+  size_t len, half, stride, i, j, k;
+  q15_t *a, *b;
+  int32_t wr, wi, tr, ti;
+
+  fft_reorder(buf, n);
+
+  for (len = 2U; len <= n; len <<= 1) {
+    half = len >> 1;
+    stride = DSP_FFT_MAX_SIZE / len;
+    for (j = 0U; j < half; j++) {
+      /* w = exp(-2 * pi * i * j / len).*/
+      k = j * stride;
+      if (k <= QUARTER) {
+        wr = sine_table[QUARTER - k];
+        wi = -(int32_t)sine_table[k];
+      }
+      else {
+        wr = -(int32_t)sine_table[k - QUARTER];
+        wi = -(int32_t)sine_table[2U * QUARTER - k];
+      }
+
+      for (i = j; i < n; i += len) {
+        a = &buf[2U * i];
+        b = &buf[2U * (i + half)];
+        tr = ((int32_t)b[0] * wr - (int32_t)b[1] * wi + 0x4000) >> 15;
+        ti = ((int32_t)b[0] * wi + (int32_t)b[1] * wr + 0x4000) >> 15;
+        b[0] = dspSat16(((int32_t)a[0] - tr + 1) >> 1);
+        b[1] = dspSat16(((int32_t)a[1] - ti + 1) >> 1);
+        a[0] = dspSat16(((int32_t)a[0] + tr + 1) >> 1);
+        a[1] = dspSat16(((int32_t)a[1] + ti + 1) >> 1);
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Magnitude of complex samples.
+ * @note    The computation can be done in place, the magnitudes are packed
+ *          at the beginning of the buffer.
+ *
+ * @param[in] buf       interleaved real and imaginary parts, 2 * @p n
+ *                      samples
+ * @param[out] mag      magnitudes, @p n samples
+ * @param[in] n         number of complex samples
+ */
+void dspFFTMagnitude(const q15_t *buf, q15_t *mag, size_t n) {
+  int32_t re, im;
+
+  while (n > 0U) {
+    re = *buf++;
+    im = *buf++;
+    *mag++ = dspSat16((int32_t)dspSqrt((uint32_t)(re * re) +
+                                       (uint32_t)(im * im)));
+    n--;
+  }
+}
+
+/**
+ * @brief   Loads real samples into a complex buffer.
+ * @note    The loading can be done in place, the samples are expanded
+ *          starting from the end of the buffer.
+ *
+ * @param[out] buf      interleaved real and imaginary parts, 2 * @p n
+ *                      samples
+ * @param[in] in        real samples
+ * @param[in] n         number of samples
+ */
+void dspFFTLoadReal(q15_t *buf, const q15_t *in, size_t n) {
+
+  while (n > 0U) {
+    n--;
+    buf[2U * n + 1U] = 0;
+    buf[2U * n] = in[n];
+  }
+}
+
+/** @} */
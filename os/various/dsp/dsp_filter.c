@@ -0,0 +1,389 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dsp_filter.c
+ * @brief   Fixed point DSP blocks, filters code.
+ *
+ * @addtogroup dsp
+ * @{
+ */
+
+#include "hal.h"
+#include "dsp.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a FIR filter.
+ *
+ * @param[out] fp       pointer to the @p dsp_fir_t structure
+ * @param[in] coeffs    Q15 coefficients, h[0] applies to the most recent
+ *                      sample
+ * @param[in] state     delay line buffer of @p ntaps samples
+ * @param[in] ntaps     number of taps, must be greater than zero
+ */
+void dspFirObjectInit(dsp_fir_t *fp, const q15_t *coeffs, q15_t *state,
+                      size_t ntaps) {
+  size_t i;
+
+  for (i = 0U; i < ntaps; i++) {
+    state[i] = 0;
+  }
+  fp->coeffs = coeffs;
+  fp->state  = state;
+  fp->ntaps  = ntaps;
+  fp->pos    = 0U;
+}
+
+/**
+ * @brief   Filters samples with a FIR filter.
+ * @details The delay line is circular, the convolution is split in the
+ *          two linear segments of the delay line so that the inner loops
+ *          have no wrap check.
+ * @pre     The sum of the absolute values of the coefficients must be
+ *          lower than 2, the accumulator is 32 bits wide.
+ * @note    The filtering can be done in place.
+ *
+ * @param[in,out] fp    pointer to the @p dsp_fir_t structure
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspFirProcess(dsp_fir_t *fp, const q15_t *in, q15_t *out, size_t n) {
+  const q15_t *h;
+  const q15_t *s;
+  q15_t *state = fp->state;
+  size_t ntaps = fp->ntaps;
+  size_t pos = fp->pos;
+  size_t k;
+  int32_t acc;
+
+  while (n > 0U) {
+    pos = pos == 0U ? ntaps - 1U : pos - 1U;
+    state[pos] = *in++;
+
+    acc = 0x4000;
+    h = fp->coeffs;
+    s = &state[pos];
+    for (k = ntaps - pos; k > 0U; k--) {
+      acc += (int32_t)*h++ * (int32_t)*s++;
+    }
+    s = state;
+    for (k = pos; k > 0U; k--) {
+      acc += (int32_t)*h++ * (int32_t)*s++;
+    }
+
+    *out++ = dspSat16(acc >> 15);
+    n--;
+  }
+  fp->pos = pos;
+}
+
+/**
+ * @brief   Initializes a biquad cascade.
+ *
+ * @param[out] bp       pointer to the @p dsp_biquad_t structure
+ * @param[in] coeffs    Q14 coefficients, b0, b1, b2, a1, a2 for each stage,
+ *                      the a0 coefficient is normalized to one
+ * @param[in] state     state buffer of 4 * @p stages samples
+ * @param[in] stages    number of stages
+ */
+void dspBiquadObjectInit(dsp_biquad_t *bp, const q15_t *coeffs,
+                         q15_t *state, unsigned stages) {
+  unsigned i;
+
+  for (i = 0U; i < stages * 4U; i++) {
+    state[i] = 0;
+  }
+  bp->coeffs = coeffs;
+  bp->state  = state;
+  bp->stages = stages;
+}
+
+/**
+ * @brief   Filters samples with a biquad cascade.
+ * @details Direct form I, each stage processes the whole block before the
+ *          next one so the coefficients and the state of a stage stay in
+ *          registers.
+ * @pre     For each stage the sum of the absolute values of the
+ *          coefficients must be lower than 4, the accumulator is 32 bits
+ *          wide.
+ * @note    The filtering can be done in place.
+ *
+ * @param[in,out] bp    pointer to the @p dsp_biquad_t structure
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspBiquadProcess(dsp_biquad_t *bp, const q15_t *in, q15_t *out,
+                      size_t n) {
+  const q15_t *c = bp->coeffs;
+  q15_t *st = bp->state;
+  unsigned stage;
+  size_t i;
+
+  for (stage = 0U; stage < bp->stages; stage++) {
+    int32_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+    int32_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+    int32_t x, y;
+
+    for (i = 0U; i < n; i++) {
+      x = in[i];
+      y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+      y = dspSat16((y + 0x2000) >> 14);
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      out[i] = (q15_t)y;
+    }
+
+    st[0] = (q15_t)x1;
+    st[1] = (q15_t)x2;
+    st[2] = (q15_t)y1;
+    st[3] = (q15_t)y2;
+    c += 5;
+    st += 4;
+    in = out;
+  }
+}
+
+/**
+ * @brief   Initializes a Q31 FIR filter.
+ *
+ * @param[out] fp       pointer to the @p dsp_fir_q31_t structure
+ * @param[in] coeffs    Q31 coefficients, h[0] applies to the most recent
+ *                      sample
+ * @param[in] state     delay line buffer of @p ntaps samples
+ * @param[in] ntaps     number of taps, must be greater than zero
+ */
+void dspFirQ31ObjectInit(dsp_fir_q31_t *fp, const q31_t *coeffs,
+                         q31_t *state, size_t ntaps) {
+  size_t i;
+
+  for (i = 0U; i < ntaps; i++) {
+    state[i] = 0;
+  }
+  fp->coeffs = coeffs;
+  fp->state  = state;
+  fp->ntaps  = ntaps;
+  fp->pos    = 0U;
+}
+
+/**
+ * @brief   Filters Q31 samples with a FIR filter.
+ * @details Same structure as @p dspFirProcess(), the products and the
+ *          accumulator are 64 bits wide.
+ * @pre     The sum of the absolute values of the coefficients must be
+ *          lower than 2.
+ * @note    ARMv6-M has no long multiply, each product is a library call.
+ * @note    The filtering can be done in place.
+ *
+ * @param[in,out] fp    pointer to the @p dsp_fir_q31_t structure
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspFirQ31Process(dsp_fir_q31_t *fp, const q31_t *in, q31_t *out,
+                      size_t n) {
+  const q31_t *h;
+  const q31_t *s;
+  q31_t *state = fp->state;
+  size_t ntaps = fp->ntaps;
+  size_t pos = fp->pos;
+  size_t k;
+  int64_t acc;
+
+  while (n > 0U) {
+    pos = pos == 0U ? ntaps - 1U : pos - 1U;
+    state[pos] = *in++;
+
+    acc = 0x40000000;
+    h = fp->coeffs;
+    s = &state[pos];
+    for (k = ntaps - pos; k > 0U; k--) {
+      acc += (int64_t)*h++ * (int64_t)*s++;
+    }
+    s = state;
+    for (k = pos; k > 0U; k--) {
+      acc += (int64_t)*h++ * (int64_t)*s++;
+    }
+
+    *out++ = dspSat32(acc >> 31);
+    n--;
+  }
+  fp->pos = pos;
+}
+
+/**
+ * @brief   Initializes a Q31 biquad cascade.
+ *
+ * @param[out] bp       pointer to the @p dsp_biquad_q31_t structure
+ * @param[in] coeffs    Q30 coefficients, b0, b1, b2, a1, a2 for each stage,
+ *                      the a0 coefficient is normalized to one
+ * @param[in] state     state buffer of 4 * @p stages samples
+ * @param[in] stages    number of stages
+ */
+void dspBiquadQ31ObjectInit(dsp_biquad_q31_t *bp, const q31_t *coeffs,
+                            q31_t *state, unsigned stages) {
+  unsigned i;
+
+  for (i = 0U; i < stages * 4U; i++) {
+    state[i] = 0;
+  }
+  bp->coeffs = coeffs;
+  bp->state  = state;
+  bp->stages = stages;
+}
+
+/**
+ * @brief   Filters Q31 samples with a biquad cascade.
+ * @details Same structure as @p dspBiquadProcess(), the products and the
+ *          accumulator are 64 bits wide. The wider state keeps the
+ *          rounding noise of low cutoff filters well below the signal,
+ *          as required by slow signals like the accelerometer ones.
+ * @pre     For each stage the sum of the absolute values of the
+ *          coefficients must be lower than 4.
+ * @note    The filtering can be done in place.
+ *
+ * @param[in,out] bp    pointer to the @p dsp_biquad_q31_t structure
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspBiquadQ31Process(dsp_biquad_q31_t *bp, const q31_t *in,
+                         q31_t *out, size_t n) {
+  const q31_t *c = bp->coeffs;
+  q31_t *st = bp->state;
+  unsigned stage;
+  size_t i;
+
+  for (stage = 0U; stage < bp->stages; stage++) {
+    int64_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+    int64_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+    int64_t x, y;
+
+    for (i = 0U; i < n; i++) {
+      x = in[i];
+      y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+      y = dspSat32((y + 0x20000000) >> 30);
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      out[i] = (q31_t)y;
+    }
+
+    st[0] = (q31_t)x1;
+    st[1] = (q31_t)x2;
+    st[2] = (q31_t)y1;
+    st[3] = (q31_t)y2;
+    c += 5;
+    st += 4;
+    in = out;
+  }
+}
+
+/**
+ * @brief   Initializes a CIC decimator.
+ * @details The DC gain is <tt>ratio ^ order</tt>, unity gain is obtained
+ *          with a power of two ratio and @p shift equal to
+ *          <tt>order * log2(ratio)</tt>.
+ * @pre     The gain must be lower than 2^16, the integrators are 32 bits
+ *          wide and rely on the modulo arithmetic.
+ *
+ * @param[out] cp       pointer to the @p dsp_cic_t structure
+ * @param[in] order     filter order, 1..@p DSP_CIC_MAX_ORDER
+ * @param[in] ratio     decimation ratio
+ * @param[in] shift     output right shift
+ */
+void dspCicObjectInit(dsp_cic_t *cp, unsigned order, unsigned ratio,
+                      unsigned shift) {
+  unsigned i;
+
+  for (i = 0U; i < DSP_CIC_MAX_ORDER; i++) {
+    cp->integ[i] = 0U;
+    cp->comb[i]  = 0U;
+  }
+  cp->order = order;
+  cp->ratio = ratio;
+  cp->shift = shift;
+  cp->phase = 0U;
+}
+
+/**
+ * @brief   Decimates samples with a CIC filter.
+ * @note    The decimation can be done in place.
+ *
+ * @param[in,out] cp    pointer to the @p dsp_cic_t structure
+ * @param[in] in        input samples
+ * @param[out] out      output samples, up to
+ *                      <tt>n / ratio + 1</tt> samples
+ * @param[in] n         number of input samples
+ * @return              The number of output samples.
+ */
+size_t dspCicDecimate(dsp_cic_t *cp, const q15_t *in, q15_t *out,
+                      size_t n) {
+  unsigned order = cp->order;
+  unsigned i;
+  size_t nout = 0U;
+  uint32_t v, t;
+
+  while (n > 0U) {
+    v = (uint32_t)(int32_t)*in++;
+    for (i = 0U; i < order; i++) {
+      v += cp->integ[i];
+      cp->integ[i] = v;
+    }
+
+    if (++cp->phase >= cp->ratio) {
+      cp->phase = 0U;
+      for (i = 0U; i < order; i++) {
+        t = v;
+        v -= cp->comb[i];
+        cp->comb[i] = t;
+      }
+      out[nout++] = dspSat16((int32_t)v >> cp->shift);
+    }
+    n--;
+  }
+  return nout;
+}
+
+/** @} */
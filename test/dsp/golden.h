@@ -0,0 +1,457 @@
+/* Generated by golden.py, do not edit.*/
+
+static const adcsample_t adc_in[64] = {
+  978, 3741, 2508, 3796, 202, 3505, 1478, 217, 281, 4030,
+  3984, 2176, 1850, 2243, 2478, 3184, 3194, 1712, 1941, 3490,
+  1484, 1972, 376, 3068, 3416, 1466, 732, 4021, 499, 1862,
+  1869, 442, 467, 2546, 3165, 346, 2480, 3794, 1088, 2418,
+  1444, 1281, 2099, 2915, 1268, 647, 3580, 2562, 1553, 4081,
+  1984, 729, 1039, 3771, 2408, 2018, 716, 1777, 731, 8,
+  2832, 3113, 592, 2224
+};
+
+static const q15_t adc_out[64] = {
+  -17120, 27088, 7360, 27968, -29536, 23312, -9120, -29296, -28272, 31712,
+  30976, 2048, -3168, 3120, 6880, 18176, 18336, -5376, -1712, 23072,
+  -9024, -1216, -26752, 16320, 21888, -9312, -21056, 31568, -24784, -2976,
+  -2864, -25696, -25296, 7968, 17872, -27232, 6912, 27936, -15360, 5920,
+  -9664, -12272, 816, 13872, -12480, -22416, 24512, 8224, -7920, 32528,
+  -1024, -21104, -16144, 27568, 5760, -480, -21312, -4336, -21072, -32640,
+  12544, 17040, -23296, 2816
+};
+
+static const q15_t signal_in[256] = {
+  -2591, 7280, 9519, 6563, -1706, 7504, 20093, 20151, 9273, 9893,
+  7895, 16329, 20586, 17082, 2510, 7245, 10396, 8336, 7022, -4274,
+  -12990, -11501, -7154, -6442, -16654, -17542, -16946, -12152, -10650, -10789,
+  -14990, -21054, -11160, 1969, -4954, -8417, -9147, 4084, 11918, 12079,
+  9777, 7405, 4685, 15579, 21721, 11495, 8739, 6585, 17287, 23373,
+  12832, 911, 6618, 3428, 13048, 1155, -5034, -14722, -9874, -7048,
+  -1243, -13149, -22842, -17287, -8741, -3945, -17306, -23385, -13405, -7307,
+  -3381, -4282, -6557, -4400, 757, 7702, 9625, 2552, 6803, 9836,
+  17557, 20864, 15957, 4789, 8529, 16261, 24036, 13580, 8951, -284,
+  9339, 13792, 5672, -3836, -11684, -13775, -2383, -1547, -12038, -19086,
+  -15586, -14483, -13081, -13236, -16665, -22750, -13087, -5992, -5137, -4873,
+  -9028, -1149, 8094, 15578, 6598, 1067, 11579, 17705, 21464, 15843,
+  10639, 5135, 19193, 22678, 11012, 3859, 2388, -207, 9650, 6548,
+  -2863, -10695, -14459, -2824, 662, -8373, -18647, -16394, -14566, -6901,
+  -6494, -19647, -16123, -11014, -2739, -5646, -11488, -8396, 310, 2659,
+  6607, 12097, 655, 4496, 12804, 19605, 19517, 8501, 6002, 10190,
+  21159, 18118, 7791, 1577, 2674, 3765, 9148, -5736, -6323, -8883,
+  -4157, -3862, -7941, -20804, -18055, -15315, -9562, -9299, -14492, -16112,
+  -7845, -997, -3568, -2683, -12842, -2197, 1617, 7120, 5298, 6127,
+  3851, 15732, 23522, 16938, 13995, 7339, 14518, 14605, 17856, 6506,
+  1515, -632, 3094, 3650, 3117, -10742, -9916, -5954, -5559, -9250,
+  -13282, -24209, -16818, -5849, -9933, -16536, -16676, -9705, -4970, 392,
+  -8335, -7674, -7858, 10327, 10058, 7160, 1766, 1364, 10708, 18777,
+  22569, 13956, 4770, 15115, 19838, 17777, 7557, 4670, 1316, 7527,
+  5169, -1266, -8297, -9744, -7839, -1544, -7284, -15930, -17730, -12646,
+  -4233, -6326, -11196, -20624, -13555, -7408
+};
+
+static const q15_t block_rms = 11668;
+static const q15_t block_peak = 24209;
+
+static const q15_t fir_coeffs[31] = {
+  53, 46, 24, -36, -150, -306, -451, -492, -321, 148,
+  941, 1993, 3154, 4214, 4957, 5225, 4957, 4214, 3154, 1993,
+  941, 148, -321, -492, -451, -306, -150, -36, 24, 46,
+  53
+};
+
+static const q15_t fir_out[256] = {
+  -4, 8, 24, 32, 17, -5, -41, -112, -219, -313,
+  -361, -293, -56, 403, 1114, 2130, 3428, 4944, 6597, 8267,
+  9854, 11275, 12462, 13364, 13942, 14201, 14117, 13657, 12765, 11387,
+  9491, 7091, 4264, 1161, -2055, -5152, -7965, -10339, -12193, -13508,
+  -14337, -14739, -14802, -14554, -14008, -13147, -11941, -10349, -8334, -5945,
+  -3277, -464, 2347, 4970, 7295, 9228, 10752, 11891, 12722, 13304,
+  13684, 13852, 13785, 13414, 12654, 11468, 9804, 7704, 5249, 2555,
+  -227, -2951, -5487, -7730, -9651, -11235, -12477, -13417, -14039, -14357,
+  -14329, -13897, -13039, -11789, -10144, -8194, -5991, -3654, -1231, 1186,
+  3569, 5841, 7955, 9854, 11467, 12752, 13708, 14345, 14658, 14646,
+  14329, 13674, 12644, 11203, 9330, 7054, 4480, 1735, -1026, -3682,
+  -6137, -8331, -10255, -11912, -13324, -14493, -15360, -15870, -15914, -15432,
+  -14362, -12739, -10585, -8008, -5157, -2163, 844, 3713, 6381, 8776,
+  10840, 12530, 13829, 14727, 15186, 15180, 14716, 13807, 12487, 10826,
+  8888, 6751, 4514, 2250, 27, -2097, -4090, -5942, -7623, -9131,
+  -10426, -11479, -12286, -12833, -13090, -13025, -12640, -11944, -10910, -9554,
+  -7863, -5878, -3653, -1249, 1227, 3676, 6019, 8138, 9978, 11493,
+  12652, 13436, 13843, 13818, 13364, 12467, 11168, 9516, 7573, 5428,
+  3190, 918, -1364, -3589, -5776, -7863, -9803, -11492, -12806, -13640,
+  -13940, -13694, -12955, -11851, -10519, -9101, -7658, -6232, -4732, -3117,
+  -1276, 832, 3203, 5749, 8336, 10733, 12776, 14293, 15174, 15378,
+  14924, 13865, 12338, 10489, 8416, 6251, 4053, 1889, -238, -2317,
+  -4379, -6393, -8352, -10165, -11752, -13020, -13875, -14280, -14201, -13682,
+  -12761, -11528, -10048, -8360, -6525, -4594, -2586, -534, 1535, 3619,
+  5687, 7708, 9654, 11439, 12966, 14160, 14909, 15120, 14751, 13812,
+  12350, 10464, 8252, 5835, 3317, 817
+};
+
+static const q15_t biquad_coeffs[10] = {
+  329, 658, 329, -25575, 10507, 329, 658, 329, -25575, 10507
+};
+
+static const q15_t biquad_out[256] = {
+  -1, -4, 0, 44, 174, 416, 769, 1243, 1878, 2712,
+  3736, 4893, 6111, 7340, 8555, 9720, 10767, 11621, 12231, 12572,
+  12620, 12328, 11634, 10501, 8948, 7036, 4837, 2424, -115, -2669,
+  -5117, -7357, -9329, -11006, -12354, -13320, -13866, -13997, -13740, -13105,
+  -12076, -10644, -8842, -6751, -4474, -2097, 316, 2690, 4931, 6956,
+  8732, 10263, 11544, 12534, 13186, 13482, 13434, 13053, 12324, 11217,
+  9730, 7917, 5869, 3664, 1352, -1012, -3338, -5525, -7510, -9276,
+  -10806, -12056, -12965, -13489, -13616, -13357, -12725, -11727, -10383, -8744,
+  -6879, -4847, -2683, -415, 1899, 4159, 6265, 8163, 9842, 11292,
+  12471, 13324, 13824, 13983, 13816, 13304, 12405, 11099, 9427, 7475,
+  5326, 3038, 662, -1737, -4083, -6305, -8358, -10214, -11833, -13149,
+  -14092, -14618, -14715, -14377, -13585, -12328, -10643, -8617, -6343, -3889,
+  -1311, 1316, 3882, 6276, 8430, 10313, 11891, 13103, 13882, 14195,
+  14062, 13533, 12644, 11406, 9836, 7998, 5993, 3908, 1788, -342,
+  -2442, -4444, -6283, -7926, -9362, -10568, -11503, -12135, -12461, -12494,
+  -12235, -11668, -10771, -9544, -8028, -6288, -4373, -2308, -129, 2086,
+  4230, 6219, 8014, 9596, 10924, 11931, 12557, 12779, 12605, 12046,
+  11110, 9822, 8239, 6441, 4492, 2425, 262, -1951, -4133, -6194,
+  -8062, -9684, -11004, -11958, -12502, -12639, -12415, -11886, -11087, -10034,
+  -8746, -7256, -5597, -3779, -1795, 340, 2562, 4771, 6868, 8780,
+  10449, 11807, 12774, 13286, 13325, 12919, 12113, 10944, 9448, 7684,
+  5732, 3666, 1530, -655, -2852, -4986, -6973, -8755, -10296, -11557,
+  -12485, -13035, -13201, -13016, -12514, -11700, -10564, -9125, -7450, -5625,
+  -3708, -1714, 356, 2467, 4547, 6527, 8364, 10021, 11438, 12535,
+  13245, 13538, 13416, 12886, 11951, 10626, 8963, 7051, 4980, 2813,
+  598, -1600, -3688, -5576, -7219, -8619
+};
+
+static const q15_t cic_out[32] = {
+  1010, 8368, 10174, -4709, -11736, 573, 11331, 4921, -9570, -8752,
+  5595, 11947, 323, -12179, -5181, 10375, 8203, -5500, -10526, 95,
+  10822, 3546, -9508, -7390, 6115, 10308, -2797, -11448, -2976, 9917,
+  7590, -6385
+};
+
+static const q15_t mavg_out[256] = {
+  -324, 586, 1776, 2596, 2383, 3321, 5833, 8352, 9835, 10161,
+  9958, 11179, 13966, 15163, 12965, 11352, 11492, 11297, 11188, 8613,
+  4416, 843, -365, -2076, -5457, -8692, -11688, -12673, -12380, -12291,
+  -13271, -15097, -14410, -11971, -10472, -10006, -9818, -7959, -4595, -453,
+  2164, 2843, 4048, 7048, 10906, 11832, 11435, 10748, 11687, 13683,
+  14701, 12868, 10980, 9972, 10510, 9832, 7041, 2280, -559, -1554,
+  -2536, -4608, -9095, -11400, -11863, -10516, -11445, -13487, -15007, -14277,
+  -11845, -10219, -9946, -10003, -7745, -3859, -980, 252, 1525, 3290,
+  6304, 9462, 11362, 10998, 10861, 12575, 14729, 15197, 14121, 11477,
+  10650, 11776, 11418, 8906, 4441, 1022, -395, -553, -3225, -7335,
+  -9992, -11323, -11497, -11430, -13215, -15866, -15997, -14360, -13054, -11853,
+  -11346, -9835, -6740, -1949, 511, 1394, 3483, 6306, 10117, 12241,
+  12559, 11254, 12828, 15530, 15459, 13728, 11343, 9337, 9214, 9390,
+  6633, 2462, -722, -1558, -1773, -2794, -6331, -9199, -10662, -10188,
+  -9192, -11295, -13393, -13723, -11735, -10391, -10006, -10193, -9343, -6555,
+  -3713, -824, -400, 868, 3904, 7404, 9805, 10535, 10460, 10221,
+  12784, 14487, 13860, 11607, 9502, 8910, 9303, 7312, 3877, 502,
+  -992, -1672, -2999, -6070, -9470, -10667, -11072, -11124, -12416, -13947,
+  -13935, -11460, -9649, -8070, -8480, -7592, -5578, -2674, -1031, -141,
+  786, 3088, 7634, 10026, 11573, 11600, 12753, 13813, 15563, 14410,
+  11659, 9463, 8100, 7639, 6214, 3046, -426, -1983, -2868, -3945,
+  -5992, -9474, -11966, -11355, -11357, -12679, -14069, -14126, -13087, -10012,
+  -8951, -9180, -8920, -5562, -2221, -112, 730, 851, 3231, 6538,
+  10341, 10795, 10134, 11128, 13387, 15439, 15045, 13282, 10625, 9821,
+  9871, 7824, 4307, 867, -1058, -1835, -2910, -5842, -8704, -10127,
+  -9619, -9191, -9611, -11996, -12780, -11715
+};
+
+static const q15_t level_out[16] = {
+  7915, 21054, 9688, 21415, 10563, 13775, 11427, 17520, 11257, 16083,
+  10860, 15732, 11138, 11164, 11322, 18127
+};
+
+static const q15_t fft_in[512] = {
+  -861, 0, 8731, 0, 10702, 0, 5463, 0, 2331, 0,
+  9983, 0, 17840, 0, 19233, 0, 12499, 0, 9357, 0,
+  9227, 0, 18049, 0, 19840, 0, 14558, 0, 5742, 0,
+  3871, 0, 5758, 0, 9570, 0, 4506, 0, -5222, 0,
+  -9876, 0, -8497, 0, -3224, 0, -4785, 0, -13458, 0,
+  -19282, 0, -16838, 0, -9610, 0, -7065, 0, -11664, 0,
+  -20515, 0, -17922, 0, -10314, 0, -3778, 0, -4896, 0,
+  -9238, 0, -9865, 0, -322, 0, 8795, 0, 8378, 0,
+  5024, 0, 3569, 0, 7336, 0, 16787, 0, 21182, 0,
+  13695, 0, 8115, 0, 10308, 0, 15358, 0, 19980, 0,
+  15203, 0, 6421, 0, 716, 0, 7037, 0, 9517, 0,
+  6956, 0, -4501, 0, -11329, 0, -6860, 0, -3679, 0,
+  -5585, 0, -12161, 0, -20534, 0, -16996, 0, -11819, 0,
+  -9024, 0, -12617, 0, -18806, 0, -18150, 0, -11456, 0,
+  -1943, 0, -3472, 0, -8650, 0, -9643, 0, -2313, 0,
+  8212, 0, 9950, 0, 7200, 0, 4220, 0, 7090, 0,
+  15105, 0, 20869, 0, 16526, 0, 8569, 0, 8322, 0,
+  15461, 0, 19541, 0, 16203, 0, 7834, 0, 2349, 0,
+  3851, 0, 7913, 0, 6596, 0, -4729, 0, -10368, 0,
+  -7710, 0, -2597, 0, -2611, 0, -12660, 0, -19262, 0,
+  -18627, 0, -12944, 0, -7123, 0, -10732, 0, -18593, 0,
+  -19246, 0, -9626, 0, -2518, 0, -1999, 0, -7421, 0,
+  -8775, 0, -3862, 0, 7566, 0, 11177, 0, 6274, 0,
+  3975, 0, 5600, 0, 16569, 0, 19845, 0, 14797, 0,
+  9626, 0, 9525, 0, 15082, 0, 20727, 0, 15255, 0,
+  5687, 0, 1238, 0, 3195, 0, 7516, 0, 5363, 0,
+  -955, 0, -8797, 0, -8439, 0, -3042, 0, -5125, 0,
+  -9431, 0, -18119, 0, -18194, 0, -11630, 0, -9846, 0,
+  -10513, 0, -18247, 0, -19368, 0, -12214, 0, -4782, 0,
+  -1739, 0, -6763, 0, -10074, 0, -3309, 0, 6467, 0,
+  11403, 0, 8294, 0, 3778, 0, 5498, 0, 15749, 0,
+  21457, 0, 16436, 0, 11563, 0, 7344, 0, 12777, 0,
+  18669, 0, 15326, 0, 9081, 0, 2632, 0, 3696, 0,
+  9631, 0, 7355, 0, -536, 0, -11109, 0, -11333, 0,
+  -4458, 0, -3403, 0, -8337, 0, -17620, 0, -20247, 0,
+  -14141, 0, -7805, 0, -9415, 0, -15958, 0, -18069, 0,
+  -10973, 0, -3476, 0, -3148, 0, -5800, 0, -7569, 0,
+  -3980, 0, 7250, 0, 11942, 0, 8227, 0, 4791, 0,
+  5045, 0, 14384, 0, 20295, 0, 17291, 0, 11078, 0,
+  7483, 0, 14286, 0, 18858, 0, 17729, 0, 7938, 0,
+  1332, 0, 3547, 0, 8461, 0, 6543, 0, -1552, 0,
+  -9474, 0, -9647, 0, -7590, 0, -4060, 0, -7863, 0,
+  -19158, 0, -21183, 0, -15038, 0, -7640, 0, -10442, 0,
+  -15145, 0, -18995, 0, -14167, 0, -3787, 0, -424, 0,
+  -4793, 0, -8134, 0, -4864, 0, 4631, 0, 11853, 0,
+  8845, 0, 4432, 0, 6146, 0, 14285, 0, 19792, 0,
+  19175, 0, 12370, 0, 8844, 0, 13199, 0, 19341, 0,
+  17382, 0, 7984, 0, 737, 0, 1388, 0, 6085, 0,
+  7628, 0, -898, 0, -9613, 0, -12413, 0, -6936, 0,
+  -5014, 0, -8341, 0, -17809, 0, -20667, 0, -16593, 0,
+  -10139, 0, -10011, 0, -14879, 0, -18462, 0, -12977, 0,
+  -4197, 0
+};
+
+static const q15_t fft_out[512] = {
+  100, 0, 38, 72, 54, 40, 120, 44, 77, 146,
+  93, 210, 218, 476, -1761, -7112, -64, -610, 17, -272,
+  79, -256, 22, -159, 14, -183, 43, -102, -38, -120,
+  22, -37, -47, -96, 76, -74, 28, -78, 148, -111,
+  90, -96, 71, -98, 23, -119, 44, -6, -14, -93,
+  20, -66, 21, -11, 73, -83, -33, -45, 50, -37,
+  38, -156, 3, 15, -14, -88, 70, -52, -3, -8,
+  80, -6, 98, -92, 92, 45, 31, -113, 21, -57,
+  73, -49, 99, -148, 48, -122, 185, -115, 124, -114,
+  163, -179, 291, -222, 541, -388, 2282, -1699, -969, 687,
+  -409, 294, -257, 107, -205, 209, -120, 28, -133, 48,
+  -102, 49, -52, 65, -51, -18, -101, 45, -129, -23,
+  -60, 4, -17, 83, -59, 9, -72, 1, -77, 18,
+  -11, 39, -35, 28, -62, 4, -101, 29, -39, 41,
+  12, -63, -22, 22, -25, 96, -82, -43, -89, 53,
+  16, 31, -26, -4, -27, -1, -82, 33, -80, 21,
+  -17, -9, 57, 44, 21, 36, -12, 8, -74, 41,
+  -40, -15, -84, 64, 32, 42, 56, 3, 38, 33,
+  -69, -69, -29, 34, -8, -22, 14, -6, -77, -28,
+  8, -40, -17, 54, -62, -8, 43, -20, -66, 10,
+  -19, 52, -19, -55, 31, 41, -21, -66, -17, 90,
+  -79, 25, 75, -73, -21, -16, -33, 16, -7, 39,
+  -1, -17, -20, 13, -24, -12, -21, 67, 33, -2,
+  -21, 43, 25, 9, -26, -55, -12, -71, -5, -20,
+  -13, 25, -6, -38, -45, -31, -22, -63, -13, -25,
+  6, -16, -12, -49, -28, -44, -43, 0, -28, 44,
+  -13, 50, 6, 16, -13, 26, -21, 63, -45, 31,
+  -7, 38, -12, -25, -6, 20, -12, 71, -26, 56,
+  24, -8, -21, -43, 33, 3, -21, -66, -24, 12,
+  -19, -12, -1, 18, -7, -39, -34, -15, -21, 17,
+  75, 73, -80, -24, -18, -89, -22, 67, 30, -40,
+  -20, 55, -20, -51, -67, -10, 43, 21, -62, 8,
+  -17, -53, 9, 40, -77, 29, 14, 7, -8, 23,
+  -29, -34, -69, 69, 37, -32, 56, -2, 32, -41,
+  -85, -63, -41, 16, -74, -41, -12, -7, 20, -36,
+  56, -43, -17, 9, -80, -20, -82, -33, -27, 2,
+  -26, 6, 15, -30, -89, -52, -82, 44, -25, -95,
+  -22, -21, 12, 64, -39, -40, -100, -28, -62, -4,
+  -35, -28, -11, -38, -77, -17, -72, -1, -60, -9,
+  -18, -82, -61, -3, -129, 23, -102, -44, -53, 18,
+  -53, -65, -103, -48, -134, -47, -121, -28, -205, -208,
+  -258, -106, -409, -294, -970, -687, 2281, 1700, 542, 388,
+  290, 222, 162, 179, 123, 115, 184, 115, 48, 123,
+  97, 150, 72, 51, 21, 58, 31, 115, 91, -45,
+  97, 94, 79, 7, -3, 9, 69, 53, -14, 89,
+  2, -15, 38, 157, 50, 38, -34, 46, 72, 83,
+  21, 11, 19, 68, -15, 94, 44, 7, 22, 120,
+  71, 99, 89, 97, 148, 112, 28, 79, 75, 76,
+  -48, 97, 22, 38, -38, 121, 41, 103, 14, 184,
+  21, 160, 78, 258, 16, 274, -65, 611, -1762, 7114,
+  217, -474, 92, -208, 77, -143, 119, -41, 52, -37,
+  37, -69
+};
+
+static const q15_t fft_mag[256] = {
+  100, 81, 67, 127, 165, 229, 523, 7326, 613, 272,
+  267, 160, 183, 110, 125, 43, 106, 106, 82, 185,
+  131, 121, 121, 44, 94, 68, 23, 110, 55, 62,
+  160, 15, 89, 87, 8, 80, 134, 102, 117, 60,
+  87, 178, 131, 217, 168, 242, 366, 665, 2845, 1187,
+  503, 278, 292, 123, 141, 113, 83, 54, 110, 131,
+  60, 84, 59, 72, 79, 40, 44, 62, 105, 56,
+  64, 31, 99, 92, 103, 34, 26, 27, 88, 82,
+  19, 72, 41, 14, 84, 42, 105, 52, 56, 50,
+  97, 44, 23, 15, 81, 40, 56, 62, 47, 66,
+  55, 58, 51, 69, 91, 82, 104, 26, 36, 39,
+  17, 23, 26, 70, 33, 47, 26, 60, 72, 20,
+  28, 38, 54, 66, 28, 17, 50, 52, 43, 52,
+  51, 17, 29, 66, 54, 38, 27, 20, 72, 61,
+  25, 47, 33, 69, 26, 22, 18, 39, 37, 27,
+  104, 83, 90, 70, 50, 58, 54, 67, 47, 62,
+  55, 41, 82, 15, 24, 44, 97, 48, 56, 52,
+  105, 44, 84, 13, 41, 70, 19, 82, 88, 27,
+  26, 33, 103, 93, 98, 30, 65, 55, 103, 62,
+  44, 39, 78, 72, 60, 83, 61, 131, 111, 55,
+  83, 113, 142, 124, 292, 278, 503, 1188, 2844, 666,
+  365, 241, 168, 216, 132, 178, 88, 61, 119, 101,
+  135, 79, 9, 87, 90, 15, 161, 62, 57, 109,
+  23, 70, 95, 44, 122, 121, 131, 185, 83, 106,
+  108, 43, 126, 110, 184, 161, 269, 274, 614, 7328,
+  521, 227, 162, 125, 63, 78
+};
+
+static const q31_t signal_q31_in[256] = {
+  -168797798, 710837634, 455577632, 525529570, 317198100, 485906141,
+  1139079396, 1104553987, 630190844, 796371565, 398136576, 902130406,
+  1289485666, 995291519, 108621136, 387419189, 431770573, 585439868,
+  585412751, -571871971, -358871300, -591808446, -30176064, -237381604,
+  -788895380, -1299617898, -854582863, -752361119, -543696217, -1049003323,
+  -1400879737, -980020236, -825938042, -241058252, 55116102, -750683527,
+  -324816355, -191028596, 519358711, 524971078, 595645649, 200869055,
+  460560674, 1166759893, 1047070535, 751060773, 307264740, 410796221,
+  1256248210, 1155737153, 692343917, 342752426, -80539734, 306173119,
+  321003239, 490945319, -419674453, -798512880, -504080321, -87837903,
+  -346870771, -710505887, -1498118588, -1376838434, -1024832418, -494973843,
+  -549985667, -941575846, -1462253949, -683002986, -415570005, -241806811,
+  -810261263, -506582943, 88627663, 675049144, 541209010, 438395631,
+  466282936, 201311263, 1181765173, 1570887976, 725729715, 646169608,
+  919119663, 914210907, 1602276642, 855590805, 217309404, 434770966,
+  157316939, 373160950, 560142158, -134243123, -625965790, -396518780,
+  -466251230, -522476309, -538989737, -1320812766, -1339347198, -904697795,
+  -443124405, -910627886, -1435533133, -1193326088, -670040952, -405345257,
+  -405205008, -618545536, -488177034, -200934964, 523929693, 535174972,
+  251049750, 48102297, 307257574, 1278749797, 1098953044, 1143833348,
+  560053415, 435037834, 773597905, 1555137383, 1126501287, 182337159,
+  -134972019, 81211022, 597457745, 543271302, -200296520, -747427301,
+  -462925234, -450459518, -420874549, -999846837, -998432801, -987838297,
+  -832000352, -612410323, -803188178, -1258101531, -965996957, -976114719,
+  -132622862, -406875523, -761100331, -402275090, 107186397, 593684302,
+  491444250, 481449997, -79137673, 233134448, 819559287, 1204250368,
+  1356893273, 680083252, 252298137, 660278621, 1554833771, 1178693593,
+  433969174, -160183595, 283964657, 654457692, 413836253, -49663418,
+  -708258411, -516231403, -100233959, -121457314, -795908298, -1423727285,
+  -1577587096, -925830480, -237776271, -1000696257, -864822230, -1058523174,
+  -1139671875, -268914969, 72580688, -513328039, -444464256, -461406041,
+  487677358, 616117960, 698595585, 506588878, 225666632, 929740046,
+  1152722810, 1036563125, 619284941, 284611793, 1173028022, 1502140436,
+  1359416320, 522124036, -28757068, -15904560, 384571981, 378382728,
+  55762953, -496241447, -927940295, -383784712, -274807645, -714516751,
+  -1370101800, -1454866774, -976726724, -350844401, -872888514, -1236634183,
+  -1367302469, -790563244, -2439028, 141749210, -593011379, -414653906,
+  -276059589, 350560837, 1002868468, 621709087, 532558906, 285943204,
+  776406506, 1307853861, 1239830624, 961082437, 385842760, 906939794,
+  1457762569, 1109388038, 273235029, 144526303, 471455079, 609800365,
+  651613442, -246067766, -809534467, -609962888, -452694181, -250798409,
+  -568276454, -820442102, -1611463915, -1014420741, -707533026, -432987291,
+  -1028568101, -1549465702, -1172329524, -502149661
+};
+
+static const q31_t block_rms_q31 = 775436686;
+
+static const q31_t fir_q31_coeffs[31] = {
+  3455284, 2999493, 1560767, -2369641, -9843541, -20083835,
+  -29579878, -32274573, -21067552, 9706712, 61662062, 130640452,
+  206711566, 276143914, 324874787, 342411617, 324874787, 276143914,
+  206711566, 130640452, 61662062, 9706712, -21067552, -32274573,
+  -29579878, -20083835, -9843541, -2369641, 1560767, 2999493,
+  3455284
+};
+
+static const q31_t fir_q31_out[256] = {
+  -271594, 907964, 1603201, 2184789, 1564864, -575558,
+  -4249045, -10552575, -18822845, -25308533, -27143963, -18239441,
+  5874154, 47930438, 108775800, 189128585, 284329603, 388257157,
+  493490535, 591239999, 677958676, 748643532, 802347098, 837194085,
+  852911973, 849632261, 828171335, 786629485, 724083146, 639097152,
+  532925253, 409475079, 270198432, 122659184, -28441830, -178916947,
+  -323114105, -459896707, -585580202, -698612525, -796835095, -875871168,
+  -931482826, -958428503, -953356821, -913332079, -840786663, -737577052,
+  -608124143, -460231586, -298907222, -132520818, 33112282, 191522416,
+  337569425, 467925252, 578382414, 667107138, 735236780, 782745892,
+  810181220, 817621864, 802755715, 766276935, 706458511, 624062217,
+  522430983, 403419873, 272238145, 134072050, -8049309, -152373159,
+  -297348896, -440054141, -577207959, -702349491, -810048262, -893882680,
+  -950534317, -980876838, -982955455, -959601833, -914585162, -846749170,
+  -756452585, -643143330, -506442282, -349113611, -176425807, 4508683,
+  183556333, 354071737, 509949006, 647331153, 764036206, 860125128,
+  933187364, 981700161, 1003473160, 995224807, 954955849, 884899590,
+  788270638, 669994534, 534551346, 387802799, 233726386, 75626580,
+  -84561859, -244586511, -399953953, -548620499, -684564093, -802002974,
+  -897858785, -968976052, -1012231023, -1027152192, -1013220922, -970123017,
+  -900848421, -805578935, -687710192, -550927271, -400426570, -241863834,
+  -80054286, 81638990, 239447255, 388986447, 527710221, 651658960,
+  757225760, 838792194, 893227507, 916457807, 906985454, 865133717,
+  794313729, 699423208, 585367013, 456149429, 316632641, 168301042,
+  16272766, -137481634, -288733145, -432157654, -564169343, -678969005,
+  -774831646, -848618200, -901441403, -933209750, -945011018, -934577724,
+  -898838207, -836864682, -747372556, -631182141, -491761350, -337408032,
+  -177058799, -19577821, 130929424, 270609844, 398741805, 515050571,
+  620037848, 713903468, 793689201, 854740236, 891620387, 899069646,
+  875877313, 821885842, 742031729, 639759531, 521775953, 392151989,
+  253622867, 109382529, -41329892, -197588423, -356413422, -513312519,
+  -659539121, -787986725, -888973752, -956668888, -989484831, -987757781,
+  -954299473, -893949303, -811681163, -712215219, -595511215, -462728513,
+  -315331854, -156474144, 7956535, 170964748, 325699287, 466344981,
+  589602506, 694651174, 781852500, 853469572, 910238626, 946810355,
+  958602736, 940825337, 888219854, 800459165, 680364182, 534266953,
+  371639923, 200472840, 29101105, -138842828, -301403907, -455069234,
+  -600001133, -732008461, -845997984, -936994786, -998354691, -1028188730,
+  -1023232759, -984137299, -913592824, -815881393, -696483701, -558936624,
+  -407482192, -247625786, -83846422, 80789589, 241034105, 393030826,
+  534022902, 660167953, 768738412, 857410433, 923165593, 966158792,
+  984671846, 978580585, 945818161, 887824191, 804851259, 699424934,
+  571342860, 424714258, 264626293, 96381975
+};
+
+static const q31_t biquad_q31_coeffs[10] = {
+  21563766, 43127531, 21563766, -1676085001, 688598239, 21563766,
+  43127531, 21563766, -1676085001, 688598239
+};
+
+static const q31_t biquad_q31_out[256] = {
+  -68079, -198163, 556594, 4733158, 15494742, 34966976,
+  63826200, 102469579, 151859118, 212437567, 282535320, 358245092,
+  434951224, 509420602, 580129328, 645143955, 700686028, 742479173,
+  767914353, 776434818, 767752119, 740202476, 691584398, 621512929,
+  532501968, 428433789, 312209237, 185575500, 51030002, -87034611,
+  -223500712, -354582282, -478189276, -592266836, -693029253, -774900771,
+  -832705511, -863985146, -868771785, -847605134, -800429138, -727422789,
+  -630678826, -514566536, -384008545, -242940079, -95128850, 54001578,
+  197481618, 329422522, 447168457, 550249051, 637609805, 706280001,
+  752557129, 774347301, 772211806, 747881344, 702043510, 634519612,
+  546662711, 442514771, 327052035, 203454450, 72380864, -65813198,
+  -208160711, -348524581, -480059694, -598167101, -700711123, -785809407,
+  -850718186, -893217846, -912948603, -910352178, -884663853, -833902997,
+  -756950847, -655429333, -533808647, -397407094, -250052909, -94564958,
+  64846226, 222183141, 371654662, 509539539, 633838353, 741975367,
+  829631103, 892087014, 926285873, 931971447, 910891572, 864726714,
+  794429201, 701466608, 588843908, 460737030, 321027478, 172275813,
+  16903264, -140683083, -294305505, -438661420, -570815904, -688757689,
+  -789415199, -868730807, -923415006, -952247109, -955549930, -933498128,
+  -885431153, -811367275, -714008010, -598487964, -469747697, -330595380,
+  -182668683, -28929915, 125032698, 272475902, 408596066, 531516037,
+  639588433, 728618669, 792829427, 828428246, 835634930, 817043637,
+  774617670, 709018080, 621364358, 514482125, 392190735, 258069291,
+  115400992, -31920935, -178793482, -319577822, -449784959, -566992821,
+  -669879581, -756437662, -823562298, -868711892, -891173646, -890963795,
+  -867143731, -817986653, -742954834, -644703863, -529083284, -402587458,
+  -269465108, -131278927, 10686378, 152686565, 288868693, 414603239,
+  528302977, 629138225, 713963136, 777755119, 816864711, 830861832,
+  821116097, 788352454, 732291154, 653735908, 556152466, 444257823,
+  321071651, 186987436, 42322161, -109358976, -261164606, -405778330,
+  -537808668, -654033903, -751841519, -827573479, -877349345, -899514858,
+  -895269954, -866672636, -814550145, -738681397, -639803675, -521142171,
+  -387706715, -244211462, -94391054, 57551949, 205818275, 344563084,
+  470784009, 584696506, 686655238, 773936496, 840810293, 881698922,
+  894073143, 878516046, 836591606, 769188988, 677309120, 564008724,
+  434302831, 292765874, 142054233, -15554256, -175540119, -331092157,
+  -475958132, -606624531, -721267007, -816891077, -888349808, -930839517,
+  -942902929, -926495226, -884484159, -818319195, -728199250, -615430873,
+  -484127794, -340289718, -189288589, -34578834, 120994839, 273161644,
+  416439867, 546618828, 661858839, 760597338, 839516001, 894630563,
+  923954847, 928430924, 910010403, 869020927, 804056318, 714516300,
+  602779547, 473964648, 333731363, 186063657, 33304499, -121501787,
+  -273034520, -415229905, -544246523, -659120781
+};
+
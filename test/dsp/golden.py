@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+#
+# Golden vectors for the fixed point DSP blocks.
+#
+# Bit exact Python models of the os/various/dsp blocks are run on
+# pseudo-random inputs and the results are written to golden.h, run again
+# after changing the library arithmetic and commit the new header.
+#
+#   python3 golden.py > golden.h
+
+import math
+
+def sat16(x):
+    return max(-32768, min(32767, x))
+
+def q15(x):
+    return sat16(int(math.floor(x * 32768.0 + 0.5)))
+
+def q14(x):
+    return sat16(int(math.floor(x * 16384.0 + 0.5)))
+
+def sat32(x):
+    return max(-(1 << 31), min((1 << 31) - 1, x))
+
+def q31(x):
+    return sat32(int(math.floor(x * 2147483648.0 + 0.5)))
+
+def q30(x):
+    return sat32(int(math.floor(x * 1073741824.0 + 0.5)))
+
+def s32(x):
+    x &= 0xffffffff
+    return x - (1 << 32) if x & 0x80000000 else x
+
+class Rand:
+    def __init__(self, seed):
+        self.s = seed
+    def next(self):
+        self.s = (self.s * 1664525 + 1013904223) & 0xffffffff
+        return self.s >> 16
+
+def signal(n, seed, noise, quant=q15):
+    r = Rand(seed)
+    out = []
+    for i in range(n):
+        v = 0.45 * math.sin(2 * math.pi * i / 37.0) + \
+            0.2 * math.sin(2 * math.pi * i / 5.3)
+        v += noise * ((r.next() / 65536.0) - 0.5)
+        out.append(quant(v))
+    return out
+
+# Models.
+
+def from_adc(src, offset, shift):
+    return [sat16((x - offset) << shift) for x in src]
+
+def isqrt(x):
+    return math.isqrt(x)
+
+def rms(x):
+    return sat16(isqrt(sum(v * v for v in x) // len(x)))
+
+def rms31(x):
+    return sat32(isqrt((sum((v * v) >> 31 for v in x) // len(x)) << 31))
+
+def peak(x):
+    return sat16(max(abs(v) for v in x))
+
+def fir(h, x, bits=15):
+    sat = sat16 if bits == 15 else sat32
+    n = len(h)
+    state = [0] * n
+    pos = 0
+    out = []
+    for v in x:
+        pos = n - 1 if pos == 0 else pos - 1
+        state[pos] = v
+        acc = 1 << (bits - 1)
+        for k in range(n):
+            acc += h[k] * state[(pos + k) % n]
+        out.append(sat(acc >> bits))
+    return out
+
+def biquad(c, x, bits=15):
+    sat = sat16 if bits == 15 else sat32
+    for s in range(len(c) // 5):
+        b0, b1, b2, a1, a2 = c[5 * s:5 * s + 5]
+        x1 = x2 = y1 = y2 = 0
+        y = []
+        for v in x:
+            acc = b0 * v + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2
+            o = sat((acc + (1 << (bits - 2))) >> (bits - 1))
+            x2, x1, y2, y1 = x1, v, y1, o
+            y.append(o)
+        x = y
+    return x
+
+def cic(order, ratio, shift, x):
+    integ = [0] * order
+    comb = [0] * order
+    phase = 0
+    out = []
+    for v in x:
+        v &= 0xffffffff
+        for i in range(order):
+            v = (v + integ[i]) & 0xffffffff
+            integ[i] = v
+        phase += 1
+        if phase >= ratio:
+            phase = 0
+            for i in range(order):
+                t = v
+                v = (v - comb[i]) & 0xffffffff
+                comb[i] = t
+            out.append(sat16(s32(v) >> shift))
+    return out
+
+def mavg(k, x):
+    hist = [0] * (1 << k)
+    s = 0
+    pos = 0
+    out = []
+    for v in x:
+        s += v - hist[pos]
+        hist[pos] = v
+        pos = (pos + 1) & ((1 << k) - 1)
+        out.append((s + ((1 << k) >> 1)) >> k)
+    return out
+
+def level(rshift, pshift, x, block):
+    ms = 0
+    pk = 0
+    out = []
+    for i, v in enumerate(x):
+        a = abs(v)
+        ms = ms + ((a * a - ms) >> rshift)
+        pk -= pk >> pshift
+        if a > pk:
+            pk = a
+        if (i + 1) % block == 0:
+            out += [sat16(isqrt(ms)), sat16(pk)]
+    return out
+
+SINE = [min(32767, int(math.floor(math.sin(2 * math.pi * k / 1024) * 32768 + 0.5)))
+        for k in range(257)]
+
+def fft(buf):
+    n = len(buf) // 2
+    j = 0
+    for i in range(n - 1):
+        if i < j:
+            buf[2 * i], buf[2 * j] = buf[2 * j], buf[2 * i]
+            buf[2 * i + 1], buf[2 * j + 1] = buf[2 * j + 1], buf[2 * i + 1]
+        m = n >> 1
+        while j >= m:
+            j -= m
+            m >>= 1
+        j += m
+    length = 2
+    while length <= n:
+        half = length >> 1
+        stride = 1024 // length
+        for j in range(half):
+            k = j * stride
+            if k <= 256:
+                wr, wi = SINE[256 - k], -SINE[k]
+            else:
+                wr, wi = -SINE[k - 256], -SINE[512 - k]
+            for i in range(j, n, length):
+                a, b = 2 * i, 2 * (i + half)
+                tr = (buf[b] * wr - buf[b + 1] * wi + 0x4000) >> 15
+                ti = (buf[b] * wi + buf[b + 1] * wr + 0x4000) >> 15
+                ar, ai = buf[a], buf[a + 1]
+                buf[b] = sat16((ar - tr + 1) >> 1)
+                buf[b + 1] = sat16((ai - ti + 1) >> 1)
+                buf[a] = sat16((ar + tr + 1) >> 1)
+                buf[a + 1] = sat16((ai + ti + 1) >> 1)
+        length <<= 1
+    return buf
+
+def magnitude(buf):
+    return [sat16(isqrt(buf[2 * i] ** 2 + buf[2 * i + 1] ** 2))
+            for i in range(len(buf) // 2)]
+
+# Test configurations, keep in sync with main.c.
+
+def fir_lowpass(ntaps, fc, quant=q15):
+    h = []
+    for i in range(ntaps):
+        m = i - (ntaps - 1) / 2.0
+        s = 2 * fc if m == 0 else math.sin(2 * math.pi * fc * m) / (math.pi * m)
+        w = 0.54 - 0.46 * math.cos(2 * math.pi * i / (ntaps - 1))
+        h.append(s * w)
+    g = sum(h)
+    return [quant(v / g) for v in h]
+
+def biquad_lowpass(fc, q, quant=q14):
+    w0 = 2 * math.pi * fc
+    alpha = math.sin(w0) / (2 * q)
+    cw = math.cos(w0)
+    a0 = 1 + alpha
+    b = [(1 - cw) / 2 / a0, (1 - cw) / a0, (1 - cw) / 2 / a0]
+    a = [-2 * cw / a0, (1 - alpha) / a0]
+    return [quant(v) for v in b + a]
+
+N = 256
+
+def emit(name, ctype, data):
+    step = 6 if ctype == "q31_t" else 10
+    print("static const %s %s[%d] = {" % (ctype, name, len(data)))
+    for i in range(0, len(data), step):
+        line = ", ".join("%d" % v for v in data[i:i + step])
+        print("  " + line + ("," if i + step < len(data) else ""))
+    print("};")
+    print("")
+
+def main():
+    r = Rand(7)
+    adc_in = [r.next() >> 4 for _ in range(64)]
+    x = signal(N, 1, 0.3)
+    fir_h = fir_lowpass(31, 0.08)
+    bq = biquad_lowpass(0.05, 0.707) + biquad_lowpass(0.05, 0.707)
+    fft_in = []
+    for v in signal(N, 3, 0.1):
+        fft_in += [v, 0]
+
+    print("/* Generated by golden.py, do not edit.*/")
+    print("")
+    emit("adc_in", "adcsample_t", adc_in)
+    emit("adc_out", "q15_t", from_adc(adc_in, 2048, 4))
+    emit("signal_in", "q15_t", x)
+    print("static const q15_t block_rms = %d;" % rms(x))
+    print("static const q15_t block_peak = %d;" % peak(x))
+    print("")
+    emit("fir_coeffs", "q15_t", fir_h)
+    emit("fir_out", "q15_t", fir(fir_h, x))
+    emit("biquad_coeffs", "q15_t", bq)
+    emit("biquad_out", "q15_t", biquad(bq, x))
+    emit("cic_out", "q15_t", cic(3, 8, 9, x))
+    emit("mavg_out", "q15_t", mavg(3, x))
+    emit("level_out", "q15_t", level(6, 4, x, 32))
+    emit("fft_in", "q15_t", fft_in)
+    f = fft(list(fft_in))
+    emit("fft_out", "q15_t", f)
+    emit("fft_mag", "q15_t", magnitude(f))
+
+    x31 = signal(N, 5, 0.3, q31)
+    fir_h31 = fir_lowpass(31, 0.08, q31)
+    bq31 = biquad_lowpass(0.05, 0.707, q30) + biquad_lowpass(0.05, 0.707, q30)
+    emit("signal_q31_in", "q31_t", x31)
+    print("static const q31_t block_rms_q31 = %d;" % rms31(x31))
+    print("")
+    emit("fir_q31_coeffs", "q31_t", fir_h31)
+    emit("fir_q31_out", "q31_t", fir(fir_h31, x31, 31))
+    emit("biquad_q31_coeffs", "q31_t", bq31)
+    emit("biquad_q31_out", "q31_t", biquad(bq31, x31, 31))
+
+main()
@@ -0,0 +1,542 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Fixed point DSP blocks tests, golden vectors, accuracy against a double
+ * precision reference and a host benchmark.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "dsp.h"
+
+#include "golden.h"
+
+#define CHECK(c)        check((c), #c, __LINE__)
+
+#define N               256U
+#define ELEMS(a)        (sizeof (a) / sizeof (a)[0])
+
+#ifndef M_PI
+#define M_PI            3.14159265358979323846
+#endif
+
+static unsigned failures;
+
+/* Irregular block sizes, the state must carry across calls.*/
+static const size_t chunks[] = {1, 7, 32, 3, 64, 13, 100, 36};
+
+static void check(bool c, const char *s, int line) {
+
+  if (!c) {
+    printf("  FAILED at line %d: %s\n", line, s);
+    failures++;
+  }
+}
+
+static bool same(const q15_t *a, const q15_t *b, size_t n,
+                 const char *name) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    if (a[i] != b[i]) {
+      printf("  %s differs at %u: %d, expected %d\n",
+             name, (unsigned)i, a[i], b[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool same_q31(const q31_t *a, const q31_t *b, size_t n,
+                     const char *name) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    if (a[i] != b[i]) {
+      printf("  %s differs at %u: %ld, expected %ld\n",
+             name, (unsigned)i, (long)a[i], (long)b[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+static void sine(q15_t *buf, size_t n, double amp, double period) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    buf[i] = (q15_t)lrint(amp * 32767.0 * sin(2.0 * M_PI * i / period));
+  }
+}
+
+static void sine_q31(q31_t *buf, size_t n, double amp, double period) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    buf[i] = (q31_t)lrint(amp * 2147483647.0 * sin(2.0 * M_PI * i / period));
+  }
+}
+
+/*===========================================================================*/
+/* Golden vectors.                                                           */
+/*===========================================================================*/
+
+static void test_convert(void) {
+  static const adcsample_t sat_in[4] = {0, 4095, 2048, 1000};
+  q15_t out[ELEMS(adc_in)];
+
+  printf("ADC conversion\n");
+
+  dspFromADC(out, adc_in, ELEMS(adc_in), 2048, 4);
+  CHECK(same(out, adc_out, ELEMS(adc_in), "adc"));
+
+  /* 12 bits shifted by 5 saturates on both ends.*/
+  dspFromADC(out, sat_in, 4, 2048, 5);
+  CHECK(out[0] == -32768);
+  CHECK(out[1] == 32767);
+  CHECK(out[2] == 0);
+  CHECK(out[3] == -32768);
+}
+
+static void test_sqrt(void) {
+  uint32_t x;
+
+  printf("square root\n");
+
+  CHECK(dspSqrt(0U) == 0U);
+  CHECK(dspSqrt(0xFFFFFFFFU) == 65535U);
+  CHECK(dspSqrt(1U << 30) == 32768U);
+  CHECK(dspSqrt64(0U) == 0U);
+  CHECK(dspSqrt64(0xFFFFFFFFFFFFFFFFULL) == 0xFFFFFFFFU);
+  CHECK(dspSqrt64(1ULL << 62) == 0x80000000U);
+  CHECK(dspSqrt64(0xFFFFFFFE00000001ULL) == 0xFFFFFFFFU);
+  CHECK(dspSqrt64(0xFFFFFFFE00000000ULL) == 0xFFFFFFFEU);
+  for (x = 1U; x < 100000U; x++) {
+    uint32_t r = dspSqrt(x);
+    if ((r * r > x) || ((r + 1U) * (r + 1U) <= x)) {
+      CHECK(false);
+      break;
+    }
+  }
+}
+
+static void test_measure(void) {
+  dsp_level_t level;
+  q15_t out[2U * N / 32U];
+  size_t i;
+
+  printf("RMS, peak and level detector\n");
+
+  CHECK(dspRMS(signal_in, N) == block_rms);
+  CHECK(dspPeak(signal_in, N) == block_peak);
+  CHECK(dspRMSQ31(signal_q31_in, N) == block_rms_q31);
+
+  dspLevelObjectInit(&level, 6U, 4U);
+  for (i = 0U; i < N / 32U; i++) {
+    dspLevelProcess(&level, &signal_in[i * 32U], 32U);
+    out[2U * i] = dspLevelRMS(&level);
+    out[2U * i + 1U] = dspLevelPeak(&level);
+  }
+  CHECK(same(out, level_out, ELEMS(out), "level"));
+}
+
+static void test_mavg(void) {
+  dsp_mavg_t mavg;
+  q15_t history[8];
+  q15_t out[N];
+  size_t i, pos;
+
+  printf("moving average\n");
+
+  dspMavgObjectInit(&mavg, history, 3U);
+  for (i = 0U, pos = 0U; i < ELEMS(chunks); pos += chunks[i++]) {
+    dspMavgProcess(&mavg, &signal_in[pos], &out[pos], chunks[i]);
+  }
+  CHECK(same(out, mavg_out, N, "mavg"));
+
+  /* In place.*/
+  memcpy(out, signal_in, sizeof out);
+  dspMavgObjectInit(&mavg, history, 3U);
+  dspMavgProcess(&mavg, out, out, N);
+  CHECK(same(out, mavg_out, N, "mavg in place"));
+}
+
+static void test_fir(void) {
+  dsp_fir_t fir;
+  q15_t state[ELEMS(fir_coeffs)];
+  q15_t out[N];
+  size_t i, pos;
+
+  printf("FIR, %u taps\n", (unsigned)ELEMS(fir_coeffs));
+
+  dspFirObjectInit(&fir, fir_coeffs, state, ELEMS(fir_coeffs));
+  for (i = 0U, pos = 0U; i < ELEMS(chunks); pos += chunks[i++]) {
+    dspFirProcess(&fir, &signal_in[pos], &out[pos], chunks[i]);
+  }
+  CHECK(same(out, fir_out, N, "fir"));
+
+  memcpy(out, signal_in, sizeof out);
+  dspFirObjectInit(&fir, fir_coeffs, state, ELEMS(fir_coeffs));
+  dspFirProcess(&fir, out, out, N);
+  CHECK(same(out, fir_out, N, "fir in place"));
+}
+
+static void test_biquad(void) {
+  dsp_biquad_t bq;
+  q15_t state[8];
+  q15_t out[N];
+  size_t i, pos;
+
+  printf("biquad, 2 stages\n");
+
+  dspBiquadObjectInit(&bq, biquad_coeffs, state, 2U);
+  for (i = 0U, pos = 0U; i < ELEMS(chunks); pos += chunks[i++]) {
+    dspBiquadProcess(&bq, &signal_in[pos], &out[pos], chunks[i]);
+  }
+  CHECK(same(out, biquad_out, N, "biquad"));
+
+  memcpy(out, signal_in, sizeof out);
+  dspBiquadObjectInit(&bq, biquad_coeffs, state, 2U);
+  dspBiquadProcess(&bq, out, out, N);
+  CHECK(same(out, biquad_out, N, "biquad in place"));
+}
+
+static void test_fir_q31(void) {
+  dsp_fir_q31_t fir;
+  q31_t state[ELEMS(fir_q31_coeffs)];
+  q31_t out[N];
+  size_t i, pos;
+
+  printf("Q31 FIR, %u taps\n", (unsigned)ELEMS(fir_q31_coeffs));
+
+  dspFirQ31ObjectInit(&fir, fir_q31_coeffs, state, ELEMS(fir_q31_coeffs));
+  for (i = 0U, pos = 0U; i < ELEMS(chunks); pos += chunks[i++]) {
+    dspFirQ31Process(&fir, &signal_q31_in[pos], &out[pos], chunks[i]);
+  }
+  CHECK(same_q31(out, fir_q31_out, N, "fir"));
+
+  memcpy(out, signal_q31_in, sizeof out);
+  dspFirQ31ObjectInit(&fir, fir_q31_coeffs, state, ELEMS(fir_q31_coeffs));
+  dspFirQ31Process(&fir, out, out, N);
+  CHECK(same_q31(out, fir_q31_out, N, "fir in place"));
+}
+
+static void test_biquad_q31(void) {
+  dsp_biquad_q31_t bq;
+  q31_t state[8];
+  q31_t out[N];
+  size_t i, pos;
+
+  printf("Q31 biquad, 2 stages\n");
+
+  dspBiquadQ31ObjectInit(&bq, biquad_q31_coeffs, state, 2U);
+  for (i = 0U, pos = 0U; i < ELEMS(chunks); pos += chunks[i++]) {
+    dspBiquadQ31Process(&bq, &signal_q31_in[pos], &out[pos], chunks[i]);
+  }
+  CHECK(same_q31(out, biquad_q31_out, N, "biquad"));
+
+  memcpy(out, signal_q31_in, sizeof out);
+  dspBiquadQ31ObjectInit(&bq, biquad_q31_coeffs, state, 2U);
+  dspBiquadQ31Process(&bq, out, out, N);
+  CHECK(same_q31(out, biquad_q31_out, N, "biquad in place"));
+}
+
+static void test_cic(void) {
+  dsp_cic_t cic;
+  q15_t out[N];
+  size_t i, pos, nout;
+
+  printf("CIC, order 3, ratio 8\n");
+
+  dspCicObjectInit(&cic, 3U, 8U, 9U);
+  nout = 0U;
+  for (i = 0U, pos = 0U; i < ELEMS(chunks); pos += chunks[i++]) {
+    nout += dspCicDecimate(&cic, &signal_in[pos], &out[nout], chunks[i]);
+  }
+  CHECK(nout == ELEMS(cic_out));
+  CHECK(same(out, cic_out, ELEMS(cic_out), "cic"));
+
+  memcpy(out, signal_in, sizeof out);
+  dspCicObjectInit(&cic, 3U, 8U, 9U);
+  CHECK(dspCicDecimate(&cic, out, out, N) == ELEMS(cic_out));
+  CHECK(same(out, cic_out, ELEMS(cic_out), "cic in place"));
+}
+
+static void test_fft(void) {
+  q15_t buf[2U * N];
+  q15_t real[N];
+  size_t i;
+
+  printf("FFT, %u points\n", N);
+
+  memcpy(buf, fft_in, sizeof buf);
+  dspFFT(buf, N);
+  CHECK(same(buf, fft_out, 2U * N, "fft"));
+
+  dspFFTMagnitude(buf, buf, N);
+  CHECK(same(buf, fft_mag, N, "fft magnitude"));
+
+  /* Real input expanded in place.*/
+  for (i = 0U; i < N; i++) {
+    real[i] = fft_in[2U * i];
+  }
+  memcpy(buf, real, sizeof real);
+  dspFFTLoadReal(buf, buf, N);
+  CHECK(same(buf, fft_in, 2U * N, "load real"));
+}
+
+/*===========================================================================*/
+/* Accuracy.                                                                 */
+/*===========================================================================*/
+
+static void test_accuracy(void) {
+  static q15_t in[4096], out[4096], buf[2U * DSP_FFT_MAX_SIZE];
+  dsp_fir_t fir;
+  dsp_biquad_t bq;
+  dsp_cic_t cic;
+  dsp_level_t level;
+  q15_t state[ELEMS(fir_coeffs)];
+  q15_t bqstate[8];
+  double err, maxerr, ref;
+  size_t i, k, n;
+
+  printf("accuracy against double precision\n");
+
+  /* FIR, the result is within one LSB of the exact convolution.*/
+  for (i = 0U; i < 1024U; i++) {
+    in[i] = (q15_t)((rand() & 0xFFFF) - 0x8000) / 2;
+  }
+  dspFirObjectInit(&fir, fir_coeffs, state, ELEMS(fir_coeffs));
+  dspFirProcess(&fir, in, out, 1024U);
+  maxerr = 0.0;
+  for (i = ELEMS(fir_coeffs); i < 1024U; i++) {
+    ref = 0.0;
+    for (k = 0U; k < ELEMS(fir_coeffs); k++) {
+      ref += fir_coeffs[k] * (double)in[i - k] / 32768.0;
+    }
+    err = fabs(out[i] - ref);
+    if (err > maxerr) {
+      maxerr = err;
+    }
+  }
+  printf("  FIR max error %.2f LSB\n", maxerr);
+  CHECK(maxerr <= 1.0);
+
+  /* Biquad cascade and CIC, unity gain at DC.*/
+  for (i = 0U; i < 4096U; i++) {
+    in[i] = 10000;
+  }
+  dspBiquadObjectInit(&bq, biquad_coeffs, bqstate, 2U);
+  dspBiquadProcess(&bq, in, out, 1024U);
+  printf("  biquad DC output %d for 10000\n", out[1023]);
+  CHECK(abs(out[1023] - 10000) <= 10);
+
+  dspCicObjectInit(&cic, 4U, 16U, 16U);
+  n = dspCicDecimate(&cic, in, out, 4096U);
+  CHECK(n == 256U);
+  CHECK(out[n - 1U] == 10000);
+
+  /* Level detector on a sine, RMS is amplitude / sqrt(2), the input
+     stops on a crest of the sine.*/
+  sine(in, 4096U, 0.5, 64.0);
+  dspLevelObjectInit(&level, 8U, 6U);
+  dspLevelProcess(&level, in, 4096U - 47U);
+  ref = 0.5 * 32767.0 / sqrt(2.0);
+  printf("  level RMS %d, expected %.0f, peak %d\n",
+         dspLevelRMS(&level), ref, dspLevelPeak(&level));
+  CHECK(fabs(dspLevelRMS(&level) - ref) < ref * 0.02);
+  CHECK(abs(dspLevelPeak(&level) - 16384) <= 1);
+  CHECK(fabs(dspRMS(in, 4096U) - ref) <= 1.0);
+
+  /* Full size FFT on a sine centered on bin 37, the output is the DFT
+     divided by N so the bin holds half the amplitude.*/
+  sine(in, DSP_FFT_MAX_SIZE, 0.9, DSP_FFT_MAX_SIZE / 37.0);
+  dspFFTLoadReal(buf, in, DSP_FFT_MAX_SIZE);
+  dspFFT(buf, DSP_FFT_MAX_SIZE);
+  dspFFTMagnitude(buf, out, DSP_FFT_MAX_SIZE);
+  ref = 0.45 * 32767.0;
+  maxerr = 0.0;
+  for (i = 0U; i < DSP_FFT_MAX_SIZE; i++) {
+    if ((i != 37U) && (i != DSP_FFT_MAX_SIZE - 37U) && (out[i] > maxerr)) {
+      maxerr = out[i];
+    }
+  }
+  printf("  FFT bin %d, expected %.0f, largest other bin %.0f\n",
+         out[37], ref, maxerr);
+  CHECK(fabs(out[37] - ref) < ref * 0.01);
+  CHECK(abs(out[DSP_FFT_MAX_SIZE - 37U] - out[37]) <= 2);
+  CHECK(maxerr <= 8.0);
+}
+
+static void test_accuracy_q31(void) {
+  static q31_t in[4096], out[4096];
+  dsp_fir_q31_t fir;
+  dsp_biquad_q31_t bq;
+  q31_t state[ELEMS(fir_q31_coeffs)];
+  q31_t bqstate[8];
+  double err, maxerr, ref;
+  size_t i, k;
+
+  printf("Q31 accuracy against double precision\n");
+
+  /* FIR, the result is within one LSB of the exact convolution.*/
+  for (i = 0U; i < 1024U; i++) {
+    in[i] = (q31_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand()) / 2;
+  }
+  dspFirQ31ObjectInit(&fir, fir_q31_coeffs, state, ELEMS(fir_q31_coeffs));
+  dspFirQ31Process(&fir, in, out, 1024U);
+  maxerr = 0.0;
+  for (i = ELEMS(fir_q31_coeffs); i < 1024U; i++) {
+    ref = 0.0;
+    for (k = 0U; k < ELEMS(fir_q31_coeffs); k++) {
+      ref += fir_q31_coeffs[k] * (double)in[i - k] / 2147483648.0;
+    }
+    err = fabs(out[i] - ref);
+    if (err > maxerr) {
+      maxerr = err;
+    }
+  }
+  printf("  FIR max error %.2f LSB\n", maxerr);
+  CHECK(maxerr <= 1.0);
+
+  /* Biquad cascade, unity gain at DC, same input as the Q15 test.*/
+  for (i = 0U; i < 4096U; i++) {
+    in[i] = DSP_Q31(0.30517578125);
+  }
+  dspBiquadQ31ObjectInit(&bq, biquad_q31_coeffs, bqstate, 2U);
+  dspBiquadQ31Process(&bq, in, out, 1024U);
+  printf("  biquad DC output %ld for %ld\n", (long)out[1023], (long)in[0]);
+  CHECK(labs((long)out[1023] - (long)in[0]) <= 64L);
+
+  /* Block RMS on a sine, RMS is amplitude / sqrt(2).*/
+  sine_q31(in, 4096U, 0.5, 64.0);
+  ref = 0.5 * 2147483647.0 / sqrt(2.0);
+  printf("  block RMS %ld, expected %.0f\n", (long)dspRMSQ31(in, 4096U), ref);
+  CHECK(fabs(dspRMSQ31(in, 4096U) - ref) <= 2.0);
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static double now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#define BENCH_BLOCK     256U
+#define BENCH_ROUNDS    4000U
+
+#define BENCH(name, expr) do {                                              \
+  unsigned r_;                                                              \
+  double t_ = now_ns();                                                     \
+  for (r_ = 0U; r_ < BENCH_ROUNDS; r_++) {                                  \
+    expr;                                                                   \
+  }                                                                         \
+  t_ = now_ns() - t_;                                                       \
+  printf("  %-24s %7.2f ns/sample\n", name,                                 \
+         t_ / ((double)BENCH_ROUNDS * BENCH_BLOCK));                        \
+} while (false)
+
+static void bench(void) {
+  static adcsample_t adc[BENCH_BLOCK];
+  static q15_t in[BENCH_BLOCK], out[BENCH_BLOCK], buf[2U * BENCH_BLOCK];
+  static q15_t history[16], state[ELEMS(fir_coeffs)], bqstate[8];
+  static q31_t in31[BENCH_BLOCK], out31[BENCH_BLOCK];
+  static q31_t state31[ELEMS(fir_q31_coeffs)], bqstate31[8];
+  dsp_fir_t fir;
+  dsp_biquad_t bq;
+  dsp_fir_q31_t fir31;
+  dsp_biquad_q31_t bq31;
+  dsp_cic_t cic;
+  dsp_mavg_t mavg;
+  dsp_level_t level;
+  volatile q15_t sink;
+  volatile q31_t sink31;
+  size_t i;
+
+  printf("benchmark, blocks of %u samples\n", BENCH_BLOCK);
+
+  for (i = 0U; i < BENCH_BLOCK; i++) {
+    adc[i] = (adcsample_t)(rand() & 0xFFF);
+  }
+  dspFromADC(in, adc, BENCH_BLOCK, 2048, 4);
+  for (i = 0U; i < BENCH_BLOCK; i++) {
+    in31[i] = (q31_t)in[i] << 16;
+  }
+  dspFirObjectInit(&fir, fir_coeffs, state, ELEMS(fir_coeffs));
+  dspBiquadObjectInit(&bq, biquad_coeffs, bqstate, 2U);
+  dspFirQ31ObjectInit(&fir31, fir_q31_coeffs, state31,
+                      ELEMS(fir_q31_coeffs));
+  dspBiquadQ31ObjectInit(&bq31, biquad_q31_coeffs, bqstate31, 2U);
+  dspCicObjectInit(&cic, 3U, 8U, 9U);
+  dspMavgObjectInit(&mavg, history, 4U);
+  dspLevelObjectInit(&level, 6U, 4U);
+
+  BENCH("ADC conversion", dspFromADC(out, adc, BENCH_BLOCK, 2048, 4));
+  BENCH("FIR 31 taps", dspFirProcess(&fir, in, out, BENCH_BLOCK));
+  BENCH("biquad 2 stages", dspBiquadProcess(&bq, in, out, BENCH_BLOCK));
+  BENCH("Q31 FIR 31 taps",
+        dspFirQ31Process(&fir31, in31, out31, BENCH_BLOCK));
+  BENCH("Q31 biquad 2 stages",
+        dspBiquadQ31Process(&bq31, in31, out31, BENCH_BLOCK));
+  BENCH("CIC order 3 ratio 8",
+        (void)dspCicDecimate(&cic, in, out, BENCH_BLOCK));
+  BENCH("moving average 16", dspMavgProcess(&mavg, in, out, BENCH_BLOCK));
+  BENCH("level detector", dspLevelProcess(&level, in, BENCH_BLOCK));
+  BENCH("block RMS", sink = dspRMS(in, BENCH_BLOCK));
+  BENCH("Q31 block RMS", sink31 = dspRMSQ31(in31, BENCH_BLOCK));
+  BENCH("FFT 256 points", (dspFFTLoadReal(buf, in, BENCH_BLOCK),
+                           dspFFT(buf, BENCH_BLOCK)));
+  (void)sink;
+  (void)sink31;
+}
+
+int main(int argc, char *argv[]) {
+
+  test_convert();
+  test_sqrt();
+  test_measure();
+  test_mavg();
+  test_fir();
+  test_biquad();
+  test_fir_q31();
+  test_biquad_q31();
+  test_cic();
+  test_fft();
+  test_accuracy();
+  test_accuracy_q31();
+
+  if (failures > 0U) {
+    printf("%u failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0)) {
+    bench();
+  }
+
+  return 0;
+}
@@ -0,0 +1,355 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Kinetis ADC0 register level model, see adcmodel.h.
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "adcmodel.h"
+
+/* Clock sources of the model.*/
+#define MODEL_BUSCLK                KINETIS_BUSCLK_FREQUENCY
+#define MODEL_ALTCLK                8000000U
+#define MODEL_ADACK                 4000000U
+
+/* ADCK cycles of a single conversion, the long sample time adds 20.*/
+#define MODEL_CONV_CYCLES           25U
+#define MODEL_LSMP_CYCLES           20U
+
+#define NEVER                       UINT64_MAX
+
+ADC_TypeDef adc_model_adc0;
+SIM_TypeDef adc_model_sim;
+PMC_TypeDef adc_model_pmc;
+
+adc_model_stats_t adc_model_stats;
+adc_model_sample_t adc_model_log[ADC_MODEL_LOG_SIZE];
+
+OSAL_IRQ_HANDLER(KINETIS_ADC0_IRQ_VECTOR);
+
+static enum {IDLE, CONVERTING, CALIBRATING} state;
+static uint64_t now;
+static uint64_t busy_end;           /* End of conversion or calibration.   */
+static uint64_t isr_time;           /* Pending interrupt.                  */
+static uint64_t trig_next;          /* Next trigger event.                 */
+static uint32_t trig_source, trig_period;
+static uint32_t latency_max, lcg;
+static uint64_t conv_start;
+static unsigned conv_channel;
+static unsigned seq;
+
+static bool clocked(void) {
+
+  return (adc_model_sim.SCGC6 & SIM_SCGC6_ADC0) != 0U;
+}
+
+static unsigned adch(void) {
+
+  return adc_model_adc0.SC1A & ADCx_SC1n_ADCH_MASK;
+}
+
+static uint32_t latency(void) {
+
+  if (latency_max == 0U) {
+    return 0;
+  }
+  lcg = lcg * 1664525U + 1013904223U;
+  return (lcg >> 8) % (latency_max + 1U);
+}
+
+static uint64_t conversion_ns(void) {
+  uint32_t cfg1 = adc_model_adc0.CFG1;
+  uint32_t sc3  = adc_model_adc0.SC3;
+  uint64_t clk, cycles;
+
+  switch ((cfg1 & ADCx_CFG1_ADICLK_MASK) >> ADCx_CFG1_ADICLK_SHIFT) {
+  case ADCx_CFG1_ADIVCLK_BUS_CLOCK:
+    clk = MODEL_BUSCLK;
+    break;
+  case ADCx_CFG1_ADIVCLK_BUS_CLOCK_DIV_2:
+    clk = MODEL_BUSCLK / 2U;
+    break;
+  case ADCx_CFG1_ADIVCLK_BUS_ALTCLK:
+    clk = MODEL_ALTCLK;
+    break;
+  default:
+    clk = MODEL_ADACK;
+    break;
+  }
+  clk >>= (cfg1 & ADCx_CFG1_ADIV_MASK) >> ADCx_CFG1_ADIV_SHIFT;
+
+  cycles = MODEL_CONV_CYCLES;
+  if ((cfg1 & ADCx_CFG1_ADLSMP) != 0U) {
+    cycles += MODEL_LSMP_CYCLES;
+  }
+  if ((sc3 & ADCx_SC3_AVGE) != 0U) {
+    cycles *= 4U << (sc3 & ADCx_SC3_AVGS_MASK);
+  }
+
+  return (cycles * 1000000000U + clk - 1U) / clk;
+}
+
+/* True if the hardware trigger of the model starts conversions.*/
+static bool triggered(void) {
+  uint32_t sopt7 = adc_model_sim.SOPT7 & 0x9FU;
+
+  return clocked() && (trig_period > 0U) &&
+         ((adc_model_adc0.SC2 & ADCx_SC2_ADTRG) != 0U) &&
+         (sopt7 == trig_source);
+}
+
+static void start_conversion(void) {
+
+  state        = CONVERTING;
+  conv_start   = now;
+  conv_channel = adch();
+  busy_end     = now + conversion_ns();
+}
+
+static void end_conversion(void) {
+  adc_model_sample_t *lp = &adc_model_log[adc_model_stats.samples %
+                                          ADC_MODEL_LOG_SIZE];
+
+  /* RA is read-only for the driver.*/
+  *(volatile uint32_t *)&adc_model_adc0.RA = (conv_channel << 11) |
+                                            (seq++ & 0x7FFU);
+  adc_model_adc0.SC1A |= ADCx_SC1n_COCO;
+  lp->start   = conv_start;
+  lp->channel = conv_channel;
+  adc_model_stats.samples++;
+
+  state = IDLE;
+  if (((adc_model_adc0.SC3 & ADCx_SC3_ADCO) != 0U) &&
+      ((adc_model_adc0.SC2 & ADCx_SC2_ADTRG) == 0U) &&
+      (adch() != ADCx_SC1n_ADCH_DISABLED)) {
+    start_conversion();
+  }
+
+  if ((adc_model_adc0.SC1A & ADCx_SC1n_AIEN) != 0U) {
+    if (isr_time != NEVER) {
+      adc_model_stats.overruns++;
+    }
+    else {
+      isr_time = now + latency();
+    }
+  }
+}
+
+static void end_calibration(void) {
+  volatile uint32_t *clp = &adc_model_adc0.CLPD;
+  volatile uint32_t *clm = &adc_model_adc0.CLMD;
+  unsigned i;
+
+  /* CLPD, CLPS, CLP4..CLP0 and the same on the minus side.*/
+  for (i = 0; i < 7; i++) {
+    clp[i] = 0x20U + (i << 4);
+    clm[i] = 0x21U + (i << 4);
+  }
+  adc_model_adc0.OFS = 0x0004U;
+  adc_model_adc0.SC3 &= ~(ADCx_SC3_CAL | ADCx_SC3_CALF);
+  adc_model_adc0.SC1A |= ADCx_SC1n_COCO;
+  adc_model_stats.calibrations++;
+
+  state = IDLE;
+  if ((adc_model_adc0.SC1A & ADCx_SC1n_AIEN) != 0U) {
+    isr_time = now + latency();
+  }
+}
+
+static void invoke_isr(void) {
+
+  isr_time = NEVER;
+  adc_model_stats.isrs++;
+
+  KINETIS_ADC0_IRQ_VECTOR();
+
+  /* A SC1A write aborts the conversion in progress.*/
+  if ((adc_model_adc0.SC1A & ADCx_SC1n_COCO) == 0U) {
+    if (state == CONVERTING) {
+      adc_model_stats.aborts++;
+      state = IDLE;
+    }
+    if (adch() != ADCx_SC1n_ADCH_DISABLED) {
+      adc_model_stats.selects++;
+    }
+  }
+}
+
+/*
+ * Reacts to the register changes made by the driver outside of the
+ * interrupt handler.
+ */
+static void sync(void) {
+
+  if (!clocked()) {
+    state    = IDLE;
+    isr_time = NEVER;
+    return;
+  }
+
+  /* The interrupt request is removed by a SC1A write.*/
+  if (((adc_model_adc0.SC1A & ADCx_SC1n_COCO) == 0U) ||
+      ((adc_model_adc0.SC1A & ADCx_SC1n_AIEN) == 0U)) {
+    isr_time = NEVER;
+  }
+
+  if (((adc_model_adc0.SC3 & ADCx_SC3_CAL) != 0U) && (state != CALIBRATING)) {
+    state    = CALIBRATING;
+    busy_end = now + ADC_MODEL_CAL_NS;
+    return;
+  }
+
+  if (state == CALIBRATING) {
+    return;
+  }
+
+  if ((state == CONVERTING) && (adch() == ADCx_SC1n_ADCH_DISABLED)) {
+    adc_model_stats.aborts++;
+    state = IDLE;
+  }
+
+  /* Software trigger, a SC1A write since the last conversion.*/
+  if ((state == IDLE) &&
+      ((adc_model_adc0.SC2 & ADCx_SC2_ADTRG) == 0U) &&
+      ((adc_model_adc0.SC1A & ADCx_SC1n_COCO) == 0U) &&
+      (adch() != ADCx_SC1n_ADCH_DISABLED)) {
+    start_conversion();
+  }
+}
+
+/*
+ * Back to the reset state, the time base and the trigger included.
+ */
+void adcModelReset(void) {
+
+  memset(&adc_model_adc0, 0, sizeof (adc_model_adc0));
+  memset(&adc_model_sim, 0, sizeof (adc_model_sim));
+  memset(&adc_model_pmc, 0, sizeof (adc_model_pmc));
+  adc_model_adc0.SC1A = ADCx_SC1n_ADCH(ADCx_SC1n_ADCH_DISABLED);
+  memset(&adc_model_stats, 0, sizeof (adc_model_stats));
+
+  state       = IDLE;
+  now         = 0;
+  isr_time    = NEVER;
+  trig_source = 0;
+  trig_period = 0;
+  trig_next   = NEVER;
+  latency_max = 0;
+  lcg         = 1;
+  seq         = 0;
+}
+
+/*
+ * Periodic trigger event, source is one of the ADC_TRIGGER_XXX values.
+ */
+void adcModelSetTrigger(uint32_t source, uint32_t period_ns) {
+
+  trig_source = source;
+  trig_period = period_ns;
+  trig_next   = period_ns > 0U ? now + period_ns : NEVER;
+}
+
+/*
+ * Maximum interrupt latency.
+ */
+void adcModelSetLatency(uint32_t max_ns) {
+
+  latency_max = max_ns;
+}
+
+uint64_t adcModelNow(void) {
+
+  return now;
+}
+
+bool adcModelBusy(void) {
+
+  sync();
+  return state != IDLE;
+}
+
+/*
+ * Advances the model to its next event and processes it.
+ * Returns false if there is nothing left to happen.
+ */
+bool adcModelRun(void) {
+  uint64_t t = NEVER;
+
+  sync();
+
+  if (state != IDLE) {
+    t = busy_end;
+  }
+  if (isr_time < t) {
+    t = isr_time;
+  }
+  if (triggered() && (trig_next < t)) {
+    t = trig_next;
+  }
+  if (t == NEVER) {
+    return false;
+  }
+
+  /* Trigger events never wait, the ones while not enabled are lost.*/
+  while ((trig_period > 0U) && (trig_next < t)) {
+    trig_next += trig_period;
+  }
+
+  now = t;
+  if (isr_time == t) {
+    invoke_isr();
+  }
+  else if ((state != IDLE) && (busy_end == t)) {
+    if (state == CALIBRATING) {
+      end_calibration();
+    }
+    else {
+      end_conversion();
+    }
+  }
+  else {
+    trig_next += trig_period;
+    if (adch() == ADCx_SC1n_ADCH_DISABLED) {
+      /* Nothing selected.*/
+    }
+    else if (state == IDLE) {
+      adc_model_stats.triggers++;
+      start_conversion();
+    }
+    else {
+      adc_model_stats.lost_triggers++;
+    }
+  }
+
+  return true;
+}
+
+void hal_lld_init(void) {
+}
+
+void nvicEnableVector(uint32_t n, uint32_t prio) {
+
+  (void)n;
+  (void)prio;
+}
+
+void nvicDisableVector(uint32_t n) {
+
+  (void)n;
+}
@@ -0,0 +1,76 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _ADCMODEL_H_
+#define _ADCMODEL_H_
+
+/*
+ * Register level model of the Kinetis ADC0 for host tests.
+ *
+ * The model is event driven with a nanoseconds time base. It reacts to
+ * the register contents left by the driver, a write to SC1A is detected
+ * because the driver writes COCO as zero, the model sets it again at the
+ * end of each conversion. Conversions are started by a SC1A write, by the
+ * continuous mode or by the hardware trigger selected in SIM_SOPT7, the
+ * trigger source is a periodic event of the model. The interrupt handler
+ * is invoked at the end of each conversion, after a pseudo-random latency
+ * if configured. The result of a conversion is the channel number in the
+ * bits 15..11 and a running sample number in the bits 10..0.
+ */
+
+/* Number of logged conversions, older entries are overwritten.*/
+#define ADC_MODEL_LOG_SIZE          4096U
+
+/* Calibration time.*/
+#define ADC_MODEL_CAL_NS            500000U
+
+/* Extracting channel and sample number from a result.*/
+#define ADC_MODEL_CHANNEL(s)        ((unsigned)(s) >> 11)
+#define ADC_MODEL_SEQ(s)            ((unsigned)(s) & 0x7FFU)
+
+typedef struct {
+  uint64_t              start;          /* Sampling time.                   */
+  unsigned              channel;
+} adc_model_sample_t;
+
+typedef struct {
+  unsigned long         samples;        /* Conversions completed.           */
+  unsigned long         isrs;           /* Interrupt handler invocations.   */
+  unsigned long         selects;        /* Channel selections by the ISR.   */
+  unsigned long         triggers;       /* Trigger events accepted.         */
+  unsigned long         lost_triggers;  /* Trigger events while busy.       */
+  unsigned long         overruns;       /* Results never seen by the ISR.   */
+  unsigned long         aborts;         /* Conversions aborted.             */
+  unsigned long         calibrations;   /* Calibrations completed.          */
+} adc_model_stats_t;
+
+extern adc_model_stats_t adc_model_stats;
+extern adc_model_sample_t adc_model_log[ADC_MODEL_LOG_SIZE];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void adcModelReset(void);
+  void adcModelSetTrigger(uint32_t source, uint32_t period_ns);
+  void adcModelSetLatency(uint32_t max_ns);
+  uint64_t adcModelNow(void);
+  bool adcModelBusy(void);
+  bool adcModelRun(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ADCMODEL_H_ */
@@ -0,0 +1,56 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _HAL_LLD_H_
+#define _HAL_LLD_H_
+
+/*
+ * Host stand-in for the KL02x platform, the device header is the real one
+ * but the ADC0, SIM and PMC registers blocks are variables of the model,
+ * see adcmodel.c.
+ */
+
+#include "kl02x.h"
+#include "kinetis_registry.h"
+
+#define PLATFORM_NAME               "Host ADC model"
+
+#define KINETIS_SYSCLK_FREQUENCY    48000000UL
+#define KINETIS_BUSCLK_FREQUENCY    24000000UL
+
+#undef ADC0
+#undef SIM
+#undef PMC
+
+#define ADC0                        (&adc_model_adc0)
+#define SIM                         (&adc_model_sim)
+#define PMC                         (&adc_model_pmc)
+
+extern ADC_TypeDef adc_model_adc0;
+extern SIM_TypeDef adc_model_sim;
+extern PMC_TypeDef adc_model_pmc;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hal_lld_init(void);
+  void nvicEnableVector(uint32_t n, uint32_t prio);
+  void nvicDisableVector(uint32_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_LLD_H_ */
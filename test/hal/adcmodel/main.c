@@ -0,0 +1,506 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Kinetis ADC driver tests against the register level model.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "adcmodel.h"
+
+#define CHECK(c)        check((c), #c, __LINE__)
+
+/* ADCCLK = 24MHz / 2 / 2 = 6MHz, 16 bits.*/
+#define TEST_CFG1       (ADCx_CFG1_ADIV(ADCx_CFG1_ADIV_DIV_2) |             \
+                         ADCx_CFG1_ADICLK(ADCx_CFG1_ADIVCLK_BUS_CLOCK_DIV_2) |\
+                         ADCx_CFG1_MODE(ADCx_CFG1_MODE_16_BITS))
+
+/* Duration of a conversion in the model, 25 cycles at 6MHz.*/
+#define TEST_CONV_NS    4167U
+
+#define MIC_CHANNEL     ADCx_SC1n_ADCH_AD8
+
+static unsigned failures;
+
+static adcsample_t samples[512];
+
+static struct {
+  unsigned      halves;
+  unsigned      fulls;
+  unsigned      bad;
+  unsigned      stop_after;
+  unsigned      next_seq;
+} cb;
+
+static void check(bool c, const char *s, int line) {
+
+  if (!c) {
+    printf("  FAILED at line %d: %s\n", line, s);
+    failures++;
+  }
+}
+
+static void cb_reset(unsigned stop_after) {
+
+  cb.halves     = 0;
+  cb.fulls      = 0;
+  cb.bad        = 0;
+  cb.stop_after = stop_after;
+  cb.next_seq   = 0;
+}
+
+/*
+ * Checks that each half buffer continues the previous one, alternates the
+ * halves and optionally stops the conversion from the callback.
+ */
+static void stream_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+  size_t half = adcp->depth / 2;
+  size_t i, rows = n * adcp->grpp->num_channels;
+
+  if (n != half) {
+    cb.bad++;
+  }
+  if (buffer == adcp->samples) {
+    if (cb.halves != cb.fulls) {
+      cb.bad++;
+    }
+    cb.halves++;
+  }
+  else {
+    if ((buffer != adcp->samples + half * adcp->grpp->num_channels) ||
+        (cb.fulls + 1U != cb.halves)) {
+      cb.bad++;
+    }
+    cb.fulls++;
+  }
+  for (i = 0; i < rows; i++) {
+    if (ADC_MODEL_SEQ(buffer[i]) != (cb.next_seq++ & 0x7FFU)) {
+      cb.bad++;
+    }
+  }
+
+  if ((cb.stop_after > 0U) && (cb.fulls == cb.stop_after)) {
+    osalSysLockFromISR();
+    adcStopConversionI(adcp);
+    osalSysUnlockFromISR();
+  }
+}
+
+/*
+ * Runs the model until the specified number of full buffer callbacks.
+ */
+static void run_until_fulls(unsigned fulls) {
+
+  while (cb.fulls < fulls) {
+    if (!adcModelRun()) {
+      CHECK(false);
+      return;
+    }
+  }
+}
+
+/* Spacing of the logged conversions, from the first one.*/
+static void log_spacing(unsigned first, unsigned n,
+                        uint64_t *minp, uint64_t *maxp) {
+  uint64_t d;
+  unsigned i;
+
+  *minp = UINT64_MAX;
+  *maxp = 0;
+  for (i = first + 1U; i < first + n; i++) {
+    d = adc_model_log[i].start - adc_model_log[i - 1U].start;
+    if (d < *minp) {
+      *minp = d;
+    }
+    if (d > *maxp) {
+      *maxp = d;
+    }
+  }
+}
+
+static const ADCConfig cfg_calibrate = {
+  true
+};
+
+static void test_calibration(void) {
+  static adccalib_t rec;
+  static const ADCConversionGroup grp = {
+    false, 2, NULL, NULL,
+    ADC_TEMP_SENSOR | ADC_BANDGAP,
+    TEST_CFG1,
+    0,
+    ADC_TRIGGER_SOFTWARE
+  };
+  uint16_t pg, mg;
+  unsigned i;
+  msg_t msg;
+
+  printf("background calibration, deferred conversion\n");
+
+  adcStart(&ADCD1, &cfg_calibrate);
+  CHECK(adcModelBusy());
+  CHECK(adc_model_stats.calibrations == 0U);
+
+  msg = adcConvert(&ADCD1, &grp, samples, 4);
+  CHECK(msg == MSG_OK);
+  CHECK(adc_model_stats.calibrations == 1U);
+  CHECK(adc_model_log[0].start >= ADC_MODEL_CAL_NS);
+
+  pg = ((adc_model_adc0.CLP0 + adc_model_adc0.CLP1 + adc_model_adc0.CLP2 +
+         adc_model_adc0.CLP3 + adc_model_adc0.CLP4 + adc_model_adc0.CLPS) /
+        2U) | 0x8000U;
+  mg = ((adc_model_adc0.CLM0 + adc_model_adc0.CLM1 + adc_model_adc0.CLM2 +
+         adc_model_adc0.CLM3 + adc_model_adc0.CLM4 + adc_model_adc0.CLMS) /
+        2U) | 0x8000U;
+  CHECK(adc_model_adc0.PG == pg);
+  CHECK(adc_model_adc0.MG == mg);
+
+  for (i = 0; i < 8U; i++) {
+    CHECK(ADC_MODEL_CHANNEL(samples[i]) ==
+          ((i & 1U) ? ADCx_SC1n_ADCH_BANDGAP : ADCx_SC1n_ADCH_TEMP_SENSOR));
+    CHECK(ADC_MODEL_SEQ(samples[i]) == i);
+  }
+  adcStop(&ADCD1);
+
+  printf("persistent calibration\n");
+
+  adc_model_adc0.PG = 0;
+  adc_model_adc0.MG = 0;
+  adcStart(&ADCD1, &cfg_calibrate);
+  CHECK(!adcModelBusy());
+  CHECK(adc_model_stats.calibrations == 1U);
+  CHECK(adc_model_adc0.PG == pg);
+  CHECK(adc_model_adc0.MG == mg);
+
+  printf("calibration loaded before the driver initialization\n");
+
+  /* A lazy driver class is initialized by the first adcStart(), after a
+     record has been loaded at boot.*/
+  CHECK(adcKinetisGetCalibration(&ADCD1, &rec, 25, 3000U));
+  adcStop(&ADCD1);
+  CHECK(adcKinetisSetCalibration(&ADCD1, NULL, 25, 3000U));
+  CHECK(adcKinetisSetCalibration(&ADCD1, &rec, 25, 3000U));
+  adc_model_adc0.PG = 0;
+  adc_model_adc0.MG = 0;
+  adcInit();
+  adcStart(&ADCD1, &cfg_calibrate);
+  CHECK(!adcModelBusy());
+  CHECK(adc_model_stats.calibrations == 1U);
+  CHECK(adc_model_adc0.PG == pg);
+  CHECK(adc_model_adc0.MG == mg);
+}
+
+static void test_linear(void) {
+  static const ADCConversionGroup grp = {
+    false, 3, NULL, NULL,
+    ADC_AD4 | ADC_AD5 | ADC_AD6,
+    TEST_CFG1,
+    0,
+    ADC_TRIGGER_SOFTWARE
+  };
+  unsigned i, first = adc_model_stats.samples;
+  msg_t msg;
+
+  printf("linear, software triggered, 3 channels\n");
+
+  adc_model_stats.selects = 0;
+  msg = adcConvert(&ADCD1, &grp, samples, 4);
+  CHECK(msg == MSG_OK);
+  for (i = 0; i < 12U; i++) {
+    CHECK(ADC_MODEL_CHANNEL(samples[i]) == 4U + i % 3U);
+    CHECK(ADC_MODEL_SEQ(samples[i]) == first + i);
+  }
+
+  /* The first channel is selected by the start, the others by the ISR.*/
+  CHECK(adc_model_stats.selects == 11U);
+  CHECK(!adcModelRun());
+}
+
+static void test_stream_trigger(void) {
+  static const ADCConversionGroup grp = {
+    true, 1, stream_cb, NULL,
+    1U << MIC_CHANNEL,
+    TEST_CFG1,
+    ADCx_SC3_AVGE | ADCx_SC3_AVGS(ADCx_SC3_AVGS_AVERAGE_4_SAMPLES),
+    ADC_TRIGGER_TPM0
+  };
+  unsigned first = adc_model_stats.samples;
+  unsigned long isrs = adc_model_stats.isrs;
+  uint64_t dmin, dmax;
+
+  printf("circular, TPM0 triggered at 8kHz, 4x averaging, ISR latency"
+         " up to 40us\n");
+
+  cb_reset(0);
+  cb.next_seq = first;
+  adc_model_stats.selects = 0;
+  adcModelSetTrigger(ADC_TRIGGER_TPM0, 125000U);
+  adcModelSetLatency(40000U);
+
+  adcStartConversion(&ADCD1, &grp, samples, 256);
+  run_until_fulls(8);
+  adcStopConversion(&ADCD1);
+
+  CHECK(cb.halves == 8U);
+  CHECK(cb.fulls == 8U);
+  CHECK(cb.bad == 0U);
+  CHECK(adc_model_stats.selects == 0U);
+  CHECK(adc_model_stats.lost_triggers == 0U);
+  CHECK(adc_model_stats.overruns == 0U);
+
+  log_spacing(first, 2048, &dmin, &dmax);
+  CHECK(dmin == 125000U);
+  CHECK(dmax == 125000U);
+  printf("  %lu samples, %lu ISRs, %lu channel selections, period"
+         " %llu..%llu ns\n",
+         adc_model_stats.samples - first, adc_model_stats.isrs - isrs,
+         adc_model_stats.selects,
+         (unsigned long long)dmin, (unsigned long long)dmax);
+
+  /* Nothing happens after the stop.*/
+  while (adcModelRun()) {
+  }
+  CHECK(adc_model_stats.samples - first <= 2048U + 1U);
+  CHECK(ADCD1.state == ADC_READY);
+
+  adcModelSetTrigger(0, 0);
+  adcModelSetLatency(0);
+}
+
+static void test_stream_continuous(void) {
+  static const ADCConversionGroup grp = {
+    true, 1, stream_cb, NULL,
+    1U << MIC_CHANNEL,
+    TEST_CFG1,
+    ADCx_SC3_ADCO | ADCx_SC3_AVGE |
+      ADCx_SC3_AVGS(ADCx_SC3_AVGS_AVERAGE_32_SAMPLES),
+    ADC_TRIGGER_SOFTWARE
+  };
+  unsigned first;
+  uint64_t dmin, dmax;
+
+  printf("circular, continuous, 32x averaging, ISR latency up to 40us\n");
+
+  adcModelSetLatency(40000U);
+  adc_model_stats.selects = 0;
+  first = adc_model_stats.samples;
+  cb_reset(0);
+  cb.next_seq = first;
+
+  adcStartConversion(&ADCD1, &grp, samples, 64);
+  run_until_fulls(4);
+  adcStopConversion(&ADCD1);
+  while (adcModelRun()) {
+  }
+
+  CHECK(cb.bad == 0U);
+  CHECK(adc_model_stats.selects == 0U);
+  log_spacing(first, 256, &dmin, &dmax);
+  CHECK(dmin == dmax);
+  CHECK(dmin == (25U * 32U * 1000000000ULL + 5999999U) / 6000000U);
+  printf("  period %llu..%llu ns\n",
+         (unsigned long long)dmin, (unsigned long long)dmax);
+
+  adcModelSetLatency(0);
+}
+
+static void test_stream_software(void) {
+  static const ADCConversionGroup grp = {
+    true, 1, stream_cb, NULL,
+    1U << MIC_CHANNEL,
+    TEST_CFG1,
+    ADCx_SC3_AVGE | ADCx_SC3_AVGS(ADCx_SC3_AVGS_AVERAGE_32_SAMPLES),
+    ADC_TRIGGER_SOFTWARE
+  };
+  unsigned first;
+  uint64_t dmin, dmax;
+
+  printf("circular, restarted by the ISR, 32x averaging, ISR latency up"
+         " to 40us\n");
+
+  adcModelSetLatency(40000U);
+  adc_model_stats.selects = 0;
+  first = adc_model_stats.samples;
+  cb_reset(0);
+  cb.next_seq = first;
+
+  adcStartConversion(&ADCD1, &grp, samples, 64);
+  run_until_fulls(4);
+  adcStopConversion(&ADCD1);
+  while (adcModelRun()) {
+  }
+
+  CHECK(cb.bad == 0U);
+  CHECK(adc_model_stats.selects >= 255U);
+  log_spacing(first, 256, &dmin, &dmax);
+  CHECK(dmax > dmin);
+  printf("  period %llu..%llu ns\n",
+         (unsigned long long)dmin, (unsigned long long)dmax);
+
+  adcModelSetLatency(0);
+}
+
+static void test_multi_trigger(void) {
+  static const ADCConversionGroup grp = {
+    true, 2, stream_cb, NULL,
+    ADC_AD4 | ADC_AD9,
+    TEST_CFG1,
+    0,
+    ADC_TRIGGER_TPM1
+  };
+  unsigned i, first;
+  uint64_t dmin, dmax;
+
+  printf("circular, TPM1 triggered at 20kHz, 2 channels\n");
+
+  adcModelSetTrigger(ADC_TRIGGER_TPM1, 50000U);
+  adcModelSetLatency(20000U);
+  adc_model_stats.lost_triggers = 0;
+  first = adc_model_stats.samples;
+  cb_reset(0);
+  cb.next_seq = first;
+
+  adcStartConversion(&ADCD1, &grp, samples, 8);
+  run_until_fulls(4);
+  adcStopConversion(&ADCD1);
+  while (adcModelRun()) {
+  }
+
+  CHECK(cb.bad == 0U);
+  CHECK(adc_model_stats.lost_triggers == 0U);
+  log_spacing(first, 64, &dmin, &dmax);
+  CHECK(dmin == 50000U);
+  CHECK(dmax == 50000U);
+  for (i = 0; i < 64U; i++) {
+    CHECK(adc_model_log[first + i].channel == ((i & 1U) ? 9U : 4U));
+  }
+
+  adcModelSetTrigger(0, 0);
+  adcModelSetLatency(0);
+}
+
+static void test_stop_from_callback(void) {
+  static const ADCConversionGroup grp = {
+    true, 1, stream_cb, NULL,
+    1U << MIC_CHANNEL,
+    TEST_CFG1,
+    0,
+    ADC_TRIGGER_TPM0
+  };
+  unsigned long samples_at_stop;
+
+  printf("circular, stopped by the callback\n");
+
+  adcModelSetTrigger(ADC_TRIGGER_TPM0, 125000U);
+  cb_reset(2);
+  cb.next_seq = adc_model_stats.samples;
+
+  adcStartConversion(&ADCD1, &grp, samples, 16);
+  run_until_fulls(2);
+  samples_at_stop = adc_model_stats.samples;
+  while (adcModelRun()) {
+  }
+
+  CHECK(cb.bad == 0U);
+  CHECK(cb.fulls == 2U);
+  CHECK(ADCD1.state == ADC_READY);
+  CHECK(adc_model_stats.samples == samples_at_stop);
+
+  adcModelSetTrigger(0, 0);
+}
+
+/*
+ * Restarts the conversion from the first full buffer callback, then checks
+ * the channels order in the following half buffers.
+ */
+static void restart_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+  size_t i, rows = n * adcp->grpp->num_channels;
+
+  if (cb.fulls == 0U) {
+    if (buffer != adcp->samples) {
+      const ADCConversionGroup *grpp = adcp->grpp;
+
+      cb.fulls++;
+      osalSysLockFromISR();
+      adcStopConversionI(adcp);
+      adcStartConversionI(adcp, grpp, adcp->samples, adcp->depth);
+      osalSysUnlockFromISR();
+    }
+    return;
+  }
+  for (i = 0; i < rows; i++) {
+    if (ADC_MODEL_CHANNEL(buffer[i]) != ((i & 1U) ? 9U : 4U)) {
+      cb.bad++;
+    }
+  }
+  cb.halves++;
+}
+
+static void test_restart_from_callback(void) {
+  static const ADCConversionGroup grp = {
+    true, 2, restart_cb, NULL,
+    ADC_AD4 | ADC_AD9,
+    TEST_CFG1,
+    0,
+    ADC_TRIGGER_SOFTWARE
+  };
+
+  printf("circular, 2 channels, restarted by the callback\n");
+
+  cb_reset(0);
+
+  adcStartConversion(&ADCD1, &grp, samples, 8);
+  while (cb.halves < 4U) {
+    if (!adcModelRun()) {
+      CHECK(false);
+      break;
+    }
+  }
+  adcStopConversion(&ADCD1);
+  while (adcModelRun()) {
+  }
+
+  CHECK(cb.fulls == 1U);
+  CHECK(cb.bad == 0U);
+}
+
+int main(void) {
+
+  adcModelReset();
+  adcInit();
+
+  test_calibration();
+  test_linear();
+  test_stream_trigger();
+  test_stream_continuous();
+  test_stream_software();
+  test_multi_trigger();
+  test_stop_from_callback();
+  test_restart_from_callback();
+
+  adcStop(&ADCD1);
+
+  if (failures > 0U) {
+    printf("%u failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  return 0;
+}
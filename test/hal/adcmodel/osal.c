@@ -0,0 +1,166 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Host OSAL for the ADC model tests.
+ *
+ * There is a single thread and no real interrupts, the interrupt handler
+ * is invoked by the ADC model. A thread that has to wait runs the model
+ * until it is resumed by the handler. A wait while the model has nothing
+ * left to do is a deadlock and halts the test.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "adcmodel.h"
+
+const char *osal_halt_msg;
+
+static msg_t resume_msg;
+
+void osalInit(void) {
+}
+
+void osalSysHalt(const char *reason) {
+
+  osal_halt_msg = reason;
+  fprintf(stderr, "halted: %s\n", reason);
+  exit(1);
+}
+
+void osalSysPolledDelayX(rtcnt_t cycles) {
+
+  (void)cycles;
+}
+
+void osalOsTimerHandlerI(void) {
+}
+
+void osalOsRescheduleS(void) {
+}
+
+systime_t osalOsGetSystemTimeX(void) {
+
+  return (systime_t)0;
+}
+
+void osalThreadSleepS(systime_t time) {
+
+  (void)time;
+  (void)adcModelRun();
+}
+
+void osalThreadSleep(systime_t time) {
+
+  osalThreadSleepS(time);
+}
+
+msg_t osalThreadSuspendS(thread_reference_t *trp) {
+
+  return osalThreadSuspendTimeoutS(trp, TIME_INFINITE);
+}
+
+msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp, systime_t timeout) {
+  static int self;
+
+  if (timeout == TIME_IMMEDIATE) {
+    return MSG_TIMEOUT;
+  }
+
+  *trp = &self;
+  while (*trp != NULL) {
+    if (!adcModelRun()) {
+      if (timeout == TIME_INFINITE) {
+        osalSysHalt("deadlock, the ADC model is stuck");
+      }
+      *trp = NULL;
+      return MSG_TIMEOUT;
+    }
+  }
+
+  return resume_msg;
+}
+
+void osalThreadResumeI(thread_reference_t *trp, msg_t msg) {
+
+  if (*trp != NULL) {
+    *trp = NULL;
+    resume_msg = msg;
+  }
+}
+
+void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
+
+  osalThreadResumeI(trp, msg);
+}
+
+msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp, systime_t timeout) {
+
+  (void)tqp;
+
+  if ((timeout != TIME_IMMEDIATE) && adcModelRun()) {
+    return MSG_OK;
+  }
+  if (timeout == TIME_INFINITE) {
+    osalSysHalt("deadlock, the ADC model is stuck");
+  }
+  return MSG_TIMEOUT;
+}
+
+void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
+
+  (void)tqp;
+  (void)msg;
+}
+
+void osalThreadDequeueAllI(threads_queue_t *tqp, msg_t msg) {
+
+  (void)tqp;
+  (void)msg;
+}
+
+void osalEventBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
+
+  esp->flags |= flags;
+  if (esp->cb != NULL) {
+    esp->cb(esp);
+  }
+}
+
+void osalEventBroadcastFlags(event_source_t *esp, eventflags_t flags) {
+
+  osalEventBroadcastFlagsI(esp, flags);
+}
+
+void osalEventSetCallback(event_source_t *esp,
+                          eventcallback_t cb,
+                          void *param) {
+
+  esp->cb    = cb;
+  esp->param = param;
+}
+
+void osalMutexLock(mutex_t *mp) {
+
+  *mp = 1;
+}
+
+void osalMutexUnlock(mutex_t *mp) {
+
+  *mp = 0;
+}
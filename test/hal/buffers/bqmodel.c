@@ -0,0 +1,31 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * The buffers code under test. The system unlock is redirected to the
+ * model, an interrupt can be taken wherever the code leaves a critical
+ * zone, as on the target.
+ */
+
+#include "hal.h"
+#include "bqmodel.h"
+
+#define osalSysUnlock() bqModelUnlock()
+
+#include "hal_buffers.c"
+
+/* Chunk size of the transfers, local to the buffers code.*/
+const size_t bq_max_chunk = BQ_MAX_CHUNK;
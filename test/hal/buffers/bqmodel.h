@@ -0,0 +1,39 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _BQMODEL_H_
+#define _BQMODEL_H_
+
+/**
+ * @brief   Interrupt handler model.
+ * @details Invoked on each exit from a critical zone of the buffers code
+ *          and on each tick while the thread waits.
+ */
+typedef void (*bq_model_isr_t)(void);
+
+extern bq_model_isr_t bq_model_isr;
+extern systime_t bq_model_time;
+extern const size_t bq_max_chunk;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bqModelUnlock(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BQMODEL_H_ */
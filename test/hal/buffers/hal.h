@@ -0,0 +1,28 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Minimal HAL header for the host build of the buffers queues, only the
+ * OSAL and the buffers queues interface are required.
+ */
+
+#ifndef _HAL_H_
+#define _HAL_H_
+
+#include "osal.h"
+#include "hal_buffers.h"
+
+#endif /* _HAL_H_ */
@@ -0,0 +1,380 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Buffers queues tests.
+ *
+ * The interrupt model fills input buffers or drains output buffers while
+ * the thread reads or writes with transfers of different sizes, the data
+ * must go through unchanged across the buffers wrap-around, with buffers
+ * smaller and larger than BQ_MAX_CHUNK. Timeouts, resets while waiting or
+ * within a transfer and a flush from the interrupt model racing a large
+ * write are also checked.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hal.h"
+#include "bqmodel.h"
+
+#define CHECK(cond, ...)                                                    \
+  do {                                                                      \
+    if (!(cond)) {                                                          \
+      printf("FAILED line %d: ", __LINE__);                                 \
+      printf(__VA_ARGS__);                                                  \
+      printf("\n");                                                         \
+      failures++;                                                           \
+    }                                                                       \
+  } while (false)
+
+#define MAX_BSIZE                   200U
+#define MAX_BN                      4U
+#define DATA_SIZE                   4000U
+
+static int failures;
+
+static input_buffers_queue_t ibq;
+static output_buffers_queue_t obq;
+static uint8_t buffers[BQ_BUFFER_SIZE(MAX_BN, MAX_BSIZE)];
+
+static uint8_t data[DATA_SIZE];
+static uint8_t sink[DATA_SIZE];
+static size_t produced, consumed;
+
+/* Size of the next input buffer, cycles through the sizes.*/
+static size_t post_size, post_max;
+
+/* Interrupt model actions, a single reset at the specified time.*/
+static bool reset_armed;
+static systime_t reset_tick;
+static unsigned flush_calls, flushes;
+
+static void gen_data(void) {
+  size_t i;
+
+  for (i = 0; i < DATA_SIZE; i++) {
+    data[i] = (uint8_t)(i * 13U + i / 256U + 1U);
+  }
+}
+
+/*
+ * Input side interrupt, fills and posts the empty buffers.
+ */
+static void ibq_fill_isr(void) {
+  uint8_t *p;
+  size_t size;
+
+  while ((produced < DATA_SIZE) &&
+         ((p = ibqGetEmptyBufferI(&ibq)) != NULL)) {
+    size = post_size;
+    post_size = post_size % post_max + 1U;
+    if (size > DATA_SIZE - produced) {
+      size = DATA_SIZE - produced;
+    }
+    memcpy(p, &data[produced], size);
+    produced += size;
+    ibqPostFullBufferI(&ibq, size);
+  }
+}
+
+/*
+ * Output side interrupt, drains the filled buffers.
+ */
+static void obq_drain_isr(void) {
+  uint8_t *p;
+  size_t size;
+
+  while ((p = obqGetFullBufferI(&obq, &size)) != NULL) {
+    if (consumed + size <= DATA_SIZE) {
+      memcpy(&sink[consumed], p, size);
+    }
+    consumed += size;
+    obqReleaseEmptyBufferI(&obq);
+  }
+}
+
+/*
+ * Output side interrupt of a driver that sends partial buffers when idle,
+ * as the USB serial driver does on its periodic flush. The flush period
+ * lets partial buffers survive into the next write so that the flush can
+ * also happen within it.
+ */
+static void obq_flush_isr(void) {
+
+  obq_drain_isr();
+  if ((++flush_calls % 3U == 0U) && obqTryFlushI(&obq)) {
+    flushes++;
+  }
+}
+
+static void ibq_reset_isr(void) {
+
+  if (reset_armed && (bq_model_time == reset_tick)) {
+    reset_armed = false;
+    ibqResetI(&ibq);
+  }
+}
+
+static void obq_reset_isr(void) {
+
+  if (reset_armed && (bq_model_time == reset_tick)) {
+    reset_armed = false;
+    obqResetI(&obq);
+  }
+}
+
+static void test_input(size_t bsize, size_t bn) {
+  static const size_t reads[] = {1, 5, 16, 33, 100, 257};
+  size_t r, n, i;
+  msg_t msg;
+
+  ibqObjectInit(&ibq, buffers, bsize, bn, NULL, NULL);
+  produced = 0;
+  consumed = 0;
+  post_size = 1;
+  post_max = bsize;
+  memset(sink, 0, sizeof (sink));
+  bq_model_isr = ibq_fill_isr;
+
+  for (i = 0; consumed < DATA_SIZE; i++) {
+    n = reads[i % (sizeof (reads) / sizeof (reads[0]))];
+    if (n > DATA_SIZE - consumed) {
+      n = DATA_SIZE - consumed;
+    }
+    if (n == 1U) {
+      msg = ibqGetTimeout(&ibq, TIME_INFINITE);
+      CHECK((msg >= 0) && (msg <= 255),
+            "bsize %u, get returned %d", (unsigned)bsize, (int)msg);
+      sink[consumed] = (uint8_t)msg;
+      consumed++;
+      continue;
+    }
+    r = ibqReadTimeout(&ibq, &sink[consumed], n, TIME_INFINITE);
+    CHECK(r == n, "bsize %u, read %u of %u bytes",
+          (unsigned)bsize, (unsigned)r, (unsigned)n);
+    consumed += r;
+  }
+  CHECK(memcmp(sink, data, DATA_SIZE) == 0,
+        "bsize %u, input data mismatch", (unsigned)bsize);
+  CHECK(ibqIsEmptyI(&ibq), "bsize %u, input data left", (unsigned)bsize);
+  bq_model_isr = NULL;
+}
+
+static void test_output(size_t bsize, size_t bn) {
+  static const size_t writes[] = {1, 7, 16, 64, 65, 300};
+  size_t w, n, i;
+
+  obqObjectInit(&obq, buffers, bsize, bn, NULL, NULL);
+  produced = 0;
+  consumed = 0;
+  memset(sink, 0, sizeof (sink));
+  bq_model_isr = obq_drain_isr;
+
+  for (i = 0; produced < DATA_SIZE; i++) {
+    n = writes[i % (sizeof (writes) / sizeof (writes[0]))];
+    if (n > DATA_SIZE - produced) {
+      n = DATA_SIZE - produced;
+    }
+    if (n == 1U) {
+      CHECK(obqPutTimeout(&obq, data[produced], TIME_INFINITE) == MSG_OK,
+            "bsize %u, put failed", (unsigned)bsize);
+      produced++;
+      continue;
+    }
+    w = obqWriteTimeout(&obq, &data[produced], n, TIME_INFINITE);
+    CHECK(w == n, "bsize %u, wrote %u of %u bytes",
+          (unsigned)bsize, (unsigned)w, (unsigned)n);
+    produced += w;
+  }
+  obqFlush(&obq);
+  osalSysLock();
+  obq_drain_isr();
+  osalSysUnlock();
+  CHECK(consumed == DATA_SIZE, "bsize %u, %u bytes sent",
+        (unsigned)bsize, (unsigned)consumed);
+  CHECK(memcmp(sink, data, DATA_SIZE) == 0,
+        "bsize %u, output data mismatch", (unsigned)bsize);
+  bq_model_isr = NULL;
+}
+
+static void test_timeout(void) {
+  uint8_t buf[100];
+  systime_t t;
+  uint8_t *p;
+  size_t n;
+
+  /* Nothing arrives.*/
+  ibqObjectInit(&ibq, buffers, 16, 2, NULL, NULL);
+  t = bq_model_time;
+  CHECK(ibqGetTimeout(&ibq, 5) == MSG_TIMEOUT, "get, no timeout");
+  CHECK(bq_model_time - t == 5, "get, waited %u ticks",
+        (unsigned)(bq_model_time - t));
+  CHECK(ibqGetTimeout(&ibq, TIME_IMMEDIATE) == MSG_TIMEOUT,
+        "get, immediate");
+  t = bq_model_time;
+  CHECK(ibqReadTimeout(&ibq, buf, 10, 5) == 0, "read, no timeout");
+  CHECK(bq_model_time - t == 5, "read, waited %u ticks",
+        (unsigned)(bq_model_time - t));
+
+  /* Less data than requested.*/
+  osalSysLock();
+  p = ibqGetEmptyBufferI(&ibq);
+  memcpy(p, "abc", 3);
+  ibqPostFullBufferI(&ibq, 3);
+  osalSysUnlock();
+  n = ibqReadTimeout(&ibq, buf, 10, 5);
+  CHECK((n == 3) && (memcmp(buf, "abc", 3) == 0),
+        "read, %u bytes returned", (unsigned)n);
+
+  /* Nothing is sent, the write stops when the buffers are all full.*/
+  obqObjectInit(&obq, buffers, 16, 2, NULL, NULL);
+  gen_data();
+  n = obqWriteTimeout(&obq, data, 100, 5);
+  CHECK(n == 32, "write, %u bytes written", (unsigned)n);
+  CHECK(obqIsFullI(&obq), "write, queue not full");
+  CHECK(obqPutTimeout(&obq, 0, 5) == MSG_TIMEOUT, "put, no timeout");
+
+  /* The queue is usable once drained.*/
+  produced = 32;
+  consumed = 0;
+  osalSysLock();
+  obq_drain_isr();
+  osalSysUnlock();
+  CHECK((consumed == 32) && (memcmp(sink, data, 32) == 0),
+        "drain, %u bytes", (unsigned)consumed);
+  CHECK(obqWriteTimeout(&obq, &data[32], 20, 5) == 20, "write after drain");
+}
+
+static void test_reset(void) {
+  uint8_t buf[300];
+  uint8_t *p;
+  size_t n;
+
+  gen_data();
+
+  /* Reset while waiting for data.*/
+  ibqObjectInit(&ibq, buffers, 16, 2, NULL, NULL);
+  reset_armed = true;
+  reset_tick = bq_model_time + 3U;
+  bq_model_isr = ibq_reset_isr;
+  CHECK(ibqGetTimeout(&ibq, TIME_INFINITE) == MSG_RESET, "get, no reset");
+  reset_armed = true;
+  reset_tick = bq_model_time + 3U;
+  CHECK(ibqReadTimeout(&ibq, buf, 10, TIME_INFINITE) == 0, "read, no reset");
+
+  /* Reset within a read, the data of the current chunk is kept and the
+     rest is discarded.*/
+  ibqObjectInit(&ibq, buffers, MAX_BSIZE, 2, NULL, NULL);
+  bq_model_isr = NULL;
+  osalSysLock();
+  p = ibqGetEmptyBufferI(&ibq);
+  memcpy(p, data, MAX_BSIZE);
+  ibqPostFullBufferI(&ibq, MAX_BSIZE);
+  osalSysUnlock();
+  reset_armed = true;
+  reset_tick = bq_model_time;
+  bq_model_isr = ibq_reset_isr;
+  n = ibqReadTimeout(&ibq, buf, MAX_BSIZE, 5);
+  CHECK(n == bq_max_chunk, "read, %u bytes before the reset", (unsigned)n);
+  CHECK(memcmp(buf, data, n) == 0, "read, data mismatch");
+  CHECK(ibqIsEmptyI(&ibq), "read, data left after reset");
+
+  /* Reset while waiting for space.*/
+  obqObjectInit(&obq, buffers, 16, 2, NULL, NULL);
+  bq_model_isr = NULL;
+  CHECK(obqWriteTimeout(&obq, data, 32, TIME_INFINITE) == 32, "write");
+  reset_armed = true;
+  reset_tick = bq_model_time + 3U;
+  bq_model_isr = obq_reset_isr;
+  CHECK(obqPutTimeout(&obq, 0, TIME_INFINITE) == MSG_RESET, "put, no reset");
+  CHECK(obqIsEmptyI(&obq), "write, data left after reset");
+
+  /* Reset within a write, the write continues on a new buffer.*/
+  produced = 0;
+  consumed = 0;
+  obqObjectInit(&obq, buffers, MAX_BSIZE, 2, NULL, NULL);
+  reset_armed = true;
+  reset_tick = bq_model_time;
+  bq_model_isr = obq_reset_isr;
+  n = obqWriteTimeout(&obq, data, 150, 5);
+  CHECK(n == 150, "write, %u bytes", (unsigned)n);
+  bq_model_isr = NULL;
+  obqFlush(&obq);
+  osalSysLock();
+  obq_drain_isr();
+  osalSysUnlock();
+  CHECK((consumed == 150 - bq_max_chunk) &&
+        (memcmp(sink, &data[bq_max_chunk], consumed) == 0),
+        "write, %u bytes after the reset", (unsigned)consumed);
+}
+
+static void test_flush_race(void) {
+  static const size_t writes[] = {150, 500, 3, 199, 200, 201};
+  size_t w, n, i;
+
+  gen_data();
+  obqObjectInit(&obq, buffers, MAX_BSIZE, 2, NULL, NULL);
+  produced = 0;
+  consumed = 0;
+  flush_calls = 0;
+  flushes = 0;
+  memset(sink, 0, sizeof (sink));
+  bq_model_isr = obq_flush_isr;
+
+  for (i = 0; produced < DATA_SIZE; i++) {
+    n = writes[i % (sizeof (writes) / sizeof (writes[0]))];
+    if (n > DATA_SIZE - produced) {
+      n = DATA_SIZE - produced;
+    }
+    w = obqWriteTimeout(&obq, &data[produced], n, TIME_INFINITE);
+    CHECK(w == n, "wrote %u of %u bytes", (unsigned)w, (unsigned)n);
+    produced += w;
+  }
+  bq_model_isr = NULL;
+  obqFlush(&obq);
+  osalSysLock();
+  obq_drain_isr();
+  osalSysUnlock();
+
+  CHECK(flushes > 0, "no flushes");
+  CHECK(consumed == DATA_SIZE, "%u bytes sent", (unsigned)consumed);
+  CHECK(memcmp(sink, data, DATA_SIZE) == 0, "data mismatch");
+}
+
+int main(void) {
+  static const size_t sizes[] = {8, 16, 56, 64, 72, MAX_BSIZE};
+  size_t i;
+
+  gen_data();
+  for (i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    test_input(sizes[i], 2);
+    test_input(sizes[i], MAX_BN);
+    test_output(sizes[i], 2);
+    test_output(sizes[i], MAX_BN);
+  }
+  test_timeout();
+  test_reset();
+  test_flush_race();
+
+  if (failures > 0) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  return 0;
+}
@@ -0,0 +1,286 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Compressing streams tests.
+ *
+ * Log, trace, random and degenerate inputs are compressed into a memory
+ * stream with writes of different sizes, the encoded data must not depend
+ * on the way the input is split and must decode back to the input. The
+ * figures are the compressed size in percent of the input and the encode
+ * rate. The log capture is left in log.lz and log.txt for the host
+ * decompressor check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "memstreams.h"
+#include "lzstreams.h"
+
+#define CHECK(cond, ...)                                                    \
+  do {                                                                      \
+    if (!(cond)) {                                                          \
+      printf("FAILED line %d: ", __LINE__);                                 \
+      printf(__VA_ARGS__);                                                  \
+      printf("\n");                                                         \
+      failures++;                                                           \
+    }                                                                       \
+  } while (false)
+
+#define INPUT_SIZE                  (256U * 1024U)
+
+static int failures;
+
+static LzStream lzs;
+static MemoryStream ms;
+
+static uint8_t input[INPUT_SIZE];
+static uint8_t encoded[INPUT_SIZE * 9U / 8U + 16U];
+static uint8_t reference[sizeof (encoded)];
+static uint8_t decoded[INPUT_SIZE];
+
+static uint32_t seed;
+
+static uint32_t rnd(void) {
+
+  seed = seed * 1664525U + 1013904223U;
+  return seed >> 8;
+}
+
+static double now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/*
+ * Reference decoder, written from the format description.
+ */
+static long decode(const uint8_t *in, size_t n, uint8_t *out, size_t size) {
+  unsigned wbits, lbits, flag, dist, len;
+  size_t bit = 8, o = 0;
+
+#define BITS(x, nb)                                                         \
+  do {                                                                      \
+    unsigned _i;                                                            \
+    (x) = 0;                                                                \
+    for (_i = 0; _i < (nb); _i++, bit++) {                                  \
+      if (bit / 8 >= n) {                                                   \
+        return -1;                                                          \
+      }                                                                     \
+      (x) = ((x) << 1) | ((in[bit / 8] >> (7 - bit % 8)) & 1U);            \
+    }                                                                       \
+  } while (false)
+
+  if (n < 1) {
+    return -1;
+  }
+  wbits = in[0] >> 4;
+  lbits = in[0] & 15U;
+  while (true) {
+    BITS(flag, 1);
+    if (flag) {
+      if (o >= size) {
+        return -1;
+      }
+      BITS(out[o], 8);
+      o++;
+      continue;
+    }
+    BITS(dist, wbits);
+    BITS(len, lbits);
+    if (dist == (1U << wbits) - 1U) {
+      break;
+    }
+    dist += 1U;
+    len += LZSTREAM_MIN_MATCH;
+    if (o + len > size) {
+      return -1;
+    }
+    while (len--) {
+      /* The window starts zero filled.*/
+      out[o] = o >= dist ? out[o - dist] : 0U;
+      o++;
+    }
+  }
+  if ((bit + 7) / 8 != n) {
+    return -1;
+  }
+
+  return (long)o;
+#undef BITS
+}
+
+/*
+ * Compresses the input with writes of the specified size, zero for a
+ * single write, returns the encoded size.
+ */
+static size_t compress(uint8_t *dst, size_t size, size_t n, size_t chunk) {
+  size_t i, k;
+
+  msObjectInit(&ms, dst, size, 0);
+  lzsObjectInit(&lzs, (BaseSequentialStream *)&ms);
+  if (chunk == 0) {
+    streamWrite(&lzs, input, n);
+  }
+  else if (chunk == 1) {
+    for (i = 0; i < n; i++) {
+      streamPut(&lzs, input[i]);
+    }
+  }
+  else {
+    for (i = 0; i < n; i += k) {
+      k = n - i < chunk ? n - i : chunk;
+      streamWrite(&lzs, &input[i], k);
+    }
+  }
+  lzsFinish(&lzs);
+
+  return ms.eos;
+}
+
+static void run(const char *name, size_t n) {
+  static const size_t chunks[] = {1, 3, 17, 250, 4096};
+  size_t ref, len, i;
+  long dlen;
+  double t;
+
+  t = now();
+  ref = compress(reference, sizeof (reference), n, 0);
+  t = now() - t;
+
+  for (i = 0; i < sizeof (chunks) / sizeof (chunks[0]); i++) {
+    len = compress(encoded, sizeof (encoded), n, chunks[i]);
+    CHECK((len == ref) && (memcmp(encoded, reference, len) == 0),
+          "%s, writes of %u bytes change the encoding",
+          name, (unsigned)chunks[i]);
+  }
+
+  /* The object is ready for a new stream after lzsFinish().*/
+  msObjectInit(&ms, encoded, sizeof (encoded), 0);
+  streamWrite(&lzs, input, n);
+  lzsFinish(&lzs);
+  CHECK((ms.eos == ref) && (memcmp(encoded, reference, ref) == 0),
+        "%s, second stream differs", name);
+
+  dlen = decode(reference, ref, decoded, sizeof (decoded));
+  CHECK((dlen == (long)n) && (memcmp(decoded, input, n) == 0),
+        "%s, decoding mismatch", name);
+
+  if (n >= 1024U) {
+    printf(" %-8s %8u %8u %6.1f%% %8.2f MB/s\n", name, (unsigned)n,
+           (unsigned)ref, 100.0 * (double)ref / (double)n,
+           (double)n / (1024.0 * 1024.0) / t);
+  }
+}
+
+static size_t gen_log(void) {
+  static const char *const what[] = {"adc", "vbat", "temp", "led"};
+  size_t n = 0;
+  unsigned t = 0;
+
+  while (n < INPUT_SIZE - 80U) {
+    t += rnd() % 2000U;
+    n += (size_t)sprintf((char *)&input[n], "[%8u.%03u] %s: ch %u = %4u mV\r\n",
+                         t / 1000U, t % 1000U, what[rnd() % 4U],
+                         rnd() % 8U, 3000U + rnd() % 300U);
+  }
+  return n;
+}
+
+static size_t gen_trace(void) {
+  static const char *const fn[] = {"chSchGoSleepS", "sdPutTimeout",
+                                   "adc_lld_start", "orchardProfTick"};
+  size_t n = 0;
+  unsigned t = 0x10000000U;
+
+  while (n < INPUT_SIZE - 80U) {
+    t += rnd() % 64U;
+    n += (size_t)sprintf((char *)&input[n], "%08x %08x %c %s\r\n",
+                         t, 0x20000400U + (rnd() % 4U) * 0x100U,
+                         rnd() & 1U ? '>' : '<', fn[rnd() % 4U]);
+  }
+  return n;
+}
+
+static void write_capture(size_t n) {
+  FILE *f;
+  size_t len;
+
+  len = compress(encoded, sizeof (encoded), n, 0);
+  f = fopen("log.txt", "wb");
+  CHECK((f != NULL) && (fwrite(input, 1, n, f) == n), "log.txt");
+  if (f != NULL) {
+    fclose(f);
+  }
+  f = fopen("log.lz", "wb");
+  CHECK((f != NULL) && (fwrite(encoded, 1, len, f) == len), "log.lz");
+  if (f != NULL) {
+    fclose(f);
+  }
+}
+
+int main(void) {
+  size_t i, n;
+
+  printf("window %u bytes, matches %u..%u bytes, %u bytes of state\n",
+         LZSTREAM_WINDOW_SIZE, LZSTREAM_MIN_MATCH, LZSTREAM_MAX_MATCH,
+         (unsigned)sizeof (LzStream));
+  printf(" input       bytes  encoded  ratio  encode rate\n");
+
+  for (n = 0; n < 40; n++) {
+    seed = (uint32_t)n;
+    for (i = 0; i < n; i++) {
+      input[i] = (uint8_t)(rnd() % 3U);
+    }
+    run("short", n);
+  }
+
+  seed = 1;
+  n = gen_log();
+  run("log", n);
+  write_capture(n);
+
+  seed = 2;
+  run("trace", gen_trace());
+
+  seed = 3;
+  for (i = 0; i < INPUT_SIZE; i++) {
+    input[i] = (uint8_t)rnd();
+  }
+  run("random", INPUT_SIZE);
+
+  memset(input, 0, INPUT_SIZE);
+  run("zeros", INPUT_SIZE);
+
+  for (i = 0; i < INPUT_SIZE; i++) {
+    input[i] = (uint8_t)(i % 251U);
+  }
+  run("period", INPUT_SIZE);
+
+  if (failures > 0) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * I/O queues gather write tests.
+ *
+ * The interrupt model drains the output queue while the thread writes
+ * lists of fragments of different sizes, the data must go through
+ * unchanged and no critical zone of the gather write may move more than
+ * Q_MAX_CHUNK bytes. The notification count and the timeout of each wait
+ * for space are also checked.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hal.h"
+#include "qmodel.h"
+
+#define CHECK(cond, ...)                                                    \
+  do {                                                                      \
+    if (!(cond)) {                                                          \
+      printf("FAILED line %d: ", __LINE__);                                 \
+      printf(__VA_ARGS__);                                                  \
+      printf("\n");                                                         \
+      failures++;                                                           \
+    }                                                                       \
+  } while (false)
+
+#define MAX_QSIZE                   512U
+#define DATA_SIZE                   4000U
+
+static int failures;
+
+static output_queue_t oq;
+static uint8_t qbuf[MAX_QSIZE];
+
+static uint8_t data[DATA_SIZE];
+static uint8_t sink[DATA_SIZE];
+static size_t produced, consumed;
+
+/* Bytes drained per tick, largest amount written within a single critical
+   zone.*/
+static size_t drain_rate, written, max_zone;
+static systime_t drained_at;
+static unsigned notifies;
+
+static void gen_data(void) {
+  size_t i;
+
+  for (i = 0; i < DATA_SIZE; i++) {
+    data[i] = (uint8_t)(i * 13U + i / 256U + 1U);
+  }
+}
+
+static void notify(io_queue_t *qp) {
+
+  (void)qp;
+  notifies++;
+}
+
+/*
+ * Output side interrupt, notes the data written since the previous
+ * interrupt then drains up to drain_rate bytes once per tick, as a reader
+ * slower than the writer.
+ */
+static void oq_drain_isr(void) {
+  size_t n = consumed + oqGetFullI(&oq) - written;
+  msg_t msg;
+
+  if (n > max_zone) {
+    max_zone = n;
+  }
+  for (n = 0; (q_model_time != drained_at) && (n < drain_rate); n++) {
+    msg = oqGetI(&oq);
+    if (msg < MSG_OK) {
+      break;
+    }
+    if (consumed < DATA_SIZE) {
+      sink[consumed] = (uint8_t)msg;
+    }
+    consumed++;
+  }
+  drained_at = q_model_time;
+  written = consumed + oqGetFullI(&oq);
+}
+
+static void test_gather(size_t qsize, size_t rate) {
+  static const size_t frags[] = {1, 3, 40, 64, 65, 200, 7, 300};
+  stream_iovec_t iov[3];
+  size_t w, n, i, j;
+
+  oqObjectInit(&oq, qbuf, qsize, notify, NULL);
+  produced = 0;
+  consumed = 0;
+  written = 0;
+  max_zone = 0;
+  drain_rate = rate;
+  memset(sink, 0, sizeof (sink));
+  q_model_isr = oq_drain_isr;
+
+  for (i = 0; produced < DATA_SIZE; i++) {
+    n = 0;
+    for (j = 0; j < 3U; j++) {
+      iov[j].bp = &data[produced + n];
+      iov[j].n  = frags[(i + j * 3U) % (sizeof (frags) / sizeof (frags[0]))];
+      if (iov[j].n > DATA_SIZE - produced - n) {
+        iov[j].n = DATA_SIZE - produced - n;
+      }
+      n += iov[j].n;
+    }
+    w = oqWriteVTimeout(&oq, iov, 3U, TIME_INFINITE);
+    CHECK(w == n, "qsize %u, wrote %u of %u bytes",
+          (unsigned)qsize, (unsigned)w, (unsigned)n);
+    produced += w;
+  }
+  while (!oqIsEmptyI(&oq)) {
+    q_model_time++;
+    qModelUnlock();
+  }
+
+  CHECK(consumed == DATA_SIZE, "qsize %u, %u bytes drained",
+        (unsigned)qsize, (unsigned)consumed);
+  CHECK(memcmp(sink, data, DATA_SIZE) == 0,
+        "qsize %u, output data mismatch", (unsigned)qsize);
+  CHECK(max_zone <= q_max_chunk, "qsize %u, %u bytes in a critical zone",
+        (unsigned)qsize, (unsigned)max_zone);
+  q_model_isr = NULL;
+}
+
+static void test_notify(void) {
+  stream_iovec_t iov[3];
+  size_t w;
+
+  oqObjectInit(&oq, qbuf, MAX_QSIZE, notify, NULL);
+  consumed = 0;
+  written = 0;
+  max_zone = 0;
+  drain_rate = 0;
+  notifies = 0;
+  q_model_isr = oq_drain_isr;
+
+  /* Larger than a chunk, notified once after the last fragment.*/
+  iov[0].bp = data;
+  iov[0].n  = 4;
+  iov[1].bp = &data[4];
+  iov[1].n  = 250;
+  iov[2].bp = &data[254];
+  iov[2].n  = 2;
+  w = oqWriteVTimeout(&oq, iov, 3U, TIME_INFINITE);
+  CHECK(w == 256U, "wrote %u bytes", (unsigned)w);
+  CHECK(notifies == 1U, "%u notifications", notifies);
+  CHECK(max_zone <= q_max_chunk, "%u bytes in a critical zone",
+        (unsigned)max_zone);
+  q_model_isr = NULL;
+}
+
+static void test_timeout(void) {
+  stream_iovec_t iov[3];
+  systime_t start;
+  size_t w, i;
+
+  for (i = 0; i < 3U; i++) {
+    iov[i].bp = &data[i * 20U];
+    iov[i].n  = 20;
+  }
+
+  /* No reader, the queue is filled then the wait times out.*/
+  oqObjectInit(&oq, qbuf, 32, NULL, NULL);
+  q_model_isr = NULL;
+  start = q_model_time;
+  w = oqWriteVTimeout(&oq, iov, 3U, 10);
+  CHECK(w == 32U, "wrote %u bytes", (unsigned)w);
+  CHECK(q_model_time - start == 10U, "returned after %u ticks",
+        (unsigned)(q_model_time - start));
+
+  /* A slow reader, each wait for space is shorter than the timeout, the
+     whole write lasts longer.*/
+  oqObjectInit(&oq, qbuf, 32, NULL, NULL);
+  consumed = 0;
+  written = 0;
+  drain_rate = 1;
+  q_model_isr = oq_drain_isr;
+  start = q_model_time;
+  w = oqWriteVTimeout(&oq, iov, 3U, 10);
+  CHECK(w == 60U, "wrote %u bytes", (unsigned)w);
+  CHECK(q_model_time - start > 10U, "returned after %u ticks",
+        (unsigned)(q_model_time - start));
+  q_model_isr = NULL;
+}
+
+int main(void) {
+  static const size_t sizes[] = {16, 64, 100, MAX_QSIZE};
+  size_t i;
+
+  gen_data();
+  for (i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    test_gather(sizes[i], 1);
+    test_gather(sizes[i], 48);
+    test_gather(sizes[i], MAX_QSIZE);
+  }
+  test_notify();
+  test_timeout();
+
+  if (failures > 0) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  return 0;
+}
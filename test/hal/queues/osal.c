@@ -0,0 +1,101 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Host OSAL for the I/O queues tests.
+ *
+ * There is a single thread, a thread that has to wait advances the time
+ * one tick at a time and invokes the interrupt model on each tick until it
+ * is dequeued or its timeout expires. An infinite wait that is not ended
+ * within a second of model time is a deadlock and halts the test.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "qmodel.h"
+
+#define DEADLOCK_TICKS          OSAL_ST_FREQUENCY
+
+q_model_isr_t q_model_isr;
+systime_t q_model_time;
+
+static threads_queue_t *waiting_on;
+static msg_t wakeup_msg;
+
+static void run_isr(void) {
+
+  if (q_model_isr != NULL) {
+    osalSysLockFromISR();
+    q_model_isr();
+    osalSysUnlockFromISR();
+  }
+}
+
+void qModelUnlock(void) {
+
+  osalSysUnlock();
+  run_isr();
+}
+
+void osalSysHalt(const char *reason) {
+
+  fprintf(stderr, "halted: %s\n", reason);
+  exit(1);
+}
+
+systime_t osalOsGetSystemTimeX(void) {
+
+  return q_model_time;
+}
+
+msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp, systime_t timeout) {
+  systime_t start = q_model_time;
+
+  if (timeout == TIME_IMMEDIATE) {
+    return MSG_TIMEOUT;
+  }
+
+  waiting_on = tqp;
+  while (waiting_on != NULL) {
+    if ((timeout != TIME_INFINITE) &&
+        ((systime_t)(q_model_time - start) >= timeout)) {
+      waiting_on = NULL;
+      return MSG_TIMEOUT;
+    }
+    if ((systime_t)(q_model_time - start) >= DEADLOCK_TICKS) {
+      osalSysHalt("deadlock");
+    }
+    q_model_time++;
+    run_isr();
+  }
+
+  return wakeup_msg;
+}
+
+void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
+
+  if (waiting_on == tqp) {
+    waiting_on = NULL;
+    wakeup_msg = msg;
+  }
+}
+
+void osalThreadDequeueAllI(threads_queue_t *tqp, msg_t msg) {
+
+  osalThreadDequeueNextI(tqp, msg);
+}
@@ -0,0 +1,236 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * SerialUSB loopback benchmark.
+ *
+ * Blocks of increasing size are written to the SerialUSB driver and read
+ * back after the loop through the host model, the data is verified. The
+ * figures are the CPU time per megabyte, the number of USB transfers and
+ * packets per kilobyte and the number of zero length packets.
+ *
+ * Frames made of header, payload and CRC are then written with three
+ * stream writes and with a single gather write, the figure is the number
+ * of USB transfers per frame.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "usbmodel.h"
+
+/* Bytes moved for each block size.*/
+#define BENCH_TOTAL                 (4U * 1024U * 1024U)
+
+/* Frames written for each frames benchmark.*/
+#define BENCH_FRAMES                1024U
+
+#define BENCH_EP                    1U
+#define BENCH_EP_SIZE               64U
+
+static SerialUSBDriver SDU1;
+
+static USBInEndpointState ep1instate;
+static USBOutEndpointState ep1outstate;
+
+static const USBEndpointConfig ep1config = {
+  USB_EP_MODE_TYPE_BULK,
+  NULL,
+  sduDataTransmitted,
+  sduDataReceived,
+  BENCH_EP_SIZE,
+  BENCH_EP_SIZE,
+  &ep1instate,
+  &ep1outstate
+};
+
+static const USBConfig usbcfg = {
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+static const SerialUSBConfig serusbcfg = {
+  &USBD1,
+  BENCH_EP,
+  BENCH_EP,
+  0
+};
+
+static const size_t block_sizes[] = {1, 63, 64, 256, 1000, 4096};
+
+static uint8_t txbuf[4096], rxbuf[4096];
+
+static double now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/*
+ * Simulated bus reset and enumeration, SET_CONFIGURATION handled as done
+ * by the applications event callback.
+ */
+static void bench_connect(void) {
+
+  sduObjectInit(&SDU1);
+  sduStart(&SDU1, &serusbcfg);
+  usbStart(&USBD1, &usbcfg);
+
+  osalSysLock();
+  _usb_reset(&USBD1);
+  USBD1.state = USB_ACTIVE;
+  usbInitEndpointI(&USBD1, BENCH_EP, &ep1config);
+  sduConfigureHookI(&SDU1);
+  osalSysUnlock();
+}
+
+static void bench_disconnect(void) {
+
+  sduStop(&SDU1);
+  usbStop(&USBD1);
+}
+
+static int bench_run(size_t bsize) {
+  unsigned long long kb = BENCH_TOTAL / 1024U;
+  uint32_t seq = 0, chk = 0;
+  size_t done, i, n;
+  double t;
+
+  bench_connect();
+  usbModelReset();
+
+  t = now();
+  for (done = 0; done < BENCH_TOTAL; done += bsize) {
+    for (i = 0; i < bsize; i++) {
+      txbuf[i] = (uint8_t)(seq++ * 2654435761U >> 24);
+    }
+    n = chnWriteTimeout(&SDU1, txbuf, bsize, TIME_INFINITE);
+    if (n != bsize) {
+      fprintf(stderr, "short write %zu/%zu\n", n, bsize);
+      return 1;
+    }
+    n = chnReadTimeout(&SDU1, rxbuf, bsize, TIME_INFINITE);
+    if (n != bsize) {
+      fprintf(stderr, "short read %zu/%zu\n", n, bsize);
+      return 1;
+    }
+    for (i = 0; i < bsize; i++) {
+      if (rxbuf[i] != (uint8_t)(chk++ * 2654435761U >> 24)) {
+        fprintf(stderr, "data mismatch at %u\n", (unsigned)(chk - 1U));
+        return 1;
+      }
+    }
+  }
+  t = now() - t;
+
+  printf("%6zu %10.1f %9.2f %9.2f %9.2f %6lu %6lu\n",
+         bsize,
+         (double)BENCH_TOTAL / (1024.0 * 1024.0) / t,
+         (double)usb_model_stats.in_transfers / (double)kb,
+         (double)usb_model_stats.in_packets / (double)kb,
+         (double)usb_model_stats.out_transfers / (double)kb,
+         usb_model_stats.in_zlps,
+         usb_model_stats.out_zlps);
+
+  bench_disconnect();
+
+  return 0;
+}
+
+static int bench_frames(bool gather) {
+  static const uint8_t header[4] = {0x7E, 0x01, 0x00, 0x38};
+  static const uint8_t crc[2] = {0x12, 0x34};
+  uint8_t payload[56];
+  stream_iovec_t iov[3];
+  size_t i, n, len;
+
+  bench_connect();
+  usbModelReset();
+
+  iov[0].bp = header;
+  iov[0].n  = sizeof (header);
+  iov[1].bp = payload;
+  iov[1].n  = sizeof (payload);
+  iov[2].bp = crc;
+  iov[2].n  = sizeof (crc);
+  len = sizeof (header) + sizeof (payload) + sizeof (crc);
+
+  for (i = 0; i < BENCH_FRAMES; i++) {
+    memset(payload, (int)i, sizeof (payload));
+    if (gather) {
+      n = streamWriteV(&SDU1, iov, 3U);
+    }
+    else {
+      n  = streamWrite(&SDU1, header, sizeof (header));
+      n += streamWrite(&SDU1, payload, sizeof (payload));
+      n += streamWrite(&SDU1, crc, sizeof (crc));
+    }
+    if (n != len) {
+      fprintf(stderr, "short write %zu/%zu\n", n, len);
+      return 1;
+    }
+    n = chnReadTimeout(&SDU1, rxbuf, len, TIME_INFINITE);
+    if ((n != len) || (memcmp(rxbuf, header, sizeof (header)) != 0) ||
+        (memcmp(&rxbuf[sizeof (header)], payload, sizeof (payload)) != 0) ||
+        (memcmp(&rxbuf[len - sizeof (crc)], crc, sizeof (crc)) != 0)) {
+      fprintf(stderr, "frame %u mismatch\n", (unsigned)i);
+      return 1;
+    }
+  }
+
+  printf(" %-20s %9.2f\n", gather ? "gather write" : "three writes",
+         (double)usb_model_stats.in_transfers / (double)BENCH_FRAMES);
+
+  bench_disconnect();
+
+  return 0;
+}
+
+int main(void) {
+  size_t i;
+
+  usbInit();
+  sduInit();
+
+#if SERIAL_USB_PACKET_MODE == TRUE
+  printf("SerialUSB packet mode, %u buffers of %u bytes\n",
+         (unsigned)SERIAL_USB_BUFFERS_NUMBER,
+         (unsigned)SERIAL_USB_BUFFERS_SIZE);
+#else
+  printf("SerialUSB byte mode, %u bytes queues\n",
+         (unsigned)SERIAL_USB_BUFFERS_SIZE);
+#endif
+  printf(" block       MB/s  inxfer/K  inpkts/K outxfer/K inZLPs outZLPs\n");
+
+  for (i = 0; i < sizeof (block_sizes) / sizeof (block_sizes[0]); i++) {
+    if (bench_run(block_sizes[i]) != 0) {
+      return 1;
+    }
+  }
+
+  printf(" %u bytes frames   inxfer/frame\n", 62U);
+  if ((bench_frames(false) != 0) || (bench_frames(true) != 0)) {
+    return 1;
+  }
+
+  return 0;
+}
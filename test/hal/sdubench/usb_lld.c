@@ -0,0 +1,374 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * USB low level driver model, implements the template usb_lld.h interface
+ * on the host, see usbmodel.h.
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "usbmodel.h"
+
+#if (HAL_USE_USB == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+USBDriver USBD1;
+
+usb_model_stats_t usb_model_stats;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static const USBEndpointConfig ep0config = {
+  USB_EP_MODE_TYPE_CTRL,
+  _usb_ep0setup,
+  _usb_ep0in,
+  _usb_ep0out,
+  0x40,
+  0x40,
+  NULL,
+  NULL
+};
+
+/* Host request being filled by the IN packets.*/
+static uint8_t urb[USB_MODEL_URB_SIZE];
+static size_t urbcnt;
+
+/* Host loopback FIFO.*/
+static uint8_t fifo[USB_MODEL_FIFO_SIZE];
+static size_t fifo_rd, fifo_cnt;
+
+/* Host write in progress, bytes left and terminating ZLP.*/
+static size_t wrleft;
+static bool wrzlp;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void fifo_put(const uint8_t *bp, size_t n) {
+
+  osalDbgAssert(fifo_cnt + n <= USB_MODEL_FIFO_SIZE, "host FIFO overflow");
+
+  while (n-- > 0U) {
+    fifo[(fifo_rd + fifo_cnt) % USB_MODEL_FIFO_SIZE] = *bp++;
+    fifo_cnt++;
+  }
+}
+
+static uint8_t fifo_get(void) {
+  uint8_t b = fifo[fifo_rd];
+
+  fifo_rd = (fifo_rd + 1U) % USB_MODEL_FIFO_SIZE;
+  fifo_cnt--;
+
+  return b;
+}
+
+/*
+ * One IN packet from the device to the host.
+ */
+static bool serve_in(USBDriver *usbp, usbep_t ep) {
+  const USBEndpointConfig *epcp = usbp->epc[ep];
+  USBInEndpointState *isp = epcp->in_state;
+  uint8_t packet[1024];
+  size_t i, n;
+
+  if ((usbp->transmitting & (1U << ep)) == 0U) {
+    return false;
+  }
+
+  n = isp->txsize - isp->txcnt;
+  if (n > epcp->in_maxsize) {
+    n = epcp->in_maxsize;
+  }
+
+  if (isp->txqueued) {
+    output_queue_t *oqp = isp->mode.queue.txqueue;
+
+    for (i = 0; i < n; i++) {
+      packet[i] = *oqp->q_rdptr++;
+      if (oqp->q_rdptr >= oqp->q_top) {
+        oqp->q_rdptr = oqp->q_buffer;
+      }
+    }
+    osalSysLockFromISR();
+    oqp->q_counter += n;
+    osalThreadDequeueAllI(&oqp->q_waiting, Q_OK);
+    osalSysUnlockFromISR();
+  }
+  else if (n > 0U) {
+    memcpy(packet, isp->mode.linear.txbuf + isp->txcnt, n);
+  }
+  isp->txcnt += n;
+
+  /* Host side, the request completes on a short packet or when full.*/
+  usb_model_stats.in_packets++;
+  if (n == 0U) {
+    usb_model_stats.in_zlps++;
+  }
+  if (n > 0U) {
+    memcpy(urb + urbcnt, packet, n);
+    urbcnt += n;
+  }
+  if ((n < epcp->in_maxsize) || (urbcnt >= USB_MODEL_URB_SIZE)) {
+    fifo_put(urb, urbcnt);
+    urbcnt = 0;
+  }
+
+  /* Device side, end of transfer.*/
+  if (isp->txcnt >= isp->txsize) {
+    usb_model_stats.in_transfers++;
+    _usb_isr_invoke_in_cb(usbp, ep);
+  }
+
+  return true;
+}
+
+/*
+ * One OUT packet from the host to the device.
+ */
+static bool serve_out(USBDriver *usbp, usbep_t ep) {
+  const USBEndpointConfig *epcp = usbp->epc[ep];
+  USBOutEndpointState *osp = epcp->out_state;
+  size_t i, n;
+
+  if ((usbp->receiving & (1U << ep)) == 0U) {
+    return false;
+  }
+
+  /* Starting a new host write with all the pending data.*/
+  if ((wrleft == 0U) && !wrzlp) {
+    if (fifo_cnt == 0U) {
+      return false;
+    }
+    wrleft = fifo_cnt;
+  }
+
+  n = wrleft;
+  if (n > epcp->out_maxsize) {
+    n = epcp->out_maxsize;
+  }
+  osalDbgAssert(osp->rxcnt + n <= osp->rxsize, "device buffer overflow");
+
+  if (osp->rxqueued) {
+    input_queue_t *iqp = osp->mode.queue.rxqueue;
+
+    for (i = 0; i < n; i++) {
+      *iqp->q_wrptr++ = fifo_get();
+      if (iqp->q_wrptr >= iqp->q_top) {
+        iqp->q_wrptr = iqp->q_buffer;
+      }
+    }
+    osalSysLockFromISR();
+    iqp->q_counter += n;
+    osalThreadDequeueAllI(&iqp->q_waiting, Q_OK);
+    osalSysUnlockFromISR();
+  }
+  else {
+    for (i = 0; i < n; i++) {
+      osp->mode.linear.rxbuf[osp->rxcnt + i] = fifo_get();
+    }
+  }
+  osp->rxcnt += n;
+  usb_model_stats.bytes += n;
+
+  /* Host side, a write ending with a full packet is followed by a ZLP.*/
+  usb_model_stats.out_packets++;
+  if (n == 0U) {
+    usb_model_stats.out_zlps++;
+    wrzlp = false;
+  }
+  else {
+    wrleft -= n;
+    wrzlp = (wrleft == 0U) && (n == epcp->out_maxsize);
+  }
+
+  /* Device side, end of transfer on a short packet or when full.*/
+  if ((n < epcp->out_maxsize) || (osp->rxcnt >= osp->rxsize)) {
+    usb_model_stats.out_transfers++;
+    _usb_isr_invoke_out_cb(usbp, ep);
+  }
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/*
+ * Clears the host state and the statistics.
+ */
+void usbModelReset(void) {
+
+  urbcnt   = 0;
+  fifo_rd  = 0;
+  fifo_cnt = 0;
+  wrleft   = 0;
+  wrzlp    = false;
+  memset(&usb_model_stats, 0, sizeof (usb_model_stats));
+}
+
+/*
+ * Runs one bus step, at most one packet per direction and endpoint.
+ * Returns true if something happened.
+ */
+bool usbModelRun(void) {
+  USBDriver *usbp = &USBD1;
+  bool progress = false;
+  usbep_t ep;
+
+  if (usbp->state != USB_ACTIVE) {
+    return false;
+  }
+
+  for (ep = 1; ep <= USB_MAX_ENDPOINTS; ep++) {
+    if (usbp->epc[ep] == NULL) {
+      continue;
+    }
+    if ((usbp->epc[ep]->in_state != NULL) && serve_in(usbp, ep)) {
+      progress = true;
+    }
+    if ((usbp->epc[ep]->out_state != NULL) && serve_out(usbp, ep)) {
+      progress = true;
+    }
+  }
+
+  return progress;
+}
+
+/*
+ * Data held by the host, not yet looped back.
+ */
+size_t usbModelPending(void) {
+
+  return urbcnt + fifo_cnt;
+}
+
+void usb_lld_init(void) {
+
+  usbObjectInit(&USBD1);
+}
+
+void usb_lld_start(USBDriver *usbp) {
+
+  (void)usbp;
+}
+
+void usb_lld_stop(USBDriver *usbp) {
+
+  (void)usbp;
+}
+
+void usb_lld_reset(USBDriver *usbp) {
+
+  usbp->epc[0] = &ep0config;
+  usb_lld_init_endpoint(usbp, 0);
+}
+
+void usb_lld_set_address(USBDriver *usbp) {
+
+  (void)usbp;
+}
+
+void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_disable_endpoints(USBDriver *usbp) {
+
+  (void)usbp;
+}
+
+usbepstatus_t usb_lld_get_status_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+  return EP_STATUS_ACTIVE;
+}
+
+usbepstatus_t usb_lld_get_status_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+  return EP_STATUS_ACTIVE;
+}
+
+void usb_lld_read_setup(USBDriver *usbp, usbep_t ep, uint8_t *buf) {
+
+  (void)usbp;
+  (void)ep;
+  memset(buf, 0, 8);
+}
+
+void usb_lld_prepare_receive(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_prepare_transmit(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_stall_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_stall_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_clear_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+void usb_lld_clear_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+#endif /* HAL_USE_USB == TRUE */
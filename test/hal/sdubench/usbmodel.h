@@ -0,0 +1,57 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _USBMODEL_H_
+#define _USBMODEL_H_
+
+/*
+ * Host stand-in for the USB peripheral and for the host at the other side
+ * of the cable. The host reads the bulk IN endpoints into 4kB requests, a
+ * request completes on a short packet, a zero length packet or when full,
+ * as a real host does. The data of completed requests is looped back on
+ * the bulk OUT endpoint of the same number, the host terminates its own
+ * writes with a zero length packet when the last packet has maximum size.
+ */
+
+/* Host requests size.*/
+#define USB_MODEL_URB_SIZE          4096U
+
+/* Host loopback buffer size.*/
+#define USB_MODEL_FIFO_SIZE         65536U
+
+typedef struct {
+  unsigned long         in_packets;     /* Packets sent by the device.      */
+  unsigned long         in_zlps;        /* Of which zero length.            */
+  unsigned long         in_transfers;   /* Device IN transfers completed.   */
+  unsigned long         out_packets;    /* Packets received by the device.  */
+  unsigned long         out_zlps;       /* Of which zero length.            */
+  unsigned long         out_transfers;  /* Device OUT transfers completed.  */
+  unsigned long long    bytes;          /* Bytes looped back.               */
+} usb_model_stats_t;
+
+extern usb_model_stats_t usb_model_stats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbModelReset(void);
+  bool usbModelRun(void);
+  size_t usbModelPending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _USBMODEL_H_ */
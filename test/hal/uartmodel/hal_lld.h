@@ -0,0 +1,55 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _HAL_LLD_H_
+#define _HAL_LLD_H_
+
+/*
+ * Host stand-in for the KL02x platform, the device header is the real one
+ * but the UART0 and SIM registers blocks are variables of the model, see
+ * uartmodel.c.
+ */
+
+#include "kl02x.h"
+#include "kinetis_registry.h"
+
+#define PLATFORM_NAME               "Host UART model"
+
+#define KINETIS_SYSCLK_FREQUENCY    48000000UL
+#define KINETIS_BUSCLK_FREQUENCY    24000000UL
+#define KINETIS_UART0_CLOCK_FREQ    KINETIS_SYSCLK_FREQUENCY
+#define KINETIS_UART0_CLOCK_SRC     1
+
+#undef UART0
+#undef SIM
+
+#define UART0                       (&uart_model_uart0)
+#define SIM                         (&uart_model_sim)
+
+extern UARTLP_TypeDef uart_model_uart0;
+extern SIM_TypeDef uart_model_sim;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hal_lld_init(void);
+  void nvicEnableVector(uint32_t n, uint32_t prio);
+  void nvicDisableVector(uint32_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_LLD_H_ */
@@ -0,0 +1,115 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Drivers initialization tests, halInit() and the serial driver class
+ * initialized eagerly or on first use depending on HAL_LAZY_DRIVERS. The
+ * low level initialization is counted through the linker wrapper of
+ * sd_lld_init(), it must be performed exactly once.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hal.h"
+#include "uartmodel.h"
+
+#define CHECK(c)        check((c), #c, __LINE__)
+
+#define TEST_BAUD       115200U
+
+#define LAZY            ((HAL_LAZY_DRIVERS & HAL_DRV_SERIAL) != 0U)
+
+static const SerialConfig cfg = {
+  TEST_BAUD
+};
+
+static unsigned failures;
+static unsigned lld_inits;
+
+void __real_sd_lld_init(void);
+
+void __wrap_sd_lld_init(void) {
+
+  lld_inits++;
+  __real_sd_lld_init();
+}
+
+void hal_lld_init(void) {
+}
+
+void boardInit(void) {
+}
+
+void stInit(void) {
+}
+
+static void check(bool c, const char *s, int line) {
+
+  if (!c) {
+    printf("  FAILED at line %d: %s\n", line, s);
+    failures++;
+  }
+}
+
+/*
+ * Number of sdInit() records, the lazy flag must match the mask.
+ */
+static unsigned init_records(void) {
+  const hal_init_stats_t *sp;
+  unsigned i, n, found = 0U;
+
+  sp = halGetInitStats(&n);
+  for (i = 0U; i < n; i++) {
+    if (strcmp(sp[i].name, "sdInit") == 0) {
+      CHECK(sp[i].lazy == LAZY);
+      found++;
+    }
+  }
+  return found;
+}
+
+int main(void) {
+  uint8_t buf[4];
+  int i;
+
+  printf("serial driver initialized %s\n", LAZY ? "on first use" : "eagerly");
+
+  halInit();
+  CHECK(lld_inits == (LAZY ? 0U : 1U));
+  CHECK(init_records() == (LAZY ? 0U : 1U));
+
+  for (i = 0; i < 3; i++) {
+    uartModelReset(TEST_BAUD);
+    sdStart(&SD1, &cfg);
+    CHECK(lld_inits == 1U);
+    CHECK(init_records() == 1U);
+
+    /* The driver works after the initialization on first use.*/
+    uartModelSend((const uint8_t *)"abc", 3U, 0U);
+    CHECK(sdReadTimeout(&SD1, buf, 3U, OSAL_MS2ST(10)) == 3U);
+    CHECK(memcmp(buf, "abc", 3U) == 0);
+    sdStop(&SD1);
+  }
+
+  if (failures > 0U) {
+    printf("%u failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  return 0;
+}
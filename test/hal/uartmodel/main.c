@@ -0,0 +1,295 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Kinetis serial driver frames receive and input queue watermark tests
+ * against the UART model.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hal.h"
+#include "uartmodel.h"
+
+#define CHECK(c)        check((c), #c, __LINE__)
+
+#define TEST_BAUD       115200U
+#define TEST_FRAMES     50U
+#define TEST_READ_MAX   32U
+#define TEST_STREAM     1024U
+#define TEST_CHUNK      64U
+
+static const SerialConfig cfg = {
+  TEST_BAUD
+};
+
+static unsigned failures;
+static uint8_t frames[TEST_FRAMES][TEST_READ_MAX];
+static size_t lengths[TEST_FRAMES];
+
+static void check(bool c, const char *s, int line) {
+
+  if (!c) {
+    printf("  FAILED at line %d: %s\n", line, s);
+    failures++;
+  }
+}
+
+static void restart(void) {
+
+  sdStop(&SD1);
+  uartModelReset(TEST_BAUD);
+  sdStart(&SD1, &cfg);
+}
+
+static void make_frames(void) {
+  unsigned i, j, seed = 1U;
+
+  for (i = 0U; i < TEST_FRAMES; i++) {
+    seed = seed * 1103515245U + 12345U;
+    lengths[i] = 1U + (seed >> 16) % 24U;
+    for (j = 0U; j < lengths[i]; j++) {
+      frames[i][j] = (uint8_t)(i * 7U + j);
+    }
+  }
+}
+
+static void send_frames(unsigned first, unsigned n, uint32_t gap) {
+
+  while (n > 0U) {
+    uartModelSend(frames[first], lengths[first], gap);
+    first++;
+    n--;
+  }
+}
+
+static void test_frames(void) {
+  uint8_t buf[TEST_READ_MAX];
+  unsigned i;
+  size_t n;
+  bool ok = true;
+
+  printf("%u frames, 2 characters gap, reader waiting\n", TEST_FRAMES);
+
+  restart();
+  send_frames(0U, TEST_FRAMES, 2U);
+  for (i = 0U; i < TEST_FRAMES; i++) {
+    n = sdReadFrameTimeout(&SD1, buf, TEST_READ_MAX, TIME_INFINITE);
+    if ((n != lengths[i]) || (memcmp(buf, frames[i], n) != 0)) {
+      ok = false;
+    }
+  }
+  CHECK(ok);
+  CHECK(uart_model_stats.frame_ends == TEST_FRAMES);
+  CHECK(uart_model_stats.wakeups == TEST_FRAMES);
+  printf("  %lu bytes, %lu interrupts, %lu reader wakeups\n",
+         uart_model_stats.bytes, uart_model_stats.isrs,
+         uart_model_stats.wakeups);
+}
+
+static void test_bytes_reader(void) {
+  unsigned i, j;
+  bool ok = true;
+
+  printf("same frames, byte by byte reader\n");
+
+  restart();
+  send_frames(0U, TEST_FRAMES, 2U);
+  for (i = 0U; i < TEST_FRAMES; i++) {
+    for (j = 0U; j < lengths[i]; j++) {
+      if (sdGet(&SD1) != frames[i][j]) {
+        ok = false;
+      }
+    }
+  }
+  CHECK(ok);
+  CHECK(uart_model_stats.wakeups == uart_model_stats.bytes);
+  printf("  %lu bytes, %lu interrupts, %lu reader wakeups\n",
+         uart_model_stats.bytes, uart_model_stats.isrs,
+         uart_model_stats.wakeups);
+}
+
+static void test_long_frame(void) {
+  uint8_t frame[40], buf[16];
+  unsigned i;
+
+  printf("40 bytes frame read 16 bytes at time\n");
+
+  for (i = 0U; i < sizeof frame; i++) {
+    frame[i] = (uint8_t)(0x80U + i);
+  }
+  restart();
+  uartModelSend(frame, sizeof frame, 0U);
+
+  CHECK(sdReadFrameTimeout(&SD1, buf, 16U, TIME_INFINITE) == 16U);
+  CHECK(memcmp(buf, &frame[0], 16U) == 0);
+  CHECK(sdReadFrameTimeout(&SD1, buf, 16U, TIME_INFINITE) == 16U);
+  CHECK(memcmp(buf, &frame[16], 16U) == 0);
+  CHECK(sdReadFrameTimeout(&SD1, buf, 16U, TIME_INFINITE) == 8U);
+  CHECK(memcmp(buf, &frame[32], 8U) == 0);
+  CHECK(uart_model_stats.wakeups == 3U);
+  CHECK(uart_model_stats.frame_ends == 1U);
+}
+
+static void test_late_reader(void) {
+  uint8_t buf[TEST_READ_MAX * 4U];
+  size_t n;
+  unsigned i;
+
+  printf("6 frames queued before reading, %u tracked\n",
+         SERIAL_FRAMES_NUMBER);
+
+  restart();
+  send_frames(0U, 6U, 3U);
+  osalThreadSleep(OSAL_MS2ST(50));
+  CHECK(uart_model_stats.frame_ends == 6U);
+
+  for (i = 0U; i < SERIAL_FRAMES_NUMBER - 1U; i++) {
+    n = sdReadFrameTimeout(&SD1, buf, sizeof buf, TIME_IMMEDIATE);
+    CHECK((n == lengths[i]) && (memcmp(buf, frames[i], n) == 0));
+  }
+
+  /* The frames beyond the tracked number are merged into the last one.*/
+  n = sdReadFrameTimeout(&SD1, buf, sizeof buf, TIME_IMMEDIATE);
+  CHECK(n == lengths[3] + lengths[4] + lengths[5]);
+  CHECK(memcmp(buf, frames[3], lengths[3]) == 0);
+  CHECK(memcmp(&buf[lengths[3] + lengths[4]], frames[5], lengths[5]) == 0);
+  CHECK(uart_model_stats.wakeups == 0U);
+}
+
+static void test_short_gap(void) {
+  static const uint8_t a[] = {1, 2, 3}, b[] = {4, 5};
+  uint8_t buf[8];
+
+  printf("gap shorter than a character, no frame end\n");
+
+  restart();
+  uartModelSend(a, sizeof a, 0U);
+  uartModelSend(b, sizeof b, 0U);
+  CHECK(sdReadFrameTimeout(&SD1, buf, sizeof buf, TIME_INFINITE) == 5U);
+  CHECK(memcmp(buf, "\1\2\3\4\5", 5U) == 0);
+  CHECK(uart_model_stats.frame_ends == 1U);
+}
+
+static void test_count_and_timeout(void) {
+  static const uint8_t a[] = {1, 2, 3, 4, 5};
+  uint8_t buf[TEST_READ_MAX];
+  uint64_t t;
+
+  printf("bytes count wakeup and timeouts\n");
+
+  restart();
+  CHECK(sdReadFrameTimeout(&SD1, buf, 4U, TIME_IMMEDIATE) == 0U);
+  t = uartModelNow();
+  CHECK(sdReadFrameTimeout(&SD1, buf, 4U, OSAL_MS2ST(10)) == 0U);
+  CHECK(uartModelNow() - t == 10000000U);
+
+  /* Woken by the third byte, before the end of the frame.*/
+  uartModelSend(a, sizeof a, 0U);
+  CHECK(sdReadFrameTimeout(&SD1, buf, 3U, TIME_INFINITE) == 3U);
+  CHECK(uart_model_stats.bytes == 3U);
+  CHECK(memcmp(buf, a, 3U) == 0);
+  CHECK(sdReadFrameTimeout(&SD1, buf, 3U, TIME_INFINITE) == 2U);
+  CHECK(memcmp(buf, &a[3], 2U) == 0);
+  CHECK(uart_model_stats.frame_ends == 1U);
+
+  /* Nothing consumed on timeout, the frame lasts about 2ms.*/
+  uartModelSend(frames[0], 20U, 0U);
+  CHECK(sdReadFrameTimeout(&SD1, buf, sizeof buf, OSAL_MS2ST(1)) == 0U);
+  CHECK((uart_model_stats.bytes > 0U) && (uart_model_stats.bytes < 20U));
+  CHECK(sdReadFrameTimeout(&SD1, buf, sizeof buf, TIME_INFINITE) == 20U);
+  CHECK(memcmp(buf, frames[0], 20U) == 0);
+}
+
+/*
+ * Reads a continuous 1KB stream in chunks, returns the reader wakeups.
+ */
+static unsigned long stream_wakeups(size_t wm) {
+  static uint8_t stream[TEST_STREAM], buf[TEST_STREAM];
+  unsigned i;
+
+  for (i = 0U; i < TEST_STREAM; i++) {
+    stream[i] = (uint8_t)(i * 13U);
+  }
+  restart();
+  osalSysLock();
+  iqSetWatermarkI(&SD1.iqueue, wm);
+  osalSysUnlock();
+  uartModelSend(stream, TEST_STREAM, 0U);
+  for (i = 0U; i < TEST_STREAM; i += TEST_CHUNK) {
+    CHECK(sdReadTimeout(&SD1, &buf[i], TEST_CHUNK, TIME_INFINITE) ==
+          TEST_CHUNK);
+  }
+  CHECK(memcmp(buf, stream, TEST_STREAM) == 0);
+  printf("  watermark %2u: %lu reader wakeups per KB\n",
+         (unsigned)wm, uart_model_stats.wakeups);
+
+  return uart_model_stats.wakeups;
+}
+
+static void test_watermark(void) {
+  static const uint8_t a[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  uint8_t buf[TEST_CHUNK];
+  uint64_t t;
+
+  printf("input queue watermark, %u bytes reads\n", TEST_CHUNK);
+
+  CHECK(stream_wakeups(1U) == TEST_STREAM);
+  CHECK(stream_wakeups(TEST_CHUNK / 2U) <= 2U * TEST_STREAM / TEST_CHUNK);
+  CHECK(stream_wakeups(TEST_CHUNK) <= TEST_STREAM / TEST_CHUNK);
+
+  /* Short read woken by the remaining count, not the watermark.*/
+  restart();
+  osalSysLock();
+  iqSetWatermarkI(&SD1.iqueue, TEST_CHUNK);
+  osalSysUnlock();
+  uartModelSend(a, sizeof a, 0U);
+  CHECK(sdReadTimeout(&SD1, buf, 4U, TIME_INFINITE) == 4U);
+  CHECK(uart_model_stats.wakeups == 1U);
+
+  /* The watermark is not reached, the data is returned on timeout.*/
+  t = uartModelNow();
+  CHECK(sdReadTimeout(&SD1, buf, TEST_CHUNK, OSAL_MS2ST(5)) == 6U);
+  CHECK(memcmp(buf, &a[4], 6U) == 0);
+  CHECK(uartModelNow() - t == 5000000U);
+}
+
+int main(void) {
+
+  make_frames();
+  uartModelReset(TEST_BAUD);
+  sdInit();
+  sdStart(&SD1, &cfg);
+
+  test_frames();
+  test_bytes_reader();
+  test_long_frame();
+  test_late_reader();
+  test_short_gap();
+  test_count_and_timeout();
+  test_watermark();
+
+  sdStop(&SD1);
+
+  if (failures > 0U) {
+    printf("%u failures\n", failures);
+    return 1;
+  }
+  printf("all tests passed\n");
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Host OSAL for the UART model tests.
+ *
+ * There is a single thread and no real interrupts, the interrupt handler
+ * is invoked by the UART model. A thread that has to wait runs the model
+ * until it is dequeued by the handler or its timeout expires, time is the
+ * model time. An infinite wait while the model has nothing left to do is
+ * a deadlock and halts the test.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "uartmodel.h"
+
+const char *osal_halt_msg;
+
+static threads_queue_t *waiting_on;
+static msg_t wakeup_msg;
+
+static uint64_t deadline(systime_t timeout) {
+
+  if (timeout == TIME_INFINITE) {
+    return UINT64_MAX;
+  }
+  return uartModelNow() +
+         (uint64_t)timeout * 1000000000ULL / OSAL_ST_FREQUENCY;
+}
+
+void osalInit(void) {
+}
+
+void osalSysHalt(const char *reason) {
+
+  osal_halt_msg = reason;
+  fprintf(stderr, "halted: %s\n", reason);
+  exit(1);
+}
+
+void osalSysPolledDelayX(rtcnt_t cycles) {
+
+  (void)cycles;
+}
+
+void osalOsTimerHandlerI(void) {
+}
+
+void osalOsRescheduleS(void) {
+}
+
+systime_t osalOsGetSystemTimeX(void) {
+
+  return (systime_t)(uartModelNow() * OSAL_ST_FREQUENCY / 1000000000ULL);
+}
+
+void osalThreadSleepS(systime_t time) {
+  uint64_t end = deadline(time);
+
+  while (uartModelRun(end)) {
+  }
+}
+
+void osalThreadSleep(systime_t time) {
+
+  osalThreadSleepS(time);
+}
+
+msg_t osalThreadSuspendS(thread_reference_t *trp) {
+
+  return osalThreadSuspendTimeoutS(trp, TIME_INFINITE);
+}
+
+msg_t osalThreadSuspendTimeoutS(thread_reference_t *trp, systime_t timeout) {
+
+  (void)trp;
+  (void)timeout;
+  osalSysHalt("suspend not supported");
+  return MSG_RESET;
+}
+
+void osalThreadResumeI(thread_reference_t *trp, msg_t msg) {
+
+  (void)trp;
+  (void)msg;
+}
+
+void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
+
+  osalThreadResumeI(trp, msg);
+}
+
+msg_t osalThreadEnqueueTimeoutS(threads_queue_t *tqp, systime_t timeout) {
+  uint64_t end;
+
+  if (timeout == TIME_IMMEDIATE) {
+    return MSG_TIMEOUT;
+  }
+
+  end = deadline(timeout);
+  waiting_on = tqp;
+  while (waiting_on != NULL) {
+    if (!uartModelRun(end)) {
+      if (timeout == TIME_INFINITE) {
+        osalSysHalt("deadlock, the UART model is stuck");
+      }
+      waiting_on = NULL;
+      return MSG_TIMEOUT;
+    }
+  }
+  uart_model_stats.wakeups++;
+
+  return wakeup_msg;
+}
+
+void osalThreadDequeueNextI(threads_queue_t *tqp, msg_t msg) {
+
+  if (waiting_on == tqp) {
+    waiting_on = NULL;
+    wakeup_msg = msg;
+  }
+}
+
+void osalThreadDequeueAllI(threads_queue_t *tqp, msg_t msg) {
+
+  osalThreadDequeueNextI(tqp, msg);
+}
+
+void osalEventBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
+
+  if ((flags & CHN_FRAME_END) != 0U) {
+    uart_model_stats.frame_ends++;
+  }
+  esp->flags |= flags;
+  if (esp->cb != NULL) {
+    esp->cb(esp);
+  }
+}
+
+void osalEventBroadcastFlags(event_source_t *esp, eventflags_t flags) {
+
+  osalEventBroadcastFlagsI(esp, flags);
+}
+
+void osalEventSetCallback(event_source_t *esp,
+                          eventcallback_t cb,
+                          void *param) {
+
+  esp->cb    = cb;
+  esp->param = param;
+}
+
+void osalMutexLock(mutex_t *mp) {
+
+  *mp = 1;
+}
+
+void osalMutexUnlock(mutex_t *mp) {
+
+  *mp = 0;
+}
@@ -0,0 +1,162 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Receive side model of the KL02x UART0, see uartmodel.h.
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "uartmodel.h"
+
+#define NEVER                       UINT64_MAX
+
+UARTLP_TypeDef uart_model_uart0;
+SIM_TypeDef uart_model_sim;
+
+uart_model_stats_t uart_model_stats;
+
+OSAL_IRQ_HANDLER(Vector70);
+
+static struct {
+  uint64_t              t;              /* End of the stop bit.             */
+  uint8_t               b;
+} line[UART_MODEL_LINE_SIZE];
+static size_t line_head, line_tail;
+static uint64_t line_end;               /* Last scheduled stop bit.         */
+static uint64_t idle_time;              /* Pending idle line condition.     */
+static uint64_t char_ns;
+static uint64_t now;
+static bool vector_enabled;
+
+static bool receiving(void) {
+
+  return vector_enabled &&
+         ((uart_model_sim.SCGC4 & SIM_SCGC4_UART0) != 0U) &&
+         ((uart_model_uart0.C2 & UARTx_C2_RE) != 0U);
+}
+
+static void invoke_isr(uint8_t s1, uint8_t enable) {
+
+  if ((uart_model_uart0.C2 & enable) == 0U) {
+    return;
+  }
+  uart_model_uart0.S1 = s1;
+  uart_model_stats.isrs++;
+  Vector70();
+}
+
+void nvicEnableVector(uint32_t n, uint32_t prio) {
+
+  (void)prio;
+  if (n == UART0_IRQn) {
+    vector_enabled = true;
+  }
+}
+
+void nvicDisableVector(uint32_t n) {
+
+  if (n == UART0_IRQn) {
+    vector_enabled = false;
+  }
+}
+
+void uartModelReset(uint32_t baud) {
+
+  memset(&uart_model_uart0, 0, sizeof uart_model_uart0);
+  memset(&uart_model_sim, 0, sizeof uart_model_sim);
+  memset(&uart_model_stats, 0, sizeof uart_model_stats);
+  line_head = line_tail = 0U;
+  line_end = 0U;
+  idle_time = NEVER;
+  char_ns = 10ULL * 1000000000ULL / baud;
+  now = 0U;
+  vector_enabled = false;
+}
+
+/*
+ * Schedules bytes on the line, the first one starts after the previous
+ * ones plus the specified gap in character times.
+ */
+void uartModelSend(const uint8_t *p, size_t n, uint32_t gap_chars) {
+  uint64_t t = (line_end > now ? line_end : now) + gap_chars * char_ns;
+
+  /* A start bit before the idle time cancels the idle condition.*/
+  if ((n > 0U) && (t < idle_time)) {
+    idle_time = NEVER;
+  }
+  while (n > 0U) {
+    if (line_tail >= UART_MODEL_LINE_SIZE) {
+      osalSysHalt("line buffer full");
+    }
+    t += char_ns;
+    line[line_tail].t = t;
+    line[line_tail].b = *p++;
+    line_tail++;
+    n--;
+  }
+  line_end = t;
+}
+
+uint64_t uartModelNow(void) {
+
+  return now;
+}
+
+/*
+ * Processes the next event if it happens before the limit, else the time
+ * is advanced to the limit.
+ */
+bool uartModelRun(uint64_t limit) {
+  uint64_t t = line_head < line_tail ? line[line_head].t : NEVER;
+
+  if (idle_time < t) {
+    t = idle_time;
+  }
+  if ((t == NEVER) || (t > limit)) {
+    if (limit != NEVER) {
+      now = limit;
+    }
+    return false;
+  }
+  now = t;
+
+  if (t == idle_time) {
+    idle_time = NEVER;
+    uart_model_stats.idles++;
+    if (receiving()) {
+      invoke_isr(UARTx_S1_IDLE, UARTx_C2_ILIE);
+    }
+    return true;
+  }
+
+  /* The idle time is one character after the stop bit, cancelled if the
+     next start bit comes earlier.*/
+  line_head++;
+  if ((line_head < line_tail) && (line[line_head].t - char_ns < t + char_ns)) {
+    idle_time = NEVER;
+  }
+  else {
+    idle_time = t + char_ns;
+  }
+  if (receiving()) {
+    uart_model_stats.bytes++;
+    uart_model_uart0.D = line[line_head - 1U].b;
+    invoke_isr(UARTx_S1_RDRF, UARTx_C2_RIE);
+  }
+  return true;
+}
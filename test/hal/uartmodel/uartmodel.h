@@ -0,0 +1,50 @@
+/*
+    ChibiOS - Copyright (C) 2006..2015 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _UARTMODEL_H_
+#define _UARTMODEL_H_
+
+/*
+ * Receive side model of the KL02x UART0. Bytes are delivered at the line
+ * rate, the idle line flag is raised one character time after the last
+ * stop bit, interrupts are served immediately.
+ */
+
+/* Maximum number of bytes scheduled on the line.*/
+#define UART_MODEL_LINE_SIZE        4096U
+
+typedef struct {
+  unsigned long         bytes;          /* Bytes received.                  */
+  unsigned long         idles;          /* Idle line conditions raised.     */
+  unsigned long         isrs;           /* Interrupt handler invocations.   */
+  unsigned long         wakeups;        /* Threads woken.                   */
+  unsigned long         frame_ends;     /* CHN_FRAME_END broadcasts.        */
+} uart_model_stats_t;
+
+extern uart_model_stats_t uart_model_stats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void uartModelReset(uint32_t baud);
+  void uartModelSend(const uint8_t *p, size_t n, uint32_t gap_chars);
+  uint64_t uartModelNow(void);
+  bool uartModelRun(uint64_t limit);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UARTMODEL_H_ */
@@ -49,6 +49,9 @@
  * - @subpage test_benchmarks_011
  * - @subpage test_benchmarks_012
  * - @subpage test_benchmarks_013
+ * - @subpage test_benchmarks_014
+ * - @subpage test_benchmarks_015
+ * - @subpage test_benchmarks_016
  * .
  * @file testbmk.c Kernel Benchmarks
  * @brief Kernel Benchmarks source file
@@ -690,6 +693,242 @@ ROMCONST struct testcase testbmk13 = {
   bmk13_execute
 };
 
+/**
+ * @page test_benchmarks_014 Minimum working area
+ *
+ * <h2>Description</h2>
+ * A thread that only spins is started in a working area filled with a
+ * known pattern, the tester thread is awakened by the system tick and
+ * preempts it from the interrupt, this is the case covered by the port
+ * interrupt reserve. The part of the stack that has been overwritten must
+ * fit in the fixed part of the working area declared by the port, which
+ * includes @p PORT_INT_REQUIRED_STACK. The printed value is the minimum
+ * working area of a thread for the current configuration and port, the
+ * size declared by the port for an empty stack is printed for comparison.
+ */
+
+static THD_FUNCTION(thread14, p) {
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+static void bmk14_execute(void) {
+  uint8_t *base = (uint8_t *)wa[0] + sizeof(thread_t);
+  uint8_t *end = (uint8_t *)wa[0] + WA_SIZE;
+  uint8_t *p;
+
+  for (p = (uint8_t *)wa[0]; p < end; p++)
+    *p = CH_DBG_STACK_FILL_VALUE;
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() - 1,
+                                 thread14, NULL);
+  chThdSleep(2);
+  chThdTerminate(threads[0]);
+  test_wait_threads();
+
+  /* The stack grows downward, the painted part is above the thread
+     structure.*/
+  p = base;
+  while ((p < end) && (*p == CH_DBG_STACK_FILL_VALUE))
+    p++;
+  test_assert(1, p > base, "stack overflow");
+  test_assert(2, (size_t)(end - p) <= PORT_WA_SIZE(0), "reserve exceeded");
+
+  test_print("--- WA min: ");
+  test_printn(sizeof(thread_t) + (uint32_t)(end - p));
+  test_println(" bytes");
+  test_print("--- WA(0) : ");
+  test_printn(THD_WORKING_AREA_SIZE(0));
+  test_println(" bytes");
+}
+
+ROMCONST struct testcase testbmk14 = {
+  "Benchmark, minimum working area",
+  NULL,
+  NULL,
+  bmk14_execute
+};
+
+/**
+ * @page test_benchmarks_015 Threads performance, table creation
+ *
+ * <h2>Description</h2>
+ * Four threads with priority higher than the tester thread are created and
+ * terminated into a loop, first using @p chThdCreateStatic() then using
+ * @p chThdCreateTable(), the latter performs a single reschedule for all
+ * the threads as @p chSysInit() does at startup.<br>
+ * The performance is calculated by measuring the number of iterations after
+ * a second of continuous operations.
+ */
+
+static uint32_t bmk15_loop(const thread_descriptor_t *table) {
+  uint32_t n = 0;
+  int i;
+
+  test_wait_tick();
+  test_start_timer(1000);
+  do {
+    if (table != NULL) {
+      chThdCreateTable(table);
+    }
+    else {
+      for (i = 0; i < 4; i++) {
+        (void) chThdCreateStatic(wa[i], WA_SIZE,
+                                 chThdGetPriorityX() + 1, thread1, NULL);
+      }
+    }
+    for (i = 0; i < 4; i++) {
+      (void) chThdWait((thread_t *)wa[i]);
+    }
+    n += 4;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (!test_timer_done);
+
+  return n;
+}
+
+static void bmk15_execute(void) {
+  tprio_t prio = chThdGetPriorityX() + 1;
+  const thread_descriptor_t table[] = {
+    THD_TABLE_ENTRY(test.wa.T0, NULL, prio, thread1, NULL)
+    THD_TABLE_ENTRY(test.wa.T1, NULL, prio, thread1, NULL)
+    THD_TABLE_ENTRY(test.wa.T2, NULL, prio, thread1, NULL)
+    THD_TABLE_ENTRY(test.wa.T3, NULL, prio, thread1, NULL)
+    THD_TABLE_TERMINATOR
+  };
+
+  test_print("--- Static: ");
+  test_printn(bmk15_loop(NULL));
+  test_println(" threads/S");
+  test_print("--- Table : ");
+  test_printn(bmk15_loop(table));
+  test_println(" threads/S");
+}
+
+ROMCONST struct testcase testbmk15 = {
+  "Benchmark, threads table",
+  NULL,
+  NULL,
+  bmk15_execute
+};
+
+#if CH_CFG_USE_QUEUES || defined(__DOXYGEN__)
+/**
+ * @page test_benchmarks_016 I/O Queues wakeups
+ *
+ * <h2>Description</h2>
+ * A thread with priority higher than the tester thread reads 1024 bytes
+ * from an @p input_queue_t in 64 bytes blocks, the tester thread puts the
+ * bytes one at time from a lock zone as a driver would do. The same is
+ * then done with a writer thread and an @p output_queue_t.<br>
+ * The context switches per KB are counted with the default watermark and
+ * with a 64 bytes watermark.
+ */
+
+#define BMK16_BLOCK     64U
+
+static uint8_t bmk16_buf[BMK16_BLOCK * 2U];
+
+static THD_FUNCTION(bmk16_reader, p) {
+  uint8_t b[BMK16_BLOCK];
+  unsigned i;
+
+  for (i = 0; i < 1024U / BMK16_BLOCK; i++)
+    (void) chIQReadTimeout((input_queue_t *)p, b, BMK16_BLOCK, TIME_INFINITE);
+}
+
+static THD_FUNCTION(bmk16_writer, p) {
+  uint8_t b[BMK16_BLOCK] = {0};
+  unsigned i;
+
+  for (i = 0; i < 1024U / BMK16_BLOCK; i++)
+    (void) chOQWriteTimeout((output_queue_t *)p, b, BMK16_BLOCK, TIME_INFINITE);
+}
+
+static uint32_t bmk16_input(size_t wm) {
+  static input_queue_t iq;
+  uint32_t n = 0;
+  size_t before;
+  unsigned i;
+
+  chIQObjectInit(&iq, bmk16_buf, sizeof(bmk16_buf), NULL, NULL);
+  chSysLock();
+  chIQSetWatermarkI(&iq, wm);
+  chSysUnlock();
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                 bmk16_reader, &iq);
+  for (i = 0; i < 1024U; i++) {
+    chSysLock();
+    before = chQSpaceI(&iq);
+    (void) chIQPutI(&iq, (uint8_t)i);
+    chSchRescheduleS();
+    /* The reader ran if the data did not grow, a switch in and out.*/
+    if (chQSpaceI(&iq) <= before)
+      n += 2;
+    chSysUnlock();
+  }
+  test_wait_threads();
+
+  return n;
+}
+
+static uint32_t bmk16_output(size_t wm) {
+  static output_queue_t oq;
+  uint32_t n = 0;
+  size_t before;
+  unsigned i;
+
+  chOQObjectInit(&oq, bmk16_buf, sizeof(bmk16_buf), NULL, NULL);
+  chSysLock();
+  chOQSetWatermarkI(&oq, wm);
+  chSysUnlock();
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                 bmk16_writer, &oq);
+  for (i = 0; i < 1024U; i++) {
+    chSysLock();
+    before = chQSpaceI(&oq);
+    (void) chOQGetI(&oq);
+    chSchRescheduleS();
+    /* The writer ran if the free space did not grow.*/
+    if (chQSpaceI(&oq) <= before)
+      n += 2;
+    chSysUnlock();
+  }
+  test_wait_threads();
+
+  return n;
+}
+
+static void bmk16_execute(void) {
+
+  test_print("--- Input  WM 1 : ");
+  test_printn(bmk16_input(1U));
+  test_println(" ctxsw/KB");
+  test_print("--- Input  WM 64: ");
+  test_printn(bmk16_input(BMK16_BLOCK));
+  test_println(" ctxsw/KB");
+  test_print("--- Output WM 1 : ");
+  test_printn(bmk16_output(1U));
+  test_println(" ctxsw/KB");
+  test_print("--- Output WM 64: ");
+  test_printn(bmk16_output(BMK16_BLOCK));
+  test_println(" ctxsw/KB");
+}
+
+ROMCONST struct testcase testbmk16 = {
+  "Benchmark, I/O Queues wakeups",
+  NULL,
+  NULL,
+  bmk16_execute
+};
+#endif /* CH_CFG_USE_QUEUES */
+
 /**
  * @brief   Test sequence for benchmarks.
  */
@@ -718,6 +957,11 @@ ROMCONST struct testcase * ROMCONST patternbmk[] = {
   &testbmk12,
 #endif
   &testbmk13,
+  &testbmk14,
+  &testbmk15,
+#if CH_CFG_USE_QUEUES || defined(__DOXYGEN__)
+  &testbmk16,
+#endif
 #endif
   NULL
 };
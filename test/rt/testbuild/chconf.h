@@ -104,6 +104,18 @@
 #define CH_CFG_MEMCORE_SIZE                 0x20000
 #endif
 
+/**
+ * @brief   Attributes of the default core memory region.
+ * @details Placement hints, @p MEM_FAST, @p MEM_DMA and @p MEM_RETAINED,
+ *          describing the memory managed by default.
+ *
+ * @note    The default is @p MEM_DMA.
+ * @note    Requires @p CH_CFG_USE_MEMCORE_REGIONS.
+ */
+#if !defined(CH_CFG_MEMCORE_DEFAULT_FLAGS) || defined(__DOXIGEN__)
+#define CH_CFG_MEMCORE_DEFAULT_FLAGS        MEM_DMA
+#endif
+
 /**
  * @brief   Idle thread automatic spawn suppression.
  * @details When this option is activated the function @p chSysInit()
@@ -115,6 +127,18 @@
 #define CH_CFG_NO_IDLE_THREAD               FALSE
 #endif
 
+/**
+ * @brief   Static threads table.
+ * @details If enabled then @p chSysInit() creates the threads declared by
+ *          the application using @p THD_TABLE_BEGIN, @p THD_TABLE_ENTRY()
+ *          and @p THD_TABLE_END.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_THREAD_TABLE) || defined(__DOXIGEN__)
+#define CH_CFG_USE_THREAD_TABLE             FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -136,6 +160,19 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Compact threads layout.
+ * @details If enabled then the @p thread_t structure is laid out for size,
+ *          priorities are stored as 8 bits values and packed with the
+ *          thread state and flags. With @p CH_CFG_ST_RESOLUTION set to 16
+ *          the profiling time counter is packed too.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_COMPACT_THREADS) || defined(__DOXIGEN__)
+#define CH_CFG_COMPACT_THREADS              FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -156,6 +193,17 @@
 #define CH_CFG_USE_TM                       TRUE
 #endif
 
+/**
+ * @brief   Time Measurement histograms.
+ * @details If enabled then log-scale histograms can be attached to the
+ *          time measurement objects.
+ * @note    The default is @p CH_CFG_USE_TM.
+ * @note    Requires @p CH_CFG_USE_TM.
+ */
+#if !defined(CH_CFG_USE_TM_HISTOGRAM) || defined(__DOXIGEN__)
+#define CH_CFG_USE_TM_HISTOGRAM             CH_CFG_USE_TM
+#endif
+
 /**
  * @brief   Threads registry APIs.
  * @details If enabled then the registry APIs are included in the kernel.
@@ -314,6 +362,16 @@
 #define CH_CFG_USE_QUEUES                   TRUE
 #endif
 
+/**
+ * @brief   Pipes APIs.
+ * @details If enabled then the pipes APIs are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_PIPES) || defined(__DOXIGEN__)
+#define CH_CFG_USE_PIPES                    TRUE
+#endif
+
 /**
  * @brief   Core Memory Manager APIs.
  * @details If enabled then the core memory manager APIs are included
@@ -325,6 +383,19 @@
 #define CH_CFG_USE_MEMCORE                  TRUE
 #endif
 
+/**
+ * @brief   Multiple core memory regions.
+ * @details If enabled then further memory regions, with attributes, can
+ *          be added to the core allocator and allocations can specify
+ *          placement hints.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_USE_MEMCORE_REGIONS) || defined(__DOXIGEN__)
+#define CH_CFG_USE_MEMCORE_REGIONS          TRUE
+#endif
+
 /**
  * @brief   Heap Allocator APIs.
  * @details If enabled then the memory heap allocator APIs are included
@@ -350,6 +421,80 @@
 #define CH_CFG_USE_MEMPOOLS                 TRUE
 #endif
 
+/**
+ * @brief   Lock-free memory pools.
+ * @details If enabled, and if the port supports exclusive load/store
+ *          operations, then the memory pools are updated without entering
+ *          critical zones.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MEMPOOLS.
+ * @note    Ports without exclusive load/store operations ignore this option.
+ */
+#if !defined(CH_CFG_USE_LOCKFREE_POOLS) || defined(__DOXIGEN__)
+#define CH_CFG_USE_LOCKFREE_POOLS           TRUE
+#endif
+
+/**
+ * @brief   Memory Arenas APIs.
+ * @details If enabled then the memory arenas allocator APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p CH_CFG_USE_MEMCORE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_USE_ARENAS) || defined(__DOXIGEN__)
+#define CH_CFG_USE_ARENAS                   CH_CFG_USE_MEMCORE
+#endif
+
+/**
+ * @brief   Per-thread default memory arenas.
+ * @details If enabled then each thread has a default arena, used when
+ *          @p NULL is passed to @p chArenaAlloc().
+ *
+ * @note    The default is @p CH_CFG_USE_ARENAS.
+ * @note    Requires @p CH_CFG_USE_ARENAS.
+ */
+#if !defined(CH_CFG_USE_THREAD_ARENAS) || defined(__DOXIGEN__)
+#define CH_CFG_USE_THREAD_ARENAS            CH_CFG_USE_ARENAS
+#endif
+
+/**
+ * @brief   Slab allocator APIs.
+ * @details If enabled then the slab allocator APIs are included in the
+ *          kernel.
+ *
+ * @note    The default is @p CH_CFG_USE_MEMCORE.
+ * @note    Requires @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_USE_SLABS) || defined(__DOXIGEN__)
+#define CH_CFG_USE_SLABS                    CH_CFG_USE_MEMCORE
+#endif
+
+/**
+ * @brief   Relocatable heaps APIs.
+ * @details If enabled then the handle-based relocatable heaps APIs are
+ *          included in the kernel.
+ *
+ * @note    The default is @p TRUE if the required options are enabled.
+ * @note    Requires @p CH_CFG_USE_MUTEXES, @p CH_CFG_USE_SEMAPHORES and
+ *          @p CH_CFG_USE_MEMCORE.
+ */
+#if !defined(CH_CFG_USE_RELOC_HEAPS) || defined(__DOXIGEN__)
+#define CH_CFG_USE_RELOC_HEAPS              (CH_CFG_USE_MUTEXES &&          \
+                                             CH_CFG_USE_SEMAPHORES &&       \
+                                             CH_CFG_USE_MEMCORE)
+#endif
+
+/**
+ * @brief   Bytes moved by a relocatable heap compactor in a single step.
+ * @details The heap is locked during a step, this value bounds the time
+ *          other threads can be kept waiting.
+ */
+#if !defined(CH_CFG_RHEAP_COMPACT_STEP) || defined(__DOXIGEN__)
+#define CH_CFG_RHEAP_COMPACT_STEP           64
+#endif
+
 /**
  * @brief   Dynamic Threads APIs.
  * @details If enabled then the dynamic threads creation APIs are included
@@ -381,6 +526,17 @@
 #define CH_DBG_STATISTICS                   FALSE
 #endif
 
+/**
+ * @brief   Debug option, lock contention statistics.
+ * @details If enabled then mutexes, semaphores and condition variables
+ *          account acquisitions, contention and wait times.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_DBG_LOCK_STATISTICS) || defined(__DOXIGEN__)
+#define CH_DBG_LOCK_STATISTICS              TRUE
+#endif
+
 /**
  * @brief   Debug option, system state check.
  * @details If enabled the correct call protocol for system APIs is checked
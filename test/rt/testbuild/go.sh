@@ -61,6 +61,18 @@ function misra() {
   echo "OK"
 }
 
+function sizes() {
+  echo -n "  * Sizes..."
+  if ! grep -e "--- Thread:" -e "--- WA min:" reports/${1}_test.txt > sizeslog.txt
+  then
+    echo "failed"
+    clean
+    exit
+  fi
+  sed -e "s/^/${1}: /" sizeslog.txt >> reports/sizes.txt
+  echo "OK"
+}
+
 function test() {
   if [ -z "$2" ]
   then
@@ -73,6 +85,7 @@ function test() {
   echo $msg
   compile $1
   execute_test $1
+  sizes $1
   coverage $1 "$msg"
   misra
   clean
@@ -86,6 +99,7 @@ function partial() {
 }
 
 mkdir reports 2> /dev/null
+rm reports/sizes.txt 2> /dev/null
 
 test cfg1 ""
 test cfg2 "-DCH_CFG_OPTIMIZE_SPEED=FALSE"
@@ -117,6 +131,13 @@ test cfg26 "-DCH_DBG_ENABLE_TRACE=TRUE"
 test cfg28 "-DCH_DBG_FILL_THREADS=TRUE"
 test cfg29 "-DCH_DBG_THREADS_PROFILING=FALSE"
 test cfg30 "-DCH_DBG_SYSTEM_STATE_CHECK=TRUE -DCH_DBG_ENABLE_CHECKS=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE -DCH_DBG_ENABLE_TRACE=TRUE -DCH_DBG_FILL_THREADS=TRUE"
+test cfg31 "-DCH_CFG_COMPACT_THREADS=TRUE"
+test cfg32 "-DCH_CFG_COMPACT_THREADS=TRUE -DCH_CFG_ST_RESOLUTION=16"
+test cfg33 "-DCH_CFG_COMPACT_THREADS=TRUE -DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_TIME_QUANTUM=0 -DCH_CFG_USE_DYNAMIC=FALSE -DCH_CFG_USE_THREAD_ARENAS=FALSE -DCH_DBG_THREADS_PROFILING=FALSE"
+
+echo
+echo "Thread size and minimum working area per configuration:"
+cat reports/sizes.txt
 
 rm *log.txt 2> /dev/null
 echo
@@ -37,6 +37,10 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage test_heap_001
+ * - @subpage test_heap_002
+ * - @subpage test_heap_003
+ * - @subpage test_heap_004
+ * - @subpage test_heap_005
  * .
  * @file testheap.c
  * @brief Heap test source file
@@ -146,6 +150,301 @@ ROMCONST struct testcase testheap1 = {
   heap1_execute
 };
 
+#if CH_CFG_USE_MEMCORE_REGIONS || defined(__DOXYGEN__)
+
+#define REGION_SIZE 256
+
+static memory_region_t test_region;
+static stkalign_t test_region_buffer[REGION_SIZE / sizeof(stkalign_t)];
+
+static bool in_region(void *p, size_t size) {
+
+  return ((uint8_t *)p >= (uint8_t *)test_region_buffer) &&
+         ((uint8_t *)p + size <= (uint8_t *)test_region_buffer + REGION_SIZE);
+}
+
+/**
+ * @page test_heap_002 Core memory regions and placement hints
+ *
+ * <h2>Description</h2>
+ * A retained region is added to the core allocator, allocations with the
+ * @p MEM_RETAINED hint are expected to be served from that region only,
+ * the @p MEM_FAST hint is expected to fall back on any region. A heap
+ * is then created over the retained region using the provider interface.
+ */
+
+static void heap2_setup(void) {
+
+  chCoreAddRegion(&test_region, test_region_buffer,
+                  (uint8_t *)test_region_buffer + REGION_SIZE, MEM_RETAINED);
+}
+
+static void heap2_execute(void) {
+  void *p1, *p2;
+
+  test_assert(1, chCoreGetStatusHintX(MEM_RETAINED) == REGION_SIZE,
+              "wrong region size");
+
+  p1 = chCoreAllocHint(SIZE, MEM_RETAINED);
+  test_assert(2, (p1 != NULL) && in_region(p1, SIZE), "not in region");
+  p2 = chCoreAllocHint(REGION_SIZE, MEM_RETAINED);
+  test_assert(3, p2 == NULL, "allocation not failed");
+  test_assert(4, chCoreGetStatusHintX(MEM_RETAINED) == REGION_SIZE - SIZE,
+              "wrong remaining size");
+
+  /* Fast memory is only a preference.*/
+  p1 = chCoreAllocHint(SIZE, MEM_FAST);
+  test_assert(5, p1 != NULL, "no fallback");
+
+  /* Heap fed by the retained region.*/
+  chHeapObjectInitProvider(&test_heap, chCoreAllocRetained);
+  p1 = chHeapAlloc(&test_heap, SIZE);
+  test_assert(6, (p1 != NULL) && in_region(p1, SIZE), "not in region");
+  chHeapFree(p1);
+}
+
+ROMCONST struct testcase testheap2 = {
+  "Core memory, regions and hints",
+  heap2_setup,
+  NULL,
+  heap2_execute
+};
+
+#endif /* CH_CFG_USE_MEMCORE_REGIONS */
+
+#if CH_CFG_USE_ARENAS || defined(__DOXYGEN__)
+
+static memory_arena_t test_arena;
+
+/**
+ * @page test_heap_003 Arenas, allocation and rollback
+ *
+ * <h2>Description</h2>
+ * An arena is allocated from a heap, allocations are performed until
+ * exhaustion then rolled back to a mark and cleared. Finally the arena is
+ * released and the heap is expected to be back to the initial status.
+ */
+
+static void heap3_setup(void) {
+
+  chHeapObjectInit(&test_heap, test.buffer, sizeof(union test_buffers));
+}
+
+static void heap3_execute(void) {
+  void *p1, *p2, *p3;
+  arenamark_t mark;
+  size_t n, sz;
+
+  (void)chHeapStatus(&test_heap, &sz);
+  test_assert(1, chArenaObjectInitFromHeap(&test_arena, &test_heap,
+                                           SIZE * 4) == &test_arena,
+              "allocation failed");
+  test_assert(2, chArenaGetStatusX(&test_arena) == SIZE * 4, "wrong size");
+
+  /* Bump allocations, aligned and contiguous.*/
+  p1 = chArenaAlloc(&test_arena, 1);
+  mark = chArenaMarkX(&test_arena);
+  p2 = chArenaAlloc(&test_arena, SIZE);
+  test_assert(3, (p1 != NULL) && MEM_IS_ALIGNED(p2) &&
+                 ((uint8_t *)p2 == (uint8_t *)p1 + MEM_ALIGN_SIZE),
+              "wrong allocation");
+  p3 = chArenaAlloc(&test_arena, SIZE * 4);
+  test_assert(4, p3 == NULL, "allocation not failed");
+
+  /* Rollback.*/
+  chArenaResetX(&test_arena, mark);
+  p3 = chArenaAlloc(&test_arena, SIZE);
+  test_assert(5, p3 == p2, "rollback failed");
+  chArenaClearX(&test_arena);
+  test_assert(6, chArenaGetStatusX(&test_arena) == SIZE * 4, "not empty");
+
+#if CH_CFG_USE_THREAD_ARENAS || defined(__DOXYGEN__)
+  /* Default arena of the current thread.*/
+  test_assert(7, chArenaSetDefault(&test_arena) == NULL, "default set");
+  p1 = chArenaAlloc(NULL, SIZE);
+  test_assert(8, p1 == (void *)test_arena.a_base, "wrong default arena");
+  test_assert(9, chArenaSetDefault(NULL) == &test_arena, "wrong default");
+  test_assert(10, chArenaAlloc(NULL, SIZE) == NULL, "allocation not failed");
+#endif
+
+  /* Release, the buffer goes back to the heap.*/
+  chArenaRelease(&test_arena);
+  test_assert(11, chHeapStatus(&test_heap, &n) == 1, "heap fragmented");
+  test_assert(12, n == sz, "heap not restored");
+}
+
+ROMCONST struct testcase testheap3 = {
+  "Arenas, allocation and rollback",
+  heap3_setup,
+  NULL,
+  heap3_execute
+};
+
+#endif /* CH_CFG_USE_ARENAS */
+
+#if CH_CFG_USE_RELOC_HEAPS || defined(__DOXYGEN__)
+
+#define RBLOCK CH_RHEAP_BLOCK_SIZE(SIZE)
+
+static reloc_heap_t test_rheap;
+static rhandle_t test_rhandles[5];
+static stkalign_t test_rbuffer[(4 * RBLOCK) / sizeof (stkalign_t)];
+
+static void rheap_fill(rhandle_t *hp, size_t size, uint8_t c) {
+  uint8_t *p = chRHeapLock(&test_rheap, hp);
+
+  while (size-- > 0)
+    *p++ = c;
+  chRHeapUnlock(&test_rheap, hp);
+}
+
+static bool rheap_check(rhandle_t *hp, size_t size, uint8_t c) {
+  uint8_t *p = chRHeapLock(&test_rheap, hp);
+  bool ok = true;
+
+  while (size-- > 0) {
+    if (*p++ != c)
+      ok = false;
+  }
+  chRHeapUnlock(&test_rheap, hp);
+  return ok;
+}
+
+/**
+ * @page test_heap_004 Relocatable heap, compaction
+ *
+ * <h2>Description</h2>
+ * A relocatable heap is filled then fragmented by freeing alternate
+ * blocks. A locked block is expected to stay in place during compaction,
+ * once unlocked a large allocation is expected to succeed after
+ * compaction and the moved blocks are expected to retain their contents.
+ */
+
+static void heap4_setup(void) {
+
+  chRHeapObjectInit(&test_rheap, test_rhandles, 5,
+                    test_rbuffer, sizeof (test_rbuffer));
+}
+
+static void heap4_execute(void) {
+  rhandle_t *h[4], *hb;
+  rheap_stats_t rs;
+  size_t n;
+  void *p;
+  int i;
+
+  for (i = 0; i < 4; i++) {
+    h[i] = chRHeapAlloc(&test_rheap, SIZE);
+    test_assert(1, h[i] != NULL, "allocation failed");
+    rheap_fill(h[i], SIZE, (uint8_t)('A' + i));
+  }
+  test_assert(2, chRHeapAlloc(&test_rheap, SIZE) == NULL, "not full");
+
+  /* Fragmentation.*/
+  chRHeapFree(&test_rheap, h[0]);
+  chRHeapFree(&test_rheap, h[2]);
+  test_assert(3, chRHeapStatus(&test_rheap, &n, NULL) == SIZE, "not fragmented");
+  test_assert(4, n == 2 * RBLOCK, "wrong free space");
+
+  /* The locked block stays in place, the other one is moved.*/
+  p = chRHeapLock(&test_rheap, h[1]);
+  (void)chRHeapCompact(&test_rheap, 0);
+  test_assert(5, p == h[1]->h_ptr, "locked block moved");
+  hb = chRHeapAlloc(&test_rheap, 2 * RBLOCK - sizeof (union rheap_block));
+  test_assert(6, hb == NULL, "allocation not failed");
+  chRHeapUnlock(&test_rheap, h[1]);
+
+  /* Compaction on allocation.*/
+  hb = chRHeapAlloc(&test_rheap, 2 * RBLOCK - sizeof (union rheap_block));
+  test_assert(7, hb != NULL, "allocation failed");
+  test_assert(8, rheap_check(h[1], SIZE, 'B') && rheap_check(h[3], SIZE, 'D'),
+              "contents lost");
+
+  (void)chRHeapStatus(&test_rheap, &n, &rs);
+  test_assert(9, (n == 0) && (rs.rs_moves >= 2) && (rs.rs_rescues == 1) &&
+                 (rs.rs_failures == 2), "wrong statistics");
+
+  chRHeapFree(&test_rheap, hb);
+  chRHeapFree(&test_rheap, h[1]);
+  chRHeapFree(&test_rheap, h[3]);
+  (void)chRHeapCompact(&test_rheap, 0);
+  (void)chRHeapStatus(&test_rheap, &n, NULL);
+  test_assert(10, n == sizeof (test_rbuffer), "heap not empty");
+}
+
+ROMCONST struct testcase testheap4 = {
+  "Relocatable heap, compaction",
+  heap4_setup,
+  NULL,
+  heap4_execute
+};
+
+/**
+ * @page test_heap_005 Relocatable heap, compactor thread
+ *
+ * <h2>Description</h2>
+ * A compactor thread is started on a relocatable heap, the heap is
+ * fragmented around a locked block. The thread is expected to compact the
+ * holes above the locked block only, once the block is unlocked the thread
+ * is expected to compact the whole heap without further allocations or
+ * frees.
+ */
+
+static void heap5_teardown(void) {
+
+  if (threads[0] != NULL) {
+    chThdTerminate(threads[0]);
+    chBSemSignal(&test_rheap.rh_dirty);
+  }
+}
+
+static void heap5_execute(void) {
+  rhandle_t *h[4];
+  rheap_stats_t rs;
+  size_t n, largest;
+  int i;
+
+  threads[0] = chRHeapStartCompactor(&test_rheap, wa[0], WA_SIZE,
+                                     chThdGetPriorityX() - 1);
+
+  for (i = 0; i < 4; i++) {
+    h[i] = chRHeapAlloc(&test_rheap, SIZE);
+    test_assert(1, h[i] != NULL, "allocation failed");
+    rheap_fill(h[i], SIZE, (uint8_t)('A' + i));
+  }
+
+  /* Only the hole above the locked block can be compacted.*/
+  (void)chRHeapLock(&test_rheap, h[1]);
+  chRHeapFree(&test_rheap, h[0]);
+  chRHeapFree(&test_rheap, h[2]);
+  chThdSleepMilliseconds(10);
+  test_assert(2, chRHeapStatus(&test_rheap, &n, &rs) == SIZE,
+              "locked block moved");
+  test_assert(3, (n == 2 * RBLOCK) && (rs.rs_moves == 1),
+              "hole above the locked block not compacted");
+
+  /* Unlocking the block awakens the compactor.*/
+  chRHeapUnlock(&test_rheap, h[1]);
+  chThdSleepMilliseconds(10);
+  largest = chRHeapStatus(&test_rheap, &n, NULL);
+  test_assert(4, largest == n - sizeof (union rheap_block),
+              "not compacted after unlock");
+  test_assert(5, rheap_check(h[1], SIZE, 'B') && rheap_check(h[3], SIZE, 'D'),
+              "contents lost");
+
+  chRHeapFree(&test_rheap, h[1]);
+  chRHeapFree(&test_rheap, h[3]);
+}
+
+ROMCONST struct testcase testheap5 = {
+  "Relocatable heap, compactor thread",
+  heap4_setup,
+  heap5_teardown,
+  heap5_execute
+};
+
+#endif /* CH_CFG_USE_RELOC_HEAPS */
+
 #endif /* CH_CFG_USE_HEAP.*/
 
 /**
@@ -154,6 +453,16 @@ ROMCONST struct testcase testheap1 = {
 ROMCONST struct testcase * ROMCONST patternheap[] = {
 #if CH_CFG_USE_HEAP || defined(__DOXYGEN__)
   &testheap1,
+#endif
+#if (CH_CFG_USE_HEAP && CH_CFG_USE_MEMCORE_REGIONS) || defined(__DOXYGEN__)
+  &testheap2,
+#endif
+#if (CH_CFG_USE_HEAP && CH_CFG_USE_ARENAS) || defined(__DOXYGEN__)
+  &testheap3,
+#endif
+#if (CH_CFG_USE_HEAP && CH_CFG_USE_RELOC_HEAPS) || defined(__DOXYGEN__)
+  &testheap4,
+  &testheap5,
 #endif
   NULL
 };
@@ -36,6 +36,7 @@
  * - @p CH_CFG_USE_MUTEXES
  * - @p CH_CFG_USE_CONDVARS
  * - @p CH_DBG_THREADS_PROFILING
+ * - @p CH_DBG_LOCK_STATISTICS
  * .
  * In case some of the required options are not enabled then some or all tests
  * may be skipped.
@@ -49,6 +50,7 @@
  * - @subpage test_mtx_006
  * - @subpage test_mtx_007
  * - @subpage test_mtx_008
+ * - @subpage test_mtx_009
  * .
  * @file testmtx.c
  * @brief Mutexes and CondVars test source file
@@ -599,6 +601,63 @@ ROMCONST struct testcase testmtx8 = {
   mtx8_execute
 };
 #endif /* CH_CFG_USE_CONDVARS */
+
+#if CH_DBG_LOCK_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @page test_mtx_009 Lock statistics
+ *
+ * <h2>Description</h2>
+ * A named mutex is held by the test thread for a few ticks while two higher
+ * priority threads try to lock it.<br>
+ * The test expects the mutex to be registered and its statistics to report
+ * three acquisitions, two of them contended, and a non-zero hold time
+ * attributed to the test thread. Resetting the statistics clears the
+ * counters.
+ */
+
+static void mtx9_setup(void) {
+
+  chMtxObjectInit(&m1);
+  chMtxSetName(&m1, "m1");
+}
+
+static void mtx9_execute(void) {
+  lock_stats_t *lsp;
+
+  tprio_t prio = chThdGetPriorityX();
+  chMtxLock(&m1);
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread1, "B");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread1, "A");
+  chThdSleep(2);
+  chMtxUnlock(&m1);
+  test_wait_threads();
+  test_assert_sequence(1, "AB");
+
+  lsp = chLockStatsFirst();
+  while ((lsp != NULL) && (lsp != &m1.m_stats))
+    lsp = chLockStatsNext(lsp);
+  test_assert(2, lsp == &m1.m_stats, "not registered");
+  test_assert(3, lsp->ls_type == LOCK_STATS_MUTEX, "wrong type");
+  test_assert(4, lsp->ls_acquired == 3, "wrong acquisitions count");
+  test_assert(5, lsp->ls_contended == 2, "wrong contentions count");
+  test_assert(6, lsp->ls_wait_max > 0, "no wait time");
+  test_assert(7, lsp->ls_wait_total >= lsp->ls_wait_max, "wrong wait total");
+  test_assert(8, lsp->ls_hold_max > 0, "no hold time");
+  test_assert(9, lsp->ls_hold_thd == chThdGetSelfX(), "wrong hold thread");
+
+  chLockStatsReset();
+  test_assert(10, (lsp->ls_acquired == 0) && (lsp->ls_contended == 0) &&
+                  (lsp->ls_wait_total == 0) && (lsp->ls_hold_max == 0),
+              "not reset");
+}
+
+ROMCONST struct testcase testmtx9 = {
+  "Mutexes, lock statistics",
+  mtx9_setup,
+  NULL,
+  mtx9_execute
+};
+#endif /* CH_DBG_LOCK_STATISTICS */
 #endif /* CH_CFG_USE_MUTEXES */
 
 /**
@@ -618,6 +677,9 @@ ROMCONST struct testcase * ROMCONST patternmtx[] = {
   &testmtx7,
   &testmtx8,
 #endif
+#if CH_DBG_LOCK_STATISTICS || defined(__DOXYGEN__)
+  &testmtx9,
+#endif
 #endif
   NULL
 };
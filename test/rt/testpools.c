@@ -31,12 +31,16 @@
  * <h2>Preconditions</h2>
  * The module requires the following kernel options:
  * - @p CH_CFG_USE_MEMPOOLS
+ * - @p CH_CFG_USE_SLABS
+ * - @p CH_CFG_USE_HEAP
  * .
  * In case some of the required options are not enabled then some or all tests
  * may be skipped.
  *
  * <h2>Test Cases</h2>
  * - @subpage test_pools_001
+ * - @subpage test_pools_002
+ * - @subpage test_pools_003
  * .
  * @file testpools.c
  * @brief Memory Pools test source file
@@ -106,12 +110,197 @@ ROMCONST struct testcase testpools1 = {
 
 #endif /* CH_CFG_USE_MEMPOOLS */
 
+#if (CH_CFG_USE_SLABS && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+
+#define SLAB_SIZE 128
+#define SLAB_MAX_OBJECTS 16
+
+static memory_heap_t slab_heap;
+static slab_allocator_t sa1;
+static slab_class_t sa1_classes[] = {
+  SLAB_CLASS(16),
+  SLAB_CLASS(32),
+  SLAB_CLASS(64)
+};
+
+/**
+ * @page test_pools_002 Slab allocator, size classes
+ *
+ * <h2>Description</h2>
+ * A slab allocator is created over a heap, requests of various sizes are
+ * routed to the size classes. A class is filled until a second slab is
+ * allocated then emptied, the extra slab is expected to be returned to
+ * the heap.
+ */
+
+static void pools2_setup(void) {
+
+  chHeapObjectInit(&slab_heap, test.buffer, sizeof(union test_buffers));
+  chSlabObjectInit(&sa1, sa1_classes, 3, SLAB_SIZE, &slab_heap);
+}
+
+static void pools2_execute(void) {
+  void *objs[SLAB_MAX_OBJECTS];
+  slab_status_t ss;
+  size_t i, n, heapfree;
+  void *p1, *p2;
+
+  /* Routing to the nearest class.*/
+  p1 = chSlabAlloc(&sa1, 10);
+  p2 = chSlabAlloc(&sa1, 17);
+  test_assert(1, (p1 != NULL) && (p2 != NULL), "allocation failed");
+  chSlabGetStatus(&sa1, 0, &ss);
+  test_assert(2, (ss.ss_slabs == 1) && (ss.ss_used == 1), "wrong class");
+  chSlabGetStatus(&sa1, 1, &ss);
+  test_assert(3, (ss.ss_slabs == 1) && (ss.ss_used == 1), "wrong class");
+  chSlabGetStatus(&sa1, 2, &ss);
+  test_assert(4, ss.ss_slabs == 0, "wrong class");
+
+  /* Filling the first class beyond one slab.*/
+  chSlabGetStatus(&sa1, 0, &ss);
+  n = ss.ss_used + ss.ss_free;
+  test_assert(5, (n > 1) && (n < SLAB_MAX_OBJECTS), "wrong slab size");
+  (void)chHeapStatus(&slab_heap, &heapfree);
+  for (i = 0; i < n; i++) {
+    objs[i] = chSlabAlloc(&sa1, 16);
+    test_assert(6, objs[i] != NULL, "allocation failed");
+  }
+  chSlabGetStatus(&sa1, 0, &ss);
+  test_assert(7, (ss.ss_slabs == 2) && (ss.ss_used == n + 1), "no new slab");
+
+  /* Emptying it, the extra slab goes back to the heap.*/
+  for (i = 0; i < n; i++)
+    chSlabFree(objs[i]);
+  chSlabGetStatus(&sa1, 0, &ss);
+  test_assert(8, (ss.ss_slabs == 1) && (ss.ss_used == 1), "slab not freed");
+  (void)chHeapStatus(&slab_heap, &i);
+  test_assert(9, i == heapfree, "slab not returned");
+
+  /* Requests above the largest class go to the heap.*/
+  objs[0] = chSlabAlloc(&sa1, SLAB_SIZE * 2);
+  test_assert(10, objs[0] != NULL, "allocation failed");
+  chSlabFree(objs[0]);
+
+  chSlabFree(p1);
+  chSlabFree(p2);
+  for (i = 0; i < 3; i++) {
+    chSlabGetStatus(&sa1, (unsigned)i, &ss);
+    test_assert(11, ss.ss_used == 0, "objects in use");
+  }
+}
+
+ROMCONST struct testcase testpools2 = {
+  "Memory Pools, slab allocator",
+  pools2_setup,
+  NULL,
+  pools2_execute
+};
+
+#endif /* CH_CFG_USE_SLABS && CH_CFG_USE_HEAP */
+
+#if CH_CFG_USE_MEMPOOLS || defined(__DOXYGEN__)
+
+#define BMK_OBJECTS 8
+
+static MEMORYPOOL_DECL(mp2, sizeof (stkalign_t) * 2, NULL);
+static stkalign_t bmk_objects[BMK_OBJECTS][2];
+static uint32_t bmk_counts[5];
+
+/**
+ * @page test_pools_003 Contention benchmark
+ *
+ * <h2>Description</h2>
+ * Five threads at the same priority allocate and free objects from the
+ * same pool, yielding while holding objects in order to interleave their
+ * operations.<br>
+ * The performance is calculated by measuring the number of successful
+ * allocations, each followed by its release, after a second of continuous
+ * operations, the pool is then expected to contain all its objects. Each
+ * thread has its own counter, the counters are summed at the end.
+ */
+
+static THD_FUNCTION(pools_thread, p) {
+  void *o1, *o2;
+
+  do {
+    o1 = chPoolAlloc(&mp2);
+    o2 = chPoolAlloc(&mp2);
+    chThdYield();
+    if (o1 != NULL) {
+      chPoolFree(&mp2, o1);
+      (*(uint32_t *)p)++;
+    }
+    if (o2 != NULL) {
+      chPoolFree(&mp2, o2);
+      (*(uint32_t *)p)++;
+    }
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (!chThdShouldTerminateX());
+}
+
+static void pools3_setup(void) {
+
+  chPoolObjectInit(&mp2, sizeof (stkalign_t) * 2, NULL);
+  chPoolLoadArray(&mp2, bmk_objects, BMK_OBJECTS);
+}
+
+static void pools3_execute(void) {
+  uint32_t n;
+  int i;
+
+  test_wait_tick();
+
+  for (i = 0; i < 5; i++) {
+    bmk_counts[i] = 0;
+    threads[i] = chThdCreateStatic(wa[i], WA_SIZE, chThdGetPriorityX()-1,
+                                   pools_thread, (void *)&bmk_counts[i]);
+  }
+
+  chThdSleepSeconds(1);
+  test_terminate_threads();
+  test_wait_threads();
+  n = 0;
+  for (i = 0; i < 5; i++)
+    n += bmk_counts[i];
+
+  /* No object lost or duplicated.*/
+  for (i = 0; i < BMK_OBJECTS; i++)
+    test_assert(1, chPoolAlloc(&mp2) != NULL, "object lost");
+  test_assert(2, chPoolAlloc(&mp2) == NULL, "object duplicated");
+
+#if CH_MEMPOOLS_LOCKFREE
+  test_println("--- Mode  : lock-free");
+#else
+  test_println("--- Mode  : critical zone");
+#endif
+  test_print("--- Score : ");
+  test_printn(n);
+  test_println(" allocations/S");
+}
+
+ROMCONST struct testcase testpools3 = {
+  "Memory Pools, contention benchmark",
+  pools3_setup,
+  NULL,
+  pools3_execute
+};
+
+#endif /* CH_CFG_USE_MEMPOOLS */
+
 /*
  * @brief   Test sequence for pools.
  */
 ROMCONST struct testcase * ROMCONST patternpools[] = {
 #if CH_CFG_USE_MEMPOOLS || defined(__DOXYGEN__)
   &testpools1,
+#endif
+#if (CH_CFG_USE_SLABS && CH_CFG_USE_HEAP) || defined(__DOXYGEN__)
+  &testpools2,
+#endif
+#if CH_CFG_USE_MEMPOOLS || defined(__DOXYGEN__)
+  &testpools3,
 #endif
   NULL
 };
@@ -23,10 +23,10 @@
  * File: @ref testqueues.c
  *
  * <h2>Description</h2>
- * This module implements the test sequence for the @ref io_queues subsystem.
- * The tests are performed by inserting and removing data from queues and by
- * checking both the queues status and the correct sequence of the extracted
- * data.
+ * This module implements the test sequence for the @ref io_queues and the
+ * @ref pipes subsystems. The tests are performed by inserting and removing
+ * data from queues and by checking both the queues status and the correct
+ * sequence of the extracted data.
  *
  * <h2>Objective</h2>
  * Objective of the test module is to cover 100% of the @ref io_queues code.<br>
@@ -36,6 +36,7 @@
  * <h2>Preconditions</h2>
  * The module requires the following kernel options:
  * - @p CH_CFG_USE_QUEUES (and dependent options)
+ * - @p CH_CFG_USE_PIPES
  * .
  * In case some of the required options are not enabled then some or all tests
  * may be skipped.
@@ -43,6 +44,8 @@
  * <h2>Test Cases</h2>
  * - @subpage test_queues_001
  * - @subpage test_queues_002
+ * - @subpage test_queues_003
+ * - @subpage test_queues_004
  * .
  * @file testqueues.c
  * @brief I/O Queues test source file
@@ -230,6 +233,224 @@ ROMCONST struct testcase testqueues2 = {
 };
 #endif /* CH_CFG_USE_QUEUES */
 
+#if CH_CFG_USE_PIPES || defined(__DOXYGEN__)
+
+#define TEST_PIPE_SIZE 8
+#define TEST_PIPE_BENCH_SIZE 128
+#define TEST_PIPE_BENCH_BLOCK 64
+
+static uint8_t pipe_buffer[TEST_PIPE_BENCH_SIZE];
+static PIPE_DECL(pipe1, pipe_buffer, TEST_PIPE_SIZE);
+
+/**
+ * @page test_queues_003 Pipes functionality and APIs
+ *
+ * <h2>Description</h2>
+ * This test case tests bulk, windowed and stream operations on a
+ * @p pipe_t object including wrap around, blocking, timeouts and reset.
+ * The pipe state must remain consistent through the whole test.
+ */
+
+static void queues3_setup(void) {
+
+  chPipeObjectInit(&pipe1, pipe_buffer, TEST_PIPE_SIZE);
+}
+
+static THD_FUNCTION(thread3r, p) {
+  uint8_t b[TEST_PIPE_SIZE];
+  size_t i, n;
+
+  n = chPipeReadTimeout(&pipe1, b, TEST_PIPE_SIZE, MS2ST(200));
+  for (i = 0; i < n; i++)
+    test_emit_token(b[i]);
+  test_emit_token(*(char *)p);
+}
+
+static THD_FUNCTION(thread3w, p) {
+
+  (void)p;
+  chPipeWriteTimeout(&pipe1, (const uint8_t *)"WXYZ", 4, MS2ST(200));
+}
+
+static void queues3_execute(void) {
+  BaseSequentialStream *chp = (BaseSequentialStream *)&pipe1;
+  uint8_t b[TEST_PIPE_SIZE];
+  const uint8_t *rp;
+  size_t i, n;
+
+  /* Initial empty state */
+  test_assert_lock(1, chPipeGetUsedCountI(&pipe1) == 0, "not empty");
+
+  /* Partial read */
+  n = chPipeWriteTimeout(&pipe1, (const uint8_t *)"ABCD", 4, TIME_IMMEDIATE);
+  test_assert(2, n == 4, "wrong written size");
+  n = chPipeReadTimeout(&pipe1, b, TEST_PIPE_SIZE, TIME_IMMEDIATE);
+  test_assert(3, n == 4, "wrong read size");
+  for (i = 0; i < n; i++)
+    test_emit_token(b[i]);
+  test_assert_sequence(4, "ABCD");
+
+  /* Filling across the buffer end */
+  n = chPipeWriteTimeout(&pipe1, (const uint8_t *)"ABCDEFGHI",
+                         TEST_PIPE_SIZE + 1, TIME_IMMEDIATE);
+  test_assert(5, n == TEST_PIPE_SIZE, "wrong written size");
+  test_assert_lock(6, chPipeGetFreeCountI(&pipe1) == 0, "not full");
+
+  /* Windows, the data is split at the buffer end */
+  rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+  test_assert(7, (rp != NULL) && (n == TEST_PIPE_SIZE - 4), "wrong window");
+  for (i = 0; i < n; i++)
+    test_emit_token(rp[i]);
+  chPipeReadCommit(&pipe1, n);
+  rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+  test_assert(8, (rp != NULL) && (n == 4), "wrong window");
+  for (i = 0; i < n; i++)
+    test_emit_token(rp[i]);
+  chPipeReadCommit(&pipe1, n);
+  test_assert_sequence(9, "ABCDEFGH");
+  test_assert(10, chPipeWritePeekTimeout(&pipe1, &n, TIME_IMMEDIATE) ==
+                  pipe_buffer + 4, "wrong window");
+  test_assert(11, n == TEST_PIPE_SIZE - 4, "wrong window size");
+
+  /* Timeout */
+  test_assert(12, chPipeReadTimeout(&pipe1, b, 1, 10) == 0,
+              "wrong timeout return");
+
+  /* Reader resumed by a writer */
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1,
+                                 thread3r, "!");
+  chPipeWriteTimeout(&pipe1, (const uint8_t *)"ABC", 3, TIME_INFINITE);
+  test_wait_threads();
+  test_assert_sequence(13, "ABC!");
+
+  /* Writer resumed by a reader */
+  chPipeWriteTimeout(&pipe1, (const uint8_t *)"ABCDEFGH",
+                     TEST_PIPE_SIZE, TIME_IMMEDIATE);
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1,
+                                 thread3w, NULL);
+  test_assert_lock(14, chPipeGetFreeCountI(&pipe1) == 0, "not full");
+  n = chPipeReadTimeout(&pipe1, b, TEST_PIPE_SIZE, TIME_INFINITE);
+  test_wait_threads();
+  test_assert(15, n == TEST_PIPE_SIZE, "wrong read size");
+  test_assert_lock(16, chPipeGetUsedCountI(&pipe1) == 4, "wrong count");
+
+  /* Stream interface */
+  test_assert(17, chSequentialStreamGet(chp) == 'W', "wrong byte");
+  n = chSequentialStreamRead(chp, b, 3);
+  test_assert(18, (n == 3) && (b[0] == 'X') && (b[2] == 'Z'),
+              "wrong read data");
+
+  /* Reset resumes the waiting readers */
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1,
+                                 thread3r, "!");
+  chPipeReset(&pipe1);
+  test_wait_threads();
+  test_assert_sequence(19, "!");
+  test_assert_lock(20, chPipeGetUsedCountI(&pipe1) == 0, "not empty");
+}
+
+ROMCONST struct testcase testqueues3 = {
+  "Queues, pipes",
+  queues3_setup,
+  NULL,
+  queues3_execute
+};
+
+/**
+ * @page test_queues_004 Pipes throughput
+ *
+ * <h2>Description</h2>
+ * Blocks of 64 bytes are written and then read from a @p pipe_t into a
+ * continuous loop, the same is done with an @p input_queue_t filled from
+ * a lock zone as a reference when queues are enabled. A consumer thread
+ * with priority higher than the tester thread then drains the pipe using
+ * windows while the tester thread writes blocks.<br>
+ * The performance is calculated by measuring the number of bytes moved
+ * after a second of continuous operations.
+ */
+
+static THD_FUNCTION(thread4, p) {
+  const uint8_t *rp;
+  size_t n;
+
+  (void)p;
+  while ((rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_INFINITE)) != NULL)
+    chPipeReadCommit(&pipe1, n);
+}
+
+static void queues4_execute(void) {
+#if CH_CFG_USE_QUEUES
+  static uint8_t ib[TEST_PIPE_BENCH_SIZE];
+  static input_queue_t iq4;
+  unsigned i;
+#endif
+  uint8_t b[TEST_PIPE_BENCH_BLOCK];
+  uint32_t n;
+
+  chPipeObjectInit(&pipe1, pipe_buffer, TEST_PIPE_BENCH_SIZE);
+  n = 0;
+  test_wait_tick();
+  test_start_timer(1000);
+  do {
+    chPipeWriteTimeout(&pipe1, b, sizeof b, TIME_INFINITE);
+    chPipeReadTimeout(&pipe1, b, sizeof b, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (!test_timer_done);
+  test_print("--- Pipe : ");
+  test_printn(n * sizeof b);
+  test_println(" bytes/S");
+
+#if CH_CFG_USE_QUEUES
+  chIQObjectInit(&iq4, ib, sizeof ib, NULL, NULL);
+  n = 0;
+  test_wait_tick();
+  test_start_timer(1000);
+  do {
+    chSysLock();
+    for (i = 0; i < sizeof b; i++)
+      chIQPutI(&iq4, b[i]);
+    chSysUnlock();
+    chIQReadTimeout(&iq4, b, sizeof b, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (!test_timer_done);
+  test_print("--- Queue: ");
+  test_printn(n * sizeof b);
+  test_println(" bytes/S");
+#endif
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX()+1,
+                                 thread4, NULL);
+  n = 0;
+  test_wait_tick();
+  test_start_timer(1000);
+  do {
+    chPipeWriteTimeout(&pipe1, b, sizeof b, TIME_INFINITE);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (!test_timer_done);
+  chPipeReset(&pipe1);
+  test_wait_threads();
+  test_print("--- Pipe, two threads: ");
+  test_printn(n * sizeof b);
+  test_println(" bytes/S");
+}
+
+ROMCONST struct testcase testqueues4 = {
+  "Queues, pipes throughput",
+  NULL,
+  NULL,
+  queues4_execute
+};
+#endif /* CH_CFG_USE_PIPES */
+
 /**
  * @brief   Test sequence for queues.
  */
@@ -237,6 +458,12 @@ ROMCONST struct testcase * ROMCONST patternqueues[] = {
 #if CH_CFG_USE_QUEUES || defined(__DOXYGEN__)
   &testqueues1,
   &testqueues2,
+#endif
+#if CH_CFG_USE_PIPES || defined(__DOXYGEN__)
+  &testqueues3,
+#if !TEST_NO_BENCHMARKS
+  &testqueues4,
+#endif
 #endif
   NULL
 };
@@ -36,6 +36,7 @@
  * - @subpage test_sys_001
  * - @subpage test_sys_002
  * - @subpage test_sys_003
+ * - @subpage test_sys_004
  * .
  * @file testsys.c
  * @brief System test source file
@@ -166,6 +167,74 @@ ROMCONST struct testcase testsys3 = {
   sys3_execute
 };
 
+#if (CH_CFG_USE_TM && CH_CFG_USE_TM_HISTOGRAM) || defined(__DOXYGEN__)
+/**
+ * @page test_sys_004 Time measurement histograms
+ *
+ * <h2>Description</h2>
+ * An histogram is attached to a measurement object and a measurement is
+ * performed, the histogram must be registered and the sample must be
+ * accounted in it. Then a known
+ * distribution is loaded in the histogram and the percentiles are checked
+ * against the buckets limits.
+ */
+
+static void sys4_execute(void) {
+  static time_measurement_t tm;
+  static tm_histogram_t h;
+  tm_histogram_t *hp;
+  unsigned i;
+
+  /* Histograms cannot be unregistered, the objects are attached only the
+     first time the test is executed.*/
+  if (h.tmp == NULL) {
+    chTMObjectInit(&tm);
+    chTMHistogramObjectInit(&h, "test");
+    chTMAttachHistogram(&tm, &h);
+  }
+  hp = chTMHistogramFirst();
+  while ((hp != NULL) && (hp != &h)) {
+    hp = chTMHistogramNext(hp);
+  }
+  test_assert(1, hp == &h, "histogram not registered");
+
+  chTMHistogramResetX(&h);
+  chTMStartMeasurementX(&tm);
+  chTMStopMeasurementX(&tm);
+  test_assert(2, h.n == 1, "sample not accounted");
+
+  for (i = 0; i < CH_CFG_TM_HISTOGRAM_BUCKETS - 1; i++) {
+    test_assert(3, chTMHistogramGetBucketLimitX(i) <
+                   chTMHistogramGetBucketLimitX(i + 1),
+                "buckets not monotonic");
+  }
+
+  chTMHistogramResetX(&h);
+  test_assert(4, chTMHistogramGetPercentileX(&h, 500) == 0,
+              "empty histogram");
+
+  h.n = 100;
+  h.buckets[2] = 90;
+  h.buckets[10] = 9;
+  h.buckets[CH_CFG_TM_HISTOGRAM_BUCKETS - 1] = 1;
+  test_assert(5, chTMHistogramGetPercentileX(&h, 500) ==
+                 chTMHistogramGetBucketLimitX(2), "wrong median");
+  test_assert(6, chTMHistogramGetPercentileX(&h, 900) ==
+                 chTMHistogramGetBucketLimitX(2), "wrong 90th percentile");
+  test_assert(7, chTMHistogramGetPercentileX(&h, 990) ==
+                 chTMHistogramGetBucketLimitX(10), "wrong 99th percentile");
+  test_assert(8, chTMHistogramGetPercentileX(&h, 1000) == (rtcnt_t)-1,
+              "overflow bucket not reported");
+}
+
+ROMCONST struct testcase testsys4 = {
+  "System, time measurement histograms",
+  NULL,
+  NULL,
+  sys4_execute
+};
+#endif /* CH_CFG_USE_TM && CH_CFG_USE_TM_HISTOGRAM */
+
 /**
  * @brief   Test sequence for messages.
  */
@@ -173,5 +242,8 @@ ROMCONST struct testcase * ROMCONST patternsys[] = {
   &testsys1,
   &testsys2,
   &testsys3,
+#if (CH_CFG_USE_TM && CH_CFG_USE_TM_HISTOGRAM) || defined(__DOXYGEN__)
+  &testsys4,
+#endif
   NULL
 };
@@ -40,6 +40,7 @@
  * - @subpage test_threads_002
  * - @subpage test_threads_003
  * - @subpage test_threads_004
+ * - @subpage test_threads_005
  * .
  * @file testthd.c
  * @brief Threads and Scheduler test source file
@@ -226,6 +227,44 @@ ROMCONST struct testcase testthd4 = {
   thd4_execute
 };
 
+/**
+ * @page test_threads_005 Threads table
+ *
+ * <h2>Description</h2>
+ * Five threads, with pseudo-random priority higher than the tester thread,
+ * are created from a threads table.<br>
+ * The test expects the threads to have been executed in priority order
+ * when @p chThdCreateTable() returns.
+ */
+
+static void thd5_execute(void) {
+  tprio_t prio = chThdGetPriorityX();
+  const thread_descriptor_t table[] = {
+    THD_TABLE_ENTRY(test.wa.T1, "D", prio + 2, thread, "D")
+    THD_TABLE_ENTRY(test.wa.T0, "E", prio + 1, thread, "E")
+    THD_TABLE_ENTRY(test.wa.T4, "A", prio + 5, thread, "A")
+    THD_TABLE_ENTRY(test.wa.T2, "C", prio + 3, thread, "C")
+    THD_TABLE_ENTRY(test.wa.T3, "B", prio + 4, thread, "B")
+    THD_TABLE_TERMINATOR
+  };
+
+  chThdCreateTable(table);
+  test_assert_sequence(1, "ABCDE");
+  threads[0] = (thread_t *)test.wa.T0;
+  threads[1] = (thread_t *)test.wa.T1;
+  threads[2] = (thread_t *)test.wa.T2;
+  threads[3] = (thread_t *)test.wa.T3;
+  threads[4] = (thread_t *)test.wa.T4;
+  test_wait_threads();
+}
+
+ROMCONST struct testcase testthd5 = {
+  "Threads, creation from table",
+  NULL,
+  NULL,
+  thd5_execute
+};
+
 /**
  * @brief   Test sequence for threads.
  */
@@ -234,5 +273,6 @@ ROMCONST struct testcase * ROMCONST patternthd[] = {
   &testthd2,
   &testthd3,
   &testthd4,
+  &testthd5,
   NULL
 };
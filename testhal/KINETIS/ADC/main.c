@@ -93,7 +93,9 @@ static const ADCConversionGroup adcgrpcfg1 = {
     ADCx_CFG1_MODE(ADCx_CFG1_MODE_16_BITS),
   /* SC3 Register - Average 32 readings per sample */
   ADCx_SC3_AVGE |
-    ADCx_SC3_AVGS(ADCx_SC3_AVGS_AVERAGE_32_SAMPLES)
+    ADCx_SC3_AVGS(ADCx_SC3_AVGS_AVERAGE_32_SAMPLES),
+  /* Software triggered conversions */
+  ADC_TRIGGER_SOFTWARE
 };
 
 static const ADCConfig adccfg1 = {